@@ -6,7 +6,9 @@
 
 DECLARE_LIGHTNING_OBJECT(SLightningEnvironment)
 DECLARE_LIGHTNING_OBJECT(SLightningStorage)
+typedef struct SLightningEnvironmentDescriptor SLightningEnvironmentDescriptor;
 typedef struct SLightningStorageOpenDescriptor SLightningStorageOpenDescriptor;
+typedef struct SLightningEnvironmentInfo SLightningEnvironmentInfo;
 
 typedef enum ELightningStorageOpenFlag
 {
@@ -22,10 +24,19 @@ typedef enum ELightningStorageOpenFlag
 } ELightningStorageOpenFlag;
 typedef uint32_t LightningStorageOpenFlags;
 
+// name is the directory of the environment, it is created if missing. processes opening the same directory share it
 SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
 SLightningEnvironmentId skr_lightning_storage_create_environment(const char* name);
 SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+SLightningEnvironmentId skr_lightning_storage_create_environment_with_desc(const struct SLightningEnvironmentDescriptor* desc);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
 void skr_lightning_storage_free_environment(SLightningEnvironmentId environment);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_get_environment_info(SLightningEnvironmentId environment, struct SLightningEnvironmentInfo* out_info);
+// grows (or shrinks) the map of the environment, no transaction of this process may be alive while it runs.
+// 0 adopts the size another process has grown the map to, writes fail with a full map until either happens
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_set_map_size(SLightningEnvironmentId environment, uint64_t map_size);
 
 SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
 SLightningStorageId skr_open_lightning_storage(SLightningEnvironmentId environment, const struct SLightningStorageOpenDescriptor* desc);
@@ -41,13 +52,32 @@ struct SLightningEnvironment
 
 struct SLightningStorage
 {
+    SLightningEnvironmentId environment;
     uint64_t mdbi;
-    struct STimer* open_timer;
     uint32_t timeout_ms;
+    LightningStorageOpenFlags flags;
 };
 
 // lightning storage descriptors
 
+struct SLightningEnvironmentDescriptor
+{
+    const char* name;
+    // upper bound of the data in the environment, 0 for the default of 1 GiB
+    uint64_t map_size;
+    // read transactions that may be open at once across all processes, 0 for the default of 126
+    uint32_t max_readers;
+    // named storages in the environment, 0 for the default of 64
+    uint32_t max_storages;
+};
+
+struct SLightningEnvironmentInfo
+{
+    uint64_t map_size;
+    // bytes of the map in use, pages freed by old transactions are reused before the map grows
+    uint64_t used_size;
+};
+
 struct SLightningStorageOpenDescriptor
 {
     const char* name;
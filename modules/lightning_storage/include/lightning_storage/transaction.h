@@ -0,0 +1,91 @@
+#pragma once
+#include "lightning_storage/storage.h"
+
+DECLARE_LIGHTNING_OBJECT(SLightningTransaction)
+DECLARE_LIGHTNING_OBJECT(SLightningCursor)
+
+typedef enum ELightningTransactionFlag
+{
+    LIGHTNING_TRANSACTION_READ_WRITE = 0x00000000,
+    LIGHTNING_TRANSACTION_READ_ONLY = 0x00000001,
+
+    LIGHTNING_TRANSACTION_MAX_ENUM_BIT = 0x7FFFFFFF
+} ELightningTransactionFlag;
+typedef uint32_t LightningTransactionFlags;
+
+// values read in a transaction point into the memory map of the environment, they are valid until the transaction ends
+typedef struct SLightningValue {
+    const void* data;
+    uint64_t size;
+} SLightningValue;
+
+typedef struct SLightningKeyValue {
+    SLightningValue key;
+    SLightningValue value;
+} SLightningKeyValue;
+
+typedef enum ELightningPutFlag
+{
+    LIGHTNING_PUT_DEFAULT = 0x00000000,
+    // keys that exist keep their values
+    LIGHTNING_PUT_NO_OVERWRITE = 0x00000001,
+    // keys are sorted and greater than every key in the storage, bulk loads skip the tree searches
+    LIGHTNING_PUT_APPEND = 0x00000002,
+
+    LIGHTNING_PUT_MAX_ENUM_BIT = 0x7FFFFFFF
+} ELightningPutFlag;
+typedef uint32_t LightningPutFlags;
+
+// return false to stop the scan
+typedef bool (*SLightningScanCallback)(void* userdata, const SLightningKeyValue* pair);
+
+// readers never block each other or the writer, and see the storage as it was when they began.
+// one write transaction at a time per environment, across processes. begin blocks until the running one ends
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+SLightningTransactionId skr_lightning_storage_begin_transaction(SLightningEnvironmentId environment, LightningTransactionFlags flags);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_commit_transaction(SLightningTransactionId transaction);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+void skr_lightning_storage_abort_transaction(SLightningTransactionId transaction);
+
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_get(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key, SLightningValue* out_value);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_put(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key, const SLightningValue* value);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_storage_delete(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key);
+// returns the number of pairs written, existing keys skipped with LIGHTNING_PUT_NO_OVERWRITE are not counted.
+// stops at the first error, the transaction should be aborted then
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+uint64_t skr_lightning_storage_put_batch(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningKeyValue* pairs, uint64_t count, LightningPutFlags flags);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+uint64_t skr_lightning_storage_count(SLightningTransactionId transaction, SLightningStorageId storage);
+
+// keys are ordered bytewise, a key sorts before the longer keys it prefixes
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+SLightningCursorId skr_lightning_storage_open_cursor(SLightningTransactionId transaction, SLightningStorageId storage);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+void skr_lightning_storage_close_cursor(SLightningCursorId cursor);
+// moves to the first pair with a key not less than key, to the first pair of the storage if key is null
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_cursor_seek(SLightningCursorId cursor, const SLightningValue* key, SLightningKeyValue* out_pair);
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+bool skr_lightning_cursor_next(SLightningCursorId cursor, SLightningKeyValue* out_pair);
+// calls f for the pairs with begin <= key < end in key order, null bounds are open. returns the number of visited pairs
+SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
+uint64_t skr_lightning_storage_scan(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* begin, const SLightningValue* end, SLightningScanCallback f, void* userdata);
+
+// lightning transaction objects
+
+struct SLightningTransaction
+{
+    struct MDB_txn* txn;
+    LightningTransactionFlags flags;
+};
+
+struct SLightningCursor
+{
+    struct MDB_cursor* cursor;
+    SLightningTransactionId transaction;
+    SLightningStorageId storage;
+};
@@ -0,0 +1,11 @@
+#include "SkrLightningStorage/module.configure.h"
+#include "SkrRT/module/module.hpp"
+
+class SKR_LIGHTNING_STORAGE_API SkrLightningStorageModule : public skr::IDynamicModule
+{
+public:
+    virtual void on_load(int argc, char8_t** argv) override {}
+    virtual void on_unload() override {}
+};
+
+IMPLEMENT_DYNAMIC_MODULE(SkrLightningStorageModule, SkrLightningStorage);
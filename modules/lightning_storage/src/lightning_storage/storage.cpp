@@ -1,7 +1,332 @@
 #include "lightning_storage/storage.h"
+#include "lightning_storage/transaction.h"
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/misc/log.h"
 
-SKR_LIGHTNING_STORAGE_EXTERN_C SKR_LIGHTNING_STORAGE_API
-void nothing()
+#include "lmdb/lmdb.h"
+
+// environments are memory maps, the file only grows as much as it is written to on most platforms
+static constexpr uint64_t kLightningMapSize = uint64_t(1) << 30;
+static constexpr uint32_t kLightningMaxReaders = 126;
+static constexpr uint32_t kLightningMaxStorages = 64;
+
+SLightningEnvironmentId skr_lightning_storage_create_environment(const char* name)
+{
+    SLightningEnvironmentDescriptor desc = {};
+    desc.name = name;
+    return skr_lightning_storage_create_environment_with_desc(&desc);
+}
+
+SLightningEnvironmentId skr_lightning_storage_create_environment_with_desc(const SLightningEnvironmentDescriptor* desc)
+{
+    std::error_code ec = {};
+    skr::filesystem::create_directories(desc->name, ec);
+    MDB_env* env = nullptr;
+    int rc = mdb_env_create(&env);
+    if (rc == MDB_SUCCESS) rc = mdb_env_set_maxdbs(env, desc->max_storages ? desc->max_storages : kLightningMaxStorages);
+    if (rc == MDB_SUCCESS) rc = mdb_env_set_maxreaders(env, desc->max_readers ? desc->max_readers : kLightningMaxReaders);
+    if (rc == MDB_SUCCESS) rc = mdb_env_set_mapsize(env, (size_t)(desc->map_size ? desc->map_size : kLightningMapSize));
+    // read transactions are not bound to threads, tasks may end them on another worker
+    if (rc == MDB_SUCCESS) rc = mdb_env_open(env, desc->name, MDB_NOTLS, 0664);
+    if (rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to open environment %s, reason: %s", desc->name, mdb_strerror(rc));
+        if (env) mdb_env_close(env);
+        return nullptr;
+    }
+    // release the reader slots of crashed processes, they would hold old pages forever
+    int dead_readers = 0;
+    mdb_reader_check(env, &dead_readers);
+    auto environment = SkrNew<SLightningEnvironment>();
+    environment->env = env;
+    return environment;
+}
+
+void skr_lightning_storage_free_environment(SLightningEnvironmentId environment)
+{
+    if (!environment) return;
+    mdb_env_close(environment->env);
+    SkrDelete(environment);
+}
+
+bool skr_lightning_storage_get_environment_info(SLightningEnvironmentId environment, SLightningEnvironmentInfo* out_info)
+{
+    MDB_envinfo info = {};
+    MDB_stat stat = {};
+    int rc = mdb_env_info(environment->env, &info);
+    if (rc == MDB_SUCCESS) rc = mdb_env_stat(environment->env, &stat);
+    if (rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to get environment info, reason: %s", mdb_strerror(rc));
+        return false;
+    }
+    out_info->map_size = info.me_mapsize;
+    out_info->used_size = (uint64_t)(info.me_last_pgno + 1) * stat.ms_psize;
+    return true;
+}
+
+bool skr_lightning_storage_set_map_size(SLightningEnvironmentId environment, uint64_t map_size)
+{
+    if (int rc = mdb_env_set_mapsize(environment->env, (size_t)map_size); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to resize map to %llu bytes, reason: %s", (unsigned long long)map_size, mdb_strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+// storages are opened in write transactions, lmdb forbids concurrent transactions opening databases
+SLightningStorageId skr_open_lightning_storage(SLightningEnvironmentId environment, const SLightningStorageOpenDescriptor* desc)
+{
+    const unsigned int dbi_flags = (desc->flags & LIGHTNING_STORAGE_OPEN_CREATE) ? MDB_CREATE : 0;
+    STimer timer;
+    skr_init_timer(&timer);
+    while (true)
+    {
+        MDB_txn* txn = nullptr;
+        MDB_dbi dbi = 0;
+        int rc = mdb_txn_begin(environment->env, nullptr, 0, &txn);
+        if (rc == MDB_SUCCESS) rc = mdb_dbi_open(txn, desc->name, dbi_flags, &dbi);
+        if (rc == MDB_SUCCESS && (desc->flags & LIGHTNING_STORAGE_OPEN_TRUNCATE)) rc = mdb_drop(txn, dbi, 0);
+        if (rc == MDB_SUCCESS)
+        {
+            rc = mdb_txn_commit(txn);
+        }
+        else if (txn)
+        {
+            mdb_txn_abort(txn);
+        }
+        if (rc == MDB_SUCCESS)
+        {
+            auto storage = SkrNew<SLightningStorage>();
+            storage->environment = environment;
+            storage->mdbi = dbi;
+            storage->timeout_ms = desc->timeout_ms;
+            storage->flags = desc->flags;
+            return storage;
+        }
+        const bool retry = (desc->flags & LIGHTNING_STORAGE_OPEN_TRY_TIMEOUT) && (skr_timer_get_msec(&timer, false) < desc->timeout_ms);
+        if (!retry)
+        {
+            SKR_LOG_ERROR(u8"lightning storage: failed to open storage %s, reason: %s", desc->name ? desc->name : "", mdb_strerror(rc));
+            return nullptr;
+        }
+        skr_thread_sleep(1);
+    }
+}
+
+void skr_close_lightning_storage(SLightningStorageId storage)
+{
+    // database handles are owned by the environment, closing them while other storages share them is not allowed
+    SkrDelete(storage);
+}
+
+SLightningTransactionId skr_lightning_storage_begin_transaction(SLightningEnvironmentId environment, LightningTransactionFlags flags)
+{
+    MDB_txn* txn = nullptr;
+    const unsigned int txn_flags = (flags & LIGHTNING_TRANSACTION_READ_ONLY) ? MDB_RDONLY : 0;
+    if (int rc = mdb_txn_begin(environment->env, nullptr, txn_flags, &txn); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to begin transaction, reason: %s", mdb_strerror(rc));
+        return nullptr;
+    }
+    auto transaction = SkrNew<SLightningTransaction>();
+    transaction->txn = txn;
+    transaction->flags = flags;
+    return transaction;
+}
+
+bool skr_lightning_storage_commit_transaction(SLightningTransactionId transaction)
+{
+    const int rc = mdb_txn_commit(transaction->txn);
+    if (rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to commit transaction, reason: %s", mdb_strerror(rc));
+    }
+    SkrDelete(transaction);
+    return rc == MDB_SUCCESS;
+}
+
+void skr_lightning_storage_abort_transaction(SLightningTransactionId transaction)
+{
+    mdb_txn_abort(transaction->txn);
+    SkrDelete(transaction);
+}
+
+bool skr_lightning_storage_get(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key, SLightningValue* out_value)
+{
+    MDB_val mkey = { (size_t)key->size, (void*)key->data };
+    MDB_val mvalue = {};
+    const int rc = mdb_get(transaction->txn, (MDB_dbi)storage->mdbi, &mkey, &mvalue);
+    if (rc != MDB_SUCCESS)
+    {
+        if (rc != MDB_NOTFOUND)
+            SKR_LOG_ERROR(u8"lightning storage: failed to get value, reason: %s", mdb_strerror(rc));
+        return false;
+    }
+    out_value->data = mvalue.mv_data;
+    out_value->size = mvalue.mv_size;
+    return true;
+}
+
+bool skr_lightning_storage_put(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key, const SLightningValue* value)
+{
+    if ((transaction->flags & LIGHTNING_TRANSACTION_READ_ONLY) || (storage->flags & LIGHTNING_STORAGE_OPEN_READ_ONLY))
+    {
+        SKR_LOG_ERROR(u8"lightning storage: put in a read only transaction or storage");
+        return false;
+    }
+    MDB_val mkey = { (size_t)key->size, (void*)key->data };
+    MDB_val mvalue = { (size_t)value->size, (void*)value->data };
+    if (int rc = mdb_put(transaction->txn, (MDB_dbi)storage->mdbi, &mkey, &mvalue, 0); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to put value, reason: %s", mdb_strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool skr_lightning_storage_delete(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* key)
+{
+    if ((transaction->flags & LIGHTNING_TRANSACTION_READ_ONLY) || (storage->flags & LIGHTNING_STORAGE_OPEN_READ_ONLY))
+    {
+        SKR_LOG_ERROR(u8"lightning storage: delete in a read only transaction or storage");
+        return false;
+    }
+    MDB_val mkey = { (size_t)key->size, (void*)key->data };
+    const int rc = mdb_del(transaction->txn, (MDB_dbi)storage->mdbi, &mkey, nullptr);
+    if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to delete value, reason: %s", mdb_strerror(rc));
+        return false;
+    }
+    return rc == MDB_SUCCESS;
+}
+
+uint64_t skr_lightning_storage_put_batch(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningKeyValue* pairs, uint64_t count, LightningPutFlags flags)
+{
+    if ((transaction->flags & LIGHTNING_TRANSACTION_READ_ONLY) || (storage->flags & LIGHTNING_STORAGE_OPEN_READ_ONLY))
+    {
+        SKR_LOG_ERROR(u8"lightning storage: put in a read only transaction or storage");
+        return 0;
+    }
+    MDB_cursor* cursor = nullptr;
+    if (int rc = mdb_cursor_open(transaction->txn, (MDB_dbi)storage->mdbi, &cursor); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to open cursor, reason: %s", mdb_strerror(rc));
+        return 0;
+    }
+    unsigned int put_flags = 0;
+    if (flags & LIGHTNING_PUT_NO_OVERWRITE) put_flags |= MDB_NOOVERWRITE;
+    if (flags & LIGHTNING_PUT_APPEND) put_flags |= MDB_APPEND;
+    uint64_t written = 0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        MDB_val mkey = { (size_t)pairs[i].key.size, (void*)pairs[i].key.data };
+        MDB_val mvalue = { (size_t)pairs[i].value.size, (void*)pairs[i].value.data };
+        const int rc = mdb_cursor_put(cursor, &mkey, &mvalue, put_flags);
+        if (rc == MDB_KEYEXIST && (flags & LIGHTNING_PUT_NO_OVERWRITE)) continue;
+        if (rc != MDB_SUCCESS)
+        {
+            SKR_LOG_ERROR(u8"lightning storage: batch put failed at pair %llu, reason: %s", (unsigned long long)i, mdb_strerror(rc));
+            break;
+        }
+        written++;
+    }
+    mdb_cursor_close(cursor);
+    return written;
+}
+
+uint64_t skr_lightning_storage_count(SLightningTransactionId transaction, SLightningStorageId storage)
+{
+    MDB_stat stat = {};
+    if (int rc = mdb_stat(transaction->txn, (MDB_dbi)storage->mdbi, &stat); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to get storage stat, reason: %s", mdb_strerror(rc));
+        return 0;
+    }
+    return stat.ms_entries;
+}
+
+SLightningCursorId skr_lightning_storage_open_cursor(SLightningTransactionId transaction, SLightningStorageId storage)
+{
+    MDB_cursor* mcursor = nullptr;
+    if (int rc = mdb_cursor_open(transaction->txn, (MDB_dbi)storage->mdbi, &mcursor); rc != MDB_SUCCESS)
+    {
+        SKR_LOG_ERROR(u8"lightning storage: failed to open cursor, reason: %s", mdb_strerror(rc));
+        return nullptr;
+    }
+    auto cursor = SkrNew<SLightningCursor>();
+    cursor->cursor = mcursor;
+    cursor->transaction = transaction;
+    cursor->storage = storage;
+    return cursor;
+}
+
+void skr_lightning_storage_close_cursor(SLightningCursorId cursor)
+{
+    mdb_cursor_close(cursor->cursor);
+    SkrDelete(cursor);
+}
+
+static bool lightning_cursor_get(SLightningCursorId cursor, MDB_val* mkey, SLightningKeyValue* out_pair, MDB_cursor_op op)
+{
+    MDB_val mvalue = {};
+    const int rc = mdb_cursor_get(cursor->cursor, mkey, &mvalue, op);
+    if (rc != MDB_SUCCESS)
+    {
+        if (rc != MDB_NOTFOUND)
+            SKR_LOG_ERROR(u8"lightning storage: failed to move cursor, reason: %s", mdb_strerror(rc));
+        return false;
+    }
+    out_pair->key.data = mkey->mv_data;
+    out_pair->key.size = mkey->mv_size;
+    out_pair->value.data = mvalue.mv_data;
+    out_pair->value.size = mvalue.mv_size;
+    return true;
+}
+
+bool skr_lightning_cursor_seek(SLightningCursorId cursor, const SLightningValue* key, SLightningKeyValue* out_pair)
+{
+    MDB_val mkey = {};
+    if (key)
+    {
+        mkey.mv_data = (void*)key->data;
+        mkey.mv_size = (size_t)key->size;
+    }
+    return lightning_cursor_get(cursor, &mkey, out_pair, key ? MDB_SET_RANGE : MDB_FIRST);
+}
+
+bool skr_lightning_cursor_next(SLightningCursorId cursor, SLightningKeyValue* out_pair)
+{
+    MDB_val mkey = {};
+    return lightning_cursor_get(cursor, &mkey, out_pair, MDB_NEXT);
+}
+
+uint64_t skr_lightning_storage_scan(SLightningTransactionId transaction, SLightningStorageId storage, const SLightningValue* begin, const SLightningValue* end, SLightningScanCallback f, void* userdata)
 {
-    
-}
\ No newline at end of file
+    auto cursor = skr_lightning_storage_open_cursor(transaction, storage);
+    if (!cursor) return 0;
+    MDB_val mend = {};
+    if (end)
+    {
+        mend.mv_data = (void*)end->data;
+        mend.mv_size = (size_t)end->size;
+    }
+    uint64_t visited = 0;
+    SLightningKeyValue pair = {};
+    for (bool found = skr_lightning_cursor_seek(cursor, begin, &pair); found; found = skr_lightning_cursor_next(cursor, &pair))
+    {
+        MDB_val mkey = { (size_t)pair.key.size, (void*)pair.key.data };
+        if (end && mdb_cmp(transaction->txn, (MDB_dbi)storage->mdbi, &mkey, &mend) >= 0)
+            break;
+        visited++;
+        if (!f(userdata, &pair))
+            break;
+    }
+    skr_lightning_storage_close_cursor(cursor);
+    return visited;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "SkrRenderGraph/frontend/resource_node.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/containers/hashmap.hpp"
+
+namespace skr
+{
+namespace render_graph
+{
+// results of RenderGraph::compile() that only depend on the structure of the graph.
+// graphs are rebuilt every frame, a frame with the same structure as the last compiled one reuses them
+struct CompiledGraph
+{
+    // state of a resource right before a pass uses it
+    struct PriorState
+    {
+        ECGPUResourceState state = CGPU_RESOURCE_STATE_UNDEFINED;
+        // no earlier pass uses the resource, the state is the init state of this frame
+        bool from_init = true;
+    };
+    static inline uint64_t prior_state_key(uint32_t pass_order, dag_id_t resource) SKR_NOEXCEPT
+    {
+        return ((uint64_t)pass_order << 32) | (uint64_t)(uint32_t)resource;
+    }
+
+    uint64_t hash = 0;
+    // the flattened structure the hash is made of, compared on a hash match
+    skr::vector<uint64_t> keys;
+    // indexed like the resources of the graph after culling
+    skr::vector<ResourceNode::LifeSpan> lifespans;
+    // keyed by prior_state_key
+    skr::flat_hash_map<uint64_t, PriorState> prior_states;
+    // texture and aliasing source, indexed like the resources of the graph after culling
+    skr::vector<eastl::pair<uint32_t, uint32_t>> aliasing;
+    bool aliasing_valid = false;
+    // set by compile, the prior states are only valid for the frame that is compiled
+    bool frame_valid = false;
+};
+} // namespace render_graph
+} // namespace skr
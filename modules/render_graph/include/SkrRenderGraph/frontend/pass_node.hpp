@@ -30,6 +30,7 @@ class PassNode : public RenderGraphNode
 public:
     friend class RenderGraph;
     friend class RenderGraphBackend;
+    friend class SchedulePhase;
 
     SKR_RENDER_GRAPH_API const bool before(const PassNode* other) const;
     SKR_RENDER_GRAPH_API const bool after(const PassNode* other) const;
@@ -53,10 +54,12 @@ public:
         return (uint32_t)(in_buffer_edges.size() + out_buffer_edges.size() + ppl_buffer_edges.size());
     }
     const bool get_can_be_lone() const { return can_be_lone; }
+    // position in the execution sequence, declaration order unless the schedule phase reorders the passes
+    uint32_t get_order() const { return order; }
 
     const EPassType pass_type = EPassType::None;
-    const uint32_t order;
 protected:
+    uint32_t order;
     bool can_be_lone = false;
     PassNode(EPassType pass_type, uint32_t order);
     graph_edges_vector<TextureReadEdge*> in_texture_edges;
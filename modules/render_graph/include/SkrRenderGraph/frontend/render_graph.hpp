@@ -53,9 +53,11 @@ public:
         RenderGraphBuilder& with_device(CGPUDeviceId device) SKR_NOEXCEPT;
         RenderGraphBuilder& with_gfx_queue(CGPUQueueId queue) SKR_NOEXCEPT;
         RenderGraphBuilder& enable_memory_aliasing() SKR_NOEXCEPT;
+        RenderGraphBuilder& enable_pass_reordering() SKR_NOEXCEPT;
 
     protected:
         bool memory_aliasing = false;
+        bool pass_reordering = false;
         bool no_backend;
         ECGPUBackend api;
         CGPUDeviceId device;
@@ -192,6 +194,8 @@ public:
     BufferHandle create_buffer(const BufferSetupFunction& setup) SKR_NOEXCEPT;
     inline BufferHandle get_buffer(const char8_t* name) SKR_NOEXCEPT;
     const ECGPUResourceState get_lastest_state(const BufferNode* buffer, const PassNode* pending_pass) const SKR_NOEXCEPT;
+    // walks the edges of the buffer instead of looking up the prior states of the last compile
+    const ECGPUResourceState calculate_lastest_state(const BufferNode* buffer, const PassNode* pending_pass) const SKR_NOEXCEPT;
 
     class SKR_RENDER_GRAPH_API TextureBuilder
     {
@@ -221,6 +225,8 @@ public:
     TextureHandle create_texture(const TextureSetupFunction& setup) SKR_NOEXCEPT;
     TextureHandle get_texture(const char8_t* name) SKR_NOEXCEPT;
     const ECGPUResourceState get_lastest_state(const TextureNode* texture, const PassNode* pending_pass) const SKR_NOEXCEPT;
+    // walks the edges of the texture instead of looking up the prior states of the last compile
+    const ECGPUResourceState calculate_lastest_state(const TextureNode* texture, const PassNode* pending_pass) const SKR_NOEXCEPT;
 
     BufferNode* resolve(BufferHandle hdl) SKR_NOEXCEPT; 
     TextureNode* resolve(TextureHandle hdl) SKR_NOEXCEPT;
@@ -249,6 +255,11 @@ public:
         aliasing_enabled = enabled;
         return aliasing_enabled;
     }
+    // hash of the passes, resource descriptors and edges built this frame. imported objects, pipelines,
+    // clear values and execute functions are not part of it, they are read from the nodes every frame
+    inline uint64_t get_structure_hash() const SKR_NOEXCEPT { return structure_hash; }
+    // true if the last compile() found the structure of the previous one and reused its results
+    inline bool is_compile_cached() const SKR_NOEXCEPT { return compile_cached; }
     RenderGraph(const RenderGraphBuilder& builder) SKR_NOEXCEPT;
     virtual ~RenderGraph() SKR_NOEXCEPT = default;
 
@@ -266,6 +277,12 @@ protected:
     virtual void finalize() SKR_NOEXCEPT;
 
 protected:
+    void hash_structure(skr::vector<uint64_t>& keys) const SKR_NOEXCEPT;
+    // hashes the structure before the phases run, the schedule is compiled after them
+    bool compile_structure() SKR_NOEXCEPT;
+    void compile_schedule() SKR_NOEXCEPT;
+    void clear_frame() SKR_NOEXCEPT;
+
     uint32_t foreach_textures(eastl::function<void(TextureNode*)> texture) SKR_NOEXCEPT;
     uint32_t foreach_writer_passes(TextureHandle texture,
         eastl::function<void(PassNode* writer, TextureNode* tex, RenderGraphEdge* edge)>) const SKR_NOEXCEPT;
@@ -278,6 +295,10 @@ protected:
 
     bool aliasing_enabled;
     uint64_t frame_index = 0;
+    uint64_t structure_hash = 0;
+    bool compile_cached = false;
+    struct CompiledGraph* compiled = nullptr;
+    skr::vector<uint64_t> frame_keys;
 
     struct NodeAndEdgeFactory* node_factory = nullptr;
     Blackboard* blackboard = nullptr;
@@ -303,7 +324,8 @@ using BufferBuilder = RenderGraph::BufferBuilder;
 class SKR_RENDER_GRAPH_API RenderGraphViz
 {
 public:
-    static void write_graphviz(RenderGraph& graph, const char* outf) SKR_NOEXCEPT;
+    // passes are grouped by level when a schedule is given
+    static void write_graphviz(RenderGraph& graph, const char* outf, const struct SchedulePhase* schedule = nullptr) SKR_NOEXCEPT;
 };
 } // namespace render_graph
 } // namespace skr
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "SkrRenderGraph/frontend/render_graph.hpp"
+
+namespace skr {
+namespace render_graph {
+
+// plans the transient textures and buffers of a compiled graph into heaps, resources whose
+// lifespans (first to last pass) do not overlap share memory. needs no device
+struct SKR_RENDER_GRAPH_API MemoryPlanPhase : public IRenderGraphPhase
+{
+    enum EHeap : uint32_t
+    {
+        kHeapBuffers,
+        kHeapTextures,
+        kHeapCount
+    };
+
+    struct Allocation
+    {
+        ResourceNode* resource = nullptr;
+        // index in the resources of the graph after culling
+        uint32_t resource_index = 0;
+        EHeap heap = kHeapBuffers;
+        uint32_t first_pass = 0;
+        uint32_t last_pass = 0;
+        uint64_t size = 0;
+        uint64_t offset = 0;
+    };
+
+    void on_compile(RenderGraph* graph) SKR_NOEXCEPT final;
+    void on_execute(RenderGraph* graph, RenderGraphProfiler* profiler) SKR_NOEXCEPT final;
+
+    const Allocation* find_allocation(const ResourceNode* resource) const SKR_NOEXCEPT;
+    inline uint64_t get_heap_size(EHeap heap) const SKR_NOEXCEPT { return heap_sizes[heap]; }
+    // transient memory with every resource allocated on its own
+    inline uint64_t get_unaliased_size() const SKR_NOEXCEPT { return unaliased_size; }
+    // transient memory of the plan, the sum of all heaps
+    uint64_t get_aliased_size() const SKR_NOEXCEPT;
+    // largest sum of resources alive at the same pass, no plan can go below it
+    inline uint64_t get_peak_live_size() const SKR_NOEXCEPT { return peak_live_size; }
+
+    uint64_t buffer_alignment = 64 * 1024;
+    uint64_t texture_alignment = 64 * 1024;
+    uint64_t msaa_texture_alignment = 4 * 1024 * 1024;
+
+protected:
+    void plan_heap(EHeap heap) SKR_NOEXCEPT;
+
+    skr::vector<Allocation> allocations;
+    skr::vector<uint32_t> sorted;
+    skr::vector<uint32_t> neighbors;
+    uint64_t heap_sizes[kHeapCount] = { 0, 0 };
+    uint64_t unaliased_size = 0;
+    uint64_t peak_live_size = 0;
+    // structure hash of the graph the allocations were planned for
+    uint64_t planned_hash = 0;
+};
+
+} // namespace render_graph
+} // namespace skr
@@ -0,0 +1,47 @@
+#pragma once
+#include "SkrRenderGraph/frontend/render_graph.hpp"
+#include "SkrRT/containers/hashmap.hpp"
+
+namespace skr {
+namespace render_graph {
+
+// levels the passes of a compiled graph by the resources they share. passes of a level do not depend on
+// each other, they can be recorded in parallel or moved to another queue. needs no device
+struct SKR_RENDER_GRAPH_API SchedulePhase : public IRenderGraphPhase
+{
+    void on_compile(RenderGraph* graph) SKR_NOEXCEPT final;
+    void on_execute(RenderGraph* graph, RenderGraphProfiler* profiler) SKR_NOEXCEPT final;
+
+    inline uint32_t get_level_count() const SKR_NOEXCEPT { return (uint32_t)levels.size(); }
+    // passes of a level, in execution order
+    skr::span<PassNode* const> get_level(uint32_t level) const SKR_NOEXCEPT;
+    // UINT32_MAX for passes that are not scheduled
+    uint32_t get_level_of(const PassNode* pass) const SKR_NOEXCEPT;
+
+    // place passes in the last level before their outputs are read instead of the first one after their inputs
+    // are written, so transient targets are created right before use and live shorter
+    bool shorten_lifetimes = true;
+    // execute the passes level by level, declaration order is kept otherwise
+    bool reorder = false;
+
+protected:
+    void schedule(skr::vector<PassNode*>& passes) SKR_NOEXCEPT;
+
+    struct Level
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    skr::vector<Level> levels;
+    // passes sorted by level
+    skr::vector<PassNode*> level_passes;
+    skr::flat_hash_map<const PassNode*, uint32_t> pass_levels;
+
+    // kept for the next frames with the same structure, indices into the passes before scheduling
+    uint64_t scheduled_hash = 0;
+    skr::vector<uint32_t> sequence;
+    skr::vector<uint32_t> sequence_levels;
+};
+
+} // namespace render_graph
+} // namespace skr
@@ -1,6 +1,7 @@
 ﻿#include "SkrRenderGraph/backend/graph_backend.hpp"
 #include "SkrRenderGraph/frontend/pass_node.hpp"
 #include "SkrRenderGraph/frontend/node_and_edge_factory.hpp"
+#include "SkrRenderGraph/frontend/compiled_graph.hpp"
 #include "SkrRT/platform/debug.h"
 #include "SkrRT/platform/memory.h"
 #include "SkrRT/platform/thread.h"
@@ -10,6 +11,8 @@
 #include <EASTL/set.h>
 
 #include "SkrRenderGraph/phases/cull_phase.hpp"
+#include "SkrRenderGraph/phases/schedule_phase.hpp"
+#include "SkrRenderGraph/phases/memory_plan_phase.hpp"
 
 #include "SkrProfile/profile.h"
 
@@ -159,6 +162,19 @@ RenderGraphBackend::RenderGraphBackend(const RenderGraphBuilder& builder)
     phases.emplace_back(
         skr::SPtr<CullPhase>::Create()
     );
+    // levels are always computed, passes only move when asked to since execute functions may rely on declaration order
+    {
+        auto schedule = skr::SPtr<SchedulePhase>::Create();
+        schedule->reorder = builder.pass_reordering;
+        phases.emplace_back(schedule);
+    }
+    // plans transient memory after culling, binding it to placed resources needs heap support from cgpu
+    if (builder.memory_aliasing)
+    {
+        phases.emplace_back(
+            skr::SPtr<MemoryPlanPhase>::Create()
+        );
+    }
 }
 
 RenderGraph* RenderGraph::create(const RenderGraphSetupFunction& setup) SKR_NOEXCEPT
@@ -980,30 +996,7 @@ uint64_t RenderGraphBackend::execute(RenderGraphProfiler* profiler) SKR_NOEXCEPT
     }
     {
         SkrZoneScopedN("GraphCleanup");
-
-        // 3.dealloc passes & connected edges 
-        for (auto pass : passes)
-        {
-            pass->foreach_textures(
-            [this](TextureNode* t, TextureEdge* e) {
-                node_factory->Dealloc(e);
-            });
-            pass->foreach_buffers(
-            [this](BufferNode* t, BufferEdge* e) {
-                node_factory->Dealloc(e);
-            });
-            node_factory->Dealloc(pass);
-        }
-        passes.clear();
-        // 4.dealloc resource nodes
-        for (auto resource : resources)
-        {
-            node_factory->Dealloc(resource);
-        }
-        resources.clear();
-
-        graph->clear();
-        blackboard->clear();
+        clear_frame();
     }
     return frame_index++;
 }
@@ -1018,13 +1011,23 @@ inline static bool aliasing_capacity(TextureNode* aliased, TextureNode* aliasing
 
 bool RenderGraphBackend::compile() SKR_NOEXCEPT
 {
-    RenderGraph::compile();
-
+    compile_structure();
     for (auto& phase : phases)
         phase->on_compile(this);
+    compile_schedule();
 
     SkrZoneScopedN("RenderGraphCompile");
-    if (aliasing_enabled)
+    if (aliasing_enabled && is_compile_cached() && compiled->aliasing_valid)
+    {
+        SkrZoneScopedN("ReuseAliasing");
+        for (auto [texture_index, source_index] : compiled->aliasing)
+        {
+            auto texture = static_cast<TextureNode*>(resources[texture_index]);
+            texture->descriptor.flags |= CGPU_TCF_ALIASING_RESOURCE;
+            texture->frame_aliasing_source = static_cast<TextureNode*>(resources[source_index]);
+        }
+    }
+    else if (aliasing_enabled)
     {
         SkrZoneScopedN("CalculateAliasing");
         // 2.calc aliasing
@@ -1068,6 +1071,22 @@ bool RenderGraphBackend::compile() SKR_NOEXCEPT
                 }
             });
         });
+        // record the decisions by resource index for the next frames with the same structure
+        skr::flat_hash_map<const TextureNode*, uint32_t> resource_indices;
+        for (uint32_t i = 0; i < (uint32_t)resources.size(); i++)
+        {
+            if (resources[i]->type == EObjectType::Texture)
+                resource_indices.emplace(static_cast<TextureNode*>(resources[i]), i);
+        }
+        compiled->aliasing.clear();
+        for (uint32_t i = 0; i < (uint32_t)resources.size(); i++)
+        {
+            if (resources[i]->type != EObjectType::Texture) continue;
+            auto texture = static_cast<TextureNode*>(resources[i]);
+            if (texture->frame_aliasing_source)
+                compiled->aliasing.emplace_back(i, resource_indices[texture->frame_aliasing_source]);
+        }
+        compiled->aliasing_valid = true;
     }
     return true;
 }
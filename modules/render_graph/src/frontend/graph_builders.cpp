@@ -26,6 +26,12 @@ RenderGraph::RenderGraphBuilder& RenderGraph::RenderGraphBuilder::enable_memory_
     return *this;
 }
 
+RenderGraph::RenderGraphBuilder& RenderGraph::RenderGraphBuilder::enable_pass_reordering() SKR_NOEXCEPT
+{
+    pass_reordering = true;
+    return *this;
+}
+
 RenderGraph::RenderGraphBuilder& RenderGraph::RenderGraphBuilder::with_gfx_queue(CGPUQueueId queue) SKR_NOEXCEPT
 {
     gfx_queue = queue;
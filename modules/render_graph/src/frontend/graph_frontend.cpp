@@ -2,7 +2,9 @@
 #include "SkrRenderGraph/frontend/resource_node.hpp"
 #include "SkrRenderGraph/frontend/pass_node.hpp"
 #include "SkrRenderGraph/frontend/node_and_edge_factory.hpp"
+#include "SkrRenderGraph/frontend/compiled_graph.hpp"
 #include "SkrRT/platform/memory.h"
+#include "SkrRT/misc/hash.h"
 
 #include "SkrProfile/profile.h"
 
@@ -214,8 +216,150 @@ const CGPUTextureDescriptor* RenderGraph::resolve_descriptor(TextureHandle hdl)
     return nullptr;
 }
 
+void RenderGraph::hash_structure(skr::vector<uint64_t>& keys) const SKR_NOEXCEPT
+{
+    keys.clear();
+    keys.emplace_back(aliasing_enabled);
+    for (auto resource : resources)
+    {
+        keys.emplace_back((uint64_t)resource->type);
+        keys.emplace_back(resource->get_id());
+        keys.emplace_back(resource->imported | (resource->canbe_lone << 1) | ((uint64_t)resource->tags << 32));
+        if (resource->type == EObjectType::Texture)
+        {
+            const auto& desc = static_cast<TextureNode*>(resource)->descriptor;
+            keys.emplace_back(desc.flags);
+            keys.emplace_back(desc.width);
+            keys.emplace_back(desc.height);
+            keys.emplace_back(desc.depth);
+            keys.emplace_back(desc.array_size | ((uint64_t)desc.mip_levels << 32));
+            keys.emplace_back(desc.format | ((uint64_t)desc.sample_count << 32));
+            keys.emplace_back(desc.sample_quality | ((uint64_t)desc.is_restrict_dedicated << 32));
+            keys.emplace_back(desc.descriptors | ((uint64_t)desc.start_state << 32));
+        }
+        else if (resource->type == EObjectType::Buffer)
+        {
+            const auto& desc = static_cast<BufferNode*>(resource)->descriptor;
+            keys.emplace_back(desc.size);
+            keys.emplace_back(desc.descriptors | ((uint64_t)desc.memory_usage << 32));
+            keys.emplace_back(desc.format | ((uint64_t)desc.flags << 32));
+            keys.emplace_back(desc.first_element);
+            keys.emplace_back(desc.elemet_count);
+            keys.emplace_back(desc.element_stride);
+            keys.emplace_back(desc.start_state | ((uint64_t)desc.prefer_on_device << 32) | ((uint64_t)desc.prefer_on_host << 33));
+        }
+    }
+    for (auto pass : passes)
+    {
+        keys.emplace_back((uint64_t)pass->pass_type | ((uint64_t)pass->can_be_lone << 8) | ((uint64_t)pass->order << 32));
+        keys.emplace_back(pass->get_id());
+        for (auto edge : pass->in_texture_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state | ((uint64_t)edge->handle.dim << 32));
+            keys.emplace_back(edge->handle.mip_base | ((uint64_t)edge->handle.mip_count << 32));
+            keys.emplace_back(edge->handle.array_base | ((uint64_t)edge->handle.array_count << 32));
+        }
+        for (auto edge : pass->out_texture_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state | ((uint64_t)edge->mrt_index << 32));
+            keys.emplace_back(edge->handle.mip_level);
+            keys.emplace_back(edge->handle.array_base | ((uint64_t)edge->handle.array_count << 32));
+        }
+        for (auto edge : pass->inout_texture_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state);
+        }
+        for (auto edge : pass->in_buffer_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state);
+        }
+        for (auto edge : pass->out_buffer_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state);
+        }
+        for (auto edge : pass->ppl_buffer_edges)
+        {
+            keys.emplace_back(edge->handle._this);
+            keys.emplace_back(edge->requested_state);
+        }
+    }
+}
+
+bool RenderGraph::compile_structure() SKR_NOEXCEPT
+{
+    SkrZoneScopedN("RenderGraphHashStructure");
+    hash_structure(frame_keys);
+    const auto hash = skr_hash64(frame_keys.data(), frame_keys.size() * sizeof(uint64_t), SKR_DEFAULT_HASH_SEED_64);
+    compile_cached = (hash == compiled->hash) && (frame_keys == compiled->keys);
+    structure_hash = hash;
+    if (!compile_cached)
+    {
+        compiled->hash = hash;
+        compiled->keys.swap(frame_keys);
+        compiled->aliasing_valid = false;
+    }
+    return compile_cached;
+}
+
+// walks the passes in execution order and records the state every resource is left in,
+// so barriers do not search the edges of the resource. runs after the phases may have reordered the passes
+void RenderGraph::compile_schedule() SKR_NOEXCEPT
+{
+    SkrZoneScopedN("RenderGraphCompileSchedule");
+    compiled->frame_valid = true;
+    if (compile_cached)
+    {
+        // nodes are new every frame, hand them the results of the last compile
+        for (uint32_t i = 0; i < (uint32_t)resources.size(); i++)
+            resources[i]->frame_lifespan = compiled->lifespans[i];
+        return;
+    }
+
+    compiled->lifespans.clear();
+    compiled->lifespans.reserve(resources.size());
+    for (auto resource : resources)
+        compiled->lifespans.emplace_back(resource->lifespan());
+
+    compiled->prior_states.clear();
+    skr::flat_hash_map<dag_id_t, CompiledGraph::PriorState> current_states;
+    skr::vector<eastl::pair<dag_id_t, ECGPUResourceState>> left_states;
+    for (auto pass : passes)
+    {
+        left_states.clear();
+        // only the first edge of a pass to a resource counts, writers before readers like get_lastest_state
+        auto visit = [&](dag_id_t resource, ECGPUResourceState requested_state) {
+            const auto key = CompiledGraph::prior_state_key(pass->order, resource);
+            if (compiled->prior_states.find(key) != compiled->prior_states.end())
+                return;
+            compiled->prior_states.emplace(key, current_states[resource]);
+            left_states.emplace_back(resource, requested_state);
+        };
+        for (auto edge : pass->out_texture_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (auto edge : pass->inout_texture_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (auto edge : pass->in_texture_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (auto edge : pass->out_buffer_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (auto edge : pass->in_buffer_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (auto edge : pass->ppl_buffer_edges)
+            visit(edge->handle._this, edge->requested_state);
+        for (const auto& [resource, state] : left_states)
+            current_states[resource] = { state, false };
+    }
+}
+
 bool RenderGraph::compile() SKR_NOEXCEPT
 {
+    compile_structure();
+    compile_schedule();
     return true;
 }
 
@@ -289,6 +433,19 @@ const ECGPUResourceState RenderGraph::get_lastest_state(const TextureNode* textu
 {
     SkrZoneScopedN("CaclulateLatestState-Texture");
 
+    if (passes[0] == pending_pass)
+        return texture->init_state;
+    if (compiled->frame_valid)
+    {
+        auto prior = compiled->prior_states.find(CompiledGraph::prior_state_key(pending_pass->order, texture->get_id()));
+        if (prior != compiled->prior_states.end())
+            return prior->second.from_init ? texture->init_state : prior->second.state;
+    }
+    return calculate_lastest_state(texture, pending_pass);
+}
+
+const ECGPUResourceState RenderGraph::calculate_lastest_state(const TextureNode* texture, const PassNode* pending_pass) const SKR_NOEXCEPT
+{
     if (passes[0] == pending_pass)
         return texture->init_state;
     PassNode* pass_iter = nullptr;
@@ -333,6 +490,19 @@ const ECGPUResourceState RenderGraph::get_lastest_state(const BufferNode* buffer
 {
     SkrZoneScopedN("CaclulateLatestState-Buffer");
 
+    if (passes[0] == pending_pass)
+        return buffer->init_state;
+    if (compiled->frame_valid)
+    {
+        auto prior = compiled->prior_states.find(CompiledGraph::prior_state_key(pending_pass->order, buffer->get_id()));
+        if (prior != compiled->prior_states.end())
+            return prior->second.from_init ? buffer->init_state : prior->second.state;
+    }
+    return calculate_lastest_state(buffer, pending_pass);
+}
+
+const ECGPUResourceState RenderGraph::calculate_lastest_state(const BufferNode* buffer, const PassNode* pending_pass) const SKR_NOEXCEPT
+{
     if (passes[0] == pending_pass)
         return buffer->init_state;
     PassNode* pass_iter = nullptr;
@@ -375,19 +545,49 @@ const ECGPUResourceState RenderGraph::get_lastest_state(const BufferNode* buffer
 
 uint64_t RenderGraph::execute(RenderGraphProfiler* profiler) SKR_NOEXCEPT
 {
-    graph->clear();
+    clear_frame();
     return frame_index++;
 }
 
+void RenderGraph::clear_frame() SKR_NOEXCEPT
+{
+    // 1.dealloc passes & connected edges
+    for (auto pass : passes)
+    {
+        pass->foreach_textures(
+        [this](TextureNode* t, TextureEdge* e) {
+            node_factory->Dealloc(e);
+        });
+        pass->foreach_buffers(
+        [this](BufferNode* t, BufferEdge* e) {
+            node_factory->Dealloc(e);
+        });
+        node_factory->Dealloc(pass);
+    }
+    passes.clear();
+    // 2.dealloc resource nodes
+    for (auto resource : resources)
+    {
+        node_factory->Dealloc(resource);
+    }
+    resources.clear();
+
+    graph->clear();
+    blackboard->clear();
+    compiled->frame_valid = false;
+}
+
 void RenderGraph::initialize() SKR_NOEXCEPT
 {
     graph = DependencyGraph::Create();
     node_factory = NodeAndEdgeFactory::Create();
     blackboard = Blackboard::Create();
+    compiled = SkrNew<CompiledGraph>();
 }
 
 void RenderGraph::finalize() SKR_NOEXCEPT
 {
+    SkrDelete(compiled);
     Blackboard::Destroy(blackboard);
     NodeAndEdgeFactory::Destroy(node_factory);
     DependencyGraph::Destroy(graph);
@@ -1,14 +1,76 @@
 #include "SkrRenderGraph/frontend/render_graph.hpp" // IWYU pragma: keep
 #include "SkrRenderGraph/frontend/pass_node.hpp" // IWYU pragma: keep
+#include "SkrRenderGraph/phases/schedule_phase.hpp"
+#include "SkrRT/misc/log.h"
+#include <stdio.h>
 
 namespace skr
 {
 namespace render_graph
 {
 
-void RenderGraphViz::write_graphviz(RenderGraph& graph, const char* outf) SKR_NOEXCEPT
+inline static const char8_t* graphviz_name(const RenderGraphNode* node) SKR_NOEXCEPT
 {
+    return node->get_name_view().is_empty() ? u8"unnamed" : node->get_name();
+}
+
+inline static void write_graphviz_pass(skr::string& dot, PassNode* pass, const char8_t* indent) SKR_NOEXCEPT
+{
+    const char8_t* shape = (pass->pass_type == EPassType::Present) ? u8"doubleoctagon" : u8"box";
+    dot += skr::format(u8"{}pass_{} [label=\"{}\\norder {}\" shape={}];\n",
+        indent, pass->get_id(), graphviz_name(pass), pass->get_order(), shape);
+}
+
+void RenderGraphViz::write_graphviz(RenderGraph& graph, const char* outf, const SchedulePhase* schedule) SKR_NOEXCEPT
+{
+    skr::string dot = u8"digraph RenderGraph {\n    rankdir=LR;\n";
+    for (auto resource : graph.resources)
+    {
+        const char8_t* shape = (resource->type == EObjectType::Texture) ? u8"ellipse" : u8"cylinder";
+        dot += skr::format(u8"    resource_{} [label=\"{}\" shape={}{}];\n",
+            resource->get_id(), graphviz_name(resource), shape, resource->is_imported() ? u8" style=dashed" : u8"");
+    }
+    if (schedule && schedule->get_level_count())
+    {
+        // passes of a level share a rank, so levels read as columns
+        for (uint32_t level = 0; level < schedule->get_level_count(); level++)
+        {
+            dot += skr::format(u8"    subgraph cluster_level_{} {{\n        label=\"level {}\";\n        rank=same;\n", level, level);
+            for (auto pass : schedule->get_level(level))
+                write_graphviz_pass(dot, pass, u8"        ");
+            dot += u8"    }\n";
+        }
+    }
+    else
+    {
+        for (auto pass : graph.passes)
+            write_graphviz_pass(dot, pass, u8"    ");
+    }
+    for (auto pass : graph.passes)
+    {
+        pass->foreach_textures([&](TextureNode* texture, TextureEdge* edge) {
+            if (edge->type == ERelationshipType::TextureRead)
+                dot += skr::format(u8"    resource_{} -> pass_{};\n", texture->get_id(), pass->get_id());
+            else
+                dot += skr::format(u8"    pass_{} -> resource_{};\n", pass->get_id(), texture->get_id());
+        });
+        pass->foreach_buffers([&](BufferNode* buffer, BufferEdge* edge) {
+            if (edge->type == ERelationshipType::BufferReadWrite)
+                dot += skr::format(u8"    pass_{} -> resource_{};\n", pass->get_id(), buffer->get_id());
+            else
+                dot += skr::format(u8"    resource_{} -> pass_{};\n", buffer->get_id(), pass->get_id());
+        });
+    }
+    dot += u8"}\n";
 
+    auto file = fopen(outf, "wb");
+    if (!file)
+    {
+        SKR_LOG_ERROR(u8"render graph viz: failed to open %s", outf);
+        return;
+    }
+    fwrite(dot.c_str(), 1, dot.size(), file);
+    fclose(file);
 }
 
 } // namespace render_graph
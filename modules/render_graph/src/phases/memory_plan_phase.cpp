@@ -0,0 +1,201 @@
+#include "SkrRenderGraph/phases/memory_plan_phase.hpp"
+#include "SkrRenderGraph/frontend/resource_node.hpp"
+#include "SkrRenderGraph/frontend/pass_node.hpp"
+
+#include "SkrProfile/profile.h"
+#include <EASTL/sort.h>
+
+namespace skr {
+namespace render_graph {
+
+inline static uint64_t align_up(uint64_t value, uint64_t alignment) SKR_NOEXCEPT
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// bytes of the whole mip chain, TextureNode::get_size is only good for comparing sizes
+inline static uint64_t texture_bytes(const CGPUTextureDescriptor& desc) SKR_NOEXCEPT
+{
+    const uint64_t block_w = cgpu_max(FormatUtil_WidthOfBlock(desc.format), 1);
+    const uint64_t block_h = cgpu_max(FormatUtil_HeightOfBlock(desc.format), 1);
+    const uint64_t block_bits = FormatUtil_BitSizeOfBlock(desc.format);
+    uint64_t width = cgpu_max(desc.width, 1);
+    uint64_t height = cgpu_max(desc.height, 1);
+    uint64_t depth = cgpu_max(desc.depth, 1);
+    uint64_t bytes = 0;
+    for (uint32_t mip = 0; mip < cgpu_max(desc.mip_levels, 1); mip++)
+    {
+        const uint64_t blocks = ((width + block_w - 1) / block_w) * ((height + block_h - 1) / block_h) * depth;
+        bytes += (blocks * block_bits + 7) / 8;
+        width = cgpu_max(width / 2, 1);
+        height = cgpu_max(height / 2, 1);
+        depth = cgpu_max(depth / 2, 1);
+    }
+    return bytes * cgpu_max(desc.array_size, 1) * cgpu_max((uint64_t)desc.sample_count, 1);
+}
+
+inline static uint64_t buffer_bytes(const CGPUBufferDescriptor& desc) SKR_NOEXCEPT
+{
+    return desc.size ? desc.size : desc.elemet_count * desc.element_stride;
+}
+
+void MemoryPlanPhase::on_compile(RenderGraph* graph) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("RenderGraphMemoryPlan");
+    auto& resources = get_resources(graph);
+    if (graph->is_compile_cached() && planned_hash == graph->get_structure_hash())
+    {
+        // same structure as the planned frame, only the nodes are new
+        for (auto& allocation : allocations)
+            allocation.resource = resources[allocation.resource_index];
+        return;
+    }
+    planned_hash = graph->get_structure_hash();
+    allocations.clear();
+    unaliased_size = 0;
+    peak_live_size = 0;
+    for (auto& heap_size : heap_sizes)
+        heap_size = 0;
+
+    for (uint32_t i = 0; i < (uint32_t)resources.size(); i++)
+    {
+        auto resource = resources[i];
+        if (resource->is_imported())
+            continue;
+        Allocation allocation = {};
+        allocation.resource = resource;
+        allocation.resource_index = i;
+        if (resource->type == EObjectType::Texture)
+        {
+            const auto& desc = static_cast<TextureNode*>(resource)->get_desc();
+            if ((desc.flags & CGPU_TCF_DEDICATED_BIT) || desc.is_restrict_dedicated)
+                continue;
+            const auto alignment = desc.sample_count > CGPU_SAMPLE_COUNT_1 ? msaa_texture_alignment : texture_alignment;
+            allocation.heap = kHeapTextures;
+            allocation.size = align_up(texture_bytes(desc), alignment);
+        }
+        else if (resource->type == EObjectType::Buffer)
+        {
+            const auto& desc = static_cast<BufferNode*>(resource)->get_desc();
+            // only device local memory is aliased, upload and readback buffers are mapped by the host
+            if ((desc.flags & CGPU_BCF_DEDICATED_BIT) || desc.memory_usage != CGPU_MEM_USAGE_GPU_ONLY)
+                continue;
+            allocation.heap = kHeapBuffers;
+            allocation.size = align_up(buffer_bytes(desc), buffer_alignment);
+        }
+        else
+            continue;
+        const auto lifespan = resource->lifespan();
+        if (lifespan.from > lifespan.to || allocation.size == 0)
+            continue;
+        allocation.first_pass = lifespan.from;
+        allocation.last_pass = lifespan.to;
+        unaliased_size += allocation.size;
+        allocations.emplace_back(allocation);
+    }
+
+    // peak of the live sizes, sweep over the lifespans with frees ordered before allocations of a later pass
+    {
+        skr::vector<eastl::pair<uint64_t, int64_t>> events;
+        events.reserve(allocations.size() * 2);
+        for (const auto& allocation : allocations)
+        {
+            events.emplace_back((uint64_t)allocation.first_pass * 2 + 1, (int64_t)allocation.size);
+            events.emplace_back((uint64_t)allocation.last_pass * 2 + 2, -(int64_t)allocation.size);
+        }
+        eastl::sort(events.begin(), events.end());
+        int64_t live = 0;
+        for (const auto& [time, delta] : events)
+        {
+            live += delta;
+            peak_live_size = cgpu_max(peak_live_size, (uint64_t)live);
+        }
+    }
+
+    for (uint32_t heap = 0; heap < kHeapCount; heap++)
+        plan_heap((EHeap)heap);
+}
+
+// interval coloring with sizes: resources are intervals over passes, heap offsets are the colors.
+// biggest first, each one takes the tightest gap left by the placed resources it lives together with
+void MemoryPlanPhase::plan_heap(EHeap heap) SKR_NOEXCEPT
+{
+    sorted.clear();
+    for (uint32_t i = 0; i < (uint32_t)allocations.size(); i++)
+    {
+        if (allocations[i].heap == heap)
+            sorted.emplace_back(i);
+    }
+    eastl::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) {
+        const auto& A = allocations[a];
+        const auto& B = allocations[b];
+        if (A.size != B.size) return A.size > B.size;
+        return A.first_pass < B.first_pass;
+    });
+
+    uint64_t heap_size = 0;
+    for (uint32_t placed = 0; placed < (uint32_t)sorted.size(); placed++)
+    {
+        auto& allocation = allocations[sorted[placed]];
+        neighbors.clear();
+        for (uint32_t j = 0; j < placed; j++)
+        {
+            const auto& other = allocations[sorted[j]];
+            if (other.first_pass <= allocation.last_pass && allocation.first_pass <= other.last_pass)
+                neighbors.emplace_back(sorted[j]);
+        }
+        eastl::sort(neighbors.begin(), neighbors.end(), [this](uint32_t a, uint32_t b) {
+            return allocations[a].offset < allocations[b].offset;
+        });
+        const bool msaa = heap == kHeapTextures &&
+            static_cast<TextureNode*>(allocation.resource)->get_sample_count() > CGPU_SAMPLE_COUNT_1;
+        const uint64_t alignment = (heap == kHeapBuffers) ? buffer_alignment : (msaa ? msaa_texture_alignment : texture_alignment);
+        uint64_t best_offset = UINT64_MAX, best_gap = UINT64_MAX, cursor = 0;
+        for (auto neighbor : neighbors)
+        {
+            const auto& other = allocations[neighbor];
+            const uint64_t start = align_up(cursor, alignment);
+            if (other.offset > start)
+            {
+                const uint64_t gap = other.offset - start;
+                if (gap >= allocation.size && gap < best_gap)
+                {
+                    best_gap = gap;
+                    best_offset = start;
+                }
+            }
+            cursor = cgpu_max(cursor, other.offset + other.size);
+        }
+        allocation.offset = (best_offset != UINT64_MAX) ? best_offset : align_up(cursor, alignment);
+        heap_size = cgpu_max(heap_size, allocation.offset + allocation.size);
+    }
+    heap_sizes[heap] = heap_size;
+}
+
+void MemoryPlanPhase::on_execute(RenderGraph* graph, RenderGraphProfiler* profiler) SKR_NOEXCEPT
+{
+    // resources are deallocated after execution, keep the plan for the next frame with the same structure
+    for (auto& allocation : allocations)
+        allocation.resource = nullptr;
+}
+
+const MemoryPlanPhase::Allocation* MemoryPlanPhase::find_allocation(const ResourceNode* resource) const SKR_NOEXCEPT
+{
+    for (const auto& allocation : allocations)
+    {
+        if (allocation.resource == resource)
+            return &allocation;
+    }
+    return nullptr;
+}
+
+uint64_t MemoryPlanPhase::get_aliased_size() const SKR_NOEXCEPT
+{
+    uint64_t size = 0;
+    for (auto heap_size : heap_sizes)
+        size += heap_size;
+    return size;
+}
+
+} // namespace render_graph
+} // namespace skr
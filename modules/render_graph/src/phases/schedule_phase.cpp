@@ -0,0 +1,153 @@
+#include "SkrRenderGraph/phases/schedule_phase.hpp"
+#include "SkrRenderGraph/frontend/resource_node.hpp"
+#include "SkrRenderGraph/frontend/pass_node.hpp"
+
+#include "SkrProfile/profile.h"
+#include <EASTL/sort.h>
+
+namespace skr {
+namespace render_graph {
+
+void SchedulePhase::on_compile(RenderGraph* graph) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("RenderGraphSchedule");
+    auto& passes = get_passes(graph);
+    const auto hash = graph->get_structure_hash();
+    if (!graph->is_compile_cached() || scheduled_hash != hash || sequence.size() != passes.size())
+    {
+        scheduled_hash = hash;
+        schedule(passes);
+    }
+
+    level_passes.clear();
+    levels.clear();
+    pass_levels.clear();
+    for (uint32_t i = 0; i < (uint32_t)sequence.size(); i++)
+    {
+        auto pass = passes[sequence[i]];
+        const auto level = sequence_levels[i];
+        while (levels.size() <= level)
+            levels.emplace_back(Level{ i, 0 });
+        levels[level].count++;
+        level_passes.emplace_back(pass);
+        pass_levels.emplace(pass, level);
+    }
+
+    if (reorder)
+    {
+        for (uint32_t i = 0; i < (uint32_t)level_passes.size(); i++)
+        {
+            passes[i] = level_passes[i];
+            passes[i]->order = i;
+        }
+    }
+}
+
+// a pass depends on the last writer of every resource it uses, and a writer also on the readers since the last write.
+// the passes are visited in declaration order, which is a topological order of the dependency graph
+void SchedulePhase::schedule(skr::vector<PassNode*>& passes) SKR_NOEXCEPT
+{
+    struct Access
+    {
+        uint32_t last_writer = UINT32_MAX;
+        skr::vector<uint32_t> readers;
+    };
+    skr::flat_hash_map<dag_id_t, Access> accesses;
+    // predecessor and pass
+    skr::vector<eastl::pair<uint32_t, uint32_t>> dependencies;
+    skr::vector<eastl::pair<dag_id_t, bool>> used;
+    skr::vector<uint32_t> scheduled_levels(passes.size(), 0);
+
+    uint32_t max_level = 0;
+    for (uint32_t i = 0; i < (uint32_t)passes.size(); i++)
+    {
+        auto pass = passes[i];
+        used.clear();
+        pass->foreach_textures([&](TextureNode* texture, TextureEdge* edge) {
+            used.emplace_back(texture->get_id(), edge->type != ERelationshipType::TextureRead);
+        });
+        pass->foreach_buffers([&](BufferNode* buffer, BufferEdge* edge) {
+            used.emplace_back(buffer->get_id(), edge->type == ERelationshipType::BufferReadWrite);
+        });
+        auto depend = [&](uint32_t predecessor) {
+            if (predecessor == UINT32_MAX || predecessor == i) return;
+            dependencies.emplace_back(predecessor, i);
+            scheduled_levels[i] = cgpu_max(scheduled_levels[i], scheduled_levels[predecessor] + 1);
+        };
+        for (auto [resource, write] : used)
+        {
+            auto& access = accesses[resource];
+            depend(access.last_writer);
+            if (write)
+            {
+                for (auto reader : access.readers)
+                    depend(reader);
+            }
+        }
+        for (auto [resource, write] : used)
+        {
+            auto& access = accesses[resource];
+            if (write)
+            {
+                access.last_writer = i;
+                access.readers.clear();
+            }
+            else
+            {
+                access.readers.emplace_back(i);
+            }
+        }
+        max_level = cgpu_max(max_level, scheduled_levels[i]);
+    }
+
+    if (shorten_lifetimes)
+    {
+        // latest level every pass can run at, the dependencies are sorted by pass
+        skr::vector<uint32_t> latest_levels(passes.size(), max_level);
+        for (auto it = dependencies.rbegin(); it != dependencies.rend(); ++it)
+        {
+            const auto [predecessor, pass] = *it;
+            latest_levels[predecessor] = cgpu_min(latest_levels[predecessor], latest_levels[pass] - 1);
+        }
+        scheduled_levels.swap(latest_levels);
+    }
+    // presents end the frame
+    for (uint32_t i = 0; i < (uint32_t)passes.size(); i++)
+    {
+        if (passes[i]->pass_type == EPassType::Present)
+            scheduled_levels[i] = max_level;
+    }
+
+    sequence.resize(passes.size());
+    for (uint32_t i = 0; i < (uint32_t)passes.size(); i++)
+        sequence[i] = i;
+    eastl::stable_sort(sequence.begin(), sequence.end(), [&](uint32_t a, uint32_t b) {
+        return scheduled_levels[a] < scheduled_levels[b];
+    });
+    sequence_levels.resize(passes.size());
+    for (uint32_t i = 0; i < (uint32_t)sequence.size(); i++)
+        sequence_levels[i] = scheduled_levels[sequence[i]];
+}
+
+void SchedulePhase::on_execute(RenderGraph* graph, RenderGraphProfiler* profiler) SKR_NOEXCEPT
+{
+    // passes are deallocated after execution, the sequence is kept for the next frame with the same structure
+    level_passes.clear();
+    pass_levels.clear();
+}
+
+skr::span<PassNode* const> SchedulePhase::get_level(uint32_t level) const SKR_NOEXCEPT
+{
+    if (level >= levels.size() || level_passes.empty())
+        return {};
+    return skr::span<PassNode* const>(level_passes.data() + levels[level].first, levels[level].count);
+}
+
+uint32_t SchedulePhase::get_level_of(const PassNode* pass) const SKR_NOEXCEPT
+{
+    auto found = pass_levels.find(pass);
+    return found != pass_levels.end() ? found->second : UINT32_MAX;
+}
+
+} // namespace render_graph
+} // namespace skr
@@ -180,6 +180,7 @@ ESkrInstallStatus STextureFactoryImpl::InstallImpl(skr_resource_record_t* record
             tdesc.width = texture_resource->width;
             tdesc.height = texture_resource->height;
             tdesc.depth = texture_resource->depth;
+            tdesc.mip_levels = texture_resource->mips_count ? texture_resource->mips_count : 1;
             tdesc.format = (ECGPUFormat)texture_resource->format;
 
             auto request = vram_service->open_texture_request();
@@ -220,12 +221,11 @@ ESkrInstallStatus STextureFactoryImpl::UpdateInstall(skr_resource_record_t* reco
         if (okay)
         {
             texture_resource->texture = dRequest->second->io_texture->get_texture();
-            // TODO: mipmap view
             CGPUTextureViewDescriptor view_desc = {};
             view_desc.texture = texture_resource->texture;
             view_desc.array_layer_count = 1;
             view_desc.base_array_layer = 0;
-            view_desc.mip_level_count = 1;
+            view_desc.mip_level_count = texture_resource->texture->info->mip_levels;
             view_desc.base_mip_level = 0;
             view_desc.aspects = CGPU_TVA_COLOR;
             view_desc.dims = CGPU_TEX_DIMENSION_2D;
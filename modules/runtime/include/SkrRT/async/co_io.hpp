@@ -0,0 +1,78 @@
+#pragma once
+#include "SkrRT/async/co_task.hpp"
+
+#if __cpp_impl_coroutine
+#include "SkrRT/io/ram_io.hpp"
+#include "SkrRT/resource/resource_handle.h"
+
+namespace skr
+{
+namespace task2
+{
+    // co_await-able adapters over the io and resource systems, the awaiting task is handed back to the
+    // scheduler by the completion callbacks instead of polling futures every frame
+
+    struct SKR_RUNTIME_API RAMIOAwaitable
+    {
+        RAMIOAwaitable(skr::io::IRAMService* service, skr::io::IORequestId request, SkrAsyncServicePriority priority);
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<skr_task_t::promise_type> handle);
+        // the buffer holds the data only if the request completed, check is_cancelled() otherwise
+        skr::io::RAMIOBufferId await_resume() const { return buffer; }
+        bool is_cancelled() const { return future.is_cancelled(); }
+
+        skr::io::IRAMService* service = nullptr;
+        skr::io::IORequestId request;
+        SkrAsyncServicePriority priority;
+        skr::io::RAMIOBufferId buffer;
+        skr_io_future_t future;
+        // the completion callback and await_suspend race, the later one resumes the task
+        std::atomic<uint32_t> pending = 2;
+        scheduler_t* scheduler = nullptr;
+        std::coroutine_handle<skr_task_t::promise_type> handle;
+    };
+
+    struct SKR_RUNTIME_API DecompressAwaitable
+    {
+        DecompressAwaitable(skr::span<const skr_io_compressed_block_t> blocks, const uint8_t* src, uint8_t* dst);
+        bool await_ready() const { return blocks.size() == 0; }
+        bool await_suspend(std::coroutine_handle<skr_task_t::promise_type> handle);
+        // false if any of the blocks failed to decompress
+        bool await_resume() const { return failed == 0; }
+
+        skr::span<const skr_io_compressed_block_t> blocks;
+        const uint8_t* src = nullptr;
+        uint8_t* dst = nullptr;
+        std::atomic<uint32_t> pending = 0;
+        std::atomic<uint32_t> failed = 0;
+        scheduler_t* scheduler = nullptr;
+        std::coroutine_handle<skr_task_t::promise_type> handle;
+    };
+
+    struct SKR_RUNTIME_API InstallAwaitable
+    {
+        InstallAwaitable(skr_resource_handle_t& resource);
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<skr_task_t::promise_type> handle);
+        // SKR_LOADING_STATUS_INSTALLED on success, SKR_LOADING_STATUS_ERROR or SKR_LOADING_STATUS_UNLOADED otherwise
+        ESkrLoadingStatus await_resume() const;
+
+        skr_resource_record_t* record = nullptr;
+        // requests the install of a handle that was resolved without one, released with the awaitable
+        skr_resource_handle_t installer;
+        scheduler_t* scheduler = nullptr;
+        std::coroutine_handle<skr_task_t::promise_type> handle;
+    };
+
+    // submits the request and suspends until it completes or gets cancelled.
+    // the awaitable owns the SKR_IO_STAGE_COMPLETED and SKR_IO_STAGE_CANCELLED callbacks of the request
+    SKR_RUNTIME_API RAMIOAwaitable co_request(skr::io::IRAMService* service, skr::io::IORequestId request,
+        SkrAsyncServicePriority priority = SKR_ASYNC_SERVICE_PRIORITY_NORMAL);
+    // decompresses blocks packed back to back in src into dst, one task per block in the lane of the awaiting task
+    SKR_RUNTIME_API DecompressAwaitable co_decompress(skr::span<const skr_io_compressed_block_t> blocks, const uint8_t* src, uint8_t* dst);
+    // suspends until a resolved handle is installed or its loading ended otherwise,
+    // the install is requested if the handle was resolved without one
+    SKR_RUNTIME_API InstallAwaitable co_install(skr_resource_handle_t& resource);
+}
+}
+#endif
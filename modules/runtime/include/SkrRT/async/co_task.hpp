@@ -32,6 +32,15 @@ namespace task2
     using state_ptr_t = SPtr<T>;
     template<class T>
     using state_weak_ptr_t = SWeakPtr<T>;
+    // lanes of the scheduler, workers always drain the higher lanes first.
+    // a suspended task resumes in the lane it was scheduled with
+    enum class task_priority_t : uint32_t
+    {
+        high = 0,
+        normal = 1,
+        low = 2,
+        count
+    };
     struct SKR_RUNTIME_API scheudler_config_t
     {
         scheudler_config_t();
@@ -71,6 +80,7 @@ namespace task2
 
             void* operator new(size_t size) { return sakura_malloc(size); }
             void operator delete(void* ptr, size_t size) { sakura_free(ptr); }
+            task_priority_t priority = task_priority_t::normal;
 #ifdef SKR_PROFILE_ENABLE
             const char* name = nullptr;
 #endif
@@ -237,8 +247,10 @@ namespace task2
         void unbind();
         void shutdown();
         static scheduler_t* instance();
-        void schedule(skr_task_t&& task);
-        void schedule(eastl::function<void()>&& function);
+        void schedule(skr_task_t&& task, task_priority_t priority = task_priority_t::normal);
+        void schedule(eastl::function<void()>&& function, task_priority_t priority = task_priority_t::normal);
+        // hands a suspended task back to the workers, may be called from any thread (e.g. io callbacks)
+        void resume(std::coroutine_handle<skr_task_t::promise_type> handle);
         struct SKR_RUNTIME_API EventAwaitable
         {
             EventAwaitable(scheduler_t& s, event_t event, int workerIdx = -1);
@@ -271,13 +283,13 @@ namespace task2
         bool binded = false;
     };
 
-    inline void schedule(skr_task_t&& task)
+    inline void schedule(skr_task_t&& task, task_priority_t priority = task_priority_t::normal)
     {
-        scheduler_t::instance()->schedule(std::move(task));
+        scheduler_t::instance()->schedule(std::move(task), priority);
     }
-    inline void schedule(eastl::function<void()>&& function)
+    inline void schedule(eastl::function<void()>&& function, task_priority_t priority = task_priority_t::normal)
     {
-        scheduler_t::instance()->schedule(std::move(function));
+        scheduler_t::instance()->schedule(std::move(function), priority);
     }
     SKR_RUNTIME_API scheduler_t::EventAwaitable co_wait(event_t event, bool pinned = false);
     SKR_RUNTIME_API scheduler_t::CounterAwaitable co_wait(counter_t counter, bool pinned = false);
@@ -14,6 +14,14 @@ enum ESkrJobItemStatus
     kJobItemStatusFinishJob
 };
 
+enum ESkrJobItemPriority
+{
+    kJobItemPriorityNormal = 0,
+    // taken by the workers before any normal item, regardless of which thread enqueued it
+    kJobItemPriorityHigh,
+    kJobItemPriorityCount
+};
+
 namespace skr
 {
 struct JobQueue;
@@ -36,7 +44,7 @@ struct JobQueueDesc
 
 struct JobItemDesc
 {
-    int32_t __nothing__;
+    ESkrJobItemPriority priority = kJobItemPriorityNormal;
 };
 
 using EJobStatus = ESkrJobItemStatus;
@@ -99,6 +107,7 @@ public:
 	virtual ~JobQueue() SKR_NOEXCEPT;
 
     // enqueue JobItem object to job queue.
+    // items enqueued from a worker of this queue go to the worker's own deque, the others to the shared injection queue.
     // @retval ASYNC_RESULT_OK if success
 	JobResult enqueue(JobItem* jobItem) SKR_NOEXCEPT;
 
@@ -130,7 +139,7 @@ public:
 
 private:
     friend struct JobThreadFunction;
-    int enqueueCore(JobItem* jobItem, bool isEndJob) SKR_NOEXCEPT;
+    int enqueueCore(JobItem* jobItem) SKR_NOEXCEPT;
 
     // initialize JobQueue
     // @retval ASYNC_RESULT_OK if success
@@ -145,8 +154,8 @@ private:
     JobItemQueue* itemList;
     JobQueueDesc desc;
 
+    // items waiting for finish(), only touched by check(). enqueued items reach it through the lock-free inbox of itemList
     skr::vector<JobItem*> pending_queue;
-    SRWMutex pending_queue_mutex;
     SAtomic32 cancel_requested = 0;
 };
 
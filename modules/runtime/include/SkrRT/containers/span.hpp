@@ -107,6 +107,15 @@ struct SpanReader {
         offset += size;
         return 0;
     }
+    // lets buffered readers fetch ahead, returns the byte count copied
+    size_t read_some(void* dst, size_t size)
+    {
+        const size_t remain = data.size() - offset;
+        size = size < remain ? size : remain;
+        memcpy(dst, data.data() + offset, size);
+        offset += size;
+        return size;
+    }
 };
 
 struct SpanReaderBitpacked
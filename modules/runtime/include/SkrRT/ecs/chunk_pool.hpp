@@ -0,0 +1,95 @@
+#pragma once
+#include "SkrRT/ecs/dual_config.h"
+#include "SkrRT/containers/concurrent_queue.h"
+#include "SkrRT/platform/thread.h"
+#include <EASTL/vector.h>
+#include <atomic>
+
+struct dual_chunk_pool_stats_t;
+
+// the chunk pools of the dual context, exposed so benchmarks can run them side by side
+namespace dual
+{
+
+struct ECSPoolConcurrentQueueTraits : public skr::ConcurrentQueueDefaultTraits
+{
+    static constexpr const char* kECSPoolQueueName = "ECSPool";
+    static const bool RECYCLE_ALLOCATED_BLOCKS = true;
+    static inline void* malloc(size_t size) { return sakura_mallocN(size, kECSPoolQueueName); }
+    static inline void free(void* ptr) { return sakura_freeN(ptr, kECSPoolQueueName); }
+};
+
+// blocks are recycled through a MPMC queue of bounded size, everything else goes to the heap
+struct SKR_RUNTIME_API queue_pool_t {
+    size_t blockSize;
+    skr::ConcurrentQueue<void*, ECSPoolConcurrentQueueTraits> blocks;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+    std::atomic<uint64_t> heapBlocks;
+    queue_pool_t(size_t blockSize, size_t blockCount);
+    ~queue_pool_t();
+    void* allocate();
+    void free(void* block);
+    void trim();
+    void get_stats(dual_chunk_pool_stats_t* stats);
+};
+
+struct pool_block_t;
+struct pool_magazine_t;
+
+// blocks are carved from one virtual reservation that is committed on demand and never decommitted.
+// freed blocks stay in a magazine of the freeing thread, full magazines are exchanged with the other
+// threads through a lock-free depot of block chains. only an exhausted reservation falls back to the heap
+struct SKR_RUNTIME_API reserved_pool_t {
+    size_t blockSize;
+    reserved_pool_t(size_t blockSize, size_t reserveCount);
+    ~reserved_pool_t();
+    void* allocate();
+    void free(void* block);
+    // hands the pages of blocks idle in the depot back to the os, their addresses stay reserved
+    void trim();
+    void get_stats(dual_chunk_pool_stats_t* stats);
+
+    bool owns(const void* block) const
+    {
+        return (const char*)block >= base && (const char*)block < base + reserveBytes;
+    }
+
+private:
+    friend struct pool_thread_cache_t;
+    friend struct pool_registry_t;
+    pool_magazine_t* get_magazine();
+    void retire_magazine(pool_magazine_t* magazine);
+    void refill(pool_magazine_t* magazine);
+    void flush(pool_magazine_t* magazine, uint32_t count);
+    uint32_t carve(void** blocks, uint32_t count);
+    bool commit(size_t end);
+    void push_chain(pool_block_t* head, uint32_t count);
+    pool_block_t* pop_chain();
+    void* take(void* block);
+    pool_block_t* block_at(uint64_t index) const { return (pool_block_t*)(base + (index - 1) * blockSize); }
+    uint64_t index_of(const pool_block_t* block) const { return block ? ((const char*)block - base) / blockSize + 1 : 0; }
+
+    uint64_t id;
+    char* mapping = nullptr;
+    char* base = nullptr;
+    size_t mappedBytes = 0;
+    size_t reserveBytes = 0;
+    uint64_t reserveCount = 0;
+    uint32_t magazineSize;
+    // next never handed out block of the reservation
+    std::atomic<uint64_t> bump;
+    std::atomic<size_t> committedBytes;
+    SMutex commitMutex;
+    // tagged top of the chain stack, (tag << 32) | (index + 1) of the head block
+    std::atomic<uint64_t> depot;
+    std::atomic<uint64_t> depotBlocks;
+    std::atomic<uint64_t> releasedBytes;
+    std::atomic<uint64_t> heapBlocks;
+    // counters of threads without a magazine plus those of exited threads
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+    SMutex magazineMutex;
+    eastl::vector<pool_magazine_t*> magazines;
+};
+} // namespace dual
@@ -193,6 +193,39 @@ typedef struct dual_array_comp_t dual_array_comp_t;
 typedef uint32_t dual_mask_comp_t;
 typedef uint32_t dual_dirty_comp_t;
 
+// memory usage of one chunk pool, counters are sampled without synchronization
+typedef struct dual_chunk_pool_stats_t {
+    uint64_t blockSize;
+    // address space reserved for the pool and the part of it backed by memory
+    uint64_t reservedBytes;
+    uint64_t committedBytes;
+    // committed bytes of idle blocks handed back to the os by dual_trim_chunk_pools
+    uint64_t releasedBytes;
+    // idle blocks kept by the pool for reuse
+    uint64_t cachedBlocks;
+    // blocks served by the heap because the reservation was exhausted
+    uint64_t heapBlocks;
+    uint64_t allocations;
+    uint64_t deallocations;
+} dual_chunk_pool_stats_t;
+
+// limits of one incremental defragmentation step, zero means unlimited
+typedef struct dual_defragment_budget_t {
+    // bytes of entity data moved between chunks
+    uint64_t maxBytes;
+    // wall time spent moving
+    uint64_t maxMicroseconds;
+} dual_defragment_budget_t;
+
+// instruction set of the per entity mask and per chunk change filters of queries
+typedef enum dual_filter_isa_t {
+    DFI_AUTO,
+    DFI_SCALAR,
+    DFI_SSE2,
+    DFI_AVX2,
+    DFI_AVX512,
+} dual_filter_isa_t;
+
 // APIS
 /**
  * @brief initialize context, user should store the context and pass it to library by implementing dual_get_context
@@ -211,6 +244,31 @@ SKR_RUNTIME_API dual_context_t* dual_get_context();
  *
  */
 SKR_RUNTIME_API void dual_shutdown();
+/**
+ * @brief query memory statistics of the small, default and large chunk pools
+ * @param small nullable
+ * @param normal nullable
+ * @param large nullable
+ */
+SKR_RUNTIME_API void dual_get_chunk_pool_stats(dual_chunk_pool_stats_t* small, dual_chunk_pool_stats_t* normal, dual_chunk_pool_stats_t* large);
+/**
+ * @brief set the address space the chunk pools reserve up front, split between the small, default and large pool
+ * only takes effect before the context is created, chunks beyond the reservation come from the heap
+ * @param bytes
+ */
+SKR_RUNTIME_API void dual_set_chunk_pool_budget(uint64_t bytes);
+/**
+ * @brief hand memory of idle chunks back to the os, e.g. after a mass despawn
+ * blocks cached by the calling threads are kept
+ */
+SKR_RUNTIME_API void dual_trim_chunk_pools();
+/**
+ * @brief force the instruction set of the query filters, e.g. to compare them in benchmarks
+ * DFI_AUTO and sets the cpu does not support fall back to the best supported one
+ * @param isa
+ * @return the instruction set in use
+ */
+SKR_RUNTIME_API dual_filter_isa_t dual_set_filter_isa(dual_filter_isa_t isa);
 
 SKR_RUNTIME_API void dual_make_guid(skr_guid_t* guid);
 
@@ -522,6 +580,17 @@ SKR_RUNTIME_API void dualS_validate_meta(dual_storage_t* storage);
  * @param storage
  */
 SKR_RUNTIME_API void dualS_defragement(dual_storage_t* storage);
+/**
+ * @brief merge entities of half empty chunks within a budget, the groups wasting most space are compacted first
+ * groups are compacted in parallel when the storage is bound to the scheduler, their jobs are synced first
+ * call once per frame until it returns false to defragment a storage without stalling
+ * @see dualS_defragement
+ * @see dualJ_schedule_defragment
+ * @param storage
+ * @param budget
+ * @return true if fragmented groups are left
+ */
+SKR_RUNTIME_API bool dualS_defragment_incremental(dual_storage_t* storage, const dual_defragment_budget_t* budget);
 /**
  * @brief pack entity id
  * when we destroy an entity, we don't "delete" it's id, we just left a hole awaiting reuse.
@@ -529,6 +598,74 @@ SKR_RUNTIME_API void dualS_defragement(dual_storage_t* storage);
  * @param storage
  */
 SKR_RUNTIME_API void dualS_pack_entities(dual_storage_t* storage);
+/**
+ * @brief create a command buffer recording structural changes of storage, e.g. from ecs jobs
+ * every thread records into its own recorder, so recording does not lock
+ * @see dualCB_playback
+ * @param storage
+ * @return dual_command_buffer_t*
+ */
+SKR_RUNTIME_API dual_command_buffer_t* dualCB_create(dual_storage_t* storage);
+/**
+ * @brief release command buffer, pending commands are dropped
+ *
+ * @param buffer
+ */
+SKR_RUNTIME_API void dualCB_release(dual_command_buffer_t* buffer);
+/**
+ * @brief record instantiating count entities from prefab
+ *
+ * @param buffer
+ * @param prefab
+ * @param count
+ * @param callback optional, invoked with the views of the new entities during playback
+ * @param u
+ */
+SKR_RUNTIME_API void dualCB_spawn(dual_command_buffer_t* buffer, dual_entity_t prefab, EIndex count, dual_view_callback_t callback, void* u);
+/**
+ * @brief record destroying entities, other commands recorded for them are dropped
+ *
+ * @param buffer
+ * @param ents
+ * @param count
+ */
+SKR_RUNTIME_API void dualCB_destroy(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count);
+/**
+ * @brief record adding components to entities, added components are default constructed
+ *
+ * @param buffer
+ * @param ents
+ * @param count
+ * @param types
+ */
+SKR_RUNTIME_API void dualCB_add_components(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count, const dual_type_set_t* types);
+/**
+ * @brief record removing components from entities
+ *
+ * @param buffer
+ * @param ents
+ * @param count
+ * @param types
+ */
+SKR_RUNTIME_API void dualCB_remove_components(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count, const dual_type_set_t* types);
+/**
+ * @brief record writing component data of an entity, the data is copied bitwise when recording and when playing back
+ * so it is only valid for trivially copyable components. array components and components with lifetime callbacks
+ * are rejected: it asserts and the write is dropped. the write is applied after the structural changes,
+ * so it could target a component added by the same buffer
+ * @param buffer
+ * @param ent
+ * @param type
+ * @param data size of type bytes
+ */
+SKR_RUNTIME_API void dualCB_set_component(dual_command_buffer_t* buffer, dual_entity_t ent, dual_type_index_t type, const void* data);
+/**
+ * @brief apply and clear all recorded commands, must be called on the main thread after the recording jobs are done
+ * destroys and component changes are folded per entity and sorted by source and target group, then moved in chunk sized runs.
+ * component writes are applied next and spawns last. commands of one entity recorded on different threads are applied in an unspecified order
+ * @param buffer
+ */
+SKR_RUNTIME_API void dualCB_playback(dual_command_buffer_t* buffer);
 /**
  * @brief create a query which combine filter and parameters
  * query can be overloaded
@@ -717,11 +854,18 @@ SKR_RUNTIME_API void dualS_disable_components(const dual_chunk_view_t* view, con
 
 /**
  * @brief set version of storage, useful when detecting changes
+ * component writes and structural changes stamp the written chunks with this version
  *
  * @param storage
  * @param number
  */
 SKR_RUNTIME_API void dualS_set_version(dual_storage_t* storage, uint64_t number);
+/**
+ * @brief get version of storage
+ *
+ * @param storage
+ */
+SKR_RUNTIME_API uint64_t dualS_get_version(dual_storage_t* storage);
 
 /**
  * @brief get group of chunk
@@ -741,6 +885,14 @@ SKR_RUNTIME_API dual_storage_t* dualC_get_storage(const dual_chunk_t* chunk);
  * @param chunk
  */
 SKR_RUNTIME_API uint32_t dualC_get_count(const dual_chunk_t* chunk);
+/**
+ * @brief test if any owned component of the set in chunk is written after the given version
+ *
+ * @param chunk
+ * @param types
+ * @param version
+ */
+SKR_RUNTIME_API bool dualC_changed_since(const dual_chunk_t* chunk, const dual_type_set_t* types, uint64_t version);
 
 
 SKR_RUNTIME_API void dual_set_bit(uint32_t* mask, int32_t bit);
@@ -784,6 +936,16 @@ typedef struct dual_resource_operation_t {
  */
 SKR_RUNTIME_API bool dualJ_schedule_ecs(dual_query_t* query, EIndex batchSize, dual_system_callback_t callback, void* u,
 dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown, dual_resource_operation_t* resources, skr::task::event_t* counter);
+/**
+ * @brief run a query's chunk views in parallel on the task scheduler and wait for them, no job is registered
+ * note: this does not sync with scheduled ecs jobs, call dualQ_sync first if they may touch the same components
+ *
+ * @param query
+ * @param batchSize max entity count processed by a task, 0 runs every view on the calling thread
+ * @param callback processor function, called multiple times in parallel
+ * @param u
+ */
+SKR_RUNTIME_API void dualQ_parallel_for(dual_query_t* query, EIndex batchSize, dual_system_callback_t callback, void* u);
 
 typedef void (*dual_schedule_callback_t)(void* u, dual_query_t* query);
 /**
@@ -807,6 +969,16 @@ SKR_RUNTIME_API void dualJ_wait_all();
  * 
  */
 SKR_RUNTIME_API void dualJ_gc();
+/**
+ * @brief schedule an incremental defragmentation job, see dualS_defragment_incremental
+ * the job owns every component of the compacted groups, so it runs after jobs accessing them and blocks later ones
+ *
+ * @param storage
+ * @param budget
+ * @param counter
+ * @return false if nothing is fragmented and no job is scheduled
+ */
+SKR_RUNTIME_API bool dualJ_schedule_defragment(dual_storage_t* storage, const dual_defragment_budget_t* budget, skr::task::event_t* counter);
 /**
  * @brief wait for all ecs jobs are done
  *
@@ -1117,6 +1289,26 @@ namespace dual
         return schedule_task(dual::QWildcard{query}, batchSize, std::move(callback), counter);
     }
 
+    template<class T, class F>
+    void parallel_for(T query, EIndex batchSize, F&& callback)
+    {
+        using TaskContext = typename T::TaskContext;
+        using callback_t = std::remove_reference_t<F>;
+        auto trampoline = +[](void* u, dual_query_t* query, dual_chunk_view_t* view, dual_type_index_t* localTypes, EIndex entityIndex)
+        {
+            callback_t* callback = (callback_t*)u;
+            TaskContext ctx{ dualQ_get_storage(query), view, localTypes, entityIndex, query };
+            (*callback)(ctx);
+        };
+        dualQ_parallel_for(query.query, batchSize, trampoline, (void*)&callback);
+    }
+
+    template<class F>
+    void parallel_for(dual_query_t* query, EIndex batchSize, F&& callback)
+    {
+        parallel_for(dual::QWildcard{query}, batchSize, std::forward<F>(callback));
+    }
+
     template<class T, class F>
     auto schedual_custom(T query, F callback, skr::task::event_t* counter)
     {
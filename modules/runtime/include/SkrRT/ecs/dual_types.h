@@ -16,6 +16,7 @@ DUAL_DECLARE(group_t);
 DUAL_DECLARE(chunk_t);
 DUAL_DECLARE(query_t);
 DUAL_DECLARE(storage_delta_t);
+DUAL_DECLARE(command_buffer_t);
 #undef DUAL_DECLARE
 
 typedef TIndex dual_type_index_t;
@@ -38,6 +39,13 @@ namespace dual
 [[maybe_unused]] static constexpr size_t kFastBinCapacity = 800;
 [[maybe_unused]] static constexpr size_t kSmallBinCapacity = 200;
 [[maybe_unused]] static constexpr size_t kLargeBinCapacity = 80;
+// address space reserved up front for all chunk pools of a context, only touched blocks are committed.
+// overridden with dual_set_chunk_pool_budget before the context is created
+[[maybe_unused]] static constexpr uint64_t kChunkPoolBudget = sizeof(void*) == 8 ? 8ull * 1024 * 1024 * 1024 : 256ull * 1024 * 1024;
+// share of the budget reserved by each pool, in sixteenths
+[[maybe_unused]] static constexpr uint64_t kFastBinBudgetShare = 8;
+[[maybe_unused]] static constexpr uint64_t kSmallBinBudgetShare = 1;
+[[maybe_unused]] static constexpr uint64_t kLargeBinBudgetShare = 7;
 [[maybe_unused]] static constexpr SIndex kInvalidSIndex = eastl::numeric_limits<SIndex>::max();
 [[maybe_unused]] static constexpr TIndex kInvalidTypeIndex = eastl::numeric_limits<TIndex>::max();
 
@@ -2,19 +2,56 @@
 #include <EASTL/vector.h>
 #include "dual.h"
 #include "SkrRT/platform/thread.h"
+#include <atomic>
 
 namespace dual
 {
+// ids are handed out without locks: recycled ids come from a lock-free stack linked through the free entries,
+// fresh ids from small blocks reserved per thread slot. only the bulk operations (reset, shrink, serialization)
+// expect exclusive access
 struct entity_registry_t {
     struct entry_t {
         dual_chunk_t* chunk;
         uint32_t indexInChunk : 24;
         uint32_t version : 8;
+        // id + 1 of the next recycled entry while this one is free
+        uint32_t nextFree;
     };
-    eastl::vector<entry_t> entries;
-    eastl::vector<EIndex> freeEntries;
-    SMutexObject mutex;
 
+    // entries live in pages that never move, so they stay readable while other threads grow the table
+    struct entry_table_t {
+        static constexpr uint32_t kPageShift = 12;
+        static constexpr EIndex kPageSize = 1 << kPageShift;
+        static constexpr uint32_t kPageCount = (DUAL_ENTITY_ID_MASK + 1) >> kPageShift;
+
+        entry_table_t();
+        ~entry_table_t();
+        entry_t& operator[](EIndex id) const { return pages[id >> kPageShift].load(std::memory_order_acquire)[id & (kPageSize - 1)]; }
+        EIndex size() const { return count.load(std::memory_order_acquire); }
+        // appends count zeroed entries and returns the first of them, thread safe
+        EIndex grow(EIndex count);
+        // not thread safe
+        void resize(EIndex size);
+        void clear() { resize(0); }
+        void shrink_to_fit();
+
+    private:
+        void commit(EIndex end);
+        std::atomic<entry_t*> pages[kPageCount];
+        std::atomic<EIndex> count;
+    };
+
+    // fresh ids reserved at once by a thread slot, bigger requests grow the table directly
+    static constexpr EIndex kReserveBlockSize = 256;
+    static constexpr uint32_t kReserveSlotCount = 16;
+
+    entry_table_t entries;
+    // tagged top of the recycled stack, (tag << 32) | (id + 1)
+    std::atomic<uint64_t> freeHead;
+    // unused part of the block reserved by the threads of a slot, (end << 32) | begin
+    std::atomic<uint64_t> reserved[kReserveSlotCount];
+
+    entity_registry_t();
     void reset();
     void shrink();
     void new_entities(dual_entity_t* dst, EIndex count);
@@ -24,5 +61,15 @@ struct entity_registry_t {
     void free_entities(const dual_chunk_view_t& view);
     void move_entities(const dual_chunk_view_t& view, const dual_chunk_t* src, EIndex srcIndex);
     void move_entities(const dual_chunk_view_t& view, EIndex srcIndex);
+    // recycled ids, the last one is handed out first. reserved ids are recycled first, not thread safe
+    void get_free_entries(eastl::vector<EIndex>& result);
+    // replaces the recycled ids and drops reserved ones, not thread safe
+    void set_free_entries(const EIndex* ids, EIndex count);
+
+private:
+    EIndex pop_free(dual_entity_t* dst, EIndex count);
+    void push_free(EIndex head, EIndex tail);
+    EIndex take_reserved(dual_entity_t* dst, EIndex count);
+    void release_reserved();
 };
-} // namespace dual
\ No newline at end of file
+} // namespace dual
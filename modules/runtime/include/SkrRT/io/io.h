@@ -7,6 +7,7 @@
 #endif
 
 #define SKR_IO_SERVICE_MAX_TASK_COUNT 32
+#define SKR_IO_DEADLINE_NONE UINT64_MAX
 #define SKR_ASYNC_SERVICE_SLEEP_TIME_MAX UINT32_MAX
 
 SKR_DECLARE_TYPE_ID_FWD(skr, JobQueue, skr_job_queue)
@@ -105,9 +106,25 @@ using IOCompressedBlock = skr_io_compressed_block_t;
 using IOFuture = skr_io_future_t;
 using IOCallback = skr_io_callback_t;
 using IOResultId = SObjectPtr<skr::SInterface>;
+using IODecompressMethod = skr_io_decompress_method_t;
 struct IORequestComponent;
 struct IIOService;
 
+// decompress one block, `src` holds block.compressed_size bytes and `dst` block.uncompressed_size bytes
+// called concurrently from task scheduler workers, so it must be thread-safe
+using IODecompressProc = bool (*)(const IOCompressedBlock& block, const uint8_t* src, uint8_t* dst, void* usr_data);
+
+struct SKR_RUNTIME_API IODecompressMethods
+{
+    // built-in CPU decompressors, registered by default
+    static IODecompressMethod Zstd() SKR_NOEXCEPT;
+    static IODecompressMethod LZ4() SKR_NOEXCEPT;
+
+    static void Register(IODecompressMethod method, IODecompressProc proc, void* usr_data = nullptr) SKR_NOEXCEPT;
+    static void Unregister(IODecompressMethod method) SKR_NOEXCEPT;
+    static bool Decompress(const IOCompressedBlock& block, const uint8_t* src, uint8_t* dst) SKR_NOEXCEPT;
+};
+
 struct SKR_RUNTIME_API IIORequest : public skr::SInterface
 {
     virtual ~IIORequest() SKR_NOEXCEPT;
@@ -141,6 +158,11 @@ struct SKR_RUNTIME_API IIOBatch : public skr::SInterface
 
     virtual void set_priority(SkrAsyncServicePriority pri) SKR_NOEXCEPT = 0;
     virtual SkrAsyncServicePriority get_priority() const SKR_NOEXCEPT = 0;
+
+    // batches of the same priority are served earliest deadline first
+    // deadline is in microseconds of skr_sys_get_usec(false), SKR_IO_DEADLINE_NONE queues after all deadlines
+    virtual void set_deadline(uint64_t deadline) SKR_NOEXCEPT = 0;
+    virtual uint64_t get_deadline() const SKR_NOEXCEPT = 0;
 };
 using IOBatchId = SObjectPtr<IIOBatch>;
 
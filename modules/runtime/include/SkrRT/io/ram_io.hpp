@@ -8,8 +8,12 @@ typedef struct skr_ram_io_service_desc_t {
     uint32_t sleep_time SKR_IF_CPP(= SKR_ASYNC_SERVICE_SLEEP_TIME_MAX);
     skr_job_queue_id io_job_queue SKR_IF_CPP(= nullptr);
     skr_job_queue_id callback_job_queue SKR_IF_CPP(= nullptr);
+    // decompression runs on io_job_queue if not set
+    skr_job_queue_id decompress_job_queue SKR_IF_CPP(= nullptr);
     bool awake_at_request SKR_IF_CPP(= true);
     bool use_dstorage SKR_IF_CPP(= true);
+    // linux only and opt-in, ignored when a dstorage reader is created
+    bool use_io_uring SKR_IF_CPP(= false);
 } skr_ram_io_service_desc_t;
 
 namespace skr {
@@ -47,7 +51,8 @@ struct SKR_RUNTIME_API IBlocksRAMRequest : public IIORequest
 
 #pragma region CompressedBlocksComponent
     virtual skr::span<skr_io_compressed_block_t> get_compressed_blocks() SKR_NOEXCEPT = 0;
-    virtual void add_compressed_block(const skr_io_block_t& block) SKR_NOEXCEPT = 0;
+    // blocks are read into a staging buffer and decompressed into the destination by IODecompressMethods
+    virtual void add_compressed_block(const skr_io_compressed_block_t& block) SKR_NOEXCEPT = 0;
     virtual void reset_compressed_blocks() SKR_NOEXCEPT = 0;
 #pragma endregion
 };
@@ -66,6 +71,9 @@ struct SKR_RUNTIME_API IRAMService : public IIOService
 
     // submit a request
     [[nodiscard]] virtual RAMIOBufferId request(IORequestId request, IOFuture* future, SkrAsyncServicePriority priority = SKR_ASYNC_SERVICE_PRIORITY_NORMAL) SKR_NOEXCEPT = 0;
+
+    // submit a request which is needed before deadline, see IIOBatch::set_deadline
+    [[nodiscard]] virtual RAMIOBufferId request(IORequestId request, IOFuture* future, SkrAsyncServicePriority priority, uint64_t deadline) SKR_NOEXCEPT = 0;
     
     // submit a batch
     virtual void request(IOBatchId request) SKR_NOEXCEPT = 0;
@@ -102,6 +102,22 @@ using SlicesIORequestId = SObjectPtr<ISlicesVRAMRequest>;
 using TilesIORequestId = SObjectPtr<ITilesVRAMRequest>;
 using BlocksVRAMRequestId = SObjectPtr<IBlocksVRAMRequest>;
 
+// where a mip of a packed chain is read from and where it is copied to in the upload buffer
+struct MipUploadLayout
+{
+    uint64_t src_offset;
+    uint64_t dst_offset;
+    uint64_t row_size;
+    uint64_t row_pitch;
+    uint64_t rows;
+};
+
+// mips are packed largest first, each one padded to whole blocks. in the upload buffer every mip starts on
+// offset_alignment and its block rows are padded to row_alignment. fills up to mip_levels layouts, stopping at
+// the first mip src_size does not hold, and returns how many were filled
+SKR_RUNTIME_API uint32_t get_mip_upload_layouts(ECGPUFormat format, uint32_t width, uint32_t height, uint32_t mip_levels,
+    uint64_t src_size, uint64_t offset_alignment, uint64_t row_alignment, MipUploadLayout* layouts, uint64_t* upload_size) SKR_NOEXCEPT;
+
 struct SKR_RUNTIME_API IVRAMService : public IIOService
 {
     [[nodiscard]] static IVRAMService* create(const VRAMServiceDescriptor* desc) SKR_NOEXCEPT;
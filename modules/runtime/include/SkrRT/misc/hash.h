@@ -22,6 +22,10 @@ uint64_t skr_hash64(const void* buffer, uint64_t size, uint64_t seed);
 SKR_EXTERN_C SKR_STATIC_API 
 uint32_t skr_hash32(const void* buffer, uint32_t size, uint32_t seed);
 
+// xxh3, faster than skr_hash64 on large buffers. the results differ from skr_hash64, do not mix them
+SKR_EXTERN_C SKR_STATIC_API 
+uint64_t skr_hash64_xxh3(const void* buffer, uint64_t size, uint64_t seed);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,282 @@
+#pragma once
+#include "SkrRT/async/fib_task.hpp"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrBase/algo/intro_sort.hpp"
+#include "SkrBase/algo/merge_sort.hpp"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// parallel algorithms over the fiber task system. ranges are split in halves recursively, the spawning task keeps
+// the left half and schedules the right one, so idle workers steal large ranges and split them further instead of
+// one thread scheduling every batch. functors are shared by all tasks, they are never copied per batch.
+// the calling thread must be bound to a task scheduler, like skr::parallel_for
+namespace skr
+{
+namespace parallel_detail
+{
+// ranges per worker when the grain is left to the algorithm, spare ranges balance uneven work
+static constexpr size_t kRangesPerWorker = 4;
+static constexpr size_t kMinSortGrain = 4096;
+
+inline size_t auto_grain(size_t count, size_t grain, size_t min_grain = 1)
+{
+    if (grain)
+        return grain;
+    const size_t workers = std::max<size_t>(skr_cpu_cores_count(), 1);
+    return std::max(count / (workers * kRangesPerWorker), min_grain);
+}
+
+// leaves of [begin, end) start on multiples of grain from begin, so the leaf of a range is begin / grain
+template <class F>
+void split(size_t begin, size_t end, size_t grain, const F* f, task::counter_t counter)
+{
+    while (end - begin > grain)
+    {
+        const size_t leaves = (end - begin + grain - 1) / grain;
+        const size_t mid = begin + (leaves / 2) * grain;
+        counter.add(1);
+        task::schedule([=]() mutable {
+            SKR_DEFER({ counter.decrement(); });
+            split(mid, end, grain, f, counter);
+        }, nullptr);
+        end = mid;
+    }
+    (*f)(begin, end);
+}
+} // namespace parallel_detail
+
+// calls f(begin, end) over sub ranges of [0, count) no longer than grain, grain 0 picks one from the worker count
+template <class F>
+void parallel_for_range(size_t count, F&& f, size_t grain = 0)
+{
+    if (count == 0)
+        return;
+    grain = parallel_detail::auto_grain(count, grain);
+    if (grain >= count)
+    {
+        f((size_t)0, count);
+        return;
+    }
+    task::counter_t counter;
+    parallel_detail::split(0, count, grain, &f, counter);
+    counter.wait(true);
+}
+
+// calls f(index) for every index in [0, count)
+template <class F>
+void parallel_for_each_index(size_t count, F&& f, size_t grain = 0)
+{
+    parallel_for_range(count, [&f](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            f(i);
+    }, grain);
+}
+
+// op must be associative, partial results are combined in range order so it does not need to be commutative
+template <class Iter, class T, class Op>
+T parallel_reduce(Iter begin, Iter end, T init, Op op, size_t grain = 0)
+{
+    const size_t count = (size_t)std::distance(begin, end);
+    if (count == 0)
+        return init;
+    grain = parallel_detail::auto_grain(count, grain);
+    const size_t leaves = (count + grain - 1) / grain;
+    skr::vector<T> partials(leaves, init);
+    parallel_for_range(count, [&](size_t first, size_t last) {
+        T partial = *(begin + first);
+        for (size_t i = first + 1; i < last; ++i)
+            partial = op(partial, *(begin + i));
+        partials[first / grain] = partial;
+    }, grain);
+    for (const auto& partial : partials)
+        init = op(init, partial);
+    return init;
+}
+
+// out[i] = op(in[0], ..., in[i]), out may be begin. the leaves are reduced first, then scanned again with the
+// carry of the leaves before them, so every element is read twice
+template <class Iter, class OutIter, class Op>
+void parallel_inclusive_scan(Iter begin, Iter end, OutIter out, Op op, size_t grain = 0)
+{
+    using T = typename std::iterator_traits<Iter>::value_type;
+    const size_t count = (size_t)std::distance(begin, end);
+    if (count == 0)
+        return;
+    grain = parallel_detail::auto_grain(count, grain);
+    const size_t leaves = (count + grain - 1) / grain;
+    auto scan = [&](size_t first, size_t last, const T* carry) {
+        T sum = carry ? op(*carry, *(begin + first)) : T(*(begin + first));
+        *(out + first) = sum;
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            sum = op(sum, *(begin + i));
+            *(out + i) = sum;
+        }
+    };
+    if (leaves == 1)
+    {
+        scan(0, count, nullptr);
+        return;
+    }
+    skr::vector<T> carries(leaves, *begin);
+    parallel_for_range(count - grain, [&](size_t first, size_t last) {
+        // the last leaf carries nothing to others, it is skipped
+        T partial = *(begin + first);
+        for (size_t i = first + 1; i < last; ++i)
+            partial = op(partial, *(begin + i));
+        carries[first / grain + 1] = partial;
+    }, grain);
+    for (size_t leaf = 2; leaf < leaves; ++leaf)
+        carries[leaf] = op(carries[leaf - 1], carries[leaf]);
+    parallel_for_range(count, [&](size_t first, size_t last) {
+        const size_t leaf = first / grain;
+        scan(first, last, leaf ? &carries[leaf] : nullptr);
+    }, grain);
+}
+
+namespace parallel_detail
+{
+// merge path: how many of the first k merged elements come from a, ties go to a so the merge stays stable
+template <class AIter, class BIter, class Pred>
+size_t merge_split(AIter a, size_t n, BIter b, size_t m, size_t k, Pred& p)
+{
+    size_t lo = k > m ? k - m : 0;
+    size_t hi = std::min(k, n);
+    while (lo < hi)
+    {
+        const size_t i = lo + (hi - lo) / 2;
+        if (p(*(b + (k - i - 1)), *(a + i)))
+            hi = i;
+        else
+            lo = i + 1;
+    }
+    return lo;
+}
+
+// moves value to out, out is raw storage that is constructed when kConstruct is set
+template <bool kConstruct, class DstIter, class T>
+void move_to(DstIter out, T& value)
+{
+    if constexpr (kConstruct)
+        ::new ((void*)std::addressof(*out)) T(std::move(value));
+    else
+        *out = std::move(value);
+}
+
+template <bool kConstruct, class SrcIter, class DstIter, class Pred>
+void merge_move(SrcIter a, SrcIter a_end, SrcIter b, SrcIter b_end, DstIter out, Pred& p)
+{
+    while (a != a_end && b != b_end)
+    {
+        if (p(*b, *a))
+            move_to<kConstruct>(out++, *b++);
+        else
+            move_to<kConstruct>(out++, *a++);
+    }
+    if constexpr (kConstruct)
+    {
+        out = std::uninitialized_move(a, a_end, out);
+        std::uninitialized_move(b, b_end, out);
+    }
+    else
+    {
+        out = std::move(a, a_end, out);
+        std::move(b, b_end, out);
+    }
+}
+
+// merges neighbouring sorted runs of src pairwise into dst. every pair is cut into pieces of grain outputs and
+// merge path finds where a piece starts in both runs, so the last rounds split as well as the first ones.
+// every element of dst is written once, so with kConstruct dst may be raw storage
+template <bool kConstruct, class SrcIter, class DstIter, class Pred>
+void merge_round(SrcIter src, DstIter dst, size_t count, size_t run, size_t grain, Pred& p)
+{
+    const size_t pairs = (count + 2 * run - 1) / (2 * run);
+    const size_t pieces = (2 * run + grain - 1) / grain;
+    parallel_for_each_index(pairs * pieces, [&](size_t index) {
+        const size_t first = (index / pieces) * 2 * run;
+        const size_t mid = std::min(first + run, count);
+        const size_t last = std::min(first + 2 * run, count);
+        const size_t out_begin = first + (index % pieces) * grain;
+        if (out_begin >= last)
+            return;
+        const size_t out_end = std::min(out_begin + grain, last);
+        const auto a = src + first;
+        const auto b = src + mid;
+        const size_t n = mid - first, m = last - mid;
+        const size_t i0 = merge_split(a, n, b, m, out_begin - first, p);
+        const size_t i1 = merge_split(a, n, b, m, out_end - first, p);
+        const size_t j0 = out_begin - first - i0, j1 = out_end - first - i1;
+        merge_move<kConstruct>(a + i0, a + i1, b + j0, b + j1, dst + out_begin, p);
+    }, 1);
+}
+
+// merges the sorted runs of run_size, every round doubles the run size. rounds move the elements between the range
+// and a scratch buffer, so every merge is linear. the scratch buffer is raw storage the first round move constructs,
+// T only has to be move constructible and move assignable. run_size must be less than count
+template <class Iter, class Pred>
+void merge_runs(Iter begin, size_t count, size_t run_size, Pred& p)
+{
+    using T = typename std::iterator_traits<Iter>::value_type;
+    T* scratch = (T*)sakura_malloc_aligned(count * sizeof(T), alignof(T));
+    merge_round<true>(begin, scratch, count, run_size, run_size, p);
+    bool in_scratch = true;
+    for (size_t run = run_size * 2; run < count; run *= 2)
+    {
+        if (in_scratch)
+            merge_round<false>(scratch, begin, count, run, run_size, p);
+        else
+            merge_round<false>(begin, scratch, count, run, run_size, p);
+        in_scratch = !in_scratch;
+    }
+    parallel_for_range(count, [&](size_t first, size_t last) {
+        if (in_scratch)
+            std::move(scratch + first, scratch + last, begin + first);
+        std::destroy(scratch + first, scratch + last);
+    }, run_size);
+    sakura_free_aligned(scratch, alignof(T));
+}
+} // namespace parallel_detail
+
+// sorts runs of grain elements with intro_sort in parallel, then merges them through a scratch buffer
+template <class Iter, class Pred = Less<>>
+void parallel_sort(Iter begin, Iter end, Pred p = {}, size_t grain = 0)
+{
+    const size_t count = (size_t)std::distance(begin, end);
+    if (count < 2)
+        return;
+    grain = parallel_detail::auto_grain(count, grain, parallel_detail::kMinSortGrain);
+    if (grain >= count)
+    {
+        algo::intro_sort(begin, end, p);
+        return;
+    }
+    parallel_for_range(count, [&](size_t first, size_t last) {
+        algo::intro_sort(begin + first, begin + last, p);
+    }, grain);
+    parallel_detail::merge_runs(begin, count, grain, p);
+}
+
+// like parallel_sort but equal elements keep their order, the runs are sorted with merge_sort
+template <class Iter, class Pred = Less<>>
+void parallel_stable_sort(Iter begin, Iter end, Pred p = {}, size_t grain = 0)
+{
+    const size_t count = (size_t)std::distance(begin, end);
+    if (count < 2)
+        return;
+    grain = parallel_detail::auto_grain(count, grain, parallel_detail::kMinSortGrain);
+    if (grain >= count)
+    {
+        algo::merge_sort(begin, end, p);
+        return;
+    }
+    parallel_for_range(count, [&](size_t first, size_t last) {
+        algo::merge_sort(begin + first, begin + last, p);
+    }, grain);
+    parallel_detail::merge_runs(begin, count, grain, p);
+}
+} // namespace skr
@@ -0,0 +1,57 @@
+#pragma once
+#include "SkrRT/platform/vfs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SKR_PAK_MAGIC 0x4B415053 // "SPAK"
+#define SKR_PAK_VERSION 1
+// entries are aligned to the logical block size so they can be read with direct i/o
+#define SKR_PAK_DEFAULT_ALIGNMENT 4096
+
+typedef struct skr_pak_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t alignment;
+    uint32_t entry_count;
+    uint64_t toc_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+} skr_pak_header_t;
+
+// toc entries are sorted by hash, names are relative paths like "{guid}.bin"
+typedef struct skr_pak_entry_t {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t name_offset;
+    uint32_t name_size;
+} skr_pak_entry_t;
+
+typedef struct skr_pak_vfs_desc_t {
+    // file system that holds the archive, a mmap vfs makes the pak hand out mapped views
+    skr_vfs_t* archive_fs;
+    const char8_t* archive_path;
+} skr_pak_vfs_desc_t;
+
+typedef struct skr_pak_writer_t skr_pak_writer_t;
+
+// read-only file system over a pak archive, files are looked up in the toc instead of opened
+SKR_RUNTIME_API skr_vfs_t* skr_create_pak_vfs(const skr_pak_vfs_desc_t* desc) SKR_NOEXCEPT;
+SKR_RUNTIME_API void skr_free_pak_vfs(skr_vfs_t* fs) SKR_NOEXCEPT;
+SKR_RUNTIME_API bool skr_vfs_is_pak(const skr_vfs_t* fs) SKR_NOEXCEPT;
+// offset of the file's first byte in the archive, false if the file does not come from a pak
+SKR_RUNTIME_API bool skr_pak_vfs_locate(const skr_vfile_t* file, uint64_t* archive_offset) SKR_NOEXCEPT;
+// thread-safe raw read from the archive, lets readers merge neighbouring files into one read
+SKR_RUNTIME_API size_t skr_pak_vfs_read_archive(skr_vfs_t* fs, void* out_buffer, uint64_t archive_offset, uint64_t byte_count) SKR_NOEXCEPT;
+
+SKR_RUNTIME_API skr_pak_writer_t* skr_create_pak_writer(uint32_t alignment) SKR_NOEXCEPT;
+SKR_RUNTIME_API void skr_free_pak_writer(skr_pak_writer_t* writer) SKR_NOEXCEPT;
+// entry_path is the path used to open the file from the pak vfs
+SKR_RUNTIME_API void skr_pak_writer_add_file(skr_pak_writer_t* writer, const char8_t* entry_path, skr_vfs_t* src_fs, const char8_t* src_path) SKR_NOEXCEPT;
+SKR_RUNTIME_API bool skr_pak_writer_write(skr_pak_writer_t* writer, skr_vfs_t* fs, const char8_t* path) SKR_NOEXCEPT;
+
+#ifdef __cplusplus
+}
+#endif
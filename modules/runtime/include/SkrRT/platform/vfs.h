@@ -82,6 +82,10 @@ typedef size_t (*SkrVFSProcFWrite)(skr_vfile_t* file, const void* in_buffer, siz
 typedef ssize_t (*SkrVFSProcFSize)(const skr_vfile_t* file);
 typedef bool (*SkrVFSProcFGetPropI64)(skr_vfile_t* file, int32_t prop, int64_t* out_value);
 typedef bool (*SkrVFSProcFSetPropI64)(skr_vfile_t* file, int32_t prop, int64_t value);
+// returns a read-only view of the file that stays valid until fclose, or nullptr
+typedef const uint8_t* (*SkrVFSProcFMap)(skr_vfile_t* file, size_t offset, size_t size_in_bytes);
+// hint that the range will be read soon, backends may start paging it in
+typedef void (*SkrVFSProcFPrefetch)(skr_vfile_t* file, size_t offset, size_t size_in_bytes);
 
 typedef bool (*SkrVFSProcFReadRequest)(struct skr_vfs_t* fs, skr_vfile_t* file, void* out_buffer, size_t offset, size_t size_in_bytes, void* user_data);
 typedef skr_vfs_event_t (*SkrVFSProcEventRequest)(struct skr_vfs_t* fs);
@@ -96,6 +100,8 @@ typedef struct skr_vfs_proctable_t {
     SkrVFSProcFSize fsize;
     SkrVFSProcFGetPropI64 fget_prop_i64;
     SkrVFSProcFSetPropI64 fset_prop_i64;
+    SkrVFSProcFMap fmap;
+    SkrVFSProcFPrefetch fprefetch;
     
     SkrVFSProcFReadRequest fread_request;
     SkrVFSProcEventRequest event_request;
@@ -120,6 +126,8 @@ typedef struct skr_vfs_desc_t {
     void* platform_data;
     ESkrMountType mount_type;
     const char8_t* override_mount_dir;
+    // read-only file system backed by copy-on-write memory mapped files
+    bool use_mmap;
 } skr_vfs_desc_t;
 
 // file system
@@ -132,8 +140,12 @@ SKR_RUNTIME_API size_t skr_vfs_fread(skr_vfile_t* file, void* out_buffer, size_t
 SKR_RUNTIME_API size_t skr_vfs_fwrite(skr_vfile_t* file, const void* in_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT;
 SKR_RUNTIME_API ssize_t skr_vfs_fsize(const skr_vfile_t* file) SKR_NOEXCEPT;
 SKR_RUNTIME_API bool skr_vfs_fclose(skr_vfile_t* file) SKR_NOEXCEPT;
+// nullptr if the file system can't map files. pages are copy-on-write, writes never reach the file
+SKR_RUNTIME_API const uint8_t* skr_vfs_fmap(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT;
+SKR_RUNTIME_API void skr_vfs_fprefetch(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT;
 
 SKR_RUNTIME_API void skr_vfs_get_native_procs(struct skr_vfs_proctable_t* procs) SKR_NOEXCEPT;
+SKR_RUNTIME_API void skr_vfs_get_mmap_procs(struct skr_vfs_proctable_t* procs) SKR_NOEXCEPT;
 
 static FORCEINLINE const char8_t* skr_vfs_filemode_to_string(ESkrFileMode mode)
 {
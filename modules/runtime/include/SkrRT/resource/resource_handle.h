@@ -11,6 +11,21 @@ enum ESkrRequesterType
     SKR_REQUESTER_SCRIPT = 3,
     SKR_REQUESTER_UNKNOWN = 4
 };
+typedef enum ESkrLoadingUrgency
+{
+    SKR_LOADING_URGENCY_PREFETCH = 0, // speculative, read after everything else
+    SKR_LOADING_URGENCY_NORMAL = 1,
+    SKR_LOADING_URGENCY_URGENT = 2, // needed as soon as possible, e.g. visible right now
+} ESkrLoadingUrgency;
+
+// scheduling hint of a resource, applies to the file reads not yet submitted
+typedef struct skr_resource_hint_t {
+    ESkrLoadingUrgency urgency SKR_IF_CPP(= SKR_LOADING_URGENCY_NORMAL);
+    // distance to the viewer, turned into an io deadline by the streaming speed of the resource system.
+    // negative means no deadline
+    float distance SKR_IF_CPP(= -1.f);
+} skr_resource_hint_t;
+
 struct lua_State;
 typedef struct skr_resource_handle_t {
     union
@@ -63,6 +78,8 @@ typedef struct skr_resource_handle_t {
     SKR_RUNTIME_API ESkrRequesterType get_requester_type() const;
     //if resolve is false, then unresolve handle will always return SKR_LOADING_STATUS_UNLOADED
     SKR_RUNTIME_API ESkrLoadingStatus get_status(bool resolve = false) const;
+    // hint is shared by all handles of the resource, the last one set wins
+    SKR_RUNTIME_API void set_hint(const skr_resource_hint_t& hint) const;
     SKR_RUNTIME_API skr_resource_record_t* get_record() const;
     SKR_RUNTIME_API void set_record(skr_resource_record_t* record);
     SKR_RUNTIME_API void set_resolved(skr_resource_record_t* record, uint32_t requesterId, ESkrRequesterType requesterType);
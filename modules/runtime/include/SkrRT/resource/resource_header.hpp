@@ -96,6 +96,7 @@ struct SKR_RUNTIME_API skr_resource_record_t {
     std::atomic<uint32_t> referenceCount = 0;
     #endif
     skr_resource_header_t header;
+    skr_resource_hint_t hint;
     skr::resource::SResourceRequest* activeRequest;
 
     void SetStatus(ESkrLoadingStatus);
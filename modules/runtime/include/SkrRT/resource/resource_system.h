@@ -106,6 +106,17 @@ public:
 
     virtual SResourceRegistry* GetRegistry() const = 0;
     virtual skr_io_ram_service_t* GetRAMService() const = 0;
+    // max count of resources started installing in one Update, 0 means no limit
+    virtual void SetInstallBudget(uint32_t budget) = 0;
+    // expected speed of the viewer in units per second, hint distances are divided by it into io deadlines
+    virtual void SetStreamingSpeed(float unitsPerSecond) = 0;
+    virtual float GetStreamingSpeed() const = 0;
+
+    // loads the resources with SKR_LOADING_URGENCY_PREFETCH, without installing them.
+    // a prefetch not requested again within the lifetime is dropped, which cancels its file reads
+    // if nothing else references the resource
+    virtual void PrefetchResources(skr::span<const skr_guid_t> guids) = 0;
+    virtual void SetPrefetchLifetime(uint32_t frames) = 0;
 
 protected:
     virtual skr_resource_record_t* _GetOrCreateRecord(const skr_guid_t& guid) = 0;
@@ -3,6 +3,8 @@
 #include "SkrRT/misc/types.h"
 #include "SkrRT/type/type_helper.hpp"
 #include "SkrRT/serde/binary/serde.h"
+#include <string.h>
+#include <type_traits>
 
 struct skr_binary_reader_t {
     template <class T>
@@ -22,19 +24,79 @@ struct skr_binary_reader_t {
             };
         }
     }
+    // buffered mode: the user is read ahead in blocks of up to capacity bytes through its read_some(data, size),
+    // which returns the byte count it could provide. users without read_some or with bit packing are read unbuffered
+    template <class T>
+    skr_binary_reader_t(T& user, void* staging, size_t capacity)
+        : skr_binary_reader_t(user)
+    {
+        auto SupportReadSome = SKR_VALIDATOR((auto t), t.read_some((void*)0, (size_t)0));
+        if constexpr(SupportReadSome(SKR_TYPELIST(T)))
+        {
+            if (!vread_bits)
+            {
+                vread_some = [](void* user, void* data, size_t size) -> size_t {
+                    return static_cast<T*>(user)->read_some(data, size);
+                };
+                buffer_begin = buffer_cursor = buffer_end = (uint8_t*)staging;
+                buffer_capacity = capacity;
+            }
+        }
+    }
     int (*vread)(void* user_data, void* data, size_t size) = nullptr;
     int (*vread_bits)(void* user_data, void* data, size_t size) = nullptr;
+    size_t (*vread_some)(void* user_data, void* data, size_t size) = nullptr;
     void* user_data = nullptr;
+    uint8_t* buffer_begin = nullptr;
+    uint8_t* buffer_cursor = nullptr;
+    uint8_t* buffer_end = nullptr;
+    size_t buffer_capacity = 0;
     int read(void* data, size_t size)
     {
-        const auto err = vread(user_data, data, size);
-        return err;
+        // empty spans may come with null pointers, memcpy must not see them
+        if (size == 0)
+            return 0;
+        if (size <= (size_t)(buffer_end - buffer_cursor))
+        {
+            memcpy(data, buffer_cursor, size);
+            buffer_cursor += size;
+            return 0;
+        }
+        if (!vread_some)
+        {
+            const auto err = vread(user_data, data, size);
+            return err;
+        }
+        return read_slow(data, size);
     }
     int read_bits(void* data, size_t size)
     {
         const auto err = vread_bits(user_data, data, size);
         return err;
     }
+
+private:
+    int read_slow(void* data, size_t size)
+    {
+        const size_t buffered = buffer_end - buffer_cursor;
+        if (buffered)
+            memcpy(data, buffer_cursor, buffered);
+        data = (uint8_t*)data + buffered;
+        size -= buffered;
+        buffer_cursor = buffer_end = buffer_begin;
+        // large reads skip the staging memory
+        if (size >= buffer_capacity)
+            return vread(user_data, data, size);
+        buffer_end = buffer_begin + vread_some(user_data, buffer_begin, buffer_capacity);
+        if (size > (size_t)(buffer_end - buffer_begin))
+        {
+            buffer_cursor = buffer_end;
+            return -1;
+        }
+        memcpy(data, buffer_cursor, size);
+        buffer_cursor += size;
+        return 0;
+    }
 };
 namespace skr
 {
@@ -46,6 +108,14 @@ inline int ReadBytes(skr_binary_reader_t* reader, void* data, size_t size)
     return err;
 }
 
+// reads a span of trivially copyable values with a single call, skipping per element traits
+template <class T>
+inline int ArchiveBuffer(skr_binary_reader_t* reader, T* buffer, size_t count)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ArchiveBuffer requires trivially copyable elements");
+    return reader->read(buffer, sizeof(T) * count);
+}
+
 template <class T, class... Args>
 int Read(skr_binary_reader_t* reader, T&& value, Args&&... args);
 template <class T, class... Args>
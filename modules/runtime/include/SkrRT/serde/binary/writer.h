@@ -2,6 +2,8 @@
 #include "SkrRT/serde/binary/writer_fwd.h"
 #include "SkrRT/misc/types.h"
 #include <bitset>
+#include <string.h>
+#include <type_traits>
 #include "SkrRT/misc/traits.hpp"
 #include "SkrRT/serde/binary/serde.h"
 
@@ -21,17 +23,67 @@ struct skr_binary_writer_t {
             };
         }
     }
+    // buffered mode: small writes are gathered in the staging memory and handed to the user once it is full,
+    // errors of the user show up at the write that triggers the flush. staging must outlive the writer
+    template <class T>
+    skr_binary_writer_t(T& user, void* staging, size_t capacity)
+        : skr_binary_writer_t(user)
+    {
+        buffer_begin = buffer_cursor = (uint8_t*)staging;
+        buffer_end = buffer_begin + capacity;
+    }
+    // flushing can fail, so it is left to the owner, see flush()
+    ~skr_binary_writer_t()
+    {
+        SKR_ASSERT(buffer_cursor == buffer_begin && "skr_binary_writer_t destroyed with staged bytes, call flush()");
+    }
     int (*vwrite)(void* user_data, const void* data, size_t size) = nullptr;
     int (*vwrite_bits)(void* user_data, const void* data, size_t size) = nullptr;
     void* user_data = nullptr;
+    uint8_t* buffer_begin = nullptr;
+    uint8_t* buffer_cursor = nullptr;
+    uint8_t* buffer_end = nullptr;
     int write(const void* data, size_t size)
     {
-        return vwrite(user_data, data, size);
+        // empty containers pass no data, memcpy must not see the null pointer
+        if (size == 0)
+            return 0;
+        if (size <= (size_t)(buffer_end - buffer_cursor))
+        {
+            memcpy(buffer_cursor, data, size);
+            buffer_cursor += size;
+            return 0;
+        }
+        return write_slow(data, size);
     }
     int write_bits(const void* data, size_t size)
     {
+        if (int result = flush(); result != 0)
+            return result;
         return vwrite_bits(user_data, data, size);
     }
+    // hand the staged bytes to the user, must be called before the user's output is consumed
+    int flush()
+    {
+        if (buffer_cursor == buffer_begin)
+            return 0;
+        const size_t size = buffer_cursor - buffer_begin;
+        buffer_cursor = buffer_begin;
+        return vwrite(user_data, buffer_begin, size);
+    }
+
+private:
+    int write_slow(const void* data, size_t size)
+    {
+        if (int result = flush(); result != 0)
+            return result;
+        // large writes skip the staging memory
+        if (size >= (size_t)(buffer_end - buffer_begin))
+            return vwrite(user_data, data, size);
+        memcpy(buffer_cursor, data, size);
+        buffer_cursor += size;
+        return 0;
+    }
 };
 
 namespace skr::binary
@@ -41,6 +93,14 @@ inline int WriteBytes(skr_binary_writer_t* writer, const void* data, size_t size
     return writer->write(data, size);
 }
 
+// writes a span of trivially copyable values with a single call, skipping per element traits
+template <class T>
+inline int ArchiveBuffer(skr_binary_writer_t* writer, const T* buffer, size_t count)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ArchiveBuffer requires trivially copyable elements");
+    return writer->write(buffer, sizeof(T) * count);
+}
+
 template <class T, class ...Args>
 int Write(skr_binary_writer_t* writer, const T& value, Args&&... args);
 template <class T, class ...Args>
@@ -64,49 +124,73 @@ struct SKR_STATIC_API WriteTrait<const bool&> {
 
 template <>
 struct SKR_STATIC_API WriteTrait<const uint8_t&> {
-    static int Write(skr_binary_writer_t* writer, uint8_t value);
+    static int Write(skr_binary_writer_t* writer, uint8_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, uint8_t value, IntegerPackConfig<uint8_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const uint16_t&> {
-    static int Write(skr_binary_writer_t* writer, uint16_t value);
+    static int Write(skr_binary_writer_t* writer, uint16_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, uint16_t value, IntegerPackConfig<uint16_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const uint32_t&> {
-    static int Write(skr_binary_writer_t* writer, uint32_t value);
+    static int Write(skr_binary_writer_t* writer, uint32_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, uint32_t value, IntegerPackConfig<uint32_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const uint64_t&> {
-    static int Write(skr_binary_writer_t* writer, uint64_t value);
+    static int Write(skr_binary_writer_t* writer, uint64_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, uint64_t value, IntegerPackConfig<uint64_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const int32_t&> {
-    static int Write(skr_binary_writer_t* writer, int32_t value);
+    static int Write(skr_binary_writer_t* writer, int32_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, int32_t value, IntegerPackConfig<int32_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const int64_t&> {
-    static int Write(skr_binary_writer_t* writer, int64_t value);
+    static int Write(skr_binary_writer_t* writer, int64_t value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, int64_t value, IntegerPackConfig<int64_t> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const float&> {
-    static int Write(skr_binary_writer_t* writer, float value);
+    static int Write(skr_binary_writer_t* writer, float value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, float value, FloatingPackConfig<float> config);
 };
 
 template <>
 struct SKR_STATIC_API WriteTrait<const double&> {
-    static int Write(skr_binary_writer_t* writer, double value);
+    static int Write(skr_binary_writer_t* writer, double value)
+    {
+        return WriteBytes(writer, &value, sizeof(value));
+    }
     static int Write(skr_binary_writer_t* writer, double value, FloatingPackConfig<double> config);
 };
 
@@ -1160,6 +1160,9 @@ typedef struct CGPUBufferToTextureTransfer {
     CGPUTextureSubresource dst_subresource;
     CGPUBufferId src;
     uint64_t src_offset;
+    /// bytes between rows of blocks in src, 0 lets the backend pick its default layout.
+    /// must be a multiple of upload_buffer_texture_row_alignment
+    uint32_t src_row_pitch;
 } CGPUBufferToTextureTransfer;
 
 typedef struct CGPUBufferBarrier {
@@ -398,6 +398,12 @@ void cgpu_cmd_transfer_buffer_to_texture_d3d12(CGPUCommandBufferId cmd, const st
         desc->src_offset, &src.PlacedFootprint,
         NULL, NULL, NULL);
     src.PlacedFootprint.Offset = desc->src_offset;
+    cgpu_assert(desc->src_offset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0 && "Texture upload offset must be 512 bytes aligned!");
+    if (desc->src_row_pitch)
+    {
+        cgpu_assert(desc->src_row_pitch % D3D12_TEXTURE_DATA_PITCH_ALIGNMENT == 0 && "Texture upload row pitch must be 256 bytes aligned!");
+        src.PlacedFootprint.Footprint.RowPitch = desc->src_row_pitch;
+    }
     dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
     dst.pResource = Dst->pDxResource;
     dst.SubresourceIndex = subresource;
@@ -310,12 +310,14 @@ void cgpu_cmd_transfer_buffer_to_texture_vulkan(CGPUCommandBufferId cmd, const s
         const uint64_t height = cgpu_max(1, texInfo->height >> desc->dst_subresource.mip_level);
         const uint64_t depth = cgpu_max(1, texInfo->depth >> desc->dst_subresource.mip_level);
 
-		const uint64_t xBlocksCount = width / FormatUtil_WidthOfBlock(fmt);
-		const uint64_t yBlocksCount = height / FormatUtil_HeightOfBlock(fmt);
+        // partial blocks of NPOT mips still take a whole block
+		const uint64_t xBlocksCount = (width + FormatUtil_WidthOfBlock(fmt) - 1) / FormatUtil_WidthOfBlock(fmt);
+		const uint64_t yBlocksCount = (height + FormatUtil_HeightOfBlock(fmt) - 1) / FormatUtil_HeightOfBlock(fmt);
+        const uint64_t rowBlocksCount = desc->src_row_pitch ? desc->src_row_pitch / (FormatUtil_BitSizeOfBlock(fmt) / 8) : xBlocksCount;
 
         VkBufferImageCopy copy = {
             .bufferOffset = desc->src_offset,
-            .bufferRowLength = (uint32_t)xBlocksCount * FormatUtil_WidthOfBlock(fmt),
+            .bufferRowLength = (uint32_t)rowBlocksCount * FormatUtil_WidthOfBlock(fmt),
             .bufferImageHeight = (uint32_t)yBlocksCount * FormatUtil_HeightOfBlock(fmt),
             .imageSubresource.aspectMask = (VkImageAspectFlags)texInfo->aspect_mask,
             .imageSubresource.mipLevel = desc->dst_subresource.mip_level,
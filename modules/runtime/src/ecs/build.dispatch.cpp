@@ -1,5 +1,7 @@
+#include "filter.cpp"
 #include "query.cpp"
 #include "scheduler.cpp"
 #include "serialize.cpp"
 #include "storage.cpp"
-#include "luabind.cpp"
\ No newline at end of file
+#include "luabind.cpp"
+#include "command_buffer.cpp"
\ No newline at end of file
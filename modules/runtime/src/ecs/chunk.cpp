@@ -63,4 +63,18 @@ uint32_t dualC_get_count(const dual_chunk_t* chunk)
 {
     return chunk->count;
 }
+
+bool dualC_changed_since(const dual_chunk_t* chunk, const dual_type_set_t* types, uint64_t version)
+{
+    auto timestamps = const_cast<dual_chunk_t*>(chunk)->timestamps();
+    for (SIndex i = 0; i < types->length; ++i)
+    {
+        const auto id = chunk->type->index(types->data[i]);
+        if (id == kInvalidSIndex)
+            continue;
+        if ((int32_t)(timestamps[id] - (uint32_t)version) > 0)
+            return true;
+    }
+    return false;
+}
 }
\ No newline at end of file
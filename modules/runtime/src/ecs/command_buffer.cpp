@@ -0,0 +1,402 @@
+#include "SkrRT/ecs/dual.h"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/misc/log.h"
+#include "storage.hpp"
+#include "archetype.hpp"
+#include "scheduler.hpp"
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+#include <atomic>
+
+#include "SkrProfile/profile.h"
+
+namespace dual
+{
+enum command_kind_t : uint32_t
+{
+    CK_destroy,
+    CK_add,
+    CK_remove,
+};
+
+struct entity_command_t {
+    dual_entity_t entity;
+    command_kind_t kind;
+    // range of the recorder's types for add and remove
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct set_command_t {
+    dual_entity_t entity;
+    dual_type_index_t type;
+    // range of the recorder's data
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct spawn_command_t {
+    dual_entity_t prefab;
+    EIndex count;
+    dual_view_callback_t callback;
+    void* u;
+};
+
+// commands recorded by one thread, only touched by that thread until playback
+struct command_recorder_t {
+    SThreadID thread;
+    eastl::vector<entity_command_t> commands;
+    eastl::vector<dual_type_index_t> types;
+    eastl::vector<set_command_t> sets;
+    eastl::vector<uint8_t> data;
+    eastl::vector<spawn_command_t> spawns;
+
+    void clear()
+    {
+        commands.clear();
+        types.clear();
+        sets.clear();
+        data.clear();
+        spawns.clear();
+    }
+};
+
+// the recorder last used by this thread, buffers are told apart by id since their addresses get reused
+struct command_recorder_cache_t {
+    uint64_t buffer = 0;
+    command_recorder_t* recorder = nullptr;
+};
+static thread_local command_recorder_cache_t tCommandRecorderCache;
+static std::atomic<uint64_t> gCommandBufferId{ 0 };
+} // namespace dual
+
+struct dual_command_buffer_t {
+    dual_storage_t* storage;
+    uint64_t id;
+    SMutex mutex;
+    eastl::vector<dual::command_recorder_t*> recorders;
+
+    dual_command_buffer_t(dual_storage_t* storage)
+        : storage(storage)
+        , id(++dual::gCommandBufferId)
+    {
+        skr_init_mutex(&mutex);
+    }
+
+    ~dual_command_buffer_t()
+    {
+        for (auto recorder : recorders)
+            SkrDelete(recorder);
+        skr_destroy_mutex(&mutex);
+    }
+
+    dual::command_recorder_t* get_recorder()
+    {
+        using namespace dual;
+        auto& cache = tCommandRecorderCache;
+        if (cache.buffer == id)
+            return cache.recorder;
+        const auto thread = skr_current_thread_id();
+        SMutexLock lock(mutex);
+        command_recorder_t* result = nullptr;
+        for (auto recorder : recorders)
+        {
+            if (recorder->thread == thread)
+            {
+                result = recorder;
+                break;
+            }
+        }
+        if (!result)
+        {
+            result = SkrNew<command_recorder_t>();
+            result->thread = thread;
+            recorders.push_back(result);
+        }
+        cache.buffer = id;
+        cache.recorder = result;
+        return result;
+    }
+
+    void record(const dual_entity_t* ents, EIndex count, dual::command_kind_t kind, const dual_type_set_t* types)
+    {
+        using namespace dual;
+        auto recorder = get_recorder();
+        uint32_t offset = 0, length = 0;
+        if (types)
+        {
+            SKR_ASSERT(dual::ordered(*types));
+            offset = (uint32_t)recorder->types.size();
+            length = types->length;
+            recorder->types.insert(recorder->types.end(), types->data, types->data + types->length);
+        }
+        recorder->commands.reserve(recorder->commands.size() + count);
+        for (EIndex i = 0; i < count; ++i)
+            recorder->commands.push_back(entity_command_t{ ents[i], kind, offset, length });
+    }
+
+    void playback_structural();
+    void playback_sets();
+    void playback_spawns();
+};
+
+void dual_command_buffer_t::playback_structural()
+{
+    using namespace dual;
+    SkrZoneScopedN("CommandBufferStructural");
+    struct entry_t {
+        dual_entity_t entity;
+        uint32_t recorder;
+        uint32_t command;
+    };
+    eastl::vector<entry_t> entries;
+    for (uint32_t r = 0; r < recorders.size(); ++r)
+    {
+        auto& commands = recorders[r]->commands;
+        for (uint32_t c = 0; c < commands.size(); ++c)
+            entries.push_back(entry_t{ commands[c].entity, r, c });
+    }
+    if (entries.empty())
+        return;
+    // commands of an entity stay in recording order within a recorder
+    eastl::sort(entries.begin(), entries.end(), [](const entry_t& a, const entry_t& b) {
+        if (a.entity != b.entity)
+            return a.entity < b.entity;
+        return a.recorder != b.recorder ? a.recorder < b.recorder : a.command < b.command;
+    });
+
+    // fold the commands of every entity into one move from its group to the target group, nullptr for destroy
+    struct move_t {
+        dual_group_t* src;
+        dual_group_t* dst;
+        dual_entity_t entity;
+    };
+    eastl::vector<move_t> moves;
+    eastl::vector<dual_type_index_t> added, removed;
+    // entities recorded together usually share the source group and the delta
+    dual_group_t* lastSrc = nullptr;
+    dual_group_t* lastDst = nullptr;
+    eastl::vector<dual_type_index_t> lastAdded, lastRemoved;
+    // final presence of every type an entity's commands touched, the last command on a type wins
+    eastl::vector<eastl::pair<dual_type_index_t, bool>> finals;
+    auto set_final = [&](dual_type_index_t type, bool present) {
+        for (auto& final : finals)
+        {
+            if (final.first == type)
+            {
+                final.second = present;
+                return;
+            }
+        }
+        finals.emplace_back(type, present);
+    };
+    size_t i = 0;
+    while (i < entries.size())
+    {
+        const auto entity = entries[i].entity;
+        bool destroyed = false;
+        finals.clear();
+        for (; i < entries.size() && entries[i].entity == entity; ++i)
+        {
+            auto recorder = recorders[entries[i].recorder];
+            const auto& command = recorder->commands[entries[i].command];
+            const auto types = recorder->types.data() + command.offset;
+            switch (command.kind)
+            {
+                case CK_destroy:
+                    destroyed = true;
+                    break;
+                case CK_add:
+                    for (uint32_t t = 0; t < command.length; ++t)
+                        set_final(types[t], true);
+                    break;
+                case CK_remove:
+                    for (uint32_t t = 0; t < command.length; ++t)
+                        set_final(types[t], false);
+                    break;
+            }
+        }
+        if (!storage->exist(entity))
+            continue;
+        auto src = storage->entity_view(entity).chunk->group;
+        if (destroyed)
+        {
+            // dead entities wait for their pinned components to be removed
+            if (!src->isDead)
+                moves.push_back(move_t{ src, nullptr, entity });
+            continue;
+        }
+        // the delta is taken against the current type, so add then remove of an owned type still removes it
+        added.clear();
+        removed.clear();
+        for (auto [type, present] : finals)
+        {
+            const bool owned = src->index(type) != kInvalidSIndex;
+            if (present && !owned)
+                added.push_back(type);
+            else if (!present && owned)
+                removed.push_back(type);
+        }
+        if (added.empty() && removed.empty())
+            continue;
+        eastl::sort(added.begin(), added.end());
+        eastl::sort(removed.begin(), removed.end());
+        if (src != lastSrc || added != lastAdded || removed != lastRemoved)
+        {
+            dual_delta_type_t delta = {};
+            delta.added.type = { added.data(), (SIndex)added.size() };
+            delta.removed.type = { removed.data(), (SIndex)removed.size() };
+            lastSrc = src;
+            lastDst = storage->cast(src, delta);
+            lastAdded = added;
+            lastRemoved = removed;
+        }
+        if (lastDst != src)
+            moves.push_back(move_t{ src, lastDst, entity });
+    }
+    eastl::sort(moves.begin(), moves.end(), [](const move_t& a, const move_t& b) {
+        return a.src != b.src ? a.src < b.src : a.dst < b.dst;
+    });
+
+    eastl::vector<dual_chunk_view_t> slots;
+    size_t begin = 0;
+    while (begin < moves.size())
+    {
+        size_t end = begin + 1;
+        while (end < moves.size() && moves[end].src == moves[begin].src && moves[end].dst == moves[begin].dst)
+            ++end;
+        // earlier moves shuffled entities inside their chunks, so positions are read per bucket
+        slots.clear();
+        for (size_t m = begin; m < end; ++m)
+            slots.push_back(storage->entity_view(moves[m].entity));
+        eastl::sort(slots.begin(), slots.end(), [](const dual_chunk_view_t& a, const dual_chunk_view_t& b) {
+            return a.chunk != b.chunk ? a.chunk < b.chunk : a.start < b.start;
+        });
+        // removing a run only fills its hole from the chunk tail, so runs are taken from the back
+        // to keep the positions of the ones before valid
+        auto dst = moves[begin].dst;
+        size_t last = slots.size();
+        while (last > 0)
+        {
+            size_t first = last - 1;
+            while (first > 0 && slots[first - 1].chunk == slots[first].chunk && slots[first - 1].start + 1 == slots[first].start)
+                --first;
+            dual_chunk_view_t view{ slots[first].chunk, slots[first].start, (EIndex)(last - first) };
+            if (dst)
+                storage->cast(view, dst, nullptr, nullptr);
+            else
+                storage->destroy(view);
+            last = first;
+        }
+        begin = end;
+    }
+}
+
+void dual_command_buffer_t::playback_sets()
+{
+    using namespace dual;
+    SkrZoneScopedN("CommandBufferSets");
+    dual::archetype_t* synced = nullptr;
+    for (auto recorder : recorders)
+    {
+        for (const auto& set : recorder->sets)
+        {
+            if (!storage->exist(set.entity))
+                continue;
+            auto view = storage->entity_view(set.entity);
+            auto archetype = view.chunk->group->archetype;
+            if (storage->scheduler && archetype != synced)
+            {
+                storage->scheduler->sync_archetype(archetype);
+                synced = archetype;
+            }
+            auto dst = dualV_get_owned_rw(&view, set.type);
+            if (!dst)
+                continue;
+            memcpy(dst, recorder->data.data() + set.offset, set.size);
+        }
+    }
+}
+
+void dual_command_buffer_t::playback_spawns()
+{
+    using namespace dual;
+    SkrZoneScopedN("CommandBufferSpawns");
+    for (auto recorder : recorders)
+    {
+        for (const auto& spawn : recorder->spawns)
+        {
+            if (!storage->exist(spawn.prefab))
+                continue;
+            storage->instantiate(spawn.prefab, spawn.count, spawn.callback, spawn.u);
+        }
+    }
+}
+
+extern "C" {
+dual_command_buffer_t* dualCB_create(dual_storage_t* storage)
+{
+    return SkrNew<dual_command_buffer_t>(storage);
+}
+
+void dualCB_release(dual_command_buffer_t* buffer)
+{
+    SkrDelete(buffer);
+}
+
+void dualCB_spawn(dual_command_buffer_t* buffer, dual_entity_t prefab, EIndex count, dual_view_callback_t callback, void* u)
+{
+    buffer->get_recorder()->spawns.push_back(dual::spawn_command_t{ prefab, count, callback, u });
+}
+
+void dualCB_destroy(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count)
+{
+    buffer->record(ents, count, dual::CK_destroy, nullptr);
+}
+
+void dualCB_add_components(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count, const dual_type_set_t* types)
+{
+    buffer->record(ents, count, dual::CK_add, types);
+}
+
+void dualCB_remove_components(dual_command_buffer_t* buffer, const dual_entity_t* ents, EIndex count, const dual_type_set_t* types)
+{
+    buffer->record(ents, count, dual::CK_remove, types);
+}
+
+void dualCB_set_component(dual_command_buffer_t* buffer, dual_entity_t ent, dual_type_index_t type, const void* data)
+{
+    const auto desc = dualT_get_desc(type);
+    // the data is stored and written bitwise, arrays own heap storage and managed types need their callbacks
+    const bool managed = desc->callback.constructor || desc->callback.destructor || desc->callback.copy || desc->callback.move;
+    if (desc->elementSize != 0 || managed)
+    {
+        SKR_LOG_ERROR(u8"dualCB_set_component: component %s is not trivially copyable, the write is dropped", desc->name);
+        SKR_ASSERT(false && "only trivially copyable components can be set through a command buffer");
+        return;
+    }
+    auto recorder = buffer->get_recorder();
+    const uint32_t size = desc->size;
+    SKR_ASSERT(size > 0 && "tags carry no data");
+    const uint32_t offset = (uint32_t)recorder->data.size();
+    recorder->data.resize(offset + size);
+    memcpy(recorder->data.data() + offset, data, size);
+    recorder->sets.push_back(dual::set_command_t{ ent, type, offset, size });
+}
+
+void dualCB_playback(dual_command_buffer_t* buffer)
+{
+    SkrZoneScopedN("CommandBufferPlayback");
+    auto storage = buffer->storage;
+    if (storage->scheduler)
+    {
+        SKR_ASSERT(storage->scheduler->is_main_thread(storage));
+    }
+    buffer->playback_structural();
+    buffer->playback_sets();
+    buffer->playback_spawns();
+    for (auto recorder : buffer->recorders)
+        recorder->clear();
+}
+}
@@ -1,7 +1,15 @@
 #include "context.hpp"
 #include "SkrRT/ecs/dual.h"
+#include "SkrRT/misc/log.h"
 
 dual_context_t* g_dual_ctx;
+static uint64_t g_dual_pool_budget = dual::kChunkPoolBudget;
+
+// blocks of the pool's share of the budget
+static size_t dual_pool_reserve(size_t blockSize, uint64_t share)
+{
+    return (size_t)(g_dual_pool_budget / 16 * share / blockSize);
+}
 
 SKR_RUNTIME_API dual_context_t* dual_get_context()
 {
@@ -38,9 +46,15 @@ skr::string& get_error()
 } // namespace dual
 
 dual_context_t::dual_context_t()
+#ifdef DUAL_LEGACY_CHUNK_POOL
     : normalPool(dual::kFastBinSize, dual::kFastBinCapacity)
     , largePool(dual::kLargeBinSize, dual::kLargeBinCapacity)
     , smallPool(dual::kSmallBinSize, dual::kSmallBinCapacity)
+#else
+    : normalPool(dual::kFastBinSize, dual_pool_reserve(dual::kFastBinSize, dual::kFastBinBudgetShare))
+    , largePool(dual::kLargeBinSize, dual_pool_reserve(dual::kLargeBinSize, dual::kLargeBinBudgetShare))
+    , smallPool(dual::kSmallBinSize, dual_pool_reserve(dual::kSmallBinSize, dual::kSmallBinBudgetShare))
+#endif
     , typeRegistry(smallPool)
     , scheduler()
 {
@@ -54,6 +68,35 @@ dual_context_t* dual_initialize()
     return g_dual_ctx = new dual_context_t();
 }
 
+void dual_set_chunk_pool_budget(uint64_t bytes)
+{
+    if (g_dual_ctx)
+    {
+        SKR_LOG_WARN(u8"dual_set_chunk_pool_budget has no effect once the context is created");
+        return;
+    }
+    g_dual_pool_budget = bytes;
+}
+
+void dual_get_chunk_pool_stats(dual_chunk_pool_stats_t* small, dual_chunk_pool_stats_t* normal, dual_chunk_pool_stats_t* large)
+{
+    auto ctx = dual_get_context();
+    if (small)
+        ctx->smallPool.get_stats(small);
+    if (normal)
+        ctx->normalPool.get_stats(normal);
+    if (large)
+        ctx->largePool.get_stats(large);
+}
+
+void dual_trim_chunk_pools()
+{
+    auto ctx = dual_get_context();
+    ctx->smallPool.trim();
+    ctx->normalPool.trim();
+    ctx->largePool.trim();
+}
+
 void dual_shutdown()
 {
     if (auto ctx = g_dual_ctx)
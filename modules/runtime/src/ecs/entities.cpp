@@ -1,20 +1,100 @@
 #include "SkrRT/ecs/entity.hpp"
 #include "SkrRT/ecs/entities.hpp"
+#include "SkrRT/platform/memory.h"
 #include "chunk.hpp"
+#include <algorithm>
 
 dual_entity_debug_proxy_t dummy;
 namespace dual
 {
+entity_registry_t::entry_table_t::entry_table_t()
+    : count(0)
+{
+    for (auto& page : pages)
+        page.store(nullptr, std::memory_order_relaxed);
+}
+
+entity_registry_t::entry_table_t::~entry_table_t()
+{
+    for (auto& page : pages)
+    {
+        if (auto p = page.load(std::memory_order_relaxed))
+            sakura_free(p);
+    }
+}
+
+void entity_registry_t::entry_table_t::commit(EIndex end)
+{
+    const uint32_t pageEnd = (end + kPageSize - 1) >> kPageShift;
+    SKR_ASSERT(pageEnd <= kPageCount && "entity ids exhausted");
+    // pages are committed front to back, so the first missing one is found from the back
+    uint32_t p = pageEnd;
+    while (p > 0 && !pages[p - 1].load(std::memory_order_acquire))
+        --p;
+    for (; p < pageEnd; ++p)
+    {
+        auto page = (entry_t*)sakura_calloc(kPageSize, sizeof(entry_t));
+        entry_t* expected = nullptr;
+        if (!pages[p].compare_exchange_strong(expected, page, std::memory_order_release, std::memory_order_acquire))
+            sakura_free(page);
+    }
+}
+
+EIndex entity_registry_t::entry_table_t::grow(EIndex n)
+{
+    EIndex first = count.load(std::memory_order_relaxed);
+    do
+    {
+        // pages are ready before the ids are published
+        commit(first + n);
+    } while (!count.compare_exchange_weak(first, first + n, std::memory_order_release, std::memory_order_relaxed));
+    return first;
+}
+
+void entity_registry_t::entry_table_t::resize(EIndex size)
+{
+    const EIndex old = count.load(std::memory_order_relaxed);
+    if (size > old)
+        commit(size);
+    // entries past the end are kept zeroed for grow
+    for (EIndex i = size; i < old; ++i)
+        (*this)[i] = {};
+    count.store(size, std::memory_order_release);
+}
+
+void entity_registry_t::entry_table_t::shrink_to_fit()
+{
+    const uint32_t used = (count.load(std::memory_order_relaxed) + kPageSize - 1) >> kPageShift;
+    for (uint32_t p = used; p < kPageCount; ++p)
+    {
+        if (auto page = pages[p].exchange(nullptr, std::memory_order_relaxed))
+            sakura_free(page);
+    }
+}
+
+static uint32_t entity_reserve_slot()
+{
+    static std::atomic<uint32_t> nextSlot{ 0 };
+    static thread_local uint32_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % entity_registry_t::kReserveSlotCount;
+    return slot;
+}
+
+entity_registry_t::entity_registry_t()
+    : freeHead(0)
+{
+    for (auto& slot : reserved)
+        slot.store(0, std::memory_order_relaxed);
+}
+
 void entity_registry_t::reset()
 {
-    SMutexLock lock(mutex.mMutex);
     entries.clear();
-    freeEntries.clear();
+    set_free_entries(nullptr, 0);
 }
 
 void entity_registry_t::shrink()
 {
-    SMutexLock lock(mutex.mMutex);
+    release_reserved();
     if (entries.size() == 0)
         return;
     EIndex lastValid = (EIndex)(entries.size() - 1);
@@ -22,58 +102,170 @@ void entity_registry_t::shrink()
         --lastValid;
     if (entries[lastValid].indexInChunk == 0)
     {
-        entries.clear();
+        reset();
         return;
     }
+    // the free links are stored in the entries about to be cut
+    eastl::vector<EIndex> freeEntries;
+    get_free_entries(freeEntries);
     entries.resize(lastValid + 1);
     entries.shrink_to_fit();
     freeEntries.erase(std::remove_if(freeEntries.begin(), freeEntries.end(), [&](EIndex i) {
         return i > lastValid;
     }),
     freeEntries.end());
+    set_free_entries(freeEntries.data(), (EIndex)freeEntries.size());
 }
 
-void entity_registry_t::new_entities(dual_entity_t* dst, EIndex count)
+EIndex entity_registry_t::pop_free(dual_entity_t* dst, EIndex count)
 {
-    SMutexLock lock(mutex.mMutex);
-    EIndex i = 0;
-    // recycle entities
+    uint64_t top = freeHead.load(std::memory_order_acquire);
+    EIndex taken;
+    do
+    {
+        if (!(top & 0xFFFFFFFF))
+            return 0;
+        // may read links of entries another thread just took, the tag makes the exchange fail then.
+        // pages are never released while ids are handed out so the reads themselves are safe
+        const EIndex size = entries.size();
+        uint32_t link = (uint32_t)top;
+        taken = 0;
+        while (link && taken < count && link <= size)
+        {
+            dst[taken++] = link - 1;
+            link = entries[link - 1].nextFree;
+        }
+        if (freeHead.compare_exchange_weak(top, (((top >> 32) + 1) << 32) | link, std::memory_order_acquire, std::memory_order_acquire))
+            break;
+    } while (true);
+    forloop (i, 0, taken)
+        dst[i] = e_version(dst[i], entries[dst[i]].version);
+    return taken;
+}
+
+void entity_registry_t::push_free(EIndex head, EIndex tail)
+{
+    uint64_t top = freeHead.load(std::memory_order_relaxed);
+    do
+    {
+        entries[tail].nextFree = (uint32_t)top;
+    } while (!freeHead.compare_exchange_weak(top, (((top >> 32) + 1) << 32) | (head + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+EIndex entity_registry_t::take_reserved(dual_entity_t* dst, EIndex count)
+{
+    auto& slot = reserved[entity_reserve_slot()];
+    uint64_t range = slot.load(std::memory_order_relaxed);
+    EIndex begin, end, taken;
+    do
+    {
+        begin = (EIndex)range;
+        end = (EIndex)(range >> 32);
+        taken = std::min(count, end - begin);
+        if (taken == 0)
+            return 0;
+    } while (!slot.compare_exchange_weak(range, ((uint64_t)end << 32) | (begin + taken), std::memory_order_relaxed));
+    // reserved entries were never handed out, so their version is zero
+    forloop (i, 0, taken)
+        dst[i] = begin + i;
+    return taken;
+}
 
-    auto fn = (EIndex)freeEntries.size();
-    auto rn = std::min((EIndex)freeEntries.size(), count);
-    forloop (j, 0, rn)
+void entity_registry_t::release_reserved()
+{
+    eastl::vector<uint64_t> ranges;
+    for (auto& slot : reserved)
+    {
+        const uint64_t range = slot.exchange(0, std::memory_order_relaxed);
+        if ((EIndex)range != (EIndex)(range >> 32))
+            ranges.push_back(range);
+    }
+    // ranges at the end of the table are cut off, the others are recycled
+    std::sort(ranges.begin(), ranges.end(), [](uint64_t a, uint64_t b) { return (EIndex)a > (EIndex)b; });
+    EIndex size = entries.size();
+    for (auto range : ranges)
     {
-        auto id = freeEntries[fn - rn + j];
-        dst[i] = e_version(id, entries[id].version);
-        i++;
+        const EIndex begin = (EIndex)range, end = (EIndex)(range >> 32);
+        if (end == size)
+        {
+            size = begin;
+            continue;
+        }
+        for (EIndex id = begin + 1; id < end; ++id)
+            entries[id].nextFree = id;
+        push_free(end - 1, begin);
     }
-    freeEntries.resize(fn - rn);
+    if (size != entries.size())
+        entries.resize(size);
+}
+
+void entity_registry_t::get_free_entries(eastl::vector<EIndex>& result)
+{
+    release_reserved();
+    result.clear();
+    for (uint32_t link = (uint32_t)freeHead.load(std::memory_order_acquire); link; link = entries[link - 1].nextFree)
+        result.push_back(link - 1);
+    std::reverse(result.begin(), result.end());
+}
+
+void entity_registry_t::set_free_entries(const EIndex* ids, EIndex count)
+{
+    for (auto& slot : reserved)
+        slot.store(0, std::memory_order_relaxed);
+    uint32_t link = 0;
+    forloop (i, 0, count)
+    {
+        entries[ids[i]].nextFree = link;
+        link = ids[i] + 1;
+    }
+    const uint64_t top = freeHead.load(std::memory_order_relaxed);
+    freeHead.store((((top >> 32) + 1) << 32) | link, std::memory_order_release);
+}
+
+void entity_registry_t::new_entities(dual_entity_t* dst, EIndex count)
+{
+    EIndex i = pop_free(dst, count);
+    if (i < count)
+        i += take_reserved(dst + i, count - i);
     if (i == count)
         return;
     // new entities
-    EIndex newId = static_cast<EIndex>(entries.size());
-    entries.resize(entries.size() + count - i);
-    while (i < count)
+    const EIndex rest = count - i;
+    if (rest >= kReserveBlockSize)
     {
-        dst[i] = e_version(newId, entries[newId].version);
-        i++;
-        newId++;
+        const EIndex first = entries.grow(rest);
+        forloop (j, 0, rest)
+            dst[i + j] = first + j;
+        return;
+    }
+    const EIndex first = entries.grow(kReserveBlockSize);
+    forloop (j, 0, rest)
+        dst[i + j] = first + j;
+    // keep the remainder for the next small requests of this slot, another thread of the slot may have refilled it meanwhile
+    const uint64_t old = reserved[entity_reserve_slot()].exchange(((uint64_t)(first + kReserveBlockSize) << 32) | (first + rest), std::memory_order_relaxed);
+    const EIndex oldBegin = (EIndex)old, oldEnd = (EIndex)(old >> 32);
+    if (oldBegin != oldEnd)
+    {
+        for (EIndex id = oldBegin + 1; id < oldEnd; ++id)
+            entries[id].nextFree = id;
+        push_free(oldEnd - 1, oldBegin);
     }
 }
 
 void entity_registry_t::free_entities(const dual_entity_t* dst, EIndex count)
 {
-    SMutexLock lock(mutex.mMutex);
-    // build freelist in input order
-    freeEntries.reserve(freeEntries.size() + count);
-
+    if (count == 0)
+        return;
+    // link the freed entries in input order, the last one is recycled first
+    uint32_t link = 0;
     forloop (i, 0, count)
     {
         auto id = e_id(dst[i]);
         entry_t& freeData = entries[id];
-        freeData = { nullptr, 0, e_inc_version(freeData.version) };
-        freeEntries.push_back(id);
+        freeData = { nullptr, 0, e_inc_version(freeData.version), link };
+        link = id + 1;
     }
+    push_free(e_id(dst[count - 1]), e_id(dst[0]));
 }
 
 void entity_registry_t::fill_entities(const dual_chunk_view_t& view)
@@ -0,0 +1,244 @@
+#include "SkrRT/misc/bits.hpp"
+#include "filter.hpp"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define DUAL_FILTER_X86 1
+    #include "SkrRT/platform/cpu/cpuinfo_x86.h"
+    #include <immintrin.h>
+    // msvc compiles intrinsics of every instruction set without flags
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define DUAL_FILTER_TARGET(isa)
+    #else
+        #define DUAL_FILTER_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#else
+    #define DUAL_FILTER_X86 0
+#endif
+
+namespace dual
+{
+static EIndex find_scalar(const dual_mask_comp_t* masks, EIndex i, EIndex count, dual_mask_comp_t all, dual_mask_comp_t none, bool matched)
+{
+    for (; i < count; ++i)
+    {
+        const auto mask = masks[i];
+        if ((((mask & all) == all) && (mask & none) == 0) == matched)
+            return i;
+    }
+    return count;
+}
+
+static bool changed_scalar(const uint32_t* timestamps, uint32_t begin, uint32_t length, const uint32_t* lanes, uint32_t version)
+{
+    for (uint32_t j = begin; j < length; ++j)
+    {
+        if ((lanes[j >> 5] & (1u << (j & 31))) && (int32_t)(timestamps[j] - version) > 0)
+            return true;
+    }
+    return false;
+}
+
+static bool changed_scalar(const uint32_t* timestamps, uint32_t length, const uint32_t* lanes, uint32_t version)
+{
+    return changed_scalar(timestamps, 0, length, lanes, version);
+}
+
+#if DUAL_FILTER_X86
+// a lane matches if it has all bits of all and none of none, bits of unmatched lanes are flipped to find either kind
+DUAL_FILTER_TARGET("sse2")
+static EIndex find_sse2(const dual_mask_comp_t* masks, EIndex i, EIndex count, dual_mask_comp_t all, dual_mask_comp_t none, bool matched)
+{
+    const __m128i allv = _mm_set1_epi32((int)all);
+    const __m128i nonev = _mm_set1_epi32((int)none);
+    const __m128i zero = _mm_setzero_si128();
+    const int flip = matched ? 0 : 0xF;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i m = _mm_loadu_si128((const __m128i*)(masks + i));
+        const __m128i hit = _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(m, allv), allv), _mm_cmpeq_epi32(_mm_and_si128(m, nonev), zero));
+        const int bits = _mm_movemask_ps(_mm_castsi128_ps(hit)) ^ flip;
+        if (bits)
+            return i + (EIndex)skr::CountTrailingZeros64((uint64_t)bits);
+    }
+    return find_scalar(masks, i, count, all, none, matched);
+}
+
+DUAL_FILTER_TARGET("sse2")
+static bool changed_sse2(const uint32_t* timestamps, uint32_t length, const uint32_t* lanes, uint32_t version)
+{
+    const __m128i versionv = _mm_set1_epi32((int)version);
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t j = 0;
+    for (; j + 4 <= length; j += 4)
+    {
+        const uint32_t select = (lanes[j >> 5] >> (j & 31)) & 0xF;
+        if (!select)
+            continue;
+        const __m128i t = _mm_loadu_si128((const __m128i*)(timestamps + j));
+        const __m128i newer = _mm_cmpgt_epi32(_mm_sub_epi32(t, versionv), zero);
+        if ((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(newer)) & select)
+            return true;
+    }
+    return changed_scalar(timestamps, j, length, lanes, version);
+}
+
+DUAL_FILTER_TARGET("avx2")
+static EIndex find_avx2(const dual_mask_comp_t* masks, EIndex i, EIndex count, dual_mask_comp_t all, dual_mask_comp_t none, bool matched)
+{
+    const __m256i allv = _mm256_set1_epi32((int)all);
+    const __m256i nonev = _mm256_set1_epi32((int)none);
+    const __m256i zero = _mm256_setzero_si256();
+    const int flip = matched ? 0 : 0xFF;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i m = _mm256_loadu_si256((const __m256i*)(masks + i));
+        const __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(m, allv), allv), _mm256_cmpeq_epi32(_mm256_and_si256(m, nonev), zero));
+        const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(hit)) ^ flip;
+        if (bits)
+            return i + (EIndex)skr::CountTrailingZeros64((uint64_t)bits);
+    }
+    return find_sse2(masks, i, count, all, none, matched);
+}
+
+DUAL_FILTER_TARGET("avx2")
+static bool changed_avx2(const uint32_t* timestamps, uint32_t length, const uint32_t* lanes, uint32_t version)
+{
+    const __m256i versionv = _mm256_set1_epi32((int)version);
+    const __m256i zero = _mm256_setzero_si256();
+    uint32_t j = 0;
+    for (; j + 8 <= length; j += 8)
+    {
+        const uint32_t select = (lanes[j >> 5] >> (j & 31)) & 0xFF;
+        if (!select)
+            continue;
+        const __m256i t = _mm256_loadu_si256((const __m256i*)(timestamps + j));
+        const __m256i newer = _mm256_cmpgt_epi32(_mm256_sub_epi32(t, versionv), zero);
+        if ((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(newer)) & select)
+            return true;
+    }
+    return changed_scalar(timestamps, j, length, lanes, version);
+}
+
+DUAL_FILTER_TARGET("avx512f")
+static EIndex find_avx512(const dual_mask_comp_t* masks, EIndex i, EIndex count, dual_mask_comp_t all, dual_mask_comp_t none, bool matched)
+{
+    const __m512i allv = _mm512_set1_epi32((int)all);
+    const __m512i nonev = _mm512_set1_epi32((int)none);
+    const uint32_t flip = matched ? 0 : 0xFFFF;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m512i m = _mm512_loadu_si512((const void*)(masks + i));
+        const __mmask16 hit = _mm512_cmpeq_epi32_mask(_mm512_and_si512(m, allv), allv) & _mm512_testn_epi32_mask(m, nonev);
+        const uint32_t bits = (uint32_t)hit ^ flip;
+        if (bits)
+            return i + (EIndex)skr::CountTrailingZeros64((uint64_t)bits);
+    }
+    return find_avx2(masks, i, count, all, none, matched);
+}
+
+DUAL_FILTER_TARGET("avx512f")
+static bool changed_avx512(const uint32_t* timestamps, uint32_t length, const uint32_t* lanes, uint32_t version)
+{
+    const __m512i versionv = _mm512_set1_epi32((int)version);
+    const __m512i zero = _mm512_setzero_si512();
+    uint32_t j = 0;
+    for (; j + 16 <= length; j += 16)
+    {
+        const uint32_t select = (lanes[j >> 5] >> (j & 31)) & 0xFFFF;
+        if (!select)
+            continue;
+        const __m512i t = _mm512_loadu_si512((const void*)(timestamps + j));
+        if ((uint32_t)_mm512_cmpgt_epi32_mask(_mm512_sub_epi32(t, versionv), zero) & select)
+            return true;
+    }
+    return changed_scalar(timestamps, j, length, lanes, version);
+}
+#endif
+
+static const filter_kernels_t kScalarKernels = { DFI_SCALAR, &find_scalar, &changed_scalar };
+#if DUAL_FILTER_X86
+static const filter_kernels_t kSSE2Kernels = { DFI_SSE2, &find_sse2, &changed_sse2 };
+static const filter_kernels_t kAVX2Kernels = { DFI_AVX2, &find_avx2, &changed_avx2 };
+static const filter_kernels_t kAVX512Kernels = { DFI_AVX512, &find_avx512, &changed_avx512 };
+#endif
+
+static dual_filter_isa_t best_filter_isa()
+{
+#if DUAL_FILTER_X86
+    static const cpu_features::X86Features features = cpu_features::GetX86Info().features;
+    if (features.avx512f)
+        return DFI_AVX512;
+    if (features.avx2)
+        return DFI_AVX2;
+    if (features.sse2)
+        return DFI_SSE2;
+#endif
+    return DFI_SCALAR;
+}
+
+static const filter_kernels_t* filter_kernels_of(dual_filter_isa_t isa)
+{
+    switch (isa)
+    {
+#if DUAL_FILTER_X86
+        case DFI_AVX512:
+            return &kAVX512Kernels;
+        case DFI_AVX2:
+            return &kAVX2Kernels;
+        case DFI_SSE2:
+            return &kSSE2Kernels;
+#endif
+        default:
+            return &kScalarKernels;
+    }
+}
+
+static std::atomic<const filter_kernels_t*> gFilterKernels{ nullptr };
+
+const filter_kernels_t& get_filter_kernels()
+{
+    auto kernels = gFilterKernels.load(std::memory_order_acquire);
+    if (!kernels)
+    {
+        kernels = filter_kernels_of(best_filter_isa());
+        gFilterKernels.store(kernels, std::memory_order_release);
+    }
+    return *kernels;
+}
+
+bool get_changed_lanes(const dual_type_set_t& type, const dual_meta_filter_t& filter, uint32_t* lanes)
+{
+    std::fill(lanes, lanes + changed_lane_words(type), 0u);
+    bool any = false;
+    SIndex i = 0, j = 0;
+    const auto& changed = filter.changed;
+    while (i < changed.length && j < type.length)
+    {
+        if (changed.data[i] > type.data[j])
+            j++;
+        else if (changed.data[i] < type.data[j])
+            i++;
+        else
+        {
+            lanes[j >> 5] |= 1u << (j & 31);
+            any = true;
+            (j++, i++);
+        }
+    }
+    return any;
+}
+} // namespace dual
+
+extern "C" {
+dual_filter_isa_t dual_set_filter_isa(dual_filter_isa_t isa)
+{
+    using namespace dual;
+    const auto best = best_filter_isa();
+    if (isa == DFI_AUTO || isa > best)
+        isa = best;
+    gFilterKernels.store(filter_kernels_of(isa), std::memory_order_release);
+    return isa;
+}
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "SkrRT/ecs/dual.h"
+
+namespace dual
+{
+// per entity and per chunk filters of queries, picked at runtime for the best instruction set of the cpu
+struct filter_kernels_t {
+    dual_filter_isa_t isa;
+    // first index in [i, count) whose mask matches (mask & all) == all && (mask & none) == 0 exactly when matched is true, count if none
+    EIndex (*find)(const dual_mask_comp_t* masks, EIndex i, EIndex count, dual_mask_comp_t all, dual_mask_comp_t none, bool matched);
+    // whether any of the timestamps selected by the lanes bitset was written after version
+    bool (*changed)(const uint32_t* timestamps, uint32_t length, const uint32_t* lanes, uint32_t version);
+};
+
+const filter_kernels_t& get_filter_kernels();
+
+// lanes of the archetype timestamps watched by the changed filter, returns false if none of them is part of type
+bool get_changed_lanes(const dual_type_set_t& type, const dual_meta_filter_t& filter, uint32_t* lanes);
+inline uint32_t changed_lane_words(const dual_type_set_t& type) { return (type.length + 31) / 32; }
+} // namespace dual
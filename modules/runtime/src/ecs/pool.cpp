@@ -1,43 +1,533 @@
 #include "SkrRT/ecs/dual_config.h"
+#include "SkrRT/ecs/dual.h"
+#include "SkrRT/misc/log.h"
+#include "SkrRT/platform/debug.h"
 #include "pool.hpp"
 #include <EASTL/vector.h>
 #include <EASTL/numeric.h>
+#include <EASTL/algorithm.h>
+#include <string.h>
 #include "SkrProfile/profile.h"
 
+#if defined(SKR_OS_WINDOWS)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
 const char* kDualMemoryName = "dual";
 namespace dual
 {
-pool_t::pool_t(size_t blockSize, size_t blockCount)
+queue_pool_t::queue_pool_t(size_t blockSize, size_t blockCount)
     : blockSize(blockSize)
     , blocks(blockCount)
+    , allocations(0)
+    , deallocations(0)
+    , heapBlocks(0)
 {
 }
 
-pool_t::~pool_t()
+queue_pool_t::~queue_pool_t()
 {
     void* block;
     while (blocks.try_dequeue(block))
         dual_free(block);
 }
 
-void* pool_t::allocate()
+void* queue_pool_t::allocate()
 {
+    allocations.fetch_add(1, std::memory_order_relaxed);
     void* block;
     if (blocks.try_dequeue(block))
         return block;
     {
         SkrZoneScopedN("DualPoolAllocation");
+        heapBlocks.fetch_add(1, std::memory_order_relaxed);
         return dual_calloc(1, blockSize);
     }
 }
 
-void pool_t::free(void* block)
+void queue_pool_t::free(void* block)
 {
+    deallocations.fetch_add(1, std::memory_order_relaxed);
     if (blocks.try_enqueue(block))
         return;
+    heapBlocks.fetch_sub(1, std::memory_order_relaxed);
     dual_free(block);
 }
 
+void queue_pool_t::trim()
+{
+    void* block;
+    while (blocks.try_dequeue(block))
+    {
+        heapBlocks.fetch_sub(1, std::memory_order_relaxed);
+        dual_free(block);
+    }
+}
+
+void queue_pool_t::get_stats(dual_chunk_pool_stats_t* stats)
+{
+    memset(stats, 0, sizeof(dual_chunk_pool_stats_t));
+    stats->blockSize = blockSize;
+    stats->cachedBlocks = blocks.size_approx();
+    stats->heapBlocks = heapBlocks.load(std::memory_order_relaxed);
+    stats->allocations = allocations.load(std::memory_order_relaxed);
+    stats->deallocations = deallocations.load(std::memory_order_relaxed);
+}
+
+// a magazine of this many bytes is moved between a thread and the depot at once
+static constexpr size_t kMagazineBytes = 512 * 1024;
+static constexpr uint32_t kMinMagazineSize = 4;
+static constexpr uint32_t kMaxMagazineSize = 64;
+// the reservation is committed in steps of one huge page
+static constexpr size_t kCommitGranularity = 2 * 1024 * 1024;
+static constexpr uint32_t kMaxThreadPools = 4;
+
+// lives in the first bytes of a block while it is idle
+struct pool_block_t {
+    pool_block_t* next;
+    pool_block_t* nextChain;
+    uint32_t count;
+    // the pages behind the first one were handed back to the os by trim
+    uint32_t released;
+};
+
+struct pool_magazine_t {
+    std::atomic<uint32_t> count;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+    void* blocks[kMaxMagazineSize * 2];
+};
+
+// pools alive in this process, so exiting threads know whether the magazines they point to still exist
+struct pool_registry_t {
+    SMutexObject mutex;
+    eastl::vector<reserved_pool_t*> pools;
+    uint64_t nextId = 1;
+
+    static pool_registry_t& get()
+    {
+        static pool_registry_t registry;
+        return registry;
+    }
+
+    bool alive(reserved_pool_t* pool, uint64_t id) const
+    {
+        for (auto p : pools)
+            if (p == pool)
+                return p->id == id;
+        return false;
+    }
+};
+
+struct pool_thread_cache_t {
+    struct slot_t {
+        reserved_pool_t* pool = nullptr;
+        uint64_t id = 0;
+        pool_magazine_t* magazine = nullptr;
+    };
+    slot_t slots[kMaxThreadPools];
+
+    ~pool_thread_cache_t()
+    {
+        auto& registry = pool_registry_t::get();
+        SMutexLock lock(registry.mutex.mMutex);
+        for (auto& slot : slots)
+        {
+            if (slot.pool && registry.alive(slot.pool, slot.id))
+                slot.pool->retire_magazine(slot.magazine);
+            slot = slot_t();
+        }
+    }
+};
+static thread_local pool_thread_cache_t tPoolCache;
+
+static void* pool_reserve(size_t size)
+{
+#if defined(SKR_OS_WINDOWS)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+}
+
+static void pool_unreserve(void* ptr, size_t size)
+{
+#if defined(SKR_OS_WINDOWS)
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+static bool pool_commit(char* ptr, size_t size)
+{
+#if defined(SKR_OS_WINDOWS)
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    if (mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+        return false;
+    #if defined(MADV_HUGEPAGE)
+    // chunks are touched densely, let transparent huge pages back them to save tlb misses
+    madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
+    return true;
+#endif
+}
+
+static size_t pool_page_size()
+{
+#if defined(SKR_OS_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// hand the pages back. posix faults them in again zeroed on the next touch, windows decommits them so they no longer
+// count against the commit charge and take() has to commit them again
+static void pool_release(char* ptr, size_t size)
+{
+#if defined(SKR_OS_WINDOWS)
+    VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+    madvise(ptr, size, MADV_DONTNEED);
+#endif
+}
+
+reserved_pool_t::reserved_pool_t(size_t blockSize, size_t reserveCount)
+    : blockSize(blockSize)
+    , bump(0)
+    , committedBytes(0)
+    , depot(0)
+    , depotBlocks(0)
+    , releasedBytes(0)
+    , heapBlocks(0)
+    , allocations(0)
+    , deallocations(0)
+{
+    SKR_ASSERT(blockSize >= sizeof(pool_block_t));
+    magazineSize = (uint32_t)eastl::min<size_t>(eastl::max<size_t>(kMagazineBytes / blockSize, kMinMagazineSize), kMaxMagazineSize);
+    skr_init_mutex(&commitMutex);
+    skr_init_mutex(&magazineMutex);
+    // the address space may be limited, settle for less before giving up on the reservation
+    for (; reserveCount >= magazineSize; reserveCount /= 2)
+    {
+        // over reserve to align the base to the commit granularity, so huge pages can back it
+        const size_t size = reserveCount * blockSize;
+        const size_t mapped = size + kCommitGranularity;
+        if (auto ptr = (char*)pool_reserve(mapped))
+        {
+            base = (char*)(((uintptr_t)ptr + kCommitGranularity - 1) & ~(uintptr_t)(kCommitGranularity - 1));
+            mappedBytes = mapped;
+            reserveBytes = size;
+            this->reserveCount = reserveCount;
+            // keep the mapping base to unreserve it later
+            mapping = ptr;
+            break;
+        }
+    }
+    if (!base)
+        SKR_LOG_WARN(u8"dual chunk pool failed to reserve address space, blocks of size %d come from the heap", (int)blockSize);
+
+    auto& registry = pool_registry_t::get();
+    SMutexLock lock(registry.mutex.mMutex);
+    id = registry.nextId++;
+    registry.pools.push_back(this);
+}
+
+reserved_pool_t::~reserved_pool_t()
+{
+    {
+        auto& registry = pool_registry_t::get();
+        SMutexLock lock(registry.mutex.mMutex);
+        registry.pools.erase(eastl::find(registry.pools.begin(), registry.pools.end(), this));
+        for (auto magazine : magazines)
+            dual_free(magazine);
+        magazines.clear();
+    }
+    if (mapping)
+        pool_unreserve(mapping, mappedBytes);
+    skr_destroy_mutex(&commitMutex);
+    skr_destroy_mutex(&magazineMutex);
+}
+
+pool_magazine_t* reserved_pool_t::get_magazine()
+{
+    auto& cache = tPoolCache;
+    for (auto& slot : cache.slots)
+        if (slot.pool == this && slot.id == id)
+            return slot.magazine;
+    {
+        // first use of this pool on this thread, take a slot that is empty or belongs to a dead pool
+        auto& registry = pool_registry_t::get();
+        SMutexLock lock(registry.mutex.mMutex);
+        for (auto& slot : cache.slots)
+        {
+            if (slot.pool && registry.alive(slot.pool, slot.id))
+                continue;
+            auto magazine = (pool_magazine_t*)dual_calloc(1, sizeof(pool_magazine_t));
+            new (magazine) pool_magazine_t();
+            {
+                SMutexLock magazineLock(magazineMutex);
+                magazines.push_back(magazine);
+            }
+            slot = { this, id, magazine };
+            return magazine;
+        }
+    }
+    return nullptr;
+}
+
+void reserved_pool_t::retire_magazine(pool_magazine_t* magazine)
+{
+    flush(magazine, magazine->count.load(std::memory_order_relaxed));
+    SMutexLock lock(magazineMutex);
+    allocations.fetch_add(magazine->allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    deallocations.fetch_add(magazine->deallocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    magazines.erase(eastl::find(magazines.begin(), magazines.end(), magazine));
+    dual_free(magazine);
+}
+
+bool reserved_pool_t::commit(size_t end)
+{
+    SkrZoneScopedN("DualPoolCommit");
+    SMutexLock lock(commitMutex);
+    const size_t committed = committedBytes.load(std::memory_order_relaxed);
+    if (committed >= end)
+        return true;
+    const size_t newEnd = eastl::min((end + kCommitGranularity - 1) & ~(kCommitGranularity - 1), reserveBytes);
+    if (!pool_commit(base + committed, newEnd - committed))
+    {
+        SKR_LOG_ERROR(u8"dual chunk pool failed to commit %d bytes", (int)(newEnd - committed));
+        return false;
+    }
+    committedBytes.store(newEnd, std::memory_order_release);
+    return true;
+}
+
+uint32_t reserved_pool_t::carve(void** blocks, uint32_t count)
+{
+    if (!base || bump.load(std::memory_order_relaxed) >= reserveCount)
+        return 0;
+    const uint64_t first = bump.fetch_add(count, std::memory_order_relaxed);
+    if (first >= reserveCount)
+        return 0;
+    const uint64_t last = eastl::min<uint64_t>(first + count, reserveCount);
+    if (committedBytes.load(std::memory_order_acquire) < last * blockSize && !commit(last * blockSize))
+        return 0;
+    for (uint64_t i = first; i < last; ++i)
+        *blocks++ = base + i * blockSize;
+    return (uint32_t)(last - first);
+}
+
+void reserved_pool_t::push_chain(pool_block_t* head, uint32_t count)
+{
+    head->count = count;
+    const uint64_t index = index_of(head);
+    uint64_t top = depot.load(std::memory_order_relaxed);
+    do
+    {
+        head->nextChain = (top & 0xFFFFFFFF) ? block_at(top & 0xFFFFFFFF) : nullptr;
+    } while (!depot.compare_exchange_weak(top, (((top >> 32) + 1) << 32) | index, std::memory_order_release, std::memory_order_relaxed));
+    depotBlocks.fetch_add(count, std::memory_order_relaxed);
+}
+
+pool_block_t* reserved_pool_t::pop_chain()
+{
+    uint64_t top = depot.load(std::memory_order_acquire);
+    pool_block_t* head;
+    do
+    {
+        if (!(top & 0xFFFFFFFF))
+            return nullptr;
+        head = block_at(top & 0xFFFFFFFF);
+        // may read a block another thread just took, the tag makes the exchange fail then.
+        // blocks are never decommitted so the read itself is always safe
+        const uint64_t next = index_of(head->nextChain);
+        if (depot.compare_exchange_weak(top, (((top >> 32) + 1) << 32) | next, std::memory_order_acquire, std::memory_order_acquire))
+            break;
+    } while (true);
+    depotBlocks.fetch_sub(head->count, std::memory_order_relaxed);
+    return head;
+}
+
+void reserved_pool_t::refill(pool_magazine_t* magazine)
+{
+    uint32_t count = 0;
+    if (auto chain = pop_chain())
+    {
+        for (auto block = chain; block; block = block->next)
+            magazine->blocks[count++] = block;
+    }
+    else
+        count = carve(magazine->blocks, magazineSize);
+    magazine->count.store(count, std::memory_order_relaxed);
+}
+
+void reserved_pool_t::flush(pool_magazine_t* magazine, uint32_t count)
+{
+    if (count == 0)
+        return;
+    // hand the oldest blocks over, the recently freed ones are more likely to be in cache
+    auto blocks = magazine->blocks;
+    for (uint32_t i = 0; i + 1 < count; ++i)
+        ((pool_block_t*)blocks[i])->next = (pool_block_t*)blocks[i + 1];
+    ((pool_block_t*)blocks[count - 1])->next = nullptr;
+    push_chain((pool_block_t*)blocks[0], count);
+    const uint32_t remain = magazine->count.load(std::memory_order_relaxed) - count;
+    memmove(blocks, blocks + count, remain * sizeof(void*));
+    magazine->count.store(remain, std::memory_order_relaxed);
+}
+
+void* reserved_pool_t::take(void* block)
+{
+    static const size_t pageSize = pool_page_size();
+    auto header = (pool_block_t*)block;
+    if (header->released)
+    {
+#if defined(SKR_OS_WINDOWS)
+        if (!pool_commit((char*)block + pageSize, blockSize - pageSize))
+        {
+            // still released, it goes back to the depot and the caller falls back to the heap
+            SKR_LOG_ERROR(u8"dual chunk pool failed to recommit a trimmed block of %d bytes", (int)blockSize);
+            header->next = nullptr;
+            push_chain(header, 1);
+            return nullptr;
+        }
+#endif
+        header->released = 0;
+        releasedBytes.fetch_sub(blockSize - pageSize, std::memory_order_relaxed);
+    }
+    return block;
+}
+
+void* reserved_pool_t::allocate()
+{
+    if (auto magazine = get_magazine())
+    {
+        uint32_t count = magazine->count.load(std::memory_order_relaxed);
+        if (count == 0)
+        {
+            refill(magazine);
+            count = magazine->count.load(std::memory_order_relaxed);
+        }
+        magazine->allocations.store(magazine->allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (count)
+        {
+            magazine->count.store(count - 1, std::memory_order_relaxed);
+            if (auto taken = take(magazine->blocks[count - 1]))
+                return taken;
+        }
+    }
+    else
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (auto chain = pop_chain())
+        {
+            if (chain->next)
+                push_chain(chain->next, chain->count - 1);
+            if (auto taken = take(chain))
+                return taken;
+        }
+        void* block;
+        if (carve(&block, 1))
+            return block;
+    }
+    {
+        SkrZoneScopedN("DualPoolAllocation");
+        heapBlocks.fetch_add(1, std::memory_order_relaxed);
+        return dual_calloc(1, blockSize);
+    }
+}
+
+void reserved_pool_t::free(void* block)
+{
+    if (!owns(block))
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        heapBlocks.fetch_sub(1, std::memory_order_relaxed);
+        dual_free(block);
+        return;
+    }
+    auto header = (pool_block_t*)block;
+    header->released = 0;
+    if (auto magazine = get_magazine())
+    {
+        magazine->deallocations.store(magazine->deallocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        const uint32_t count = magazine->count.load(std::memory_order_relaxed);
+        if (count == magazineSize * 2)
+            flush(magazine, magazineSize);
+        const uint32_t remain = magazine->count.load(std::memory_order_relaxed);
+        magazine->blocks[remain] = block;
+        magazine->count.store(remain + 1, std::memory_order_relaxed);
+    }
+    else
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        header->next = nullptr;
+        push_chain(header, 1);
+    }
+}
+
+void reserved_pool_t::trim()
+{
+    SkrZoneScopedN("DualPoolTrim");
+    const size_t pageSize = pool_page_size();
+    if (!base || blockSize < pageSize * 2)
+        return;
+    // take the whole depot, threads running dry meanwhile carve or fall back to the heap
+    uint64_t top = depot.load(std::memory_order_acquire);
+    while (!depot.compare_exchange_weak(top, ((top >> 32) + 1) << 32, std::memory_order_acquire, std::memory_order_relaxed))
+        ;
+    pool_block_t* chain = (top & 0xFFFFFFFF) ? block_at(top & 0xFFFFFFFF) : nullptr;
+    while (chain)
+    {
+        auto nextChain = chain->nextChain;
+        const uint32_t count = chain->count;
+        depotBlocks.fetch_sub(count, std::memory_order_relaxed);
+        // the first page keeps the links of the idle block
+        for (auto block = chain; block; block = block->next)
+        {
+            if (block->released)
+                continue;
+            pool_release((char*)block + pageSize, blockSize - pageSize);
+            block->released = 1;
+            releasedBytes.fetch_add(blockSize - pageSize, std::memory_order_relaxed);
+        }
+        push_chain(chain, count);
+        chain = nextChain;
+    }
+}
+
+void reserved_pool_t::get_stats(dual_chunk_pool_stats_t* stats)
+{
+    memset(stats, 0, sizeof(dual_chunk_pool_stats_t));
+    stats->blockSize = blockSize;
+    stats->reservedBytes = reserveBytes;
+    stats->committedBytes = committedBytes.load(std::memory_order_relaxed);
+    stats->releasedBytes = releasedBytes.load(std::memory_order_relaxed);
+    stats->cachedBlocks = depotBlocks.load(std::memory_order_relaxed);
+    stats->heapBlocks = heapBlocks.load(std::memory_order_relaxed);
+    stats->allocations = allocations.load(std::memory_order_relaxed);
+    stats->deallocations = deallocations.load(std::memory_order_relaxed);
+    SMutexLock lock(magazineMutex);
+    for (auto magazine : magazines)
+    {
+        stats->cachedBlocks += magazine->count.load(std::memory_order_relaxed);
+        stats->allocations += magazine->allocations.load(std::memory_order_relaxed);
+        stats->deallocations += magazine->deallocations.load(std::memory_order_relaxed);
+    }
+}
+
 fixed_pool_t::fixed_pool_t(size_t blockSize, size_t blockCount)
     : blockSize(blockSize)
     , blockCount(blockCount)
@@ -1,24 +1,16 @@
 #pragma once
-#include "SkrRT/containers/concurrent_queue.h"
+#include "SkrRT/ecs/chunk_pool.hpp"
+
+// build with DUAL_LEGACY_CHUNK_POOL to route chunks through the old queue pool, e.g. to compare both in benchmarks
+// #define DUAL_LEGACY_CHUNK_POOL
 
 namespace dual
 {
-    
-struct ECSPoolConcurrentQueueTraits : public skr::ConcurrentQueueDefaultTraits
-{
-    static constexpr const char* kECSPoolQueueName = "ECSPool";
-    static const bool RECYCLE_ALLOCATED_BLOCKS = true;
-    static inline void* malloc(size_t size) { return sakura_mallocN(size, kECSPoolQueueName); }
-    static inline void free(void* ptr) { return sakura_freeN(ptr, kECSPoolQueueName); }
-};
-struct pool_t {
-    size_t blockSize;
-    skr::ConcurrentQueue<void*, ECSPoolConcurrentQueueTraits> blocks;
-    pool_t(size_t blockSize, size_t blockCount);
-    ~pool_t();
-    void* allocate();
-    void free(void* block);
-};
+#ifdef DUAL_LEGACY_CHUNK_POOL
+using pool_t = queue_pool_t;
+#else
+using pool_t = reserved_pool_t;
+#endif
 
 pool_t& get_default_pool();
 pool_t& get_default_pool_small();
@@ -35,4 +27,4 @@ struct fixed_pool_t {
     void free(void* block);
     void reset();
 };
-} // namespace dual
\ No newline at end of file
+} // namespace dual
@@ -7,6 +7,7 @@
 #include "chunk.hpp"
 #include "query.hpp"
 #include "stack.hpp"
+#include "filter.hpp"
 #include "storage.hpp"
 #include "type.hpp"
 
@@ -18,9 +19,6 @@
 #include "SkrRT/misc/bits.hpp"
 #include "scheduler.hpp"
 #include "SkrRT/containers/span.hpp"
-#if __SSE2__
-    #include <emmintrin.h>
-#endif
 
 #include "SkrProfile/profile.h"
 
@@ -74,26 +72,6 @@ bool match_group_shared(const dual_type_set_t& shared, const dual_filter_t& filt
     return match_filter_set<dual_type_index_t>(shared, filter.all_shared, filter.none_shared, false);
 }
 
-bool match_chunk_changed(const dual_type_set_t& type, uint32_t* timestamp, const dual_meta_filter_t& filter)
-{
-    uint16_t i = 0, j = 0;
-    auto& changed = filter.changed;
-    if (changed.length == 0)
-        return true;
-    while (i < changed.length && j < type.length)
-    {
-        if (changed.data[i] > type.data[j])
-            j++;
-        else if (changed.data[i] < type.data[j])
-            i++;
-        else if (timestamp[j] - filter.timestamp > 0)
-            return true;
-        else
-            (j++, i++);
-    }
-    return false;
-}
-
 bool match_group_meta(const dual_entity_type_t& type, const dual_meta_filter_t& filter)
 {
     return match_filter_set<dual_entity_t>(type.meta, filter.all_meta, filter.none_meta, false);
@@ -764,125 +742,50 @@ bool dual_storage_t::match_group(const dual_filter_t& filter, const dual_meta_fi
 void dual_storage_t::query(const dual_group_t* group, const dual_filter_t& filter, const dual_meta_filter_t& meta, dual_view_callback_t callback, void* u)
 {
     using namespace dual;
+    const auto& kernels = get_filter_kernels();
+    // the changed filter is resolved to timestamp lanes once per group
+    fixed_stack_scope_t _(localStack);
+    const auto& type = group->archetype->type;
+    uint32_t* lanes = nullptr;
+    if (meta.changed.length > 0)
+    {
+        lanes = localStack.allocate<uint32_t>(changed_lane_words(type));
+        if (!get_changed_lanes(type, meta, lanes))
+            return;
+    }
+    auto changed = [&](dual_chunk_t* c) {
+        return !lanes || kernels.changed(c->timestamps(), type.length, lanes, (uint32_t)meta.timestamp);
+    };
     if (!group->archetype->withMask)
     {
-        for(auto c : group->chunks)
+        for (auto c : group->chunks)
         {
-            if (match_chunk_changed(c->type->type, c->timestamps(), meta))
+            if (changed(c))
             {
                 dual_chunk_view_t view{ c, (EIndex)0, c->count };
                 callback(u, &view);
             }
         }
+        return;
     }
-    else
+    const auto allmask = group->get_mask(filter.all);
+    const auto nonemask = group->get_mask(filter.none);
+    for (auto c : group->chunks)
     {
-
-        auto allmask = group->get_mask(filter.all);
-        auto nonemask = group->get_mask(filter.none);
-        // todo:benchmark this
-#if __SSE2__
-        if (nonemask == 0) // fastpath
+        if (!changed(c))
+            continue;
+        const EIndex count = c->count;
+        dual_chunk_view_t view = { c, 0, count };
+        auto masks = (const dual_mask_comp_t*)dualV_get_owned_ro(&view, kMaskComponent);
+        // emit the runs of matching entities
+        EIndex i = kernels.find(masks, 0, count, allmask, nonemask, true);
+        while (i < count)
         {
-            __m128i allmask_128 = _mm_set1_epi32(allmask);
-            for(auto c : group->chunks)
-            {
-                if (!match_chunk_changed(c->type->type, c->timestamps(), meta))
-                {
-                    continue;
-                }
-                auto count = c->count;
-                dual_chunk_view_t view = { c, 0, c->count };
-                auto masks = (dual_mask_comp_t*)dualV_get_owned_ro(&view, kMaskComponent);
-                EIndex i = 0;
-                while (i < count)
-                {
-                    while (i < count && !((masks[i] & allmask) == allmask) && i % 4 != 0)
-                        ++i;
-                    if (i % 4 == 0)
-                    {
-                        while (i < count - 4)
-                        {
-                            __m128i m = _mm_load_si128((__m128i*)(masks + i));
-                            m = _mm_and_si128(allmask_128, m);
-                            uint16_t cmp = _mm_movemask_epi8(_mm_cmpeq_epi32(m, allmask_128));
-                            if (cmp == 0)
-                            {
-                                i += 4;
-                                continue;
-                            }
-                            else
-                            {
-                                unsigned long index = skr::CountLeadingZeros64(cmp);
-                                i += index / 4;
-                                break;
-                            }
-                        }
-                        if (i >= count - 4)
-                            while (i < count && !((masks[i] & allmask) == allmask))
-                                ++i;
-                    }
-                    view.start = i;
-
-                    while (i < count && (masks[i] & allmask) == allmask && i % 4 != 0)
-                        ++i;
-                    if (i % 4 == 0)
-                    {
-                        while (i < count - 4)
-                        {
-                            __m128i m = _mm_load_si128((__m128i*)(masks + i));
-                            m = _mm_and_si128(allmask_128, m);
-                            uint16_t cmp = _mm_movemask_epi8(_mm_cmpeq_epi32(m, allmask_128));
-                            if (cmp == 0xFFFF)
-                            {
-                                i += 4;
-                                continue;
-                            }
-                            else
-                            {
-                                unsigned long index = skr::CountLeadingZeros64((~cmp) & 0xFFFF);
-                                i += index / 4;
-                                break;
-                            }
-                        }
-                        if (i >= count - 4)
-                            while (i < count && ((masks[i] & allmask) == allmask))
-                                ++i;
-                    }
-                    view.count = i - view.start;
-                    if (view.count > 0)
-                        callback(u, &view);
-                }
-            }
-        }
-        else
-#endif
-        { // todo: should we simd this snipest too
-            auto match = [&](dual_mask_comp_t mask) {
-                return (mask & allmask) == allmask && (mask & nonemask) == 0;
-            };
-            for(auto c : group->chunks)
-            {
-                if (!match_chunk_changed(c->type->type, c->timestamps(), meta))
-                {
-                    continue;
-                }
-                auto count = c->count;
-                dual_chunk_view_t view = { c, 0, c->count };
-                auto masks = (dual_mask_comp_t*)dualV_get_owned_ro(&view, kMaskComponent);
-                EIndex i = 0;
-                while (i < count)
-                {
-                    while (i < count && !match(masks[i]))
-                        ++i;
-                    view.start = i;
-                    while (i < count && match(masks[i]))
-                        ++i;
-                    view.count = i - view.start;
-                    if (view.count > 0)
-                        callback(u, &view);
-                }
-            }
+            const EIndex end = kernels.find(masks, i, count, allmask, nonemask, false);
+            view.start = i;
+            view.count = end - i;
+            callback(u, &view);
+            i = kernels.find(masks, end, count, allmask, nonemask, true);
         }
     }
 }
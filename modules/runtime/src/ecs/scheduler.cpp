@@ -5,6 +5,7 @@
 #include "query.hpp"
 #include "storage.hpp"
 #include "scheduler.hpp"
+#include "SkrRT/platform/time.h"
 #include <EASTL/bitset.h>
 
 #include "SkrProfile/profile.h"
@@ -693,6 +694,61 @@ eastl::vector<skr::task::weak_event_t> dual::scheduler_t::update_dependencies(du
     return result;
 }
 
+skr::task::event_t dual::scheduler_t::schedule_defragment(dual_storage_t* storage, const dual_defragment_budget_t& budget)
+{
+    SkrZoneScopedN("SchedualDefragmentJob");
+    SKR_ASSERT(is_main_thread(storage));
+    eastl::vector<defragment_plan_t> plan;
+    storage->plan_defragment(budget.maxBytes, plan);
+    if (plan.empty())
+        return nullptr;
+
+    skr::task::event_t result;
+    DependencySet dependencies;
+    {
+        // moving entities rewrites every component of the archetype, so the job owns all of its entries
+        skr::flat_hash_set<dual::archetype_t*> synced;
+        SMutexLock entryLock(entryMutex.mMutex);
+        for (auto& p : plan)
+        {
+            auto at = p.group->archetype;
+            if (!synced.insert(at).second)
+                continue;
+            auto iter = dependencyEntries.find(at);
+            if (iter == dependencyEntries.end())
+            {
+                eastl::vector<job_dependency_entry_t> entries(at->type.length);
+                iter = dependencyEntries.insert(std::make_pair(at, std::move(entries))).first;
+            }
+            for (auto& entry : (*iter).second)
+                update_entry(entry, result, false, false, dependencies);
+        }
+    }
+    eastl::vector<skr::task::weak_event_t> deps;
+    for (auto& dependency : dependencies)
+        deps.push_back(dependency);
+    {
+        SkrZoneScopedN("AllocateCounter");
+        allCounter.add(1);
+        storage->counter.add(1);
+    }
+    const int64_t maxMicroseconds = (int64_t)budget.maxMicroseconds;
+    skr::task::schedule([deps = std::move(deps), this, storage, plan = std::move(plan), maxMicroseconds]()
+    {
+        for(auto dep : deps)
+            if(auto d = dep.lock())
+                d.wait(false);
+        SKR_DEFER({
+            allCounter.decrement();
+            storage->counter.decrement();
+        });
+        // the time budget starts once the job actually runs
+        const int64_t deadline = maxMicroseconds ? skr_sys_get_usec(true) + maxMicroseconds : 0;
+        storage->run_defragment(plan.data(), (uint32_t)plan.size(), deadline);
+    }, &result);
+    return result;
+}
+
 eastl::vector<skr::task::event_t> dual::scheduler_t::sync_resources(const skr::task::event_t& counter, dual_resource_operation_t* resources)
 {
     DependencySet dependencies;
@@ -740,6 +796,126 @@ dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown,
     return !!c;
 }
 
+void dualQ_parallel_for(dual_query_t* query, EIndex batchSize, dual_system_callback_t callback, void* u)
+{
+    using namespace dual;
+    SkrZoneScopedN("dualQ::parallel_for");
+    auto storage = query->storage;
+    if (!storage->scheduler || storage->scheduler->is_main_thread(storage))
+        storage->build_queries();
+    else
+        SKR_ASSERT(storage->queriesBuilt);
+
+    auto& params = query->parameters;
+    SKR_ASSERT(params.length < 32);
+    llvm_vecsmall::SmallVector<dual_group_t*, 64> groups;
+    auto add_group = [&](dual_group_t* group) {
+        groups.push_back(group);
+    };
+    storage->query_groups(query, DUAL_LAMBDA(add_group));
+    if (groups.empty())
+        return;
+
+    // same splitting rules as dualJ_schedule_ecs: random writes serialize the whole query,
+    // written chunk components keep a chunk inside one task
+    const auto groupCount = (uint32_t)groups.size();
+    eastl::vector<dual_type_index_t> localTypes(groupCount * params.length);
+    bool hasRandomWrite = !query->subqueries.empty();
+    bool hasWriteChunkComponent = false;
+    EIndex entityCount = 0;
+    forloop (i, 0, groupCount)
+    {
+        entityCount += groups[i]->size;
+        forloop (j, 0, params.length)
+        {
+            auto t = type_index_t(params.types[j]);
+            auto& op = params.accesses[j];
+            localTypes[i * params.length + j] = groups[i]->index(params.types[j]);
+            hasRandomWrite |= op.randomAccess != DOS_SEQ && !op.readonly;
+            hasWriteChunkComponent |= t.is_chunk() && !op.readonly && !op.atomic;
+        }
+    }
+    if (hasRandomWrite || batchSize == 0 || entityCount <= batchSize)
+    {
+        EIndex startIndex = 0;
+        forloop (i, 0, groupCount)
+        {
+            auto processView = [&](dual_chunk_view_t* view) {
+                callback(u, query, view, localTypes.data() + i * params.length, startIndex);
+                startIndex += view->count;
+            };
+            storage->query(groups[i], query->filter, query->meta, DUAL_LAMBDA(processView));
+        }
+        return;
+    }
+
+    struct task_t {
+        uint32_t groupIndex;
+        EIndex startIndex;
+        dual_chunk_view_t view;
+    };
+    eastl::vector<task_t> tasks;
+    eastl::vector<uint32_t> batchEnds;
+    {
+        SkrZoneScopedN("Batching");
+        tasks.reserve(entityCount / batchSize + groupCount);
+        batchEnds.reserve(entityCount / batchSize + 1);
+        EIndex batchRemain = batchSize;
+        EIndex startIndex = 0;
+        forloop (i, 0, groupCount)
+        {
+            auto batchView = [&](dual_chunk_view_t* view) {
+                EIndex allocated = 0;
+                while (allocated != view->count)
+                {
+                    const EIndex count = hasWriteChunkComponent ? view->count : std::min(view->count - allocated, batchRemain);
+                    tasks.push_back(task_t{ i, startIndex, dual_chunk_view_t{ view->chunk, view->start + allocated, count } });
+                    allocated += count;
+                    startIndex += count;
+                    batchRemain -= std::min(batchRemain, count);
+                    if (batchRemain == 0)
+                    {
+                        batchEnds.push_back((uint32_t)tasks.size());
+                        batchRemain = batchSize;
+                    }
+                }
+            };
+            storage->query(groups[i], query->filter, query->meta, DUAL_LAMBDA(batchView));
+        }
+        if (batchEnds.empty() || batchEnds.back() != tasks.size())
+            batchEnds.push_back((uint32_t)tasks.size());
+    }
+
+    auto runBatch = [&](uint32_t batchIndex) {
+        const uint32_t begin = batchIndex == 0 ? 0 : batchEnds[batchIndex - 1];
+        forloop (i, begin, batchEnds[batchIndex])
+        {
+            auto& task = tasks[i];
+            callback(u, query, &task.view, localTypes.data() + task.groupIndex * params.length, task.startIndex);
+        }
+    };
+    const auto batchCount = (uint32_t)batchEnds.size();
+    if (batchCount > 1)
+    {
+        skr::task::counter_t counter;
+        counter.add(batchCount - 1);
+        forloop (i, 1, batchCount)
+        {
+            skr::task::schedule([&runBatch, counter, i]() mutable
+            {
+                SKR_DEFER({ counter.decrement(); });
+                runBatch(i);
+            }, nullptr);
+        }
+        runBatch(0);
+        counter.wait(true);
+    }
+    else
+    {
+        runBatch(0);
+    }
+}
+
 void dualJ_schedule_custom(dual_query_t* query, dual_schedule_callback_t callback, void* u,
 dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown, dual_resource_operation_t* resources, skr::task::event_t* counter)
 {
@@ -751,6 +927,15 @@ dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown,
     }
 }
 
+bool dualJ_schedule_defragment(dual_storage_t* storage, const dual_defragment_budget_t* budget, skr::task::event_t* counter)
+{
+    SkrZoneScopedN("dualJ::schedule_defragment");
+    auto c = dual::scheduler_t::get().schedule_defragment(storage, *budget);
+    if (counter)
+        *counter = c;
+    return (bool)c;
+}
+
 void dualJ_wait_all()
 {
     dual::scheduler_t::get().sync_all();
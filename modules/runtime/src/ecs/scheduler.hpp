@@ -42,6 +42,7 @@ struct scheduler_t {
     skr::task::event_t schedule_ecs_job(dual_query_t* query, EIndex batchSize, dual_system_callback_t callback, void* u, dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown, dual_resource_operation_t* resources);
     eastl::vector<skr::task::weak_event_t> update_dependencies(dual_query_t* query, const skr::task::event_t& counter, dual_resource_operation_t* resources);
     skr::task::event_t schedule_job(dual_query_t* query, dual_schedule_callback_t callback, void* u, dual_system_lifetime_callback_t init, dual_system_lifetime_callback_t teardown, dual_resource_operation_t* resources);
+    skr::task::event_t schedule_defragment(dual_storage_t* storage, const dual_defragment_budget_t& budget);
     eastl::vector<skr::task::event_t> sync_resources(const skr::task::event_t& counter, dual_resource_operation_t* resources);
 };
 } // namespace dual
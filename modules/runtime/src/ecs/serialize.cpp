@@ -14,17 +14,7 @@
 
 #include "SkrProfile/profile.h"
 
-template<class T>
-static void ArchiveBuffer(skr_binary_writer_t* writer, const T* buffer, uint32_t count)
-{
-    skr::binary::WriteBytes(writer, (const void*)buffer, sizeof(T) * count);
-}
-
-template<class T>
-static void ArchiveBuffer(skr_binary_reader_t* reader, T* buffer, uint32_t count)
-{
-    skr::binary::ReadBytes(reader, (void*)buffer, sizeof(T) * count);
-}
+using skr::binary::ArchiveBuffer;
 
 static void serialize_impl(const dual_chunk_view_t& view, dual_type_index_t type, EIndex offset, uint32_t size, uint32_t elemSize, skr_binary_writer_t* s, skr_binary_reader_t* ds
 , void (*serialize)(dual_chunk_t* chunk, EIndex index, char* data, EIndex count, skr_binary_writer_t* writer)
@@ -119,7 +109,7 @@ void dual_storage_t::serialize_view(dual_group_t* group, dual_chunk_view_t& view
         if(s)
             ArchiveBuffer(s, view.chunk->get_entities() + view.start, view.count);
         else
-            ArchiveBuffer(ds, view.chunk->get_entities() + view.start, view.count);
+            ArchiveBuffer(ds, (dual_entity_t*)view.chunk->get_entities() + view.start, view.count);
     }
     for (SIndex i = 0; i < type->firstChunkComponent; ++i)
         serialize_impl(view, type->type.data[i], offsets[i], sizes[i], elemSizes[i], s, ds, type->callbacks[i].serialize, type->callbacks[i].deserialize);
@@ -266,9 +256,12 @@ void dual_storage_t::serialize(skr_binary_writer_t* s)
     }
     {
         SkrZoneScopedN("serialize entities");
+        // collecting the free list hands unused reserved ids back, which could shrink the entries
+        eastl::vector<EIndex> freeEntries;
+        entities.get_free_entries(freeEntries);
         bin::Archive(s, (uint32_t)entities.entries.size());
-        bin::Archive(s, (uint32_t)entities.freeEntries.size());
-        ArchiveBuffer(s, entities.freeEntries.data(), static_cast<uint32_t>(entities.freeEntries.size()));
+        bin::Archive(s, (uint32_t)freeEntries.size());
+        ArchiveBuffer(s, freeEntries.data(), static_cast<uint32_t>(freeEntries.size()));
     }
     bin::Archive(s, (uint32_t)groups.size());
     for (auto& pair : groups)
@@ -303,8 +296,10 @@ void dual_storage_t::deserialize(skr_binary_reader_t* s)
     entities.entries.resize(size);
     uint32_t freeSize = 0;
     bin::Archive(s, freeSize);
-    entities.freeEntries.resize(freeSize);
-    ArchiveBuffer(s, entities.freeEntries.data(), freeSize);
+    eastl::vector<EIndex> freeEntries;
+    freeEntries.resize(freeSize);
+    ArchiveBuffer(s, freeEntries.data(), freeSize);
+    entities.set_free_entries(freeEntries.data(), freeSize);
     uint32_t groupSize = 0;
     bin::Archive(s, groupSize);
     forloop (i, 0, groupSize)
@@ -4,6 +4,7 @@
 #include "SkrRT/ecs/entity.hpp"
 #include "SkrRT/ecs/set.hpp"
 #include "SkrRT/misc/parallel_for.hpp"
+#include "SkrRT/platform/time.h"
 #include "query.hpp"
 #include "storage.hpp"
 #include "pool.hpp"
@@ -12,11 +13,13 @@
 #include "scheduler.hpp"
 #include "iterator_ref.hpp"
 #include "type_registry.hpp"
+#include "SkrProfile/profile.h"
 
 dual_storage_t::dual_storage_t()
     : archetypeArena(dual::get_default_pool())
     , queryBuildArena(dual::get_default_pool())
     , groupPool(dual::kGroupBlockSize, dual::kGroupBlockCount)
+    , timestamp(0)
     , scheduler(nullptr)
 {
 }
@@ -127,7 +130,9 @@ void dual_storage_t::free(const dual_chunk_view_t& view)
 
 void dual_storage_t::structural_change(dual_group_t* group, dual_chunk_t* chunk)
 {
-    // todo: timestamp
+    // entities moved in or out, every component of the chunk counts as written
+    auto timestamps = chunk->timestamps();
+    std::fill(timestamps, timestamps + group->archetype->type.length, timestamp);
 }
 
 void dual_storage_t::linked_to_prefab(const dual_entity_t* src, uint32_t size, bool keepExternal)
@@ -411,6 +416,7 @@ void dual_storage_t::defragment()
                 entities.move_entities({ chunk, chunk->count, moveCount }, source, source->count - moveCount);
                 source->count -= moveCount;
                 chunk->count += moveCount;
+                structural_change(g, chunk);
                 if (source->count == 0)
                 {
                     destruct_chunk(source);
@@ -442,6 +448,117 @@ void dual_storage_t::defragment()
     }
 }
 
+namespace dual
+{
+// full chunks are kept in front of firstFree, compaction needs at least two chunks with free slots.
+// chunk components are per chunk state, moving entities across chunks would change their meaning
+static bool is_fragmented(const dual_group_t* group)
+{
+    return group->chunks.size() >= group->firstFree + 2 && !group->archetype->with_chunk_component();
+}
+} // namespace dual
+
+bool dual_storage_t::plan_defragment(uint64_t maxBytes, eastl::vector<dual::defragment_plan_t>& plan)
+{
+    using namespace dual;
+    struct candidate_t {
+        dual_group_t* group;
+        uint64_t wastedBytes;
+        uint64_t movableBytes;
+    };
+    eastl::vector<candidate_t> candidates;
+    for (auto& pair : groups)
+    {
+        auto g = pair.second;
+        if (!is_fragmented(g))
+            continue;
+        uint64_t freeSlots = 0;
+        uint64_t movable = 0;
+        EIndex fullest = 0;
+        for (uint32_t i = g->firstFree; i < (uint32_t)g->chunks.size(); ++i)
+        {
+            auto chunk = g->chunks[i];
+            freeSlots += chunk->get_capacity() - chunk->count;
+            movable += chunk->count;
+            fullest = std::max(fullest, chunk->count);
+        }
+        // the fullest chunk only ever receives entities
+        const uint64_t entitySize = g->archetype->entitySize;
+        candidates.push_back({ g, freeSlots * entitySize, (movable - fullest) * entitySize });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const candidate_t& lhs, const candidate_t& rhs) {
+        return lhs.wastedBytes > rhs.wastedBytes;
+    });
+    uint64_t remain = maxBytes ? maxBytes : UINT64_MAX;
+    uint32_t i = 0;
+    for (; i < (uint32_t)candidates.size() && remain > 0; ++i)
+    {
+        const uint64_t bytes = std::min(candidates[i].movableBytes, remain);
+        plan.push_back({ candidates[i].group, bytes });
+        remain -= bytes;
+    }
+    return i < (uint32_t)candidates.size();
+}
+
+bool dual_storage_t::compact_group(dual_group_t* g, uint64_t maxBytes, int64_t deadline)
+{
+    using namespace dual;
+    SkrZoneScopedN("DualCompactGroup");
+    const uint64_t entitySize = g->archetype->entitySize;
+    uint64_t moved = 0;
+    while (is_fragmented(g))
+    {
+        if (moved >= maxBytes || (deadline && skr_sys_get_usec(true) >= deadline))
+            return true;
+        // drain the emptiest chunk into the fullest one, every step fills or frees a chunk
+        dual_chunk_t* src = nullptr;
+        dual_chunk_t* dst = nullptr;
+        for (uint32_t i = g->firstFree; i < (uint32_t)g->chunks.size(); ++i)
+        {
+            auto chunk = g->chunks[i];
+            if (!src || chunk->count < src->count)
+                src = chunk;
+        }
+        for (uint32_t i = g->firstFree; i < (uint32_t)g->chunks.size(); ++i)
+        {
+            auto chunk = g->chunks[i];
+            if (chunk != src && (!dst || chunk->count > dst->count))
+                dst = chunk;
+        }
+        // always move one entity at least, so a tiny budget still makes progress
+        const EIndex budgetCount = (EIndex)std::max<uint64_t>((maxBytes - moved) / entitySize, 1);
+        const EIndex count = std::min({ src->count, dst->get_capacity() - dst->count, budgetCount });
+        const EIndex srcIndex = src->count - count;
+        const dual_chunk_view_t dstView{ dst, dst->count, count };
+        move_view(dstView, src, srcIndex);
+        entities.move_entities(dstView, src, srcIndex);
+        structural_change(g, dst);
+        structural_change(g, src);
+        g->resize_chunk(dst, dst->count + count);
+        g->resize_chunk(src, srcIndex);
+        moved += count * entitySize;
+    }
+    return false;
+}
+
+bool dual_storage_t::run_defragment(const dual::defragment_plan_t* plan, uint32_t count, int64_t deadline)
+{
+    using namespace dual;
+    SkrZoneScopedN("DualDefragment");
+    std::atomic<bool> remain = false;
+    auto compact = [&](const defragment_plan_t* begin, const defragment_plan_t* end) {
+        for (auto p = begin; p != end; ++p)
+            if (compact_group(p->group, p->maxBytes, deadline))
+                remain = true;
+    };
+    // groups never share chunks, so they can be compacted side by side
+    if (scheduler && count > 1)
+        skr::parallel_for(plan, plan + count, 1, compact);
+    else
+        compact(plan, plan + count);
+    return remain;
+}
+
 void dual_storage_t::pack_entities()
 {
     using namespace dual;
@@ -453,7 +570,7 @@ void dual_storage_t::pack_entities()
     eastl::vector<EIndex> map;
     auto& entries = entities.entries;
     map.resize(entries.size());
-    entities.freeEntries.clear();
+    entities.set_free_entries(nullptr, 0);
     EIndex j = 0;
     forloop (i, 0, entries.size())
     {
@@ -652,8 +769,8 @@ void dual_storage_t::merge(dual_storage_t& src)
     eastl::vector<dual_entity_t> map;
     map.resize(sents.entries.size());
     EIndex moveCount = 0;
-    for (auto& e : sents.entries)
-        if (e.chunk != nullptr)
+    forloop (i, 0, sents.entries.size())
+        if (sents.entries[i].chunk != nullptr)
             moveCount++;
     eastl::vector<dual_entity_t> newEnts;
     newEnts.resize(moveCount);
@@ -728,7 +845,9 @@ void dual_storage_t::merge(dual_storage_t& src)
                 forloop (k, 0, c->count)
                 {
                     i->m->map(ents[k]);
-                    entities.entries[ents[k]] = { c, k };
+                    auto& entry = entities.entries[e_id(ents[k])];
+                    entry.chunk = c;
+                    entry.indexInChunk = k;
                 }
                 iterator_ref_chunk( c, *(i->m) );
                 iterator_ref_view({ c, 0, c->count }, *(i->m));
@@ -802,6 +921,16 @@ void* dualS_get_userdata(dual_storage_t* storage)
     return storage->userdata;
 }
 
+void dualS_set_version(dual_storage_t* storage, uint64_t number)
+{
+    storage->timestamp = (uint32_t)number;
+}
+
+uint64_t dualS_get_version(dual_storage_t* storage)
+{
+    return storage->timestamp;
+}
+
 void dualS_allocate_type(dual_storage_t* storage, const dual_entity_type_t* type, EIndex count, dual_view_callback_t callback, void* u)
 {
     SKR_ASSERT(dual::ordered(*type));
@@ -949,6 +1078,21 @@ void dualS_defragement(dual_storage_t* storage)
     storage->defragment();
 }
 
+bool dualS_defragment_incremental(dual_storage_t* storage, const dual_defragment_budget_t* budget)
+{
+    eastl::vector<dual::defragment_plan_t> plan;
+    const bool left = storage->plan_defragment(budget->maxBytes, plan);
+    if (auto scheduler = storage->scheduler)
+    {
+        SKR_ASSERT(scheduler->is_main_thread(storage));
+        for (auto& p : plan)
+            scheduler->sync_archetype(p.group->archetype);
+    }
+    const int64_t deadline = budget->maxMicroseconds ? skr_sys_get_usec(true) + (int64_t)budget->maxMicroseconds : 0;
+    const bool remain = storage->run_defragment(plan.data(), (uint32_t)plan.size(), deadline);
+    return left || remain;
+}
+
 void dualS_pack_entities(dual_storage_t* storage)
 {
     storage->pack_entities();
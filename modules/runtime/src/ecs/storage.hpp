@@ -69,6 +69,12 @@ struct equalto {
 };
 
 struct scheduler_t;
+
+// a group picked for incremental defragmentation and the bytes it may move
+struct defragment_plan_t {
+    dual_group_t* group;
+    uint64_t maxBytes;
+};
 } // namespace dual
 
 struct dual_storage_t {
@@ -160,6 +166,11 @@ struct dual_storage_t {
     void validate_meta();
     void validate(dual_entity_set_t& meta);
     void defragment();
+    // picks the groups with the most wasted chunk space, returns whether fragmented groups are left out
+    bool plan_defragment(uint64_t maxBytes, eastl::vector<dual::defragment_plan_t>& plan);
+    // compacts the planned groups (in parallel with a bound scheduler), returns whether any of them is still fragmented
+    bool run_defragment(const dual::defragment_plan_t* plan, uint32_t count, int64_t deadline);
+    bool compact_group(dual_group_t* group, uint64_t maxBytes, int64_t deadline);
     void pack_entities();
 
     dual_chunk_view_t allocate_view(dual_group_t* group, EIndex count);
@@ -19,4 +19,9 @@
 #include "vram/vram_resources.cpp"
 #include "vram/components.cpp"
 
-#include "dstorage/dstorage_resolvers.cpp"
\ No newline at end of file
+#include "dstorage/dstorage_resolvers.cpp"
+
+#include "processors/task_decompressor.cpp"
+
+#include "uring/uring_ring.cpp"
+#include "uring/uring_resolvers.cpp"
\ No newline at end of file
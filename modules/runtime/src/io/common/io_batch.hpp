@@ -27,6 +27,9 @@ public:
 
     void set_priority(SkrAsyncServicePriority pri) SKR_NOEXCEPT { priority = pri; }
     SkrAsyncServicePriority get_priority() const SKR_NOEXCEPT { return priority; }
+    void set_deadline(uint64_t d) SKR_NOEXCEPT { deadline = d; }
+    uint64_t get_deadline() const SKR_NOEXCEPT { return deadline; }
+    uint64_t get_sequence() const SKR_NOEXCEPT { return sequence; }
 
     const bool can_use_dstorage = true; // TODO: make it configurable
 
@@ -50,6 +53,7 @@ protected:
 
 private:
     SkrAsyncServicePriority priority;
+    uint64_t deadline = SKR_IO_DEADLINE_NONE;
     SRWMutex rw_lock;
     eastl::fixed_vector<IORequestId, 4> requests;
 
@@ -40,7 +40,7 @@ void VFSFileResolver::resolve(SkrAsyncServicePriority priority, IOBatchId batch,
     auto pFile = io_component<FileComponent>(request.get());
     if (pPath && pFile)
     {
-        if (!pFile->dfile && !pFile->file)
+        if (!pFile->dfile && !pFile->file && (pFile->fd < 0))
         {
             SKR_ASSERT(pPath->get_vfs());
             pFile->file = skr_vfs_fopen(pPath->get_vfs(), pPath->get_path(), SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
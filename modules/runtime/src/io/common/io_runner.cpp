@@ -91,6 +91,8 @@ void RunnerBase::phaseRecycle() SKR_NOEXCEPT
 
         for (auto processor : batch_processors)
             processor->recycle(priority);
+        for (auto processor : request_processors)
+            processor->recycle(priority);
     }
 
 }
@@ -364,8 +366,11 @@ bool RunnerBase::complete_(IIORequest* rq, SkrAsyncServicePriority priority) SKR
 {
     if (auto pStatus = io_component<IOStatusComponent>(rq))
     {
-        SKR_ASSERT(pStatus->getStatus() == SKR_IO_STAGE_LOADED);
-        pStatus->setStatus(SKR_IO_STAGE_COMPLETED);
+        // requests that failed in a processor, e.g. on a corrupt compressed block, finish as cancelled
+        const auto failed = (pStatus->getStatus() == SKR_IO_STAGE_CANCELLED);
+        SKR_ASSERT(failed || pStatus->getStatus() == SKR_IO_STAGE_LOADED || pStatus->getStatus() == SKR_IO_STAGE_DECOMPRESSED);
+        if (!failed)
+            pStatus->setStatus(SKR_IO_STAGE_COMPLETED);
         if (pStatus->needPollFinish())
         {
             finish_queues[priority].enqueue(rq);
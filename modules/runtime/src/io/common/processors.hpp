@@ -1,5 +1,6 @@
 #pragma once
 #include "io_batch.hpp"
+#include <EASTL/heap.h>
 
 namespace skr {
 namespace io {
@@ -24,14 +25,24 @@ public:
         return true;
     }
 
+    // polled by the runner thread only, fetched batches are moved into a heap ordered by deadline
+    // and submission order, so batches without deadline keep the old fifo behavior
     virtual bool poll_processed_batch(SkrAsyncServicePriority priority, IOBatchId& batch) SKR_NOEXCEPT
     {
-        if (queues[priority].try_dequeue(batch))
+        auto& heap = deadline_heaps[priority];
+        IOBatchId fetched = nullptr;
+        while (queues[priority].try_dequeue(fetched))
         {
-            skr_atomic64_add_relaxed(&counts[priority], -1);
-            return batch.get();
+            heap.emplace_back(std::move(fetched));
+            eastl::push_heap(heap.begin(), heap.end(), LaterDeadline());
         }
-        return false;
+        if (heap.empty())
+            return false;
+        eastl::pop_heap(heap.begin(), heap.end(), LaterDeadline());
+        batch = std::move(heap.back());
+        heap.pop_back();
+        skr_atomic64_add_relaxed(&counts[priority], -1);
+        return batch.get();
     }
 
     uint64_t processed_count(SkrAsyncServicePriority priority) const SKR_NOEXCEPT
@@ -57,8 +68,20 @@ public:
     uint64_t processing_count(SkrAsyncServicePriority priority) const SKR_NOEXCEPT { return 0; }
 
 protected:
+    struct LaterDeadline
+    {
+        bool operator()(const IOBatchId& a, const IOBatchId& b) const SKR_NOEXCEPT
+        {
+            auto A = static_cast<const IOBatchBase*>(a.get());
+            auto B = static_cast<const IOBatchBase*>(b.get());
+            if (A->get_deadline() != B->get_deadline())
+                return A->get_deadline() > B->get_deadline();
+            return A->get_sequence() > B->get_sequence();
+        }
+    };
     SAtomic64 counts[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
     IOBatchQueue queues[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    IOBatchArray deadline_heaps[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
 };
 using IOBatchBufferId = SObjectPtr<IOBatchBuffer>;
 
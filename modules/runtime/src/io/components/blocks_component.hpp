@@ -3,6 +3,7 @@
 #include "SkrRT/platform/guid.hpp"
 #include "../components/component.hpp"
 #include <EASTL/fixed_vector.h>
+#include <atomic>
 
 namespace skr {
 namespace io {
@@ -39,22 +40,36 @@ struct CID<struct CompressedBlocksComponent>
 struct CompressedBlocksComponent : public IORequestComponent
 {
     CompressedBlocksComponent(IIORequest* const request) SKR_NOEXCEPT;
+    ~CompressedBlocksComponent() SKR_NOEXCEPT;
     
     skr::span<skr_io_compressed_block_t> get_compressed_blocks() SKR_NOEXCEPT 
     { 
-        SKR_UNIMPLEMENTED_FUNCTION();
-        return {}; 
+        return compressed_blocks;
     }
 
-    void add_compressed_block(const skr_io_block_t& block) SKR_NOEXCEPT 
+    void add_compressed_block(const skr_io_compressed_block_t& block) SKR_NOEXCEPT 
     {  
-        SKR_UNIMPLEMENTED_FUNCTION();
+        compressed_blocks.emplace_back(block);
     }
 
     void reset_compressed_blocks() SKR_NOEXCEPT 
     {
-        SKR_UNIMPLEMENTED_FUNCTION();
+        compressed_blocks.clear();
     }
+
+    bool is_compressed() const SKR_NOEXCEPT { return !compressed_blocks.empty(); }
+
+    // staging buffer that readers load the compressed bytes into
+    void allocate_compressed_buffer(uint64_t n) SKR_NOEXCEPT;
+    void free_compressed_buffer() SKR_NOEXCEPT;
+
+    eastl::fixed_vector<skr_io_compressed_block_t, 1> compressed_blocks;
+    uint8_t* compressed_data = nullptr;
+    uint64_t compressed_size = 0;
+    // blocks still being decompressed, the worker that drops it to zero finishes the request
+    std::atomic<uint32_t> pending_blocks = 0;
+    // set by any block that failed to decompress, the request is then finished as cancelled
+    std::atomic<bool> failed = false;
 };
 
 constexpr skr_guid_t CID<struct BlocksComponent>::Get()
@@ -1,6 +1,9 @@
 #include "status_component.hpp"
 #include "blocks_component.hpp"
 #include "src_components.hpp"
+#ifdef SKR_OS_UNIX
+#include <sys/stat.h>
+#endif
 
 namespace skr {
 namespace io {
@@ -41,6 +44,15 @@ FileComponent::FileComponent(IIORequest* const request) SKR_NOEXCEPT
 
 uint64_t FileComponent::get_fsize() const SKR_NOEXCEPT
 {
+#ifdef SKR_OS_UNIX
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (::fstat(fd, &st) == 0)
+            return (uint64_t)st.st_size;
+        return 0;
+    }
+#endif
     if (file)
     {
         SKR_ASSERT(!dfile);
@@ -70,11 +82,38 @@ BlocksComponent::BlocksComponent(IIORequest* const request) SKR_NOEXCEPT
     
 }
 
+const char* kIOCompressedBufferMemoryName = "io::compressed";
+
 CompressedBlocksComponent::CompressedBlocksComponent(IIORequest* const request) SKR_NOEXCEPT 
     : IORequestComponent(request) 
 {
     
 }
 
+CompressedBlocksComponent::~CompressedBlocksComponent() SKR_NOEXCEPT
+{
+    free_compressed_buffer();
+}
+
+void CompressedBlocksComponent::allocate_compressed_buffer(uint64_t n) SKR_NOEXCEPT
+{
+    SKR_ASSERT(!compressed_data && "compressed buffer already allocated!");
+    if (n)
+    {
+        compressed_data = (uint8_t*)sakura_mallocN(n, kIOCompressedBufferMemoryName);
+    }
+    compressed_size = n;
+}
+
+void CompressedBlocksComponent::free_compressed_buffer() SKR_NOEXCEPT
+{
+    if (compressed_data)
+    {
+        sakura_freeN(compressed_data, kIOCompressedBufferMemoryName);
+        compressed_data = nullptr;
+    }
+    compressed_size = 0;
+}
+
 } // namespace io
 } // namespace skr
\ No newline at end of file
@@ -58,6 +58,8 @@ struct FileComponent : public IORequestComponent
 
     skr_io_file_handle file = nullptr;
     SkrDStorageFileHandle dfile = nullptr;
+    int32_t fd = -1; // native descriptor, opened by UringFileResolver
+    bool fd_direct = false;
 };
 
 constexpr skr_guid_t CID<struct PathSrcComponent>::Get()
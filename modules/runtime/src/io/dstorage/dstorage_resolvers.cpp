@@ -1,4 +1,5 @@
 #include "SkrRT/platform/vfs.h"
+#include "SkrRT/platform/pak_vfs.h"
 #include <SkrRT/platform/filesystem.hpp>
 #include "../common/io_request.hpp"
 #include "../common/io_batch.hpp"
@@ -14,6 +15,9 @@ void DStorageFileResolver::resolve(SkrAsyncServicePriority priority, IOBatchId b
     auto pFile = io_component<FileComponent>(request.get());
     if (!B->can_use_dstorage) 
         return;
+    // pak entries are not files on disk, PakRAMReader reads them from the archive
+    if (pPath && skr_vfs_is_pak(pPath->get_vfs()))
+        return;
 
     if (pPath && !pFile->dfile)
     {
@@ -6,6 +6,7 @@ namespace skr { template <typename Artifact> struct IFuture; struct JobQueue; }
 
 namespace skr {
 namespace io {
+struct RunnerBase;
 
 template<typename I = IIORequestProcessor>
 struct TaskDecompressorBase : public IIODecompressor<I>
@@ -19,5 +20,29 @@ public:
     virtual ~TaskDecompressorBase() SKR_NOEXCEPT {}
 };
 
+// decompress loaded requests block by block on the job queue, inline on the service thread if no queue is given
+struct TaskDecompressor final : public TaskDecompressorBase<IIORequestProcessor>
+{
+    TaskDecompressor(RunnerBase* runner, skr::JobQueue* job_queue) SKR_NOEXCEPT 
+        : runner(runner), job_queue(job_queue) 
+    {
+
+    }
+    ~TaskDecompressor() SKR_NOEXCEPT {}
+
+    bool fetch(SkrAsyncServicePriority priority, IORequestId request) SKR_NOEXCEPT;
+    void dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    void recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    bool poll_processed_request(SkrAsyncServicePriority priority, IORequestId& request) SKR_NOEXCEPT;
+    bool is_async(SkrAsyncServicePriority priority) const SKR_NOEXCEPT { return job_queue; }
+
+    void decompressBlock(SkrAsyncServicePriority priority, const IORequestId& request, uint64_t block_index) SKR_NOEXCEPT;
+
+    RunnerBase* runner = nullptr;
+    skr::JobQueue* job_queue = nullptr;
+    IORequestQueue decompressed_requests[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    skr::vector<skr::IFuture<bool>*> decompress_futures[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+};
+
 } // namespace io
-} // namespace skr
\ No newline at end of file
+} // namespace skr
@@ -0,0 +1,212 @@
+#include "SkrRT/io/io.h"
+#include "SkrRT/async/thread_job.hpp"
+#include "SkrRT/containers/hashmap.hpp"
+#include "../common/io_runnner.hpp"
+#include "../ram/ram_request.hpp"
+#include "decompressor.hpp"
+
+#include <zstd.h>
+#include <lz4.h>
+
+// DECOMPRESS METHODS IMPLEMENTATION
+
+namespace skr {
+namespace io {
+
+namespace 
+{
+struct DecompressProcEntry
+{
+    IODecompressProc proc = nullptr;
+    void* usr_data = nullptr;
+};
+using DecompressProcMap = skr::parallel_flat_hash_map<skr_guid_t, DecompressProcEntry, skr::guid::hash>;
+
+bool ZstdDecompressProc(const IOCompressedBlock& block, const uint8_t* src, uint8_t* dst, void* usr_data)
+{
+    const auto result = ZSTD_decompress(dst, block.uncompressed_size, src, block.compressed_size);
+    return !ZSTD_isError(result) && (result == block.uncompressed_size);
+}
+
+bool LZ4DecompressProc(const IOCompressedBlock& block, const uint8_t* src, uint8_t* dst, void* usr_data)
+{
+    const auto result = LZ4_decompress_safe((const char*)src, (char*)dst, (int)block.compressed_size, (int)block.uncompressed_size);
+    return (result >= 0) && ((uint64_t)result == block.uncompressed_size);
+}
+
+DecompressProcMap& GetDecompressProcs()
+{
+    static DecompressProcMap procs = {
+        { IODecompressMethods::Zstd(), { &ZstdDecompressProc, nullptr } },
+        { IODecompressMethods::LZ4(), { &LZ4DecompressProc, nullptr } },
+    };
+    return procs;
+}
+} // namespace
+
+IODecompressMethod IODecompressMethods::Zstd() SKR_NOEXCEPT
+{
+    using namespace skr::guid::literals;
+    return u8"2f59f902-040c-4bb1-9c33-8a9173a3d3f8"_guid;
+}
+
+IODecompressMethod IODecompressMethods::LZ4() SKR_NOEXCEPT
+{
+    using namespace skr::guid::literals;
+    return u8"9f69de01-95da-4252-b8bd-909c2d25f206"_guid;
+}
+
+void IODecompressMethods::Register(IODecompressMethod method, IODecompressProc proc, void* usr_data) SKR_NOEXCEPT
+{
+    SKR_ASSERT(proc && "invalid decompress proc!");
+    GetDecompressProcs().insert_or_assign(method, DecompressProcEntry{ proc, usr_data });
+}
+
+void IODecompressMethods::Unregister(IODecompressMethod method) SKR_NOEXCEPT
+{
+    GetDecompressProcs().erase(method);
+}
+
+bool IODecompressMethods::Decompress(const IOCompressedBlock& block, const uint8_t* src, uint8_t* dst) SKR_NOEXCEPT
+{
+    DecompressProcEntry entry = {};
+    GetDecompressProcs().if_contains(block.decompress_method, [&entry](const auto& kv) { entry = kv.second; });
+    if (!entry.proc)
+    {
+        SKR_LOG_ERROR(u8"IODecompressMethods: no decompressor registered for the block's method!");
+        return false;
+    }
+    return entry.proc(block, src, dst, entry.usr_data);
+}
+
+} // namespace io
+} // namespace skr
+
+// TASK DECOMPRESSOR IMPLEMENTATION
+
+namespace skr {
+namespace io {
+
+using DecompressorFutureLauncher = skr::FutureLauncher<bool>;
+
+bool TaskDecompressor::fetch(SkrAsyncServicePriority priority, IORequestId request) SKR_NOEXCEPT
+{
+    auto pStatus = io_component<IOStatusComponent>(request.get());
+    auto pCompressed = io_component<CompressedBlocksComponent>(request.get());
+    const auto loaded = (pStatus->getStatus() == SKR_IO_STAGE_LOADED);
+    if (!loaded || !pCompressed || !pCompressed->is_compressed()) // cancelled or nothing to decompress
+    {
+        decompressed_requests[priority].enqueue(request);
+        inc_processed(priority);
+        return true;
+    }
+
+    SkrZoneScopedN("DecompressFetch");
+    const auto blocks = pCompressed->get_compressed_blocks();
+    pStatus->setStatus(SKR_IO_STAGE_DECOMPRESSIONG);
+    pCompressed->failed.store(false, std::memory_order_relaxed);
+    pCompressed->pending_blocks.store((uint32_t)blocks.size(), std::memory_order_release);
+    inc_processing(priority);
+    for (uint64_t i = 0; i < blocks.size(); i++)
+    {
+        if (job_queue)
+        {
+            auto launcher = DecompressorFutureLauncher(job_queue);
+            decompress_futures[priority].emplace_back(
+                launcher.async([this, request, priority, i](){
+                    SkrZoneScopedN("DecompressTask");
+                    decompressBlock(priority, request, i);
+                    return true;
+                })
+            );
+        }
+        else
+        {
+            decompressBlock(priority, request, i);
+        }
+    }
+    return true;
+}
+
+void TaskDecompressor::decompressBlock(SkrAsyncServicePriority priority, const IORequestId& request, uint64_t block_index) SKR_NOEXCEPT
+{
+    auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
+    auto buf = skr::static_pointer_cast<RAMIOBuffer>(rq->destination);
+    auto pCompressed = io_component<CompressedBlocksComponent>(request.get());
+    const auto blocks = pCompressed->get_compressed_blocks();
+
+    // blocks are packed back to back in both staging and destination buffers
+    uint64_t src_offset = 0, dst_offset = 0;
+    for (uint64_t i = 0; i < block_index; i++)
+    {
+        src_offset += blocks[i].compressed_size;
+        dst_offset += blocks[i].uncompressed_size;
+    }
+    const auto& block = blocks[block_index];
+    SKR_ASSERT(src_offset + block.compressed_size <= pCompressed->compressed_size);
+    SKR_ASSERT(dst_offset + block.uncompressed_size <= buf->get_size());
+    if (!IODecompressMethods::Decompress(block, pCompressed->compressed_data + src_offset, buf->get_data() + dst_offset))
+    {
+        SKR_LOG_ERROR(u8"TaskDecompressor: failed to decompress block %llu of %s", 
+            block_index, rq->get_path());
+        pCompressed->failed.store(true, std::memory_order_relaxed);
+    }
+
+    // acq_rel: every block releases its writes, the worker finishing the request acquires all of them
+    if (pCompressed->pending_blocks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        pCompressed->free_compressed_buffer();
+        if (auto pStatus = io_component<IOStatusComponent>(request.get()))
+        {
+            // the destination holds garbage after a failed block, cancelling frees it
+            const auto failed = pCompressed->failed.load(std::memory_order_relaxed);
+            pStatus->setStatus(failed ? SKR_IO_STAGE_CANCELLED : SKR_IO_STAGE_DECOMPRESSED);
+        }
+        decompressed_requests[priority].enqueue(request);
+        inc_processed(priority);
+        dec_processing(priority);
+        if (job_queue)
+        {
+            runner->awake();
+        }
+    }
+}
+
+void TaskDecompressor::dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    // blocks are launched at fetch so that the whole batch decompresses concurrently
+}
+
+bool TaskDecompressor::poll_processed_request(SkrAsyncServicePriority priority, IORequestId& request) SKR_NOEXCEPT
+{
+    if (decompressed_requests[priority].try_dequeue(request))
+    {
+        dec_processed(priority);
+        return request.get();
+    }
+    return false;
+}
+
+void TaskDecompressor::recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("TaskDecompressor::recycle");
+
+    auto& arr = decompress_futures[priority];
+    for (auto& future : arr)
+    {
+        auto status = future->wait_for(0);
+        if (status == skr::FutureStatus::Ready)
+        {
+            SkrDelete(future);
+            future = nullptr;
+        }
+    }
+    auto it = eastl::remove_if(arr.begin(), arr.end(), 
+        [](skr::IFuture<bool>* future) {
+            return (future == nullptr);
+        });
+    arr.erase(it, arr.end());
+}
+
+} // namespace io
+} // namespace skr
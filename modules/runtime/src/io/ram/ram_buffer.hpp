@@ -1,5 +1,6 @@
 #pragma once
 #include "SkrRT/io/ram_io.hpp"
+#include "SkrRT/platform/vfs.h"
 #include "../common/pool.hpp"
 
 namespace skr {
@@ -13,7 +14,9 @@ struct SKR_RUNTIME_API RAMIOBuffer : public IRAMIOBuffer
     uint8_t* get_data() const SKR_NOEXCEPT { return bytes; }
     uint64_t get_size() const SKR_NOEXCEPT { return size; }
 
-    void allocate_buffer(uint64_t n) SKR_NOEXCEPT;
+    void allocate_buffer(uint64_t n, uint64_t alignment = 0) SKR_NOEXCEPT;
+    // alias a copy-on-write file mapping instead of owning memory, the file is closed with the buffer
+    void map_buffer(skr_vfile_t* file, const uint8_t* mapped, uint64_t n) SKR_NOEXCEPT;
     void free_buffer() SKR_NOEXCEPT;
 
 public:
@@ -31,6 +34,8 @@ public:
 protected:
     uint8_t* bytes = nullptr;
     uint64_t size = 0;
+    uint64_t alignment = 0;
+    skr_vfile_t* mapped_file = nullptr;
     RAMIOBuffer(ISmartPoolPtr<IRAMIOBuffer> pool) 
         : pool(pool)
     {
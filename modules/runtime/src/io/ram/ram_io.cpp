@@ -18,23 +18,46 @@ RAMIOBuffer::~RAMIOBuffer() SKR_NOEXCEPT
     free_buffer();
 }
 
-void RAMIOBuffer::allocate_buffer(uint64_t n) SKR_NOEXCEPT
+void RAMIOBuffer::allocate_buffer(uint64_t n, uint64_t align) SKR_NOEXCEPT
 {
     if (n)
     {
-        bytes = (uint8_t*)sakura_mallocN(n, kIOBufferMemoryName);
+        if (align)
+            bytes = (uint8_t*)sakura_malloc_alignedN(n, align, kIOBufferMemoryName);
+        else
+            bytes = (uint8_t*)sakura_mallocN(n, kIOBufferMemoryName);
     }
     size = n;
+    alignment = align;
+}
+
+void RAMIOBuffer::map_buffer(skr_vfile_t* file, const uint8_t* mapped, uint64_t n) SKR_NOEXCEPT
+{
+    SKR_ASSERT(!bytes && "buffer already allocated!");
+    // mmap file systems map copy-on-write, so the pages are writable through get_data()
+    bytes = const_cast<uint8_t*>(mapped);
+    size = n;
+    mapped_file = file;
 }
 
 void RAMIOBuffer::free_buffer() SKR_NOEXCEPT
 {
+    if (mapped_file)
+    {
+        skr_vfs_fclose(mapped_file);
+        mapped_file = nullptr;
+        bytes = nullptr;
+    }
     if (bytes)
     {
-        sakura_freeN(bytes, kIOBufferMemoryName);
+        if (alignment)
+            sakura_free_alignedN(bytes, alignment, kIOBufferMemoryName);
+        else
+            sakura_freeN(bytes, kIOBufferMemoryName);
         bytes = nullptr;
     }
     size = 0;
+    alignment = 0;
 }
 
 void RAMIOBatch::add_request(IORequestId request, RAMIOBufferId buffer, skr_io_future_t* future) SKR_NOEXCEPT
@@ -48,7 +71,8 @@ void RAMIOBatch::add_request(IORequestId request, RAMIOBufferId buffer, skr_io_f
     rq->destination = buffer;
     if (auto pComp = io_component<BlocksComponent>(rq.get()))
     {
-        SKR_ASSERT(!pComp->blocks.empty());
+        auto pCompressed = io_component<CompressedBlocksComponent>(rq.get());
+        SKR_ASSERT(!pComp->blocks.empty() || (pCompressed && pCompressed->is_compressed()));
     }
     addRequest(request);
 }
@@ -64,9 +64,10 @@ void VFSRAMReader::dispatchFunction(SkrAsyncServicePriority priority, const IORe
                     pStatus->setStatus(SKR_IO_STAGE_LOADING);
                     // SKR_LOG_DEBUG(u8"dispatch read request: %s", rq->path.c_str());
                     uint64_t dst_offset = 0u;
+                    const auto read_buffer = rq->get_read_buffer();
                     for (const auto& block : pBlocks->blocks)
                     {
-                        const auto address = buf->get_data() + dst_offset;
+                        const auto address = read_buffer + dst_offset;
                         skr_vfs_fread(pFile->file, address, block.offset, block.size);
                         dst_offset += block.size;
                     }
@@ -145,6 +146,195 @@ void VFSRAMReader::recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT
 } // namespace io
 } // namespace skr
 
+// PAK READER IMPLEMENTATION
+
+#include "SkrRT/platform/pak_vfs.h"
+#include <EASTL/sort.h>
+
+namespace skr {
+namespace io {
+
+const char* kIOPakCoalesceMemoryName = "io::pak_coalesce";
+using PakReaderFutureLauncher = skr::FutureLauncher<bool>;
+
+bool PakRAMReader::fetch(SkrAsyncServicePriority priority, IOBatchId batch) SKR_NOEXCEPT
+{
+    fetched_batches[priority].enqueue(batch);
+    inc_processing(priority);
+    return true;
+}
+
+void PakRAMReader::dispatchFunction(SkrAsyncServicePriority priority, const IOBatchId& batch) SKR_NOEXCEPT
+{
+    struct PakRead
+    {
+        skr_vfs_t* pak = nullptr;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint8_t* destination = nullptr;
+        uint64_t request_index = 0;
+    };
+    skr::vector<PakRead> reads;
+    skr::vector<IORequestId> loading;
+    skr::vector<bool> failed;
+    // take a copy, try_cancel removes cancelled requests from the batch
+    const auto batch_requests = batch->get_requests();
+    eastl::fixed_vector<IORequestId, 4> requests(batch_requests.begin(), batch_requests.end());
+    for (auto&& request : requests)
+    {
+        auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
+        auto pFile = io_component<FileComponent>(request.get());
+        uint64_t archive_offset = 0;
+        if (!pFile || !skr_pak_vfs_locate(pFile->file, &archive_offset))
+            continue;
+
+        if (service->runner.try_cancel(priority, rq))
+        {
+            skr_vfs_fclose(pFile->file);
+            pFile->file = nullptr;
+            if (auto buf = skr::static_pointer_cast<RAMIOBuffer>(rq->destination))
+            {
+                buf->free_buffer();
+            }
+        }
+        else if (auto pStatus = io_component<IOStatusComponent>(request.get()))
+        {
+            if (pStatus->getStatus() == SKR_IO_STAGE_RESOLVING)
+            {
+                pStatus->setStatus(SKR_IO_STAGE_LOADING);
+                auto pBlocks = io_component<BlocksComponent>(request.get());
+                uint64_t dst_offset = 0u;
+                const auto read_buffer = rq->get_read_buffer();
+                for (const auto& block : pBlocks->blocks)
+                {
+                    reads.emplace_back(PakRead{ pFile->file->fs, archive_offset + block.offset, block.size, read_buffer + dst_offset, loading.size() });
+                    dst_offset += block.size;
+                }
+                loading.emplace_back(request);
+            }
+        }
+    }
+
+    {
+        SkrZoneScopedN("PakReader::CoalescedRead");
+        failed.resize(loading.size(), false);
+        eastl::sort(reads.begin(), reads.end(), [](const PakRead& a, const PakRead& b) {
+            return (a.pak != b.pak) ? (a.pak < b.pak) : (a.offset < b.offset);
+        });
+        for (size_t i = 0; i < reads.size();)
+        {
+            const auto& first = reads[i];
+            uint64_t run_end = first.offset + first.size;
+            size_t j = i + 1;
+            for (; j < reads.size(); j++)
+            {
+                const auto& next = reads[j];
+                const auto next_end = eastl::max(run_end, next.offset + next.size);
+                if (next.pak != first.pak || next.offset > run_end + kMaxCoalesceGap || next_end - first.offset > kMaxCoalesceSize)
+                    break;
+                run_end = next_end;
+            }
+            if (j == i + 1)
+            {
+                if (skr_pak_vfs_read_archive(first.pak, first.destination, first.offset, first.size) != first.size)
+                    failed[first.request_index] = true;
+            }
+            else
+            {
+                const auto run_size = run_end - first.offset;
+                auto staging = (uint8_t*)sakura_mallocN(run_size, kIOPakCoalesceMemoryName);
+                const bool run_ok = (skr_pak_vfs_read_archive(first.pak, staging, first.offset, run_size) == run_size);
+                for (size_t k = i; k < j; k++)
+                {
+                    if (run_ok)
+                        memcpy(reads[k].destination, staging + (reads[k].offset - first.offset), reads[k].size);
+                    else
+                        failed[reads[k].request_index] = true;
+                }
+                sakura_freeN(staging, kIOPakCoalesceMemoryName);
+            }
+            i = j;
+        }
+    }
+
+    for (uint64_t i = 0; i < loading.size(); i++)
+    {
+        const auto& request = loading[i];
+        auto pFile = io_component<FileComponent>(request.get());
+        skr_vfs_fclose(pFile->file);
+        pFile->file = nullptr;
+        if (auto pStatus = io_component<IOStatusComponent>(request.get()))
+        {
+            // a short read leaves the destination incomplete, cancelling frees it
+            if (failed[i])
+                SKR_LOG_ERROR(u8"pak reader: failed to read %s from the archive", request->get_path());
+            pStatus->setStatus(failed[i] ? SKR_IO_STAGE_CANCELLED : SKR_IO_STAGE_LOADED);
+        }
+    }
+    processed_batches[priority].enqueue(batch);
+    inc_processed(priority);
+    dec_processing(priority);
+
+    awakeService();
+}
+
+void PakRAMReader::dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    IOBatchId batch;
+    while (fetched_batches[priority].try_dequeue(batch))
+    {
+        if (job_queue)
+        {
+            auto launcher = PakReaderFutureLauncher(job_queue);
+            loaded_futures[priority].emplace_back(
+                launcher.async([this, batch, priority](){
+                    SkrZoneScopedN("PakReadTask");
+                    dispatchFunction(priority, batch);
+                    return true;
+                })
+            );
+        }
+        else
+        {
+            dispatchFunction(priority, batch);
+        }
+    }
+}
+
+bool PakRAMReader::poll_processed_batch(SkrAsyncServicePriority priority, IOBatchId& batch) SKR_NOEXCEPT
+{
+    if (processed_batches[priority].try_dequeue(batch))
+    {
+        dec_processed(priority);
+        return batch.get();
+    }
+    return false;
+}
+
+void PakRAMReader::recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("PakRAMReader::recycle");
+
+    auto& arr = loaded_futures[priority];
+    for (auto& future : arr)
+    {
+        auto status = future->wait_for(0);
+        if (status == skr::FutureStatus::Ready)
+        {
+            SkrDelete(future);
+            future = nullptr;
+        }
+    }
+    auto it = eastl::remove_if(arr.begin(), arr.end(), 
+        [](skr::IFuture<bool>* future) {
+            return (future == nullptr);
+        });
+    arr.erase(it, arr.end());
+}
+
+} // namespace io
+} // namespace skr
+
 // DSTORAGE READER IMPLEMENTATION
 
 #include "../ram/ram_request.hpp"
@@ -255,9 +445,10 @@ void DStorageRAMReader::enqueueAndSubmit(SkrAsyncServicePriority priority) SKR_N
                         SKR_ASSERT(pFile->dfile);
                         pStatus->setStatus(SKR_IO_STAGE_LOADING);
                         uint64_t dst_offset = 0u;
+                        const auto read_buffer = rq->get_read_buffer();
                         for (const auto& block : pBlocks->blocks)
                         {
-                            const auto address = buf->get_data() + dst_offset;
+                            const auto address = read_buffer + dst_offset;
                             SkrDStorageIODescriptor io = {};
                             io.name = rq->get_path();
                             io.event = nullptr;
@@ -351,4 +542,285 @@ bool DStorageRAMReader::poll_processed_batch(SkrAsyncServicePriority priority, I
 }
 
 } // namespace io
-} // namespace skr
\ No newline at end of file
+} // namespace skr
+// IO_URING READER IMPLEMENTATION
+
+#ifdef SKR_IO_URING_AVAILABLE
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+namespace skr {
+namespace io {
+
+// IORING_OP_READ takes a 32-bit length, larger blocks are finished by the short-read path
+static constexpr uint64_t kUringMaxReadSize = 1ull << 30;
+
+UringRAMReader::UringRAMReader(RAMService* service) SKR_NOEXCEPT 
+    : RAMReaderBase(service)
+{
+    for (auto i = 0; i < SKR_ASYNC_SERVICE_PRIORITY_COUNT; ++i)
+    {
+        rings[i].init(kUringQueueDepth);
+    }
+}
+
+UringRAMReader::~UringRAMReader() SKR_NOEXCEPT
+{
+    for (auto i = 0; i < SKR_ASYNC_SERVICE_PRIORITY_COUNT; ++i)
+    {
+        SKR_ASSERT(inflight_reads[i] == 0 && "UringRAMReader: destroyed with inflight reads!");
+        for (auto read : retry_reads[i])
+            SkrDelete(read);
+        rings[i].shutdown();
+    }
+}
+
+bool UringRAMReader::valid() const SKR_NOEXCEPT
+{
+    for (const auto& ring : rings)
+    {
+        if (!ring.valid()) 
+            return false;
+    }
+    return true;
+}
+
+uint64_t UringRAMReader::get_prefer_batch_size() const SKR_NOEXCEPT
+{
+    return kUringQueueDepth * 256 * 1024; // enough bytes to keep one ring saturated per dispatch
+}
+
+bool UringRAMReader::fetch(SkrAsyncServicePriority priority, IOBatchId batch) SKR_NOEXCEPT
+{
+    fetched_batches[priority].enqueue(batch);
+    inc_processing(priority);
+    return true;
+}
+
+bool UringRAMReader::prepareRead(SkrAsyncServicePriority priority, InflightRead* read) SKR_NOEXCEPT
+{
+    auto& ring = rings[priority];
+    // bound inflight reads so the completion queue (2x sq entries) can never overflow
+    if (inflight_reads[priority] >= kUringQueueDepth)
+    {
+        pollCompletions(priority);
+        if (inflight_reads[priority] >= kUringQueueDepth)
+            return false;
+    }
+    auto sqe = ring.get_sqe();
+    if (!sqe)
+    {
+        ring.submit();
+        pollCompletions(priority);
+        sqe = ring.get_sqe();
+    }
+    if (!sqe) 
+        return false;
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = read->fd;
+    sqe->off = read->offset;
+    sqe->addr = (uint64_t)read->destination;
+    sqe->len = (uint32_t)((read->size > kUringMaxReadSize) ? kUringMaxReadSize : read->size);
+    sqe->user_data = (uint64_t)read;
+    inflight_reads[priority] += 1;
+    return true;
+}
+
+void UringRAMReader::enqueueAndSubmit(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("Uring::EnqueueAndSubmit");
+
+    // requeue short reads & reads that didn't fit into the sq last time
+    auto& retries = retry_reads[priority];
+    {
+        uint32_t n = 0;
+        for (; n < retries.size(); ++n)
+        {
+            if (!prepareRead(priority, retries[n]))
+                break;
+        }
+        retries.erase(retries.begin(), retries.begin() + n);
+    }
+
+    IOBatchId batch;
+    while (retries.empty() && fetched_batches[priority].try_dequeue(batch))
+    {
+        auto B = SkrNew<InflightBatch>();
+        B->batch = batch;
+        B->pending_requests = 1; // hold the batch until all requests are issued
+        // take a copy, try_cancel removes cancelled requests from the batch
+        const auto batch_requests = batch->get_requests();
+        eastl::fixed_vector<IORequestId, 4> requests(batch_requests.begin(), batch_requests.end());
+        for (auto&& request : requests)
+        {
+            auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
+            auto buf = skr::static_pointer_cast<RAMIOBuffer>(rq->destination);
+            auto pBlocks = io_component<BlocksComponent>(request.get());
+            auto pFile = io_component<FileComponent>(request.get());
+            if (!pFile || (pFile->fd < 0)) 
+                continue; // opened by VFSFileResolver, VFSRAMReader will read it
+
+            if (service->runner.try_cancel(priority, rq))
+            {
+                ::close(pFile->fd);
+                pFile->fd = -1;
+                pFile->fd_direct = false;
+                if (buf)
+                {
+                    buf->free_buffer();
+                }
+            }
+            else if (auto pStatus = io_component<IOStatusComponent>(request.get()))
+            {
+                if (pStatus->getStatus() == SKR_IO_STAGE_RESOLVING)
+                {
+                    SkrZoneScopedN("Uring::ReadRequest");
+                    pStatus->setStatus(SKR_IO_STAGE_LOADING);
+
+                    auto R = SkrNew<InflightRequest>();
+                    R->request = request;
+                    R->batch = B;
+                    R->pending_reads = 1; // hold the request until all blocks are issued
+                    B->pending_requests += 1;
+
+                    uint64_t dst_offset = 0u;
+                    const auto read_buffer = rq->get_read_buffer();
+                    for (const auto& block : pBlocks->blocks)
+                    {
+                        if (block.size == 0) 
+                            continue;
+                        auto read = SkrNew<InflightRead>();
+                        read->request = R;
+                        read->destination = read_buffer + dst_offset;
+                        read->offset = block.offset;
+                        read->size = block.size;
+                        read->fd = pFile->fd;
+                        R->pending_reads += 1;
+                        if (!prepareRead(priority, read))
+                            retries.emplace_back(read);
+                        dst_offset += block.size;
+                    }
+                    if (--R->pending_reads == 0)
+                        finishRequest(priority, R);
+                }
+                else
+                    SKR_UNREACHABLE_CODE();
+            }
+        }
+        if (--B->pending_requests == 0)
+        {
+            processed_batches[priority].enqueue(B->batch);
+            dec_processing(priority);
+            inc_processed(priority);
+            SkrDelete(B);
+        }
+    }
+    rings[priority].submit();
+}
+
+void UringRAMReader::completeRead(SkrAsyncServicePriority priority, InflightRead* read, int32_t result) SKR_NOEXCEPT
+{
+    inflight_reads[priority] -= 1;
+    if (result == -EINTR || result == -EAGAIN)
+    {
+        retry_reads[priority].emplace_back(read);
+        return;
+    }
+    if (result > 0 && (uint64_t)result < read->size)
+    {
+        read->destination += result;
+        read->offset += result;
+        read->size -= result;
+        retry_reads[priority].emplace_back(read);
+        return;
+    }
+    if (result < 0)
+    {
+        // kernels without IORING_OP_READ report -EINVAL, fallback to a blocking pread
+        SkrZoneScopedN("Uring::FallbackRead");
+        uint64_t done = 0;
+        while (done < read->size)
+        {
+            const auto n = ::pread(read->fd, read->destination + done, read->size - done, (off_t)(read->offset + done));
+            if (n < 0 && errno == EINTR) 
+                continue;
+            if (n <= 0)
+            {
+                SKR_LOG_ERROR(u8"io_uring: failed to read %s: %s", 
+                    read->request->request->get_path(), strerror(n < 0 ? errno : -result));
+                read->request->failed = true;
+                break;
+            }
+            done += n;
+        }
+    }
+    else if (result == 0)
+    {
+        SKR_LOG_ERROR(u8"io_uring: unexpected end of file %s", read->request->request->get_path());
+        read->request->failed = true;
+    }
+    auto R = read->request;
+    SkrDelete(read);
+    if (--R->pending_reads == 0)
+        finishRequest(priority, R);
+}
+
+void UringRAMReader::finishRequest(SkrAsyncServicePriority priority, InflightRequest* R) SKR_NOEXCEPT
+{
+    auto pFile = io_component<FileComponent>(R->request.get());
+    auto pStatus = io_component<IOStatusComponent>(R->request.get());
+    // the destination is incomplete after a failed block, cancelling frees it
+    pStatus->setStatus(R->failed ? SKR_IO_STAGE_CANCELLED : SKR_IO_STAGE_LOADED);
+    ::close(pFile->fd);
+    pFile->fd = -1;
+    pFile->fd_direct = false;
+
+    auto B = R->batch;
+    SkrDelete(R);
+    if (--B->pending_requests == 0)
+    {
+        processed_batches[priority].enqueue(B->batch);
+        dec_processing(priority);
+        inc_processed(priority);
+        SkrDelete(B);
+    }
+}
+
+void UringRAMReader::pollCompletions(SkrAsyncServicePriority priority, uint32_t wait_nr) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("Uring::PollCompletions");
+
+    auto& ring = rings[priority];
+    if (wait_nr)
+        ring.submit(wait_nr);
+    ring.reap([this, priority](const io_uring_cqe& cqe) {
+        completeRead(priority, (InflightRead*)cqe.user_data, cqe.res);
+    });
+}
+
+void UringRAMReader::dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    enqueueAndSubmit(priority);
+    pollCompletions(priority);
+}
+
+void UringRAMReader::recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+
+}
+
+bool UringRAMReader::poll_processed_batch(SkrAsyncServicePriority priority, IOBatchId& batch) SKR_NOEXCEPT
+{
+    if (processed_batches[priority].try_dequeue(batch))
+    {
+        dec_processed(priority);
+        return batch.get();
+    }
+    return false;
+}
+
+} // namespace io
+} // namespace skr
+#endif
@@ -51,6 +51,33 @@ struct VFSRAMReader final : public RAMReaderBase<IIORequestProcessor>
     skr::vector<skr::IFuture<bool>*> loaded_futures[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
 };
 
+// reads pak entries of a batch from the archive, neighbouring entries are merged into one read
+struct SKR_RUNTIME_API PakRAMReader final : public RAMReaderBase<IIOBatchProcessor>
+{
+    PakRAMReader(RAMService* service, skr::JobQueue* job_queue) SKR_NOEXCEPT 
+        : RAMReaderBase(service), job_queue(job_queue) 
+    {
+
+    }
+    ~PakRAMReader() SKR_NOEXCEPT {}
+
+    bool fetch(SkrAsyncServicePriority priority, IOBatchId batch) SKR_NOEXCEPT;
+    void dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    void recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    bool poll_processed_batch(SkrAsyncServicePriority priority, IOBatchId& batch) SKR_NOEXCEPT;
+    bool is_async(SkrAsyncServicePriority priority) const SKR_NOEXCEPT { return job_queue; }
+    void dispatchFunction(SkrAsyncServicePriority priority, const IOBatchId& batch) SKR_NOEXCEPT;
+
+    // gaps up to this size are read and thrown away rather than split into two reads
+    static constexpr uint64_t kMaxCoalesceGap = 64 * 1024;
+    static constexpr uint64_t kMaxCoalesceSize = 16 * 1024 * 1024;
+
+    skr::JobQueue* job_queue = nullptr;
+    IOBatchQueue fetched_batches[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    IOBatchQueue processed_batches[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    skr::vector<skr::IFuture<bool>*> loaded_futures[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+};
+
 } // namespace io
 } // namespace skr
 
@@ -85,4 +112,62 @@ struct SKR_RUNTIME_API DStorageRAMReader final
 };
 
 } // namespace io
-} // namespace skr
\ No newline at end of file
+} // namespace skr
+#include "../uring/uring_ring.hpp"
+
+#ifdef SKR_IO_URING_AVAILABLE
+namespace skr {
+namespace io {
+
+// submits whole batches to io_uring, one ring per priority so urgent reads never queue behind low ones
+struct SKR_RUNTIME_API UringRAMReader final 
+    : public RAMReaderBase<IIOBatchProcessor>
+{
+    UringRAMReader(RAMService* service) SKR_NOEXCEPT;
+    ~UringRAMReader() SKR_NOEXCEPT;
+
+    bool valid() const SKR_NOEXCEPT;
+    bool fetch(SkrAsyncServicePriority priority, IOBatchId batch) SKR_NOEXCEPT;
+    void dispatch(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    void recycle(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    bool poll_processed_batch(SkrAsyncServicePriority priority, IOBatchId& batch) SKR_NOEXCEPT;
+    bool is_async(SkrAsyncServicePriority priority) const SKR_NOEXCEPT { return false; }
+    uint64_t get_prefer_batch_size() const SKR_NOEXCEPT;
+
+    struct InflightBatch
+    {
+        IOBatchId batch;
+        uint32_t pending_requests = 0;
+    };
+    struct InflightRequest
+    {
+        IORequestId request;
+        InflightBatch* batch = nullptr;
+        uint32_t pending_reads = 0;
+        bool failed = false; // a block hit an error or the end of file, the request is cancelled
+    };
+    struct InflightRead
+    {
+        InflightRequest* request = nullptr;
+        uint8_t* destination = nullptr;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        int32_t fd = -1;
+    };
+
+    void enqueueAndSubmit(SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    void pollCompletions(SkrAsyncServicePriority priority, uint32_t wait_nr = 0) SKR_NOEXCEPT;
+    bool prepareRead(SkrAsyncServicePriority priority, InflightRead* read) SKR_NOEXCEPT;
+    void completeRead(SkrAsyncServicePriority priority, InflightRead* read, int32_t result) SKR_NOEXCEPT;
+    void finishRequest(SkrAsyncServicePriority priority, InflightRequest* request) SKR_NOEXCEPT;
+
+    UringRing rings[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    uint32_t inflight_reads[SKR_ASYNC_SERVICE_PRIORITY_COUNT] = { 0, 0, 0 };
+    skr::vector<InflightRead*> retry_reads[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    IOBatchQueue fetched_batches[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+    IOBatchQueue processed_batches[SKR_ASYNC_SERVICE_PRIORITY_COUNT];
+};
+
+} // namespace io
+} // namespace skr
+#endif
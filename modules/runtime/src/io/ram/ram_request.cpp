@@ -25,6 +25,15 @@ RAMRequestMixin::~RAMRequestMixin() SKR_NOEXCEPT
     destination.reset();
 }
 
+uint8_t* RAMRequestMixin::get_read_buffer() SKR_NOEXCEPT
+{
+    auto pCompressed = safe_comp<CompressedBlocksComponent>();
+    if (pCompressed->is_compressed())
+        return pCompressed->compressed_data;
+    auto buf = static_cast<RAMIOBuffer*>(destination.get());
+    return buf->get_data();
+}
+
 void RAMIOStatusComponent::setStatus(ESkrIOStage status) SKR_NOEXCEPT
 {
     auto rq = static_cast<RAMRequestMixin*>(request);
@@ -34,6 +43,10 @@ void RAMIOStatusComponent::setStatus(ESkrIOStage status) SKR_NOEXCEPT
         {
             dest->free_buffer();
         }
+        if (auto pCompressed = io_component<CompressedBlocksComponent>(rq))
+        {
+            pCompressed->free_compressed_buffer();
+        }
     }
     return IOStatusComponent::setStatus(status);
 }
@@ -24,11 +24,14 @@ struct RAMRequestMixin final : public IORequestMixin<IBlocksRAMRequest,
     // components...
     RAMIOStatusComponent, 
     PathSrcComponent, FileComponent,
-    BlocksComponent>
+    BlocksComponent, CompressedBlocksComponent>
 {
     friend struct SmartPool<RAMRequestMixin, IBlocksRAMRequest>;
     ~RAMRequestMixin() SKR_NOEXCEPT;
 
+    // readers load blocks here: the staging buffer of compressed requests, the destination otherwise
+    uint8_t* get_read_buffer() SKR_NOEXCEPT;
+
     RAMIOBufferId destination = nullptr;
 protected:
     RAMRequestMixin(ISmartPoolPtr<IBlocksRAMRequest> pool, IIOService* service, const uint64_t sequence) SKR_NOEXCEPT;
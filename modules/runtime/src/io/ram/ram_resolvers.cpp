@@ -5,12 +5,38 @@
 namespace skr {
 namespace io {
 
+AllocateIOBufferResolver::AllocateIOBufferResolver(uint64_t alignment) SKR_NOEXCEPT
+    : alignment(alignment)
+{
+
+}
+
 void AllocateIOBufferResolver::resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT
 {
     SkrZoneScopedNC("IOBuffer::Allocate", tracy::Color::BlueViolet);
     auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
     auto buf = skr::static_pointer_cast<RAMIOBuffer>(rq->destination);
     auto pFiles = io_component<FileComponent>(rq.get());
+    // compressed blocks are read as raw blocks into a staging buffer, the decompressor fills the destination
+    auto pCompressed = io_component<CompressedBlocksComponent>(rq.get());
+    if (pCompressed && pCompressed->is_compressed())
+    {
+        auto pBlocks = io_component<BlocksComponent>(rq.get());
+        pBlocks->reset_blocks();
+        uint64_t staging_size = 0, uncompressed_size = 0;
+        for (const auto& block : pCompressed->get_compressed_blocks())
+        {
+            pBlocks->add_block({ block.offset, block.compressed_size });
+            staging_size += block.compressed_size;
+            uncompressed_size += block.uncompressed_size;
+        }
+        if (buf->get_size() == 0)
+        {
+            buf->size = uncompressed_size;
+        }
+        SKR_ASSERT(buf->get_size() >= uncompressed_size && "destination is too small for decompressed blocks");
+        pCompressed->allocate_compressed_buffer(staging_size);
+    }
     // deal with 0 block size
     if (auto pBlocks = io_component<BlocksComponent>(rq.get()))
     {
@@ -33,7 +59,59 @@ void AllocateIOBufferResolver::resolve(SkrAsyncServicePriority priority, IOBatch
         {
             SKR_ASSERT(0 && "invalid destination size");
         }
-        buf->allocate_buffer(buf->size);
+        buf->allocate_buffer(buf->size, alignment);
+    }
+}
+
+void MappedFileResolver::resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT
+{
+    auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
+    auto buf = skr::static_pointer_cast<RAMIOBuffer>(rq->destination);
+    auto pFile = io_component<FileComponent>(rq.get());
+    auto pBlocks = io_component<BlocksComponent>(rq.get());
+    if (!pFile || !pFile->file || !pBlocks || !pFile->file->fs->procs.fmap)
+        return;
+    
+    SkrZoneScopedN("IOBuffer::Map");
+    for (auto& block : pBlocks->blocks)
+    {
+        if (block.size == 0)
+        {
+            block.size = pFile->get_fsize() - block.offset;
+        }
+    }
+    // blocks land back to back in the destination, so only a contiguous block list can alias the mapping
+    auto pCompressed = io_component<CompressedBlocksComponent>(rq.get());
+    bool contiguous = !pBlocks->blocks.empty() && !buf->get_data() && !(pCompressed && pCompressed->is_compressed());
+    for (size_t i = 1; contiguous && i < pBlocks->blocks.size(); i++)
+    {
+        const auto& prev = pBlocks->blocks[i - 1];
+        contiguous = (prev.offset + prev.size == pBlocks->blocks[i].offset);
+    }
+    if (contiguous)
+    {
+        const auto offset = pBlocks->blocks.front().offset;
+        const auto& last = pBlocks->blocks.back();
+        const auto size = last.offset + last.size - offset;
+        if (buf->get_size() == 0 || buf->get_size() == size)
+        {
+            if (auto mapped = skr_vfs_fmap(pFile->file, offset, size))
+            {
+                skr_vfs_fprefetch(pFile->file, offset, size);
+                buf->map_buffer(pFile->file, mapped, size);
+                pFile->file = nullptr; // owned by the buffer now
+                if (auto pStatus = io_component<IOStatusComponent>(rq.get()))
+                {
+                    pStatus->setStatus(SKR_IO_STAGE_LOADED);
+                }
+                return;
+            }
+        }
+    }
+    // scattered blocks are still copied by the reader, let the pages stream in before it gets there
+    for (const auto& block : pBlocks->blocks)
+    {
+        skr_vfs_fprefetch(pFile->file, block.offset, block.size);
     }
 }
 
@@ -5,6 +5,14 @@ namespace skr {
 namespace io {
 
 struct AllocateIOBufferResolver final : public IORequestResolverBase
+{
+    AllocateIOBufferResolver(uint64_t alignment = 0) SKR_NOEXCEPT;
+    void resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT;
+    const uint64_t alignment = 0;
+};
+
+// hand out views of mmap-ed files instead of reading them, and prefetch the rest
+struct MappedFileResolver final : public IORequestResolverBase
 {
     void resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT;
 };
@@ -1,5 +1,7 @@
 #include "SkrRT/async/wait_timeout.hpp"
 #include "../dstorage/dstorage_resolvers.hpp"
+#include "../uring/uring_resolvers.hpp"
+#include "../processors/decompressor.hpp"
 
 #include "ram_service.hpp"
 #include "ram_resolvers.hpp"
@@ -28,6 +30,30 @@ inline static IOReaderId<IIOBatchProcessor> CreateBatchReader(RAMService* servic
 #endif
     return nullptr;
 }
+
+inline static IOReaderId<IIOBatchProcessor> CreateUringReader(RAMService* service, const skr_ram_io_service_desc_t* desc) SKR_NOEXCEPT
+{
+#ifdef SKR_IO_URING_AVAILABLE
+    auto reader = skr::SObjectPtr<UringRAMReader>::Create(service);
+    if (reader->valid())
+        return std::move(reader);
+    SKR_LOG_WARN(u8"RAMService: io_uring is unavailable, fallback to vfs reader");
+#endif
+    return nullptr;
+}
+
+inline static IOReaderId<IIOBatchProcessor> CreatePakReader(RAMService* service, const skr_ram_io_service_desc_t* desc) SKR_NOEXCEPT
+{
+    auto reader = skr::SObjectPtr<PakRAMReader>::Create(service, desc->io_job_queue);
+    return std::move(reader);
+}
+
+inline static IODecompressorId<IIORequestProcessor> CreateDecompressor(RAMService* service, const skr_ram_io_service_desc_t* desc) SKR_NOEXCEPT
+{
+    auto job_queue = desc->decompress_job_queue ? desc->decompress_job_queue : desc->io_job_queue;
+    auto decompressor = skr::SObjectPtr<TaskDecompressor>::Create(&service->runner, job_queue);
+    return std::move(decompressor);
+}
 } // namespace RAMUtils
 
 uint32_t RAMService::global_idx = 0;
@@ -42,7 +68,11 @@ RAMService::RAMService(const skr_ram_io_service_desc_t* desc) SKR_NOEXCEPT
 
     if (desc->use_dstorage)
         runner.ds_reader = RAMUtils::CreateBatchReader(this, desc);
+    if (desc->use_io_uring && !runner.ds_reader)
+        runner.uring_reader = RAMUtils::CreateUringReader(this, desc);
+    runner.pak_reader = RAMUtils::CreatePakReader(this, desc);
     runner.vfs_reader = RAMUtils::CreateReader(this, desc);
+    runner.decompressor = RAMUtils::CreateDecompressor(this, desc);
 
     runner.set_resolvers();
 
@@ -93,11 +123,17 @@ void RAMService::request(IOBatchId batch) SKR_NOEXCEPT
 }
 
 RAMIOBufferId RAMService::request(IORequestId request, skr_io_future_t* future, SkrAsyncServicePriority priority) SKR_NOEXCEPT
+{
+    return this->request(request, future, priority, SKR_IO_DEADLINE_NONE);
+}
+
+RAMIOBufferId RAMService::request(IORequestId request, skr_io_future_t* future, SkrAsyncServicePriority priority, uint64_t deadline) SKR_NOEXCEPT
 {
     auto batch = open_batch(1);
     auto result = batch->add_request(request, future);
     auto buffer = skr::static_pointer_cast<RAMIOBuffer>(result);
     batch->set_priority(priority);
+    batch->set_deadline(deadline);
     this->request(batch);
     return buffer;
 }
@@ -173,12 +209,13 @@ void RAMService::Runner::enqueueBatch(const IOBatchId& batch) SKR_NOEXCEPT
 
 void RAMService::Runner::set_resolvers() SKR_NOEXCEPT
 {
-    auto alloc_buffer = SObjectPtr<AllocateIOBufferResolver>::Create();
+    const bool uring = uring_reader.get();
     auto chain = skr::static_pointer_cast<IORequestResolverChain>(IIORequestResolverChain::Create());
     chain->runner = this;
 
     IORequestResolverId open_file = nullptr;
     open_file = SObjectPtr<VFSFileResolver>::Create();
+    auto map_file = SObjectPtr<MappedFileResolver>::Create();
 
     IORequestResolverId open_dfile = nullptr;
     const bool dstorage = ds_reader.get();
@@ -188,15 +225,36 @@ void RAMService::Runner::set_resolvers() SKR_NOEXCEPT
         chain->then(open_dfile);
     }
 
-    chain->then(open_file)
-        ->then(alloc_buffer);
+#ifdef SKR_IO_URING_AVAILABLE
+    if (uring)
+    {
+        // page aligned buffers let block-aligned requests go through O_DIRECT
+        auto open_ufile = SObjectPtr<UringFileResolver>::Create();
+        auto alloc_buffer = SObjectPtr<AllocateIOBufferResolver>::Create(kUringDirectIOAlignment);
+        auto direct_io = SObjectPtr<UringDirectIOResolver>::Create();
+        chain->then(open_ufile)
+            ->then(open_file)
+            ->then(map_file)
+            ->then(alloc_buffer)
+            ->then(direct_io);
+    }
+    else
+#endif
+    {
+        auto alloc_buffer = SObjectPtr<AllocateIOBufferResolver>::Create();
+        chain->then(open_file)
+            ->then(map_file)
+            ->then(alloc_buffer);
+    }
         
     batch_buffer = SObjectPtr<IOBatchBuffer>::Create(); // hold batches
 
-    batch_processors = { batch_buffer, chain };
+    batch_processors = { batch_buffer, chain, pak_reader };
     if (dstorage)
         batch_processors.push_back(ds_reader);
-    request_processors = { vfs_reader };
+    if (uring)
+        batch_processors.push_back(uring_reader);
+    request_processors = { vfs_reader, decompressor };
 }
 
 } // namespace skr::io
\ No newline at end of file
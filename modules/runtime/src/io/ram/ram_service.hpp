@@ -15,6 +15,7 @@ struct RAMService final : public IRAMService
     [[nodiscard]] IOBatchId open_batch(uint64_t n) SKR_NOEXCEPT;
     [[nodiscard]] BlocksRAMRequestId open_request() SKR_NOEXCEPT;
     RAMIOBufferId request(IORequestId request, skr_io_future_t* future, SkrAsyncServicePriority priority) SKR_NOEXCEPT;
+    RAMIOBufferId request(IORequestId request, skr_io_future_t* future, SkrAsyncServicePriority priority, uint64_t deadline) SKR_NOEXCEPT;
     void request(IOBatchId request) SKR_NOEXCEPT;
     
     void cancel(skr_io_future_t* future) SKR_NOEXCEPT 
@@ -38,6 +39,9 @@ struct RAMService final : public IRAMService
         IOBatchBufferId batch_buffer = nullptr;
         IOReaderId<IIORequestProcessor> vfs_reader = nullptr;
         IOReaderId<IIOBatchProcessor> ds_reader = nullptr;
+        IOReaderId<IIOBatchProcessor> uring_reader = nullptr;
+        IOReaderId<IIOBatchProcessor> pak_reader = nullptr;
+        IODecompressorId<IIORequestProcessor> decompressor = nullptr;
         RAMService* service = nullptr;
     };
     const skr::string name;
@@ -0,0 +1,80 @@
+#include "uring_ring.hpp"
+#include "uring_resolvers.hpp"
+
+#ifdef SKR_IO_URING_AVAILABLE
+#include "SkrRT/platform/vfs.h"
+#include <SkrRT/platform/filesystem.hpp>
+#include "../common/io_request.hpp"
+#include "../ram/ram_request.hpp"
+#include "../ram/ram_buffer.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace skr {
+namespace io {
+
+static skr::filesystem::path UringResolvePath(const PathSrcComponent* pPath)
+{
+    skr::filesystem::path p = pPath->get_path();
+    if (!p.is_absolute() && pPath->get_vfs()->mount_dir)
+    {
+        p = pPath->get_vfs()->mount_dir;
+        p /= pPath->get_path();
+    }
+    return p;
+}
+
+void UringFileResolver::resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT
+{
+    auto pPath = io_component<PathSrcComponent>(request.get());
+    auto pFile = io_component<FileComponent>(request.get());
+    // mapped files are handed out without reading, leave them to the vfs
+    const bool mapped = pPath && pPath->get_vfs() && pPath->get_vfs()->procs.fmap;
+    if (pPath && pFile && !mapped && !pFile->dfile && !pFile->file && (pFile->fd < 0))
+    {
+        SkrZoneScopedN("Uring::OpenFile");
+
+        SKR_ASSERT(pPath->get_vfs());
+        const auto p = UringResolvePath(pPath);
+        pFile->fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        pFile->fd_direct = false;
+        // leave the request to VFSFileResolver if we failed
+        if (pFile->fd < 0)
+        {
+            SKR_LOG_TRACE(u8"io_uring: failed to open %s, fallback to vfs", p.u8string().c_str());
+        }
+    }
+}
+
+void UringDirectIOResolver::resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT
+{
+    auto pFile = io_component<FileComponent>(request.get());
+    auto pBlocks = io_component<BlocksComponent>(request.get());
+    if (!pFile || !pBlocks || (pFile->fd < 0) || pFile->fd_direct)
+        return;
+
+    auto rq = skr::static_pointer_cast<RAMRequestMixin>(request);
+    const auto aligned = [](uint64_t v) { return (v % kUringDirectIOAlignment) == 0; };
+    if (!rq->destination || !aligned((uint64_t)rq->get_read_buffer()))
+        return;
+    for (const auto& block : pBlocks->blocks)
+    {
+        if (!aligned(block.offset) || !aligned(block.size))
+            return;
+    }
+
+    SkrZoneScopedN("Uring::ReopenDirect");
+    auto pPath = io_component<PathSrcComponent>(request.get());
+    const auto p = UringResolvePath(pPath);
+    const int32_t dfd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+    if (dfd >= 0) // some filesystems (tmpfs) reject O_DIRECT, keep the buffered descriptor then
+    {
+        ::close(pFile->fd);
+        pFile->fd = dfd;
+        pFile->fd_direct = true;
+    }
+}
+
+} // namespace io
+} // namespace skr
+#endif
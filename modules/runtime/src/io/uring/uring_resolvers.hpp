@@ -0,0 +1,20 @@
+#pragma once
+#include "../common/io_resolver.hpp"
+
+namespace skr {
+namespace io {
+
+// opens a native descriptor for the io_uring reader, VFSFileResolver skips requests resolved here
+struct UringFileResolver final : public IORequestResolverBase
+{
+    void resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT;
+};
+
+// reopens the file with O_DIRECT when every block and the destination buffer are aligned
+struct UringDirectIOResolver final : public IORequestResolverBase
+{
+    void resolve(SkrAsyncServicePriority priority, IOBatchId batch, IORequestId request) SKR_NOEXCEPT;
+};
+
+} // namespace io
+} // namespace skr
@@ -0,0 +1,163 @@
+#include "uring_ring.hpp"
+
+#ifdef SKR_IO_URING_AVAILABLE
+#include "SkrRT/misc/log.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+
+namespace skr {
+namespace io {
+
+static int32_t uring_setup(uint32_t entries, io_uring_params* p)
+{
+    return (int32_t)::syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int32_t uring_enter(int32_t fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int32_t)::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, _NSIG / 8);
+}
+
+bool UringRing::init(uint32_t entries) SKR_NOEXCEPT
+{
+    io_uring_params params;
+    ::memset(&params, 0, sizeof(params));
+    ring_fd = uring_setup(entries, &params);
+    if (ring_fd < 0)
+    {
+        SKR_LOG_WARN(u8"io_uring_setup failed: %s", strerror(errno));
+        ring_fd = -1;
+        return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+    {
+        sq_ring_size = cq_ring_size = (sq_ring_size > cq_ring_size) ? sq_ring_size : cq_ring_size;
+    }
+
+    sq_ptr = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED)
+    {
+        sq_ptr = nullptr;
+        shutdown();
+        return false;
+    }
+    if (single_mmap)
+    {
+        cq_ptr = sq_ptr;
+    }
+    else
+    {
+        cq_ptr = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED)
+        {
+            cq_ptr = nullptr;
+            shutdown();
+            return false;
+        }
+    }
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    auto sqes = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        shutdown();
+        return false;
+    }
+
+    auto sq_base = (uint8_t*)sq_ptr;
+    sq.head = (uint32_t*)(sq_base + params.sq_off.head);
+    sq.tail = (uint32_t*)(sq_base + params.sq_off.tail);
+    sq.ring_mask = (uint32_t*)(sq_base + params.sq_off.ring_mask);
+    sq.ring_entries = (uint32_t*)(sq_base + params.sq_off.ring_entries);
+    sq.flags = (uint32_t*)(sq_base + params.sq_off.flags);
+    sq.array = (uint32_t*)(sq_base + params.sq_off.array);
+    sq.sqes = (io_uring_sqe*)sqes;
+
+    auto cq_base = (uint8_t*)cq_ptr;
+    cq.head = (uint32_t*)(cq_base + params.cq_off.head);
+    cq.tail = (uint32_t*)(cq_base + params.cq_off.tail);
+    cq.ring_mask = (uint32_t*)(cq_base + params.cq_off.ring_mask);
+    cq.ring_entries = (uint32_t*)(cq_base + params.cq_off.ring_entries);
+    cq.cqes = (io_uring_cqe*)(cq_base + params.cq_off.cqes);
+
+    sqe_head = sqe_tail = 0;
+    return true;
+}
+
+void UringRing::shutdown() SKR_NOEXCEPT
+{
+    if (sq.sqes)
+    {
+        ::munmap(sq.sqes, sqes_size);
+        sq.sqes = nullptr;
+    }
+    if (cq_ptr && cq_ptr != sq_ptr)
+    {
+        ::munmap(cq_ptr, cq_ring_size);
+    }
+    if (sq_ptr)
+    {
+        ::munmap(sq_ptr, sq_ring_size);
+    }
+    sq_ptr = cq_ptr = nullptr;
+    if (ring_fd >= 0)
+    {
+        ::close(ring_fd);
+        ring_fd = -1;
+    }
+}
+
+io_uring_sqe* UringRing::get_sqe() SKR_NOEXCEPT
+{
+    const uint32_t head = __atomic_load_n(sq.head, __ATOMIC_ACQUIRE);
+    if (sqe_tail - head >= *sq.ring_entries)
+        return nullptr;
+    auto sqe = &sq.sqes[sqe_tail & *sq.ring_mask];
+    sqe_tail += 1;
+    ::memset(sqe, 0, sizeof(io_uring_sqe));
+    return sqe;
+}
+
+uint32_t UringRing::flush() SKR_NOEXCEPT
+{
+    const uint32_t mask = *sq.ring_mask;
+    uint32_t tail = *sq.tail;
+    const uint32_t to_submit = sqe_tail - sqe_head;
+    for (uint32_t i = 0; i < to_submit; ++i)
+    {
+        sq.array[tail & mask] = sqe_head & mask;
+        tail += 1;
+        sqe_head += 1;
+    }
+    __atomic_store_n(sq.tail, tail, __ATOMIC_RELEASE);
+    return to_submit;
+}
+
+int32_t UringRing::submit(uint32_t wait_nr) SKR_NOEXCEPT
+{
+    const uint32_t to_submit = flush();
+    if (!to_submit && !wait_nr)
+        return 0;
+    const uint32_t flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+    int32_t ret = 0;
+    do
+    {
+        ret = uring_enter(ring_fd, to_submit, wait_nr, flags);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0)
+    {
+        SKR_LOG_ERROR(u8"io_uring_enter failed: %s", strerror(errno));
+    }
+    return ret;
+}
+
+} // namespace io
+} // namespace skr
+#endif
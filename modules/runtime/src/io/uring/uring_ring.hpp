@@ -0,0 +1,88 @@
+#pragma once
+#include "SkrRT/platform/configure.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <sys/syscall.h>
+    #if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+        #define SKR_IO_URING_AVAILABLE
+    #endif
+#endif
+
+#ifdef SKR_IO_URING_AVAILABLE
+#include <linux/io_uring.h>
+
+namespace skr {
+namespace io {
+
+// direct i/o requires offset, size and destination address aligned to the logical block size
+static constexpr uint64_t kUringDirectIOAlignment = 4096;
+static constexpr uint32_t kUringQueueDepth = 256;
+
+// minimal io_uring ring over raw syscalls, we don't want liburing as a dependency
+struct UringRing
+{
+    UringRing() SKR_NOEXCEPT = default;
+    ~UringRing() SKR_NOEXCEPT { shutdown(); }
+    UringRing(const UringRing&) = delete;
+    UringRing& operator=(const UringRing&) = delete;
+
+    bool init(uint32_t entries) SKR_NOEXCEPT;
+    void shutdown() SKR_NOEXCEPT;
+    bool valid() const SKR_NOEXCEPT { return ring_fd >= 0; }
+
+    // returns nullptr if the submission queue is full
+    io_uring_sqe* get_sqe() SKR_NOEXCEPT;
+    // flush prepared sqes to the kernel, optionally waiting for `wait_nr` completions
+    int32_t submit(uint32_t wait_nr = 0) SKR_NOEXCEPT;
+    uint32_t pending_submissions() const SKR_NOEXCEPT { return sqe_tail - sqe_head; }
+
+    template <typename F>
+    uint32_t reap(F&& f) SKR_NOEXCEPT
+    {
+        uint32_t head = *cq.head;
+        const uint32_t tail = __atomic_load_n(cq.tail, __ATOMIC_ACQUIRE);
+        uint32_t count = 0;
+        for (; head != tail; ++head, ++count)
+        {
+            f(cq.cqes[head & *cq.ring_mask]);
+        }
+        __atomic_store_n(cq.head, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+private:
+    uint32_t flush() SKR_NOEXCEPT;
+
+    struct SubmissionQueue
+    {
+        uint32_t* head = nullptr;
+        uint32_t* tail = nullptr;
+        uint32_t* ring_mask = nullptr;
+        uint32_t* ring_entries = nullptr;
+        uint32_t* flags = nullptr;
+        uint32_t* array = nullptr;
+        io_uring_sqe* sqes = nullptr;
+    } sq;
+    struct CompletionQueue
+    {
+        uint32_t* head = nullptr;
+        uint32_t* tail = nullptr;
+        uint32_t* ring_mask = nullptr;
+        uint32_t* ring_entries = nullptr;
+        io_uring_cqe* cqes = nullptr;
+    } cq;
+
+    int32_t ring_fd = -1;
+    uint32_t sqe_head = 0;
+    uint32_t sqe_tail = 0;
+
+    void* sq_ptr = nullptr;
+    void* cq_ptr = nullptr;
+    size_t sq_ring_size = 0;
+    size_t cq_ring_size = 0;
+    size_t sqes_size = 0;
+};
+
+} // namespace io
+} // namespace skr
+#endif
@@ -3,6 +3,7 @@
 #include "SkrRT/misc/defer.hpp"
 #include "vram_readers.hpp"
 #include <EASTL/fixed_map.h>
+#include <EASTL/fixed_vector.h>
 #include <tuple>
 
 // VFS READER IMPLEMENTATION
@@ -305,6 +306,43 @@ struct StackCmdAllocator : public eastl::fixed_map<StackCmdMapKey, GPUUploadCmd,
     }
 };
 
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint32_t get_mip_upload_layouts(ECGPUFormat format, uint32_t width, uint32_t height, uint32_t mip_levels,
+    uint64_t src_size, uint64_t offset_alignment, uint64_t row_alignment, MipUploadLayout* layouts, uint64_t* upload_size) SKR_NOEXCEPT
+{
+    offset_alignment = eastl::max<uint64_t>(offset_alignment, 1);
+    row_alignment = eastl::max<uint64_t>(row_alignment, 1);
+    const uint64_t block_w = FormatUtil_WidthOfBlock(format);
+    const uint64_t block_h = FormatUtil_HeightOfBlock(format);
+    const uint64_t block_size = FormatUtil_BitSizeOfBlock(format) / 8;
+    uint64_t src_offset = 0;
+    uint64_t size = 0;
+    uint32_t count = 0;
+    for (; count < mip_levels; ++count)
+    {
+        const uint64_t mip_w = eastl::max<uint64_t>(width >> count, 1);
+        const uint64_t mip_h = eastl::max<uint64_t>(height >> count, 1);
+        MipUploadLayout layout = {};
+        layout.src_offset = src_offset;
+        layout.row_size = ((mip_w + block_w - 1) / block_w) * block_size;
+        layout.rows = (mip_h + block_h - 1) / block_h;
+        // files holding fewer mips than the texture upload the ones they have
+        if (src_offset + layout.row_size * layout.rows > src_size)
+            break;
+        layout.row_pitch = AlignUp(layout.row_size, row_alignment);
+        layout.dst_offset = AlignUp(size, offset_alignment);
+        size = layout.dst_offset + layout.row_pitch * layout.rows;
+        src_offset += layout.row_size * layout.rows;
+        layouts[count] = layout;
+    }
+    if (upload_size) *upload_size = size;
+    return count;
+}
+
 void CommonVRAMReader::addUploadRequests(SkrAsyncServicePriority priority) SKR_NOEXCEPT
 {
     SkrZoneScopedN("VRAMReader::UploadRequests");
@@ -372,7 +410,15 @@ void CommonVRAMReader::addUploadRequests(SkrAsyncServicePriority priority) SKR_N
             }
             else if (auto pTexture = io_component<VRAMTextureComponent>(vram_request.get()))
             {
+                // mips start on the placement alignment of the backend, block rows are padded to its row pitch alignment
+                const auto info = pTexture->texture->info;
+                const auto detail = cgpu_query_adapter_detail(cmdqueue->device->adapter);
+                eastl::fixed_vector<MipUploadLayout, 16> layouts(info->mip_levels);
+                uint64_t upload_size = 0;
+                layouts.resize(get_mip_upload_layouts(info->format, (uint32_t)info->width, (uint32_t)info->height, info->mip_levels, pUpload->src_size,
+                    detail->upload_buffer_texture_alignment, detail->upload_buffer_texture_row_alignment, layouts.data(), &upload_size));
                 CGPUBufferId upload_buffer = nullptr;
+                if (upload_size)
                 {
                     // prepare upload buffer
                     SkrZoneScopedN("PrepareUploadBuffer");
@@ -383,23 +429,41 @@ void CommonVRAMReader::addUploadRequests(SkrAsyncServicePriority priority) SKR_N
 #endif
                     skr::string name = /*pBuffer->name ? buffer_io.vbuffer.buffer_name :*/ u8"";
                     name += u8"-upload";
-                    upload_buffer = cgpux_create_mapped_upload_buffer(cmdqueue->device, pUpload->src_size, name.u8_str());
+                    upload_buffer = cgpux_create_mapped_upload_buffer(cmdqueue->device, upload_size, name.u8_str());
                     cmd.upload_buffers.emplace_back(upload_buffer);
 
-                    memcpy(upload_buffer->info->cpu_mapped_address, pUpload->src_data, pUpload->src_size);
+                    auto dst_data = (uint8_t*)upload_buffer->info->cpu_mapped_address;
+                    const auto src_data = (const uint8_t*)pUpload->src_data;
+                    for (const auto& layout : layouts)
+                    {
+                        if (layout.row_pitch == layout.row_size)
+                        {
+                            memcpy(dst_data + layout.dst_offset, src_data + layout.src_offset, layout.row_size * layout.rows);
+                            continue;
+                        }
+                        for (uint64_t row = 0; row < layout.rows; ++row)
+                        {
+                            memcpy(dst_data + layout.dst_offset + row * layout.row_pitch,
+                                src_data + layout.src_offset + row * layout.row_size, layout.row_size);
+                        }
+                    }
                 }
                 if (upload_buffer)
                 {
-                    CGPUBufferToTextureTransfer tex_cpy = {};
-                    tex_cpy.dst = pTexture->texture;
-                    tex_cpy.dst_subresource.aspects = CGPU_TVA_COLOR;
-                    // TODO: texture array & mips
-                    tex_cpy.dst_subresource.base_array_layer = 0;
-                    tex_cpy.dst_subresource.layer_count = 1;
-                    tex_cpy.dst_subresource.mip_level = 0;
-                    tex_cpy.src = upload_buffer;
-                    tex_cpy.src_offset = 0;
-                    cgpu_cmd_transfer_buffer_to_texture(cmdbuf, &tex_cpy);
+                    for (uint32_t mip = 0; mip < (uint32_t)layouts.size(); ++mip)
+                    {
+                        CGPUBufferToTextureTransfer tex_cpy = {};
+                        tex_cpy.dst = pTexture->texture;
+                        tex_cpy.dst_subresource.aspects = CGPU_TVA_COLOR;
+                        // TODO: texture array
+                        tex_cpy.dst_subresource.base_array_layer = 0;
+                        tex_cpy.dst_subresource.layer_count = 1;
+                        tex_cpy.dst_subresource.mip_level = mip;
+                        tex_cpy.src = upload_buffer;
+                        tex_cpy.src_offset = layouts[mip].dst_offset;
+                        tex_cpy.src_row_pitch = (uint32_t)layouts[mip].row_pitch;
+                        cgpu_cmd_transfer_buffer_to_texture(cmdbuf, &tex_cpy);
+                    }
                 }
                 auto&& Artifact = skr::static_pointer_cast<VRAMTexture>(pTexture->artifact);
                 Artifact->texture = pTexture->texture;
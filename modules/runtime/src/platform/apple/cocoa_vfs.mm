@@ -21,7 +21,10 @@ skr_vfs_t* skr_create_vfs(const skr_vfs_desc_t* desc) SKR_NOEXCEPT
     bool success = true;
     auto fs = (skr_vfs_t*)sakura_calloc(1, sizeof(skr_vfs_t));
     fs->mount_type = desc->mount_type;
-    skr_vfs_get_native_procs(&fs->procs);
+    if (desc->use_mmap)
+        skr_vfs_get_mmap_procs(&fs->procs);
+    else
+        skr_vfs_get_native_procs(&fs->procs);
     NSError* error = nil;
 
     NSFileManager* fileManager = [NSFileManager defaultManager];
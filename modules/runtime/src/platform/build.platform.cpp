@@ -1,6 +1,7 @@
 #include "SkrRT/platform/configure.h"
 #include "debug.cpp"
 #include "vfs.cpp"
+#include "pak_vfs.cpp"
 #include "guid.cpp"
 
 #include "standard/stdio_vfs.cpp"
@@ -14,10 +15,15 @@
         #include "linux/crash_handler.cpp"
     #endif
     #include "unix/unix_vfs.cpp"
+    #include "unix/unix_mmap_vfs.cpp"
+    #if defined(SKR_OS_LINUX)
+        #include "linux/linux_vfs.cpp"
+    #endif
     #include "unix/process.cpp"
     #include "unix/crash_handler.cpp"
 #elif defined(SKR_OS_WINDOWS)
     #include "windows/windows_vfs.cpp"
+    #include "windows/windows_mmap_vfs.cpp"
     #include "windows/process.cpp"
     #include "windows/crash_handler.cpp"
 #endif
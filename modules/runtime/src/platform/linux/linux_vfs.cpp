@@ -0,0 +1,84 @@
+#include "SkrRT/platform/vfs.h"
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/misc/log.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include <pwd.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+
+inline static char8_t* duplicate_string(const char8_t* src_string) SKR_NOEXCEPT
+{
+    if (src_string != nullptr)
+    {
+        const size_t source_len = strlen((const char*)src_string);
+        char8_t* result = (char8_t*)sakura_malloc(sizeof(char8_t) * (1 + source_len));
+        strcpy((char*)result, (const char*)src_string);
+        return result;
+    }
+    return nullptr;
+}
+
+inline static const char* linux_home_directory() SKR_NOEXCEPT
+{
+    if (const char* home = getenv("HOME"))
+        return home;
+    const passwd* pw = getpwuid(getuid());
+    return pw ? pw->pw_dir : nullptr;
+}
+
+#define LINUX_FS_MAX_PATH 4096
+skr_vfs_t* skr_create_vfs(const skr_vfs_desc_t* desc) SKR_NOEXCEPT
+{
+    SKR_ASSERT(desc);
+    auto fs = (skr_vfs_t*)sakura_calloc(1, sizeof(skr_vfs_t));
+    fs->mount_type = desc->mount_type;
+    if (desc->use_mmap)
+        skr_vfs_get_mmap_procs(&fs->procs);
+    else
+        skr_vfs_get_native_procs(&fs->procs);
+    fs->mount_dir = nullptr;
+
+    // Override Resource mounts
+    if (desc->override_mount_dir)
+    {
+        fs->mount_dir = duplicate_string(desc->override_mount_dir);
+    }
+    else if (desc->mount_type == SKR_MOUNT_TYPE_DOCUMENTS)
+    {
+        // xdg user dirs are not resolved, ~/Documents is their default
+        if (const char* home = linux_home_directory())
+        {
+            const auto documents = (skr::filesystem::path(home) / "Documents").u8string();
+            fs->mount_dir = duplicate_string((const char8_t*)documents.c_str());
+        }
+    }
+    else
+    {
+        // Get application directory
+        char applicationFilePath[LINUX_FS_MAX_PATH] = {};
+        const ssize_t length = readlink("/proc/self/exe", applicationFilePath, LINUX_FS_MAX_PATH - 1);
+        if (length > 0)
+        {
+            const skr::filesystem::path p(applicationFilePath);
+            const auto parentPath = p.parent_path().u8string();
+            fs->mount_dir = duplicate_string((const char8_t*)parentPath.c_str());
+        }
+    }
+    if (!fs->mount_dir)
+    {
+        SKR_LOG_ERROR(u8"Failed to resolve the mount directory of vfs %s", desc->app_name ? desc->app_name : u8"");
+        skr_free_vfs(fs);
+        return nullptr;
+    }
+    return fs;
+}
+
+void skr_free_vfs(skr_vfs_t* fs) SKR_NOEXCEPT
+{
+    if (fs)
+    {
+        if (fs->mount_dir) sakura_free(fs->mount_dir);
+        sakura_free(fs);
+    }
+}
@@ -0,0 +1,367 @@
+#include "SkrRT/platform/pak_vfs.h"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/misc/hash.h"
+#include "SkrRT/misc/log.h"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/containers/string.hpp"
+#include <EASTL/sort.h>
+#include <string.h>
+
+#include "SkrProfile/profile.h"
+
+struct skr_pak_vfs_t : public skr_vfs_t {
+    skr_vfs_t* archive_fs;
+    skr_vfile_t* archive;
+    skr_pak_header_t header;
+    skr::vector<skr_pak_entry_t> toc;
+    skr::vector<char8_t> names;
+    // stdio files seek before each read, so reads of an unmapped archive are serialized
+    SMutex read_mutex;
+};
+
+struct skr_vfile_pak_t : public skr_vfile_t {
+    const skr_pak_entry_t* entry;
+};
+
+struct skr_pak_writer_t {
+    struct Entry
+    {
+        skr::string entry_path;
+        skr_vfs_t* src_fs;
+        skr::string src_path;
+    };
+    uint32_t alignment;
+    skr::vector<Entry> entries;
+};
+
+// strips the leading "./" and "/" of a path, backslashes count as slashes
+inline static const char8_t* skr_pak_skip_prefix(const char8_t* p, uint64_t& n) SKR_NOEXCEPT
+{
+    const auto slash = [](char8_t c) { return c == u8'/' || c == u8'\\'; };
+    while (n >= 2 && p[0] == u8'.' && slash(p[1])) { p += 2; n -= 2; }
+    while (n >= 1 && slash(p[0])) { p += 1; n -= 1; }
+    return p;
+}
+
+inline static skr::string skr_pak_normalize_path(const char8_t* path) SKR_NOEXCEPT
+{
+    uint64_t n = strlen((const char*)path);
+    const char8_t* p = skr_pak_skip_prefix(path, n);
+    skr::vector<char8_t> buffer(p, p + n);
+    for (auto& c : buffer)
+    {
+        if (c == u8'\\') c = u8'/';
+    }
+    return skr::string(skr::string_view(buffer.data(), buffer.size()));
+}
+
+inline static uint64_t skr_pak_hash_path(const char8_t* path, uint64_t size) SKR_NOEXCEPT
+{
+    return skr_hash64(path, size, SKR_DEFAULT_HASH_SEED_64);
+}
+
+inline static uint64_t skr_pak_hash_path(const skr::string& path) SKR_NOEXCEPT
+{
+    return skr_pak_hash_path(path.u8_str(), path.raw().size());
+}
+
+static const skr_pak_entry_t* skr_pak_find_normalized(const skr_pak_vfs_t* pak, const char8_t* path, uint64_t size) SKR_NOEXCEPT
+{
+    const auto hash = skr_pak_hash_path(path, size);
+    auto it = eastl::lower_bound(pak->toc.begin(), pak->toc.end(), hash,
+        [](const skr_pak_entry_t& entry, uint64_t h) { return entry.hash < h; });
+    for (; it != pak->toc.end() && it->hash == hash; ++it)
+    {
+        if (it->name_size == size && !memcmp(pak->names.data() + it->name_offset, path, size))
+            return it;
+    }
+    return nullptr;
+}
+
+static const skr_pak_entry_t* skr_pak_find_entry(const skr_pak_vfs_t* pak, const char8_t* path) SKR_NOEXCEPT
+{
+    uint64_t n = strlen((const char*)path);
+    const char8_t* p = skr_pak_skip_prefix(path, n);
+    // the toc stores forward slashes, so only paths with backslashes are copied to be normalized
+    if (!memchr(p, '\\', n))
+        return skr_pak_find_normalized(pak, p, n);
+    const auto normalized = skr_pak_normalize_path(p);
+    return skr_pak_find_normalized(pak, normalized.u8_str(), normalized.raw().size());
+}
+
+size_t skr_pak_vfs_read_archive(skr_vfs_t* fs, void* out_buffer, uint64_t archive_offset, uint64_t byte_count) SKR_NOEXCEPT
+{
+    SKR_ASSERT(skr_vfs_is_pak(fs));
+    auto pak = (skr_pak_vfs_t*)fs;
+    if (auto mapped = skr_vfs_fmap(pak->archive, archive_offset, byte_count))
+    {
+        memcpy(out_buffer, mapped, byte_count);
+        return byte_count;
+    }
+    SMutexLock lock(pak->read_mutex);
+    return skr_vfs_fread(pak->archive, out_buffer, archive_offset, byte_count);
+}
+
+skr_vfile_t* skr_pak_fopen(skr_vfs_t* fs, const char8_t* path, ESkrFileMode mode, ESkrFileCreation creation) SKR_NOEXCEPT
+{
+    if (mode & (SKR_FM_WRITE | SKR_FM_APPEND))
+    {
+        SKR_LOG_ERROR(u8"pak vfs is read-only, failed to open %s for writing", path);
+        return nullptr;
+    }
+    SkrZoneScopedN("pak::fopen");
+    auto pak = (skr_pak_vfs_t*)fs;
+    auto entry = skr_pak_find_entry(pak, path);
+    if (!entry)
+    {
+        SKR_LOG_BACKTRACE(u8"File not found in pak: %s", path);
+        return nullptr;
+    }
+    skr_vfile_pak_t* vfile = SkrNew<skr_vfile_pak_t>();
+    vfile->mode = mode;
+    vfile->fs = fs;
+    vfile->size = (ssize_t)entry->size;
+    vfile->entry = entry;
+    return vfile;
+}
+
+size_t skr_pak_fread(skr_vfile_t* file, void* out_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SkrZoneScopedN("vfs::fread");
+
+        auto vfile = (skr_vfile_pak_t*)file;
+        if (offset >= vfile->entry->size)
+            return 0;
+        const size_t count = (offset + byte_count > vfile->entry->size) ? vfile->entry->size - offset : byte_count;
+        return skr_pak_vfs_read_archive(file->fs, out_buffer, vfile->entry->offset + offset, count);
+    }
+    return -1;
+}
+
+size_t skr_pak_fwrite(skr_vfile_t* file, const void* in_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    SKR_LOG_ERROR(u8"pak vfs is read-only!");
+    return -1;
+}
+
+ssize_t skr_pak_fsize(const skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        return file->size;
+    }
+    return -1;
+}
+
+const uint8_t* skr_pak_fmap(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_pak_t*)file;
+    if (!vfile || (offset + byte_count > vfile->entry->size))
+        return nullptr;
+    auto pak = (skr_pak_vfs_t*)file->fs;
+    return skr_vfs_fmap(pak->archive, vfile->entry->offset + offset, byte_count);
+}
+
+void skr_pak_fprefetch(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_pak_t*)file;
+    if (!vfile || (offset >= vfile->entry->size))
+        return;
+    auto pak = (skr_pak_vfs_t*)file->fs;
+    skr_vfs_fprefetch(pak->archive, vfile->entry->offset + offset, byte_count);
+}
+
+bool skr_pak_fclose(skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SKR_ASSERT(file->fs->procs.fclose == &skr_pak_fclose);
+        auto vfile = (skr_vfile_pak_t*)file;
+        SkrDelete(vfile);
+        return true;
+    }
+    return false;
+}
+
+// true if [offset, offset + size) lies in [0, limit), written to not overflow on hostile values
+inline static bool skr_pak_range_ok(uint64_t offset, uint64_t size, uint64_t limit) SKR_NOEXCEPT
+{
+    return (offset <= limit) && (size <= limit - offset);
+}
+
+// lookups binary search the toc and read names and contents without further checks, so every entry is
+// validated once when the archive is opened
+static bool skr_pak_validate_toc(const skr_pak_header_t& header, const skr::vector<skr_pak_entry_t>& toc) SKR_NOEXCEPT
+{
+    for (uint64_t i = 0; i < toc.size(); ++i)
+    {
+        const auto& entry = toc[i];
+        // contents live between the header and the toc
+        if ((entry.offset < sizeof(skr_pak_header_t)) || !skr_pak_range_ok(entry.offset, entry.size, header.toc_offset))
+            return false;
+        if (!skr_pak_range_ok(entry.name_offset, entry.name_size, header.names_size))
+            return false;
+        if (i && (toc[i - 1].hash > entry.hash))
+            return false;
+    }
+    return true;
+}
+
+skr_vfs_t* skr_create_pak_vfs(const skr_pak_vfs_desc_t* desc) SKR_NOEXCEPT
+{
+    SKR_ASSERT(desc && desc->archive_fs && desc->archive_path);
+    SkrZoneScopedN("pak::LoadTOC");
+    auto archive = skr_vfs_fopen(desc->archive_fs, desc->archive_path, SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+    if (!archive)
+        return nullptr;
+
+    skr_pak_header_t header = {};
+    const auto archive_size = (uint64_t)skr_vfs_fsize(archive);
+    const bool header_ok = (archive_size >= sizeof(header)) &&
+        (skr_vfs_fread(archive, &header, 0, sizeof(header)) == sizeof(header)) &&
+        (header.magic == SKR_PAK_MAGIC) && (header.version == SKR_PAK_VERSION) &&
+        skr_pak_range_ok(header.toc_offset, (uint64_t)header.entry_count * sizeof(skr_pak_entry_t), archive_size) &&
+        skr_pak_range_ok(header.names_offset, header.names_size, archive_size);
+    if (!header_ok)
+    {
+        SKR_LOG_ERROR(u8"Invalid pak archive: %s", desc->archive_path);
+        skr_vfs_fclose(archive);
+        return nullptr;
+    }
+
+    skr::vector<skr_pak_entry_t> toc(header.entry_count);
+    skr::vector<char8_t> names(header.names_size);
+    const uint64_t toc_size = toc.size() * sizeof(skr_pak_entry_t);
+    const bool toc_ok = (!toc_size || skr_vfs_fread(archive, toc.data(), header.toc_offset, toc_size) == toc_size) &&
+        (!names.size() || skr_vfs_fread(archive, names.data(), header.names_offset, names.size()) == names.size()) &&
+        skr_pak_validate_toc(header, toc);
+    if (!toc_ok)
+    {
+        SKR_LOG_ERROR(u8"Corrupt pak archive, an entry lies outside of the archive: %s", desc->archive_path);
+        skr_vfs_fclose(archive);
+        return nullptr;
+    }
+
+    auto pak = SkrNew<skr_pak_vfs_t>();
+    pak->mount_type = SKR_MOUNT_TYPE_CUSTOM;
+    pak->mount_dir = nullptr;
+    pak->archive_fs = desc->archive_fs;
+    pak->archive = archive;
+    pak->header = header;
+    pak->toc = std::move(toc);
+    pak->names = std::move(names);
+    skr_init_mutex(&pak->read_mutex);
+
+    pak->procs.fopen = &skr_pak_fopen;
+    pak->procs.fclose = &skr_pak_fclose;
+    pak->procs.fread = &skr_pak_fread;
+    pak->procs.fwrite = &skr_pak_fwrite;
+    pak->procs.fsize = &skr_pak_fsize;
+    pak->procs.fmap = &skr_pak_fmap;
+    pak->procs.fprefetch = &skr_pak_fprefetch;
+    return pak;
+}
+
+void skr_free_pak_vfs(skr_vfs_t* fs) SKR_NOEXCEPT
+{
+    if (fs)
+    {
+        SKR_ASSERT(skr_vfs_is_pak(fs));
+        auto pak = (skr_pak_vfs_t*)fs;
+        skr_vfs_fclose(pak->archive);
+        skr_destroy_mutex(&pak->read_mutex);
+        SkrDelete(pak);
+    }
+}
+
+bool skr_vfs_is_pak(const skr_vfs_t* fs) SKR_NOEXCEPT
+{
+    return fs && (fs->procs.fopen == &skr_pak_fopen);
+}
+
+bool skr_pak_vfs_locate(const skr_vfile_t* file, uint64_t* archive_offset) SKR_NOEXCEPT
+{
+    if (!file || !skr_vfs_is_pak(file->fs))
+        return false;
+    auto vfile = (const skr_vfile_pak_t*)file;
+    *archive_offset = vfile->entry->offset;
+    return true;
+}
+
+skr_pak_writer_t* skr_create_pak_writer(uint32_t alignment) SKR_NOEXCEPT
+{
+    auto writer = SkrNew<skr_pak_writer_t>();
+    writer->alignment = alignment ? alignment : SKR_PAK_DEFAULT_ALIGNMENT;
+    return writer;
+}
+
+void skr_free_pak_writer(skr_pak_writer_t* writer) SKR_NOEXCEPT
+{
+    SkrDelete(writer);
+}
+
+void skr_pak_writer_add_file(skr_pak_writer_t* writer, const char8_t* entry_path, skr_vfs_t* src_fs, const char8_t* src_path) SKR_NOEXCEPT
+{
+    writer->entries.emplace_back(skr_pak_writer_t::Entry{ skr_pak_normalize_path(entry_path), src_fs, skr::string(src_path) });
+}
+
+bool skr_pak_writer_write(skr_pak_writer_t* writer, skr_vfs_t* fs, const char8_t* path) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("pak::Write");
+    auto out = skr_vfs_fopen(fs, path, SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+    if (!out)
+        return false;
+
+    const uint64_t alignment = writer->alignment;
+    const auto align_up = [alignment](uint64_t v) { return (v + alignment - 1) / alignment * alignment; };
+    skr::vector<skr_pak_entry_t> toc;
+    skr::vector<char8_t> names;
+    skr::vector<uint8_t> content;
+    toc.reserve(writer->entries.size());
+    uint64_t cursor = align_up(sizeof(skr_pak_header_t));
+    bool success = true;
+    // file contents are laid out in insertion order, so callers control which files end up adjacent
+    for (const auto& entry : writer->entries)
+    {
+        auto src = skr_vfs_fopen(entry.src_fs, entry.src_path.u8_str(), SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+        if (!src)
+        {
+            success = false;
+            continue;
+        }
+        const auto size = (uint64_t)skr_vfs_fsize(src);
+        content.resize(size);
+        if (size) skr_vfs_fread(src, content.data(), 0, size);
+        skr_vfs_fclose(src);
+        if (size) skr_vfs_fwrite(out, content.data(), cursor, size);
+
+        skr_pak_entry_t pak_entry = {};
+        pak_entry.hash = skr_pak_hash_path(entry.entry_path);
+        pak_entry.offset = cursor;
+        pak_entry.size = size;
+        pak_entry.name_offset = (uint32_t)names.size();
+        pak_entry.name_size = (uint32_t)entry.entry_path.raw().size();
+        names.insert(names.end(), entry.entry_path.u8_str(), entry.entry_path.u8_str() + pak_entry.name_size);
+        toc.emplace_back(pak_entry);
+        cursor = align_up(cursor + size);
+    }
+    eastl::stable_sort(toc.begin(), toc.end(),
+        [](const skr_pak_entry_t& a, const skr_pak_entry_t& b) { return a.hash < b.hash; });
+
+    skr_pak_header_t header = {};
+    header.magic = SKR_PAK_MAGIC;
+    header.version = SKR_PAK_VERSION;
+    header.alignment = writer->alignment;
+    header.entry_count = (uint32_t)toc.size();
+    header.toc_offset = cursor;
+    header.names_offset = header.toc_offset + toc.size() * sizeof(skr_pak_entry_t);
+    header.names_size = names.size();
+    if (!toc.empty()) skr_vfs_fwrite(out, toc.data(), header.toc_offset, toc.size() * sizeof(skr_pak_entry_t));
+    if (!names.empty()) skr_vfs_fwrite(out, names.data(), header.names_offset, names.size());
+    skr_vfs_fwrite(out, &header, 0, sizeof(header));
+    skr_vfs_fclose(out);
+    return success;
+}
@@ -0,0 +1,151 @@
+#include "SkrRT/platform/vfs.h"
+#include "SkrRT/misc/log.h"
+#include <SkrRT/platform/filesystem.hpp>
+#include "SkrRT/platform/memory.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SkrProfile/profile.h"
+
+struct skr_vfile_mmap_t : public skr_vfile_t {
+    int fd;
+    uint8_t* mapped;
+};
+
+skr_vfile_t* skr_mmap_fopen(skr_vfs_t* fs, const char8_t* path, ESkrFileMode mode, ESkrFileCreation creation) SKR_NOEXCEPT
+{
+    if (mode & (SKR_FM_WRITE | SKR_FM_APPEND))
+    {
+        SKR_LOG_ERROR(u8"mmap vfs is read-only, failed to open %s for writing", path);
+        return nullptr;
+    }
+    skr::filesystem::path p = path;
+    if (!p.is_absolute() && fs->mount_dir)
+    {
+        p = fs->mount_dir;
+        p /= path;
+    }
+    const auto filePath = p.u8string();
+    int fd = -1;
+    {
+        SkrZoneScopedN("mmap::open");
+        fd = ::open((const char*)filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0)
+    {
+        SKR_LOG_ERROR(u8"Error opening file: %s (error: %s)", filePath.c_str(), strerror(errno));
+        return nullptr;
+    }
+    struct stat st = {};
+    if (::fstat(fd, &st) != 0)
+    {
+        SKR_LOG_ERROR(u8"Error stating file: %s (error: %s)", filePath.c_str(), strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+    // mmap can't map empty files
+    uint8_t* mapped = nullptr;
+    if (st.st_size > 0)
+    {
+        SkrZoneScopedN("mmap::mmap");
+        // copy-on-write, consumers may patch or decompress in place without touching the file
+        void* ptr = ::mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            SKR_LOG_ERROR(u8"Error mapping file: %s (error: %s)", filePath.c_str(), strerror(errno));
+            ::close(fd);
+            return nullptr;
+        }
+        mapped = (uint8_t*)ptr;
+    }
+    skr_vfile_mmap_t* vfile = SkrNew<skr_vfile_mmap_t>();
+    vfile->mode = mode;
+    vfile->fs = fs;
+    vfile->size = (ssize_t)st.st_size;
+    vfile->fd = fd;
+    vfile->mapped = mapped;
+    return vfile;
+}
+
+const uint8_t* skr_mmap_fmap(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_mmap_t*)file;
+    if (!vfile || !vfile->mapped || (offset + byte_count > (size_t)vfile->size))
+        return nullptr;
+    return vfile->mapped + offset;
+}
+
+void skr_mmap_fprefetch(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_mmap_t*)file;
+    if (!vfile || !vfile->mapped || (offset >= (size_t)vfile->size))
+        return;
+    SkrZoneScopedN("mmap::madvise");
+    // madvise wants a page aligned address
+    const size_t page_size = (size_t)::sysconf(_SC_PAGESIZE);
+    const size_t begin = offset - (offset % page_size);
+    const size_t end = (offset + byte_count < (size_t)vfile->size) ? offset + byte_count : (size_t)vfile->size;
+    ::madvise(vfile->mapped + begin, end - begin, MADV_WILLNEED);
+}
+
+size_t skr_mmap_fread(skr_vfile_t* file, void* out_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SkrZoneScopedN("vfs::fread");
+
+        auto vfile = (skr_vfile_mmap_t*)file;
+        if (offset >= (size_t)vfile->size)
+            return 0;
+        const size_t count = (offset + byte_count > (size_t)vfile->size) ? (size_t)vfile->size - offset : byte_count;
+        memcpy(out_buffer, vfile->mapped + offset, count);
+        return count;
+    }
+    return -1;
+}
+
+size_t skr_mmap_fwrite(skr_vfile_t* file, const void* in_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    SKR_LOG_ERROR(u8"mmap vfs is read-only!");
+    return -1;
+}
+
+ssize_t skr_mmap_fsize(const skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        return file->size;
+    }
+    return -1;
+}
+
+bool skr_mmap_fclose(skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SKR_ASSERT(file->fs->procs.fclose == &skr_mmap_fclose);
+        auto vfile = (skr_vfile_mmap_t*)file;
+        if (vfile->mapped)
+        {
+            ::munmap(vfile->mapped, (size_t)vfile->size);
+        }
+        auto code = ::close(vfile->fd);
+        SkrDelete(vfile);
+        return code == 0;
+    }
+    return false;
+}
+
+void skr_vfs_get_mmap_procs(struct skr_vfs_proctable_t* procs) SKR_NOEXCEPT
+{
+    procs->fopen = &skr_mmap_fopen;
+    procs->fclose = &skr_mmap_fclose;
+    procs->fread = &skr_mmap_fread;
+    procs->fwrite = &skr_mmap_fwrite;
+    procs->fsize = &skr_mmap_fsize;
+    procs->fmap = &skr_mmap_fmap;
+    procs->fprefetch = &skr_mmap_fprefetch;
+}
@@ -49,4 +49,17 @@ ssize_t skr_vfs_fsize(const skr_vfile_t* file) SKR_NOEXCEPT
 bool skr_vfs_fclose(skr_vfile_t* file) SKR_NOEXCEPT
 {
     return file->fs->procs.fclose(file);
+}
+
+const uint8_t* skr_vfs_fmap(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    if (file->fs->procs.fmap)
+        return file->fs->procs.fmap(file, offset, byte_count);
+    return nullptr;
+}
+
+void skr_vfs_fprefetch(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    if (file->fs->procs.fprefetch)
+        file->fs->procs.fprefetch(file, offset, byte_count);
 }
\ No newline at end of file
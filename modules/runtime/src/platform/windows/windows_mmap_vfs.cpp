@@ -0,0 +1,143 @@
+#include "SkrRT/platform/vfs.h"
+#include "SkrRT/misc/log.h"
+#include <SkrRT/platform/filesystem.hpp>
+#include "SkrRT/platform/memory.h"
+#include "winheaders.h"
+
+#include "SkrProfile/profile.h"
+
+struct skr_vfile_mmap_t : public skr_vfile_t {
+    HANDLE file;
+    HANDLE mapping;
+    uint8_t* mapped;
+};
+
+skr_vfile_t* skr_mmap_fopen(skr_vfs_t* fs, const char8_t* path, ESkrFileMode mode, ESkrFileCreation creation) SKR_NOEXCEPT
+{
+    if (mode & (SKR_FM_WRITE | SKR_FM_APPEND))
+    {
+        SKR_LOG_ERROR(u8"mmap vfs is read-only, failed to open %s for writing", path);
+        return nullptr;
+    }
+    skr::filesystem::path p = path;
+    if (!p.is_absolute() && fs->mount_dir)
+    {
+        p = fs->mount_dir;
+        p /= path;
+    }
+    HANDLE file = INVALID_HANDLE_VALUE;
+    {
+        SkrZoneScopedN("mmap::CreateFile");
+        file = CreateFileW(p.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    }
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        SKR_LOG_ERROR(u8"Error opening file: %s (error: %d)", p.u8string().c_str(), GetLastError());
+        return nullptr;
+    }
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(file, &size);
+    // CreateFileMapping fails on empty files
+    HANDLE mapping = NULL;
+    uint8_t* mapped = nullptr;
+    if (size.QuadPart > 0)
+    {
+        SkrZoneScopedN("mmap::MapViewOfFile");
+        // copy-on-write, consumers may patch or decompress in place without touching the file
+        mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        mapped = mapping ? (uint8_t*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+        if (!mapped)
+        {
+            SKR_LOG_ERROR(u8"Error mapping file: %s (error: %d)", p.u8string().c_str(), GetLastError());
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            return nullptr;
+        }
+    }
+    skr_vfile_mmap_t* vfile = SkrNew<skr_vfile_mmap_t>();
+    vfile->mode = mode;
+    vfile->fs = fs;
+    vfile->size = (ssize_t)size.QuadPart;
+    vfile->file = file;
+    vfile->mapping = mapping;
+    vfile->mapped = mapped;
+    return vfile;
+}
+
+const uint8_t* skr_mmap_fmap(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_mmap_t*)file;
+    if (!vfile || !vfile->mapped || (offset + byte_count > (size_t)vfile->size))
+        return nullptr;
+    return vfile->mapped + offset;
+}
+
+void skr_mmap_fprefetch(skr_vfile_t* file, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    auto vfile = (skr_vfile_mmap_t*)file;
+    if (!vfile || !vfile->mapped || (offset >= (size_t)vfile->size))
+        return;
+    SkrZoneScopedN("mmap::PrefetchVirtualMemory");
+    const size_t end = (offset + byte_count < (size_t)vfile->size) ? offset + byte_count : (size_t)vfile->size;
+    WIN32_MEMORY_RANGE_ENTRY range = {};
+    range.VirtualAddress = vfile->mapped + offset;
+    range.NumberOfBytes = end - offset;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+size_t skr_mmap_fread(skr_vfile_t* file, void* out_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SkrZoneScopedN("vfs::fread");
+
+        auto vfile = (skr_vfile_mmap_t*)file;
+        if (offset >= (size_t)vfile->size)
+            return 0;
+        const size_t count = (offset + byte_count > (size_t)vfile->size) ? (size_t)vfile->size - offset : byte_count;
+        memcpy(out_buffer, vfile->mapped + offset, count);
+        return count;
+    }
+    return -1;
+}
+
+size_t skr_mmap_fwrite(skr_vfile_t* file, const void* in_buffer, size_t offset, size_t byte_count) SKR_NOEXCEPT
+{
+    SKR_LOG_ERROR(u8"mmap vfs is read-only!");
+    return -1;
+}
+
+ssize_t skr_mmap_fsize(const skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        return file->size;
+    }
+    return -1;
+}
+
+bool skr_mmap_fclose(skr_vfile_t* file) SKR_NOEXCEPT
+{
+    if (file)
+    {
+        SKR_ASSERT(file->fs->procs.fclose == &skr_mmap_fclose);
+        auto vfile = (skr_vfile_mmap_t*)file;
+        if (vfile->mapped) UnmapViewOfFile(vfile->mapped);
+        if (vfile->mapping) CloseHandle(vfile->mapping);
+        auto code = CloseHandle(vfile->file);
+        SkrDelete(vfile);
+        return code;
+    }
+    return false;
+}
+
+void skr_vfs_get_mmap_procs(struct skr_vfs_proctable_t* procs) SKR_NOEXCEPT
+{
+    procs->fopen = &skr_mmap_fopen;
+    procs->fclose = &skr_mmap_fclose;
+    procs->fread = &skr_mmap_fread;
+    procs->fwrite = &skr_mmap_fwrite;
+    procs->fsize = &skr_mmap_fsize;
+    procs->fmap = &skr_mmap_fmap;
+    procs->fprefetch = &skr_mmap_fprefetch;
+}
@@ -183,6 +183,14 @@ ESkrLoadingStatus skr_resource_handle_t::get_status(bool resolve) const
     return record->loadingStatus;
 }
 
+void skr_resource_handle_t::set_hint(const skr_resource_hint_t& hint) const
+{
+    SKR_ASSERT(is_resolved());
+    auto record = get_record();
+    SMutexLock lock(record->mutex.mMutex);
+    record->hint = hint;
+}
+
 skr_resource_record_t* skr_resource_handle_t::get_record() const
 {
     return (skr_resource_record_t*)(pointer & kResourceHandleRecordMask);
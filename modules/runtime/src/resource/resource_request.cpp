@@ -6,11 +6,37 @@
 #include "SkrRT/platform/vfs.h"
 #include "SkrRT/resource/resource_factory.h"
 #include "SkrRT/serde/binary/reader.h"
+#include "SkrRT/platform/time.h"
 
 namespace skr
 {
 namespace resource
 {
+static SkrAsyncServicePriority GetIOPriority(ESkrLoadingUrgency urgency)
+{
+    switch (urgency)
+    {
+        case SKR_LOADING_URGENCY_URGENT:
+            return SKR_ASYNC_SERVICE_PRIORITY_URGENT;
+        case SKR_LOADING_URGENCY_PREFETCH:
+            return SKR_ASYNC_SERVICE_PRIORITY_LOW;
+        default:
+            return SKR_ASYNC_SERVICE_PRIORITY_NORMAL;
+    }
+}
+
+static uint64_t GetIODeadline(float distance, float streamingSpeed)
+{
+    if (distance < 0.f || streamingSpeed <= 0.f)
+        return SKR_IO_DEADLINE_NONE;
+    const auto now = (uint64_t)skr_sys_get_usec(false);
+    const double micros = (double)distance / (double)streamingSpeed * 1000000.0;
+    // nan, inf and deadlines beyond the clock would overflow the cast, they are as good as none
+    if (!(micros < (double)(SKR_IO_DEADLINE_NONE - now)))
+        return SKR_IO_DEADLINE_NONE;
+    return now + (uint64_t)micros;
+}
+
 // resource request implementation
 skr_guid_t SResourceRequestImpl::GetGuid() const
 {
@@ -277,13 +303,20 @@ void SResourceRequestImpl::Update()
             resourceRecord->SetStatus(SKR_LOADING_STATUS_LOADING);
             if (factory->AsyncIO())
             {
+                skr_resource_hint_t hint;
+                {
+                    SMutexLock lock(resourceRecord->mutex.mMutex);
+                    hint = resourceRecord->hint;
+                }
+                const auto priority = GetIOPriority(hint.urgency);
+                const auto deadline = GetIODeadline(hint.distance, system->GetStreamingSpeed());
                 {
                     auto rq = ioService->open_request();
                     rq->set_vfs(vfs);
                     rq->set_path(resourceUrl.u8_str());
                     rq->add_block({}); // read all
                     SKR_ASSERT(dataFuture.status == 0);
-                    dataBlob = ioService->request(rq, &dataFuture);
+                    dataBlob = ioService->request(rq, &dataFuture, priority, deadline);
                 }
 #ifdef SKR_RESOURCE_DEV_MODE
                 if (!artifactsUrl.is_empty())
@@ -293,7 +326,7 @@ void SResourceRequestImpl::Update()
                     rq->set_path(artifactsUrl.u8_str());
                     rq->add_block({}); // read all
                     SKR_ASSERT(artifactsFuture.status == 0);
-                    artifactsBlob = ioService->request(rq, &artifactsFuture);
+                    artifactsBlob = ioService->request(rq, &artifactsFuture, priority, deadline);
                 }
 #endif
                 currentPhase = SKR_LOADING_PHASE_WAITFOR_IO;
@@ -537,6 +570,11 @@ bool SResourceRequestImpl::AsyncSerde()
     return currentPhase == SKR_LOADING_PHASE_WAITFOR_LOAD_RESOURCE && !serdeScheduled;
 }
 
+bool SResourceRequestImpl::InstallPending() const
+{
+    return currentPhase == SKR_LOADING_PHASE_INSTALL_RESOURCE && requireLoading == isLoading;
+}
+
 bool SResourceRequestImpl::Yielded()
 {
     switch (currentPhase)
@@ -560,6 +598,9 @@ void SResourceRegistry::FillRequest(SResourceRequest* r, skr_resource_header_t h
         request->resourceRecord->header.type = header.type;
         request->resourceRecord->header.version = header.version;
         request->resourceRecord->header.dependencies = header.dependencies;
+        request->dependencies.clear();
+        for (auto& dep : header.dependencies)
+            request->dependencies.push_back(dep.get_serialized());
         request->vfs = vfs;
         request->resourceUrl = uri;
     }
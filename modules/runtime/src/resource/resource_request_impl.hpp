@@ -34,6 +34,9 @@ public:
     void OnRequestLoadFinished() override;
 
     void LoadTask() override;
+
+    // deserialized and all dependencies installed, waiting for an install wave of the system
+    bool InstallPending() const;
 protected:
     void _LoadDependencies() override;
     void _UnloadDependencies() override;
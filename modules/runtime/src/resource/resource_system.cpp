@@ -8,6 +8,7 @@
 #include "SkrRT/platform/vfs.h"
 #include "SkrRT/resource/resource_factory.h"
 #include "SkrRT/containers/concurrent_queue.h"
+#include "SkrProfile/profile.h"
 
 namespace skr::resource
 {
@@ -36,6 +37,11 @@ public:
 
     SResourceRegistry* GetRegistry() const final override;
     skr_io_ram_service_t* GetRAMService() const final override;
+    void SetInstallBudget(uint32_t budget) final override;
+    void SetStreamingSpeed(float unitsPerSecond) final override;
+    float GetStreamingSpeed() const final override;
+    void PrefetchResources(skr::span<const skr_guid_t> guids) final override;
+    void SetPrefetchLifetime(uint32_t frames) final override;
 
 protected:
     skr_resource_record_t* _GetOrCreateRecord(const skr_guid_t& guid) final override;
@@ -43,6 +49,8 @@ protected:
     skr_resource_record_t* _GetRecord(void* resource) final override;
     void _DestroyRecord(skr_resource_record_t* record) final override;
     void _UpdateAsyncSerde();
+    void _UpdateInstallWaves();
+    void _ClearStalePrefetches();
     void _ClearFinishedRequests();
 
     SResourceRegistry* resourceRegistry = nullptr;
@@ -64,6 +72,24 @@ protected:
     eastl::vector<SResourceRequest*> failedRequests;
     eastl::vector<SResourceRequest*> toUpdateRequests;
     eastl::vector<SResourceRequest*> serdeBatch;
+    eastl::vector<SResourceRequest*> installWave;
+    eastl::vector<SResourceRequest*> nextInstallWave;
+    // requests cut off by the install budget, in the order they were due, they open the first wave of the next update
+    eastl::vector<SResourceRequest*> deferredInstalls;
+    skr::flat_hash_set<SResourceRequest*> pendingInstalls;
+    // requests waiting for dependencies, keyed by the guid of each dependency they wait for
+    skr::flat_hash_map<skr_guid_t, eastl::fixed_vector<SResourceRequest*, 4>, skr::guid::hash> installDependents;
+    uint32_t installBudget = 0;
+
+    struct Prefetch
+    {
+        skr_resource_handle_t handle;
+        uint64_t lastRequestFrame = 0;
+    };
+    skr::flat_hash_map<skr_guid_t, Prefetch, skr::guid::hash> prefetches;
+    uint64_t frameIndex = 0;
+    uint32_t prefetchLifetime = 60;
+    float streamingSpeed = 0.f;
 
     dual::entity_registry_t resourceIds;
     task::counter_t counter;
@@ -149,6 +175,66 @@ skr_io_ram_service_t* SResourceSystemImpl::GetRAMService() const
     return ioService;
 }
 
+void SResourceSystemImpl::SetInstallBudget(uint32_t budget)
+{
+    installBudget = budget;
+}
+
+void SResourceSystemImpl::SetStreamingSpeed(float unitsPerSecond)
+{
+    streamingSpeed = unitsPerSecond;
+}
+
+float SResourceSystemImpl::GetStreamingSpeed() const
+{
+    return streamingSpeed;
+}
+
+void SResourceSystemImpl::SetPrefetchLifetime(uint32_t frames)
+{
+    prefetchLifetime = frames;
+}
+
+void SResourceSystemImpl::PrefetchResources(skr::span<const skr_guid_t> guids)
+{
+    SKR_ASSERT(!quit);
+    for (const auto& guid : guids)
+    {
+        auto iter = prefetches.find(guid);
+        if (iter != prefetches.end())
+        {
+            iter->second.lastRequestFrame = frameIndex;
+            continue;
+        }
+        // do not demote resources somebody else is loading already
+        const bool started = GetResourceStatus(guid) != SKR_LOADING_STATUS_UNLOADED;
+        auto& prefetch = prefetches[guid];
+        prefetch.lastRequestFrame = frameIndex;
+        prefetch.handle = guid;
+        LoadResource(prefetch.handle, false, (uint64_t)this, SKR_REQUESTER_SYSTEM);
+        if (!started)
+        {
+            skr_resource_hint_t hint;
+            hint.urgency = SKR_LOADING_URGENCY_PREFETCH;
+            prefetch.handle.set_hint(hint);
+        }
+    }
+}
+
+void SResourceSystemImpl::_ClearStalePrefetches()
+{
+    for (auto iter = prefetches.begin(); iter != prefetches.end();)
+    {
+        if (frameIndex - iter->second.lastRequestFrame > prefetchLifetime)
+        {
+            iter->second.handle.reset(); // unloads, in-flight reads get cancelled
+            prefetches.erase(iter++);
+        }
+        else
+            ++iter;
+    }
+}
+
 void SResourceSystemImpl::UnregisterFactory(skr_type_id_t type)
 {
     auto iter = resourceFactories.find(type);
@@ -163,6 +249,13 @@ void SResourceSystemImpl::LoadResource(skr_resource_handle_t& handle, bool requi
     auto record = _GetOrCreateRecord(handle.get_guid());
     auto requesterId = record->AddReference(requester, requesterType);
     handle.set_resolved(record, requesterId, requesterType);
+    if (requester != (uint64_t)this)
+    {
+        // a real request overtakes the prefetch of the same resource
+        SMutexLock lock(record->mutex.mMutex);
+        if (record->hint.urgency == SKR_LOADING_URGENCY_PREFETCH)
+            record->hint.urgency = SKR_LOADING_URGENCY_NORMAL;
+    }
     if ((!requireInstalled && record->loadingStatus >= SKR_LOADING_STATUS_LOADED && record->loadingStatus < SKR_LOADING_STATUS_UNLOADING) ||
         (requireInstalled && record->loadingStatus == SKR_LOADING_STATUS_INSTALLED) ||
         record->loadingStatus == SKR_LOADING_STATUS_ERROR) // already loaded
@@ -265,6 +358,7 @@ void SResourceSystemImpl::Initialize(SResourceRegistry* provider, skr_io_ram_ser
     SKR_ASSERT(provider);
     resourceRegistry = provider;
     ioService = service;
+    quit = false; // the system can be initialized again after a shutdown
 }
 
 bool SResourceSystemImpl::IsInitialized()
@@ -274,6 +368,9 @@ bool SResourceSystemImpl::IsInitialized()
 
 void SResourceSystemImpl::Shutdown()
 {
+    for (auto& pair : prefetches)
+        pair.second.handle.reset();
+    prefetches.clear();
     for(auto& pair : resourceRecords)
     {
         auto record = pair.second;
@@ -343,6 +440,9 @@ void SResourceSystemImpl::_ClearFinishedRequests()
 
 void SResourceSystemImpl::Update()
 {
+    ++frameIndex;
+    if (!quit)
+        _ClearStalePrefetches();
     {
         SResourceRequest* request = nullptr;
         while (requests.try_dequeue(request))
@@ -351,14 +451,14 @@ void SResourceSystemImpl::Update()
         }
         _ClearFinishedRequests();
     }
-    // TODO: time limit
     {
+        // installs are left to the waves below, so they happen in dependency order and within the budget
         for (auto req : toUpdateRequests)
         {
             auto request = static_cast<SResourceRequestImpl*>(req);
             uint32_t spinCounter = 0;
             ESkrLoadingPhase LastPhase;
-            while(!request->Okay() && !request->AsyncSerde() && spinCounter < 16)
+            while(!request->Okay() && !request->AsyncSerde() && !request->InstallPending() && spinCounter < 16)
             {
                 LastPhase = request->currentPhase;
                 request->Update();
@@ -370,6 +470,7 @@ void SResourceSystemImpl::Update()
         }
     }
     _UpdateAsyncSerde();
+    _UpdateInstallWaves();
 }
 
 
@@ -389,38 +490,101 @@ void SResourceSystemImpl::Quit()
 
 void SResourceSystemImpl::_UpdateAsyncSerde()
 {
+    SkrZoneScopedN("ResourceAsyncSerde");
+    // deserializing never touches the dependencies, so every waiting request runs in parallel
+    // the load factor of the factory decides how many requests share one task
     serdeBatch.clear();
-    serdeBatch.reserve(100);
-    float timeBudget = 100.f;
+    float batchBudget = 100.f;
+    auto flush = [&]() {
+        if (serdeBatch.empty())
+            return;
+        skr::task::schedule([batch = std::move(serdeBatch)]() {
+            for (auto request : batch)
+            {
+                request->LoadTask();
+            }
+        }, nullptr);
+        serdeBatch.clear();
+        batchBudget = 100.f;
+    };
     for (auto req : toUpdateRequests)
     {
         auto request = static_cast<SResourceRequestImpl*>(req);
-        if(request->currentPhase == SKR_LOADING_PHASE_WAITFOR_LOAD_RESOURCE && !request->serdeScheduled)
+        if (request->currentPhase == SKR_LOADING_PHASE_WAITFOR_LOAD_RESOURCE && !request->serdeScheduled)
         {
             request->serdeScheduled = true;
-            auto factor = request->factory->AsyncSerdeLoadFactor();
-            timeBudget -= factor;
             serdeBatch.push_back(request);
-            if(timeBudget < 0.f)
-            {
-                timeBudget = 0.f;
-                skr::task::schedule([batch = std::move(serdeBatch)](){
-                    for(auto request : batch)
-                    {
-                        request->LoadTask();
-                    }
-                }, nullptr);
-                timeBudget = 100.f;
-            }
+            batchBudget -= request->factory->AsyncSerdeLoadFactor();
+            if (batchBudget <= 0.f)
+                flush();
         }
     }
-    if(!serdeBatch.empty())
+    flush();
+}
+
+void SResourceSystemImpl::_UpdateInstallWaves()
+{
+    SkrZoneScopedN("ResourceInstallWaves");
+    // the first wave are the requests whose dependencies are installed already, each installed
+    // resource then releases the requests waiting for it into the next wave of the same frame
+    installWave.clear();
+    installDependents.clear();
+    pendingInstalls.clear();
+    for (auto req : toUpdateRequests)
     {
-        // run rest requests on main thread
-        for(auto request : serdeBatch)
+        auto request = static_cast<SResourceRequestImpl*>(req);
+        if (request->InstallPending())
+            pendingInstalls.insert(request);
+        else if (request->currentPhase == SKR_LOADING_PHASE_WAITFOR_LOAD_DEPENDENCIES)
+        {
+            for (const auto& dependency : request->GetDependencies())
+                installDependents[dependency].push_back(request);
+        }
+    }
+    // requests deferred by the budget go first, the ones finished or cancelled meanwhile are dropped
+    for (auto req : deferredInstalls)
+    {
+        if (pendingInstalls.erase(req))
+            installWave.push_back(req);
+    }
+    deferredInstalls.clear();
+    for (auto req : toUpdateRequests)
+    {
+        if (pendingInstalls.count(req))
+            installWave.push_back(req);
+    }
+    uint32_t installed = 0;
+    while (!installWave.empty())
+    {
+        nextInstallWave.clear();
+        for (size_t i = 0; i < installWave.size(); ++i)
         {
-            request->LoadTask();
+            if (installBudget != 0 && installed >= installBudget)
+            {
+                // the rest of this wave and the released dependents keep their turn for the next update
+                deferredInstalls.assign(installWave.begin() + i, installWave.end());
+                deferredInstalls.insert(deferredInstalls.end(), nextInstallWave.begin(), nextInstallWave.end());
+                return;
+            }
+            auto request = static_cast<SResourceRequestImpl*>(installWave[i]);
+            request->Update();
+            ++installed;
+            if (request->currentPhase != SKR_LOADING_PHASE_FINISHED || request->Failed())
+                continue; // in progress or failed, dependents are checked by their own update
+            auto iter = installDependents.find(request->GetGuid());
+            if (iter == installDependents.end())
+                continue;
+            for (auto dep : iter->second)
+            {
+                auto dependent = static_cast<SResourceRequestImpl*>(dep);
+                if (dependent->currentPhase != SKR_LOADING_PHASE_WAITFOR_LOAD_DEPENDENCIES)
+                    continue;
+                dependent->Update();
+                if (dependent->InstallPending())
+                    nextInstallWave.push_back(dependent);
+            }
         }
+        installWave.swap(nextInstallWave);
     }
 }
 
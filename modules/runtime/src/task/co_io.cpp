@@ -0,0 +1,173 @@
+#if __cpp_impl_coroutine
+
+#include "SkrRT/async/co_io.hpp"
+#include "SkrRT/resource/resource_header.hpp"
+#include "SkrRT/resource/resource_system.h"
+#include "SkrRT/misc/log.h"
+#include <EASTL/algorithm.h>
+
+namespace skr
+{
+namespace task2
+{
+    RAMIOAwaitable::RAMIOAwaitable(skr::io::IRAMService* service, skr::io::IORequestId request, SkrAsyncServicePriority priority)
+        : service(service), request(std::move(request)), priority(priority)
+    {
+    }
+
+    bool RAMIOAwaitable::await_suspend(std::coroutine_handle<skr_task_t::promise_type> h)
+    {
+        scheduler = scheduler_t::instance();
+        SKR_ASSERT(scheduler != nullptr);
+        handle = h;
+        // runs on the io thread right after the status is stored, the future is not touched afterwards
+        auto finished = +[](skr_io_future_t* future, skr_io_request_t* request, void* data) {
+            auto self = (RAMIOAwaitable*)data;
+            if (self->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                self->scheduler->resume(self->handle);
+        };
+        request->add_callback(SKR_IO_STAGE_COMPLETED, finished, this);
+        request->add_callback(SKR_IO_STAGE_CANCELLED, finished, this);
+#ifdef SKR_PROFILE_ENABLE
+        const char* name = h.promise().name;
+        if(name != nullptr)
+            SkrFiberLeave;
+#endif
+        buffer = service->request(request, &future, priority);
+        // keep running if the request finished before the buffer was stored
+        const bool suspended = pending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+#ifdef SKR_PROFILE_ENABLE
+        if(!suspended && name != nullptr)
+            SkrFiberEnter(name);
+#endif
+        return suspended;
+    }
+
+    RAMIOAwaitable co_request(skr::io::IRAMService* service, skr::io::IORequestId request, SkrAsyncServicePriority priority)
+    {
+        return { service, std::move(request), priority };
+    }
+
+    DecompressAwaitable::DecompressAwaitable(skr::span<const skr_io_compressed_block_t> blocks, const uint8_t* src, uint8_t* dst)
+        : blocks(blocks), src(src), dst(dst)
+    {
+    }
+
+    bool DecompressAwaitable::await_suspend(std::coroutine_handle<skr_task_t::promise_type> h)
+    {
+        scheduler = scheduler_t::instance();
+        SKR_ASSERT(scheduler != nullptr);
+        handle = h;
+        const auto count = (uint32_t)blocks.size();
+        const auto lane = h.promise().priority;
+        // one extra count for this function, so the task is not resumed while blocks are still being forked
+        pending.store(count + 1, std::memory_order_relaxed);
+#ifdef SKR_PROFILE_ENABLE
+        const char* name = h.promise().name;
+        if(name != nullptr)
+            SkrFiberLeave;
+#endif
+        uint64_t src_offset = 0, dst_offset = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const auto& block = blocks[i];
+            scheduler->schedule([this, &block, src_offset, dst_offset]() {
+                SkrZoneScopedN("DecompressTask");
+                if (!skr::io::IODecompressMethods::Decompress(block, src + src_offset, dst + dst_offset))
+                {
+                    SKR_LOG_ERROR(u8"co_decompress: failed to decompress block at %llu", block.offset);
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    scheduler->resume(handle);
+            }, lane);
+            src_offset += block.compressed_size;
+            dst_offset += block.uncompressed_size;
+        }
+        const bool suspended = pending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+#ifdef SKR_PROFILE_ENABLE
+        if(!suspended && name != nullptr)
+            SkrFiberEnter(name);
+#endif
+        return suspended;
+    }
+
+    DecompressAwaitable co_decompress(skr::span<const skr_io_compressed_block_t> blocks, const uint8_t* src, uint8_t* dst)
+    {
+        return { blocks, src, dst };
+    }
+
+    static bool is_install_finished(ESkrLoadingStatus status)
+    {
+        return status == SKR_LOADING_STATUS_INSTALLED || status == SKR_LOADING_STATUS_ERROR || status == SKR_LOADING_STATUS_UNLOADED;
+    }
+
+    static constexpr ESkrLoadingStatus kInstallFinishStatuses[] = {
+        SKR_LOADING_STATUS_INSTALLED,
+        SKR_LOADING_STATUS_ERROR,
+        SKR_LOADING_STATUS_UNLOADED
+    };
+
+    InstallAwaitable::InstallAwaitable(skr_resource_handle_t& resource)
+        : record(resource.is_resolved() ? resource.get_record() : nullptr)
+    {
+        SKR_ASSERT(record && "resolve the handle before awaiting its installation");
+        // a resource loaded without install stops at LOADED and would never resume the task
+        const auto status = record ? record->loadingStatus : SKR_LOADING_STATUS_ERROR;
+        if (status == SKR_LOADING_STATUS_LOADING || status == SKR_LOADING_STATUS_LOADED)
+        {
+            installer = record->header.guid;
+            skr::resource::GetResourceSystem()->LoadResource(installer, true, (uint64_t)this, SKR_REQUESTER_SYSTEM);
+        }
+    }
+
+    bool InstallAwaitable::await_ready() const
+    {
+        return !record || is_install_finished(record->loadingStatus);
+    }
+
+    bool InstallAwaitable::await_suspend(std::coroutine_handle<skr_task_t::promise_type> h)
+    {
+        scheduler = scheduler_t::instance();
+        SKR_ASSERT(scheduler != nullptr);
+        handle = h;
+        // status callbacks run under the record mutex, so registering under it cannot miss a transition
+        SMutexLock lock(record->mutex.mMutex);
+        if (is_install_finished(record->loadingStatus))
+            return false;
+#ifdef SKR_PROFILE_ENABLE
+        if(h.promise().name != nullptr)
+            SkrFiberLeave;
+#endif
+        auto finished = +[](void* data) {
+            auto self = (InstallAwaitable*)data;
+            // only one of the statuses is reached, drop the registrations of the others before the frame goes away
+            for (auto status : kInstallFinishStatuses)
+            {
+                if (status == self->record->loadingStatus)
+                    continue;
+                auto& callbacks = self->record->callbacks[status];
+                callbacks.erase(eastl::remove_if(callbacks.begin(), callbacks.end(), [self](const auto& callback) {
+                    return callback.data == self;
+                }), callbacks.end());
+            }
+            self->scheduler->resume(self->handle);
+        };
+        for (auto status : kInstallFinishStatuses)
+            record->callbacks[status].push_back({ this, finished });
+        return true;
+    }
+
+    ESkrLoadingStatus InstallAwaitable::await_resume() const
+    {
+        return record ? record->loadingStatus : SKR_LOADING_STATUS_ERROR;
+    }
+
+    InstallAwaitable co_install(skr_resource_handle_t& resource)
+    {
+        return { resource };
+    }
+}
+}
+
+#endif
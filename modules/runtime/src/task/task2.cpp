@@ -63,16 +63,19 @@ namespace task2
         auto exception = std::current_exception();
     }
 
+    static constexpr uint32_t kLaneCount = (uint32_t)task_priority_t::count;
+
     struct Task
     {
         eastl::function<void()> func;
         std::coroutine_handle<skr_task_t::promise_type> coro;
+        task_priority_t priority = task_priority_t::normal;
 
         Task() {}
         Task(nullptr_t) {}
 
-        Task(eastl::function<void()>&& func)
-            : func(std::move(func))
+        Task(eastl::function<void()>&& func, task_priority_t priority = task_priority_t::normal)
+            : func(std::move(func)), priority(priority)
         {
         }
 
@@ -80,12 +83,14 @@ namespace task2
             : coro(std::move(coro))
         {
             SKR_ASSERT(!this->coro.done());
+            priority = this->coro.promise().priority;
             coro = nullptr;
         }
 
         Task(Task&& other)
             : func(std::move(other.func))
             , coro(std::move(other.coro))
+            , priority(other.priority)
         {
             SKR_ASSERT(func || !this->coro.done());
             other.coro = nullptr;
@@ -95,11 +100,14 @@ namespace task2
         {
             func = std::move(other.func);
             coro = std::move(other.coro);
+            priority = other.priority;
             SKR_ASSERT(func || !this->coro.done());
             other.coro = nullptr;
             return *this;
         }
 
+        uint32_t lane() const { return (uint32_t)priority; }
+
         void operator()()
         {
             SKR_ASSERT(*this);
@@ -149,7 +157,7 @@ namespace task2
 #endif
     };
 
-    void enqueue(Task&& task, int workerIdx);
+    void enqueue(Task&& task, int workerIdx, scheduler_t* scheduler = nullptr);
     thread_local struct Worker* currentWorker = nullptr;
     struct Worker
     {
@@ -279,26 +287,41 @@ namespace task2
             });
         }
 
+        // called with the work mutex held. higher lanes go first, within a lane pinned tasks go before shared ones
+        bool takeTask(Task& task)
+        {
+            for (uint32_t lane = 0; lane < kLaneCount; ++lane)
+            {
+                auto& pinned = work.pinnedTasks[lane];
+                if (!pinned.empty())
+                {
+                    task = std::move(pinned.front());
+                    pinned.pop_front();
+                    work.num--;
+                    return true;
+                }
+                if (work.tasks[lane].pop(task))
+                {
+                    work.num--;
+                    return true;
+                }
+            }
+            return false;
+        }
+
         void runUntilIdle() 
         {
             SkrZoneScopedN("Worker::RunUntilIdle");
-            while(!work.pinnedTask.empty())
+            while (true)
             {
-                auto task = std::move(work.pinnedTask.front());
-                work.pinnedTask.pop_front();
-                work.num--;
+                // a task is picked per iteration, so work of a higher lane enqueued meanwhile overtakes the rest
+                Task task(nullptr);
+                if (!takeTask(task))
+                    break;
                 skr_mutex_release(&work.mutex);
                 task();
                 skr_mutex_acquire(&work.mutex);
             }
-            skr_mutex_release(&work.mutex);
-            Task task(nullptr);
-            while(work.tasks.pop(task))
-            {
-                work.num--;
-                task();
-            }
-            skr_mutex_acquire(&work.mutex);
         }
 
         void run()
@@ -323,7 +346,8 @@ namespace task2
             {
                 work.num++;
                 auto notify = work.notifyAdded;
-                work.tasks.push(std::move(task));
+                const auto lane = task.lane();
+                work.tasks[lane].push(std::move(task));
                 if (notify)
                 {
                     skr_wake_condition_var(&work.added);
@@ -341,7 +365,8 @@ namespace task2
         {
             SkrZoneScopedN("EnqueueTaskWorker");
             auto notify = work.notifyAdded;
-            work.pinnedTask.push_back(std::move(task));
+            const auto lane = task.lane();
+            work.pinnedTasks[lane].push_back(std::move(task));
             work.num++;
             skr_mutex_release(&work.mutex);
             if (notify)
@@ -352,12 +377,15 @@ namespace task2
 
         bool steal(Task& out) 
         {
-            bool result = work.tasks.steal(out);
-            if (result) 
+            for (uint32_t lane = 0; lane < kLaneCount; ++lane)
             {
-                work.num--;
+                if (work.tasks[lane].steal(out))
+                {
+                    work.num--;
+                    return true;
+                }
             }
-            return result;
+            return false;
         }
 
         Worker()
@@ -372,8 +400,8 @@ namespace task2
         struct Work 
         {
             std::atomic<uint64_t> num = 0;
-            eastl::deque<Task, eastl::allocator_sakura, 128> pinnedTask;
-            WorkQueue tasks;
+            eastl::deque<Task, eastl::allocator_sakura, 128> pinnedTasks[kLaneCount];
+            WorkQueue tasks[kLaneCount];
             bool notifyAdded = true;
             SConditionVariable added;
             SMutex mutex;
@@ -409,10 +437,11 @@ namespace task2
     };
     
 
-    void enqueue(Task&& task, int workerIdx)
+    void enqueue(Task&& task, int workerIdx, scheduler_t* scheduler)
     {
         //SkrZoneScopedN("EnqueueTask");
-        scheduler_t* scheduler = scheduler_t::instance();
+        if (scheduler == nullptr)
+            scheduler = scheduler_t::instance();
         SKR_ASSERT(scheduler != nullptr);
         size_t workerCount = scheduler->config.numThreads;
         while(true)
@@ -444,16 +473,22 @@ namespace task2
         }
     }
 
-    void scheduler_t::schedule(eastl::function<void ()>&& function)
+    void scheduler_t::schedule(eastl::function<void ()>&& function, task_priority_t priority)
     {
-        enqueue(Task(std::move(function)), -1);
+        enqueue(Task(std::move(function), priority), -1, this);
     }
 
-    void scheduler_t::schedule(skr_task_t&& task)
+    void scheduler_t::schedule(skr_task_t&& task, task_priority_t priority)
     {
         std::coroutine_handle<skr_task_t::promise_type> coroutine = task.coroutine;
         task.coroutine = nullptr;
-        enqueue(Task(std::move(coroutine)), -1);
+        coroutine.promise().priority = priority;
+        enqueue(Task(std::move(coroutine)), -1, this);
+    }
+
+    void scheduler_t::resume(std::coroutine_handle<skr_task_t::promise_type> handle)
+    {
+        enqueue(Task(std::move(handle)), -1, this);
     }
 
     scheduler_t::EventAwaitable::EventAwaitable(scheduler_t& scheduler, event_t event, int workerIdx)
@@ -1,18 +1,22 @@
 #include "SkrRT/async/thread_job.hpp"
 #include "SkrRT/async/wait_timeout.hpp"
 #include "job_thread.hpp"
+#include "job_deque.hpp"
+#include "SkrRT/containers/concurrent_queue.h"
 #include "SkrRT/containers/vector.hpp"
-#include "SkrRT/misc/defer.hpp"
 #include "SkrRT/misc/log.h"
+#include <EASTL/algorithm.h>
+#include <atomic>
 
 namespace skr
 {
 struct JobThreadFunctionImpl : public JobThreadFunction
 {
 public:
-    JobThreadFunctionImpl(JobItemQueue* itemQueue)
+    JobThreadFunctionImpl(JobItemQueue* itemQueue, uint32_t workerIndex)
         : m_item(nullptr)
         , m_queue(itemQueue)
+        , m_worker(workerIndex)
     {
         
     }
@@ -25,150 +29,228 @@ protected:
 private:
     JobItem*		m_item;
     JobItemQueue*	m_queue;
+    uint32_t		m_worker;
 };
 
+struct JobQueueConcurrentQueueTraits : public skr::ConcurrentQueueDefaultTraits
+{
+    static constexpr const char* kJobQueueName = "JobQueueConcurrentQueue";
+    static const bool RECYCLE_ALLOCATED_BLOCKS = true;
+    static inline void* malloc(size_t size) { return sakura_mallocN(size, kJobQueueName); }
+    static inline void free(void* ptr) { return sakura_freeN(ptr, kJobQueueName); }
+};
+
+// work stealing scheduler of a JobQueue: every worker owns a Chase-Lev deque, items enqueued from outside
+// the workers go through lock-free injection queues (one per priority). idle workers steal from each other
+// and only park on the condition variable when nothing is left anywhere
 struct JobItemQueue
 {
     friend struct JobQueue;
 
-public:
-    JobItemQueue(const char8_t* name) 
-        : waiting_workers_count(0) , name(name) , is_end_job_queued(false)
+    struct Worker
+    {
+        JobItemQueue* owner = nullptr;
+        uint32_t index = 0;
+        uint32_t seed = 0;
+        WorkStealingDeque<JobItem*> deque;
+    };
+
+    // rounds of stealing an idle worker tries before it parks
+    static constexpr uint32_t kSpinRounds = 64;
+
+    static thread_local Worker* current_worker;
+
+    JobItemQueue(const char8_t* name, uint32_t workerCount) 
+        : name(name)
     {
         cond = SkrNew<JobQueueCond>();
         cond->initialize(u8"SampleUtilJobItemQueueCond");					
         SKR_ASSERT(cond != nullptr);
+        workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            auto worker = SkrNew<Worker>();
+            worker->owner = this;
+            worker->index = i;
+            worker->seed = i * 2654435761u + 1;
+            workers.emplace_back(worker);
+        }
     }
 
     ~JobItemQueue()
     {
+        for (auto worker : workers)
+        {
+            SkrDelete(worker);
+        }
         SkrDelete(cond);
     }
 
-    JobResult push(JobItem* jobItem, bool isEndJob = false)
+    JobResult push(JobItem* jobItem)
     {
-        cond->lock();
-        const auto endJobEnqueud = skr_atomic32_load_acquire(&is_end_job_queued);
-        if (endJobEnqueud && !isEndJob)
+        // counted before the quit check, so a worker never exits while this item is on its way
+        item_count.fetch_add(1, std::memory_order_seq_cst);
+        if (quitting.load(std::memory_order_seq_cst))
         {
-            cond->unlock();
+            item_count.fetch_sub(1, std::memory_order_relaxed);
             return ASYNC_RESULT_ERROR_INVALID_STATE;
         }
+        skr_atomic32_store_release(&jobItem->status, kJobItemStatusWaiting);
 
-        // update the status of JobItem together with the state of the queue
-        skr_atomic32_store_release(&jobItem->status, isEndJob ? kJobItemStatusFinishJob : kJobItemStatusWaiting);
-        list_runnable.emplace_back(jobItem);
-
-        // end job is queued, only end job is accepted
-        skr_atomic32_store_release(&is_end_job_queued, isEndJob);
-
-        const auto c = skr_atomic32_load_acquire(&waiting_workers_count);
-        if (c) 
+        auto worker = current_worker;
+        const auto priority = jobItem->desc.priority;
+        if (priority == kJobItemPriorityNormal && worker && worker->owner == this)
         {
-            cond->signal();
+            worker->deque.push(jobItem);
         }
-
-        cond->unlock();
-
+        else
+        {
+            injected[priority == kJobItemPriorityHigh ? 0 : 1].enqueue(jobItem);
+        }
+        wake(1);
         return ASYNC_RESULT_OK;
     }
 
+    // called by the worker after running the item, from now on check() may finish it
     void erase(JobItem* jobItem)
     {
-        cond->lock();
         SKR_ASSERT(jobItem);
         SKR_ASSERT(jobItem->status != kJobItemStatusNone);
+        skr_atomic32_store_release(&jobItem->status, kJobItemStatusNone);
+        if (item_count.fetch_sub(1, std::memory_order_seq_cst) == 1 && quitting.load(std::memory_order_seq_cst))
+        {
+            // the last item of a finalizing queue releases the parked workers
+            wake(UINT32_MAX);
+        }
+    }
 
-        bool isFound = false;
-        for (auto i = list_consumed.begin(); i != list_consumed.end(); ++i)
+    // blocks until an item is available, returns nullptr once the queue quits and every item has been taken
+    JobItem* getRunnableJobItem(Worker* worker)
+    {
+        JobItem* jobItem = nullptr;
+        while (true)
         {
-            if ((*i) == jobItem) 
+            for (uint32_t round = 0; round < kSpinRounds; ++round)
+            {
+                if (tryTake(worker, jobItem))
+                {
+                    ESkrJobItemStatus statusWaiting = kJobItemStatusWaiting; (void)statusWaiting;
+                    skr_atomic32_cas_relaxed(&jobItem->status, statusWaiting, kJobItemStatusRunning);
+                    return jobItem;
+                }
+            }
+            // a producer publishes its item then reads the waiter count, a parking worker raises the count then
+            // rechecks the queues. with a full fence on both sides at least one of them sees the other: either the
+            // producer signals under the lock, or the recheck below finds the item. so parking needs no timeout
+            cond->lock();
+            waiting_workers_count.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool found = tryTake(worker, jobItem);
+            if (!found)
             {
-                // update the status of JobItem together with the state of the queue
-                list_consumed.erase(i);
-                skr_atomic32_store_release(&jobItem->status, kJobItemStatusNone);
-                isFound = true;
-                break;
+                if (quitting.load(std::memory_order_seq_cst) && item_count.load(std::memory_order_seq_cst) == 0)
+                {
+                    waiting_workers_count.fetch_sub(1, std::memory_order_relaxed);
+                    cond->unlock();
+                    return nullptr;
+                }
+                cond->wait();
+            }
+            waiting_workers_count.fetch_sub(1, std::memory_order_relaxed);
+            cond->unlock();
+            if (found)
+            {
+                ESkrJobItemStatus statusWaiting = kJobItemStatusWaiting; (void)statusWaiting;
+                skr_atomic32_cas_relaxed(&jobItem->status, statusWaiting, kJobItemStatusRunning);
+                return jobItem;
             }
         }
-        SKR_ASSERT(isFound);
-
-        cond->unlock();
     }
 
-    JobItem* getRunnableJobItem()
+    bool tryTake(Worker* worker, JobItem*& jobItem)
     {
-        cond->lock();
-
-        // wait until the notification is queued
-        while (list_runnable.size() == 0) 
+        if (injected[0].try_dequeue(jobItem))
+            return true;
+        if (worker->deque.pop(jobItem))
+            return true;
+        if (injected[1].try_dequeue(jobItem))
+            return true;
+        // start at a random victim so thieves spread over the workers
+        const auto count = (uint32_t)workers.size();
+        worker->seed = worker->seed * 1664525u + 1013904223u;
+        const uint32_t start = (worker->seed >> 16) % count;
+        for (uint32_t i = 0; i < count; ++i)
         {
-            skr_atomic32_add_relaxed(&waiting_workers_count, 1);
-
-            cond->wait();
-
-            skr_atomic32_add_relaxed(&waiting_workers_count, -1);
+            auto victim = workers[(start + i) % count];
+            if (victim != worker && victim->deque.steal(jobItem))
+                return true;
         }
+        return false;
+    }
 
-        JobItem* jobItem = nullptr;
-        // previous jobItem is moved to consumed list
-        jobItem = *list_runnable.begin();
-        list_runnable.erase(list_runnable.begin());
-        list_consumed.emplace_back(jobItem);
-
-        SKR_ASSERT(jobItem != nullptr);
-        SKR_ASSERT(jobItem->status == kJobItemStatusWaiting || jobItem->status == kJobItemStatusFinishJob);
-
-        // update the status of JobItem together with the state of the queue
-        ESkrJobItemStatus statusWaiting = kJobItemStatusWaiting; (void)statusWaiting;
-        skr_atomic32_cas_relaxed(&jobItem->status, statusWaiting, kJobItemStatusRunning);
-        // jobItem->status.compare_exchange_strong((int&)statusWaiting, kJobItemStatusRunning, std::memory_order_acq_rel, std::memory_order_acquire);
-
+    void wake(uint32_t count)
+    {
+        // orders the publication of the item (or of the quit state) before reading the waiter count,
+        // pairs with the fence of a parking worker
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting_workers_count.load(std::memory_order_seq_cst) == 0)
+            return;
+        cond->lock();
+        if (count == 1)
+            cond->signal();
+        else
+            cond->broadcast();
         cond->unlock();
-
-        return jobItem;
     }
 
-    uint64_t numItems()
+    // lets the workers exit once every queued item has run, later pushes fail
+    void quit()
     {
+        quitting.store(true, std::memory_order_seq_cst);
         cond->lock();
-        const auto num = list_runnable.size() + list_consumed.size();
+        cond->broadcast();
         cond->unlock();
-        return num;
     }
 
-    SAtomic32 waiting_workers_count = 0;
-    skr::string name = u8"JobItemQueue";
-    SAtomic32 is_end_job_queued = false;
+    uint64_t numItems()
+    {
+        return item_count.load(std::memory_order_acquire);
+    }
 
-    skr::vector<JobItem*> list_runnable;
-    skr::vector<JobItem*> list_consumed;
+    skr::string name = u8"JobItemQueue";
+    skr::vector<Worker*> workers;
+    // high priority items first
+    skr::ConcurrentQueue<JobItem*, JobQueueConcurrentQueueTraits> injected[kJobItemPriorityCount];
+    // every enqueued item on its way to JobQueue::pending_queue
+    skr::ConcurrentQueue<JobItem*, JobQueueConcurrentQueueTraits> pending_inbox;
+    std::atomic<uint32_t> pending_count = 0;
+    std::atomic<uint64_t> item_count = 0;
+    std::atomic<uint32_t> waiting_workers_count = 0;
+    std::atomic<bool> quitting = false;
     JobQueueCond* cond = nullptr;
-
 };
 
+thread_local JobItemQueue::Worker* JobItemQueue::current_worker = nullptr;
+
 JobResult JobThreadFunctionImpl::run() SKR_NOEXCEPT
 {
-    bool isEndJobArrived = false;
-    while (false == isEndJobArrived)
+    auto worker = m_queue->workers[m_worker];
+    JobItemQueue::current_worker = worker;
+    while (true)
     {
-        m_item = m_queue->getRunnableJobItem();
-
-        if (m_item)
-        {
-            const auto itemStatus = skr_atomic32_load_acquire(&m_item->status);
-            SKR_ASSERT((itemStatus == kJobItemStatusRunning) || (itemStatus == kJobItemStatusFinishJob));
+        m_item = m_queue->getRunnableJobItem(worker);
+        // the queue is finalizing and drained
+        if (!m_item)
+            break;
 
-            // exit the loop when the end job is arrived
-            isEndJobArrived = (itemStatus == kJobItemStatusFinishJob);
+        SKR_ASSERT(skr_atomic32_load_acquire(&m_item->status) == kJobItemStatusRunning);
+        m_item->result = m_item->run();
 
-            m_item->result = m_item->run();
-
-            // delete the JobItem which has been executed
-            m_queue->erase(m_item);
-            m_item = nullptr;
-        }
+        // the item is finished by JobQueue::check()
+        m_queue->erase(m_item);
+        m_item = nullptr;
     }
+    JobItemQueue::current_worker = nullptr;
     return ASYNC_RESULT_OK;
 }
 
@@ -199,28 +281,11 @@ int JobItem::get_result() SKR_NOEXCEPT
     return result;
 }
 
-class JobFinalizeItem final : public JobItem 
-{
-public:
-    JobFinalizeItem() : JobItem(u8"JobFinalizeItem"){}
-protected:
-    // this job is used to notify the end of the job
-    JobResult run() SKR_NOEXCEPT override
-    {
-        return ASYNC_RESULT_OK;
-    }
-    void finish(JobResult res) SKR_NOEXCEPT override
-    {
-        // do nothing
-    }  
-};
-
 JobQueue::JobQueue(const JobQueueDesc& desc) SKR_NOEXCEPT
     : desc(desc)
 {
     queue_name = desc.name ? desc.name : u8"UnknownJobQueue";
-    skr_init_rw_mutex(&pending_queue_mutex);
-    itemList = SkrNew<JobItemQueue>(queue_name.u8_str());
+    itemList = SkrNew<JobItemQueue>(queue_name.u8_str(), desc.thread_count);
     SKR_ASSERT(itemList);
     initialize();
 }
@@ -229,7 +294,6 @@ JobQueue::~JobQueue() SKR_NOEXCEPT
 {
     finalize();
     SkrDelete(itemList);
-    skr_destroy_rw_mutex(&pending_queue_mutex);
 }
 
 JobResult JobQueue::initialize() SKR_NOEXCEPT
@@ -238,7 +302,7 @@ JobResult JobQueue::initialize() SKR_NOEXCEPT
     const char8_t* n = desc.name;
     for (uint32_t i = 0; i < desc.thread_count; ++i)
     {
-        JobThreadFunction* jobfunc = SkrNew<JobThreadFunctionImpl>(itemList);
+        JobThreadFunction* jobfunc = SkrNew<JobThreadFunctionImpl>(itemList, i);
         SKR_ASSERT(jobfunc != nullptr);
         if (jobfunc == nullptr)
         {
@@ -276,16 +340,8 @@ JobResult JobQueue::initialize() SKR_NOEXCEPT
 
 int JobQueue::finalize() SKR_NOEXCEPT
 {
-    // Queue as many JobFinalizeItems as the number of worker threads to finish the worker threads.
-    // Since the worker thread that received JobFinalizeItem will always end without taking the next Job,
-    // This will terminate all worker threads.
-    skr::vector<JobFinalizeItem> finalJobs;
-    finalJobs.reserve(thread_list.size());
-    for (int i = 0; i < thread_list.size(); ++i)
-    {
-        finalJobs.emplace_back();
-        enqueueCore(&finalJobs.back(), /*isEndJob=*/true); // Normal enqueue will fail after this point
-    }
+    // workers run everything queued so far and exit when the queue is drained, normal enqueue fails after this point
+    itemList->quit();
 
     // wait for worker thread to finish。
     for (auto *pWorkerThread : thread_list)
@@ -302,31 +358,34 @@ int JobQueue::finalize() SKR_NOEXCEPT
 
 int JobQueue::enqueue(JobItem* jobItem) SKR_NOEXCEPT
 {
-    // Add to pending queue
-    skr_rw_mutex_acquire_w(&pending_queue_mutex);
-    SKR_DEFER({skr_rw_mutex_release_w(&pending_queue_mutex);});
-    JobResult ret;
+    // count the item as pending before a worker can finish it, is_empty() must not see a gap
+    itemList->pending_count.fetch_add(1, std::memory_order_relaxed);
+    const JobResult ret = enqueueCore(jobItem);
+    if (ret == ASYNC_RESULT_OK)
     {
-        ret = enqueueCore(jobItem, /*isEndJob=*/false);
+        itemList->pending_inbox.enqueue(jobItem);
     }
-    if (ret == ASYNC_RESULT_OK)
+    else
     {
-        pending_queue.emplace_back(jobItem);
+        itemList->pending_count.fetch_sub(1, std::memory_order_relaxed);
     }
     return ret;
 }
 
 bool JobQueue::is_empty() SKR_NOEXCEPT
 {
-    skr_rw_mutex_acquire_r(&pending_queue_mutex);
-    SKR_DEFER({skr_rw_mutex_release_r(&pending_queue_mutex);});
-    return (items_count() == 0 && (pending_queue.size() == 0)) ? true : false;
+    return (items_count() == 0 && itemList->pending_count.load(std::memory_order_acquire) == 0) ? true : false;
 }
 
 JobResult JobQueue::check() SKR_NOEXCEPT
 {
-    skr_rw_mutex_acquire_w(&pending_queue_mutex);
-    SKR_DEFER({skr_rw_mutex_release_w(&pending_queue_mutex);});
+    {
+        JobItem* incoming = nullptr;
+        while (itemList->pending_inbox.try_dequeue(incoming))
+        {
+            pending_queue.emplace_back(incoming);
+        }
+    }
 
     auto need_cancel = false;
     need_cancel = skr_atomic32_load_acquire(&cancel_requested);
@@ -342,24 +401,23 @@ JobResult JobQueue::check() SKR_NOEXCEPT
         skr_atomic32_store_release(&cancel_requested, false);
     }
 
-    auto it = pending_queue.begin();
-    while (it != pending_queue.end()) {
-        // call finish() when finished
-        if ((*it)->is_none()) {
-            auto jobItemPtr = *it;
-            // finish is called while the lock is released
-            skr_rw_mutex_release_w(&pending_queue_mutex);
-            jobItemPtr->finish(jobItemPtr->get_result());
-            skr_rw_mutex_acquire_w(&pending_queue_mutex);
-
-            // Since enqueue may be done while unlocking, it cannot be used
-            // so re-search the list
-            it = eastl::find(pending_queue.begin(), pending_queue.end(), jobItemPtr);
-            it = pending_queue.erase(it);
-        }
-        else {
-            ++it;
+    // finished items leave the list before finish() is called, finish() may enqueue again or release the item
+    skr::vector<JobItem*> finished;
+    auto it = eastl::remove_if(pending_queue.begin(), pending_queue.end(), 
+    [&finished](JobItem* ptr) {
+        if (ptr->is_none())
+        {
+            finished.emplace_back(ptr);
+            return true;
         }
+        return false;
+    });
+    pending_queue.erase(it, pending_queue.end());
+    for (auto jobItemPtr : finished)
+    {
+        // call finish() when finished
+        jobItemPtr->finish(jobItemPtr->get_result());
+        itemList->pending_count.fetch_sub(1, std::memory_order_release);
     }
 
     return ASYNC_RESULT_OK;
@@ -374,7 +432,7 @@ void JobQueue::get_descriptor(JobQueueDesc* pDesc) SKR_NOEXCEPT
     }
 }
 
-int JobQueue::enqueueCore(JobItem* jobItem, bool isEndJob) SKR_NOEXCEPT
+int JobQueue::enqueueCore(JobItem* jobItem) SKR_NOEXCEPT
 {
     SKR_ASSERT(jobItem->status == kJobItemStatusNone);
 
@@ -389,7 +447,7 @@ int JobQueue::enqueueCore(JobItem* jobItem, bool isEndJob) SKR_NOEXCEPT
         return ASYNC_RESULT_ERROR_JOB_NOTHREAD;
     }
 
-    return itemList->push(jobItem, isEndJob);
+    return itemList->push(jobItem);
 }
 
 uint32_t JobQueue::items_count() const SKR_NOEXCEPT
@@ -414,8 +472,6 @@ void JobQueue::change_priority(JobQueuePriority priority) SKR_NOEXCEPT
 
 JobResult JobQueue::cancel_all_items() SKR_NOEXCEPT
 {
-    skr_rw_mutex_acquire_w(&pending_queue_mutex);
-    SKR_DEFER({skr_rw_mutex_release_w(&pending_queue_mutex);});
     skr_atomic32_store_release(&cancel_requested, true);
     return ASYNC_RESULT_OK;
 }
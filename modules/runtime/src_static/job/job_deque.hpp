@@ -0,0 +1,132 @@
+#pragma once
+#include "SkrRT/platform/memory.h"
+#include "SkrRT/containers/vector.hpp"
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+namespace skr
+{
+// Chase-Lev work stealing deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+// only the owner thread pushes and pops at the bottom, any thread may steal from the top.
+// outgrown buffers are retired instead of freed because thieves may still read from them
+template <typename T>
+struct WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "items of the deque are copied with relaxed atomics");
+
+    WorkStealingDeque(int64_t capacity = 256) SKR_NOEXCEPT
+        : top(0), bottom(0)
+    {
+        SKR_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        buffer.store(Buffer::create(capacity), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque() SKR_NOEXCEPT
+    {
+        Buffer::destroy(buffer.load(std::memory_order_relaxed));
+        for (auto retired_buffer : retired)
+            Buffer::destroy(retired_buffer);
+    }
+
+    // owner only
+    void push(T item) SKR_NOEXCEPT
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            a = grow(a, t, b);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only, takes the most recently pushed item
+    bool pop(T& item) SKR_NOEXCEPT
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = a->get(b);
+        if (t == b)
+        {
+            // last item, race the thieves for it
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // any thread, takes the least recently pushed item. fails spuriously when racing another thief
+    bool steal(T& item) SKR_NOEXCEPT
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        Buffer* a = buffer.load(std::memory_order_acquire);
+        item = a->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    int64_t size_approx() const SKR_NOEXCEPT
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+private:
+    struct Buffer
+    {
+        int64_t capacity;
+        int64_t mask;
+        std::atomic<T>* slots;
+
+        static Buffer* create(int64_t capacity)
+        {
+            auto memory = (uint8_t*)sakura_malloc(sizeof(Buffer) + sizeof(std::atomic<T>) * capacity);
+            auto result = new (memory) Buffer();
+            result->capacity = capacity;
+            result->mask = capacity - 1;
+            result->slots = (std::atomic<T>*)(memory + sizeof(Buffer));
+            for (int64_t i = 0; i < capacity; ++i)
+                new (result->slots + i) std::atomic<T>();
+            return result;
+        }
+        static void destroy(Buffer* b)
+        {
+            sakura_free(b);
+        }
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+    };
+
+    Buffer* grow(Buffer* a, int64_t t, int64_t b)
+    {
+        Buffer* grown = Buffer::create(a->capacity * 2);
+        for (int64_t i = t; i < b; ++i)
+            grown->put(i, a->get(i));
+        retired.emplace_back(a);
+        buffer.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Buffer*> buffer;
+    skr::vector<Buffer*> retired;
+};
+} // namespace skr
@@ -24,4 +24,9 @@ uint64_t skr_hash64(const void* buffer, uint64_t size, uint64_t seed)
 uint32_t skr_hash32(const void* buffer, uint32_t size, uint32_t seed)
 {
     return XXH32(buffer, size, seed);
-}
\ No newline at end of file
+}
+
+uint64_t skr_hash64_xxh3(const void* buffer, uint64_t size, uint64_t seed)
+{
+    return XXH3_64bits_withSeed(buffer, (size_t)size, seed);
+}
@@ -14,36 +14,6 @@ int WriteTrait<const bool&>::Write(skr_binary_writer_t* writer, bool value)
     return WriteTrait<const uint32_t&>::Write(writer, (uint32_t)value);
 }
 
-int WriteTrait<const uint8_t&>::Write(skr_binary_writer_t* writer, uint8_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const uint16_t&>::Write(skr_binary_writer_t* writer, uint16_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const uint32_t&>::Write(skr_binary_writer_t* writer, uint32_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const uint64_t&>::Write(skr_binary_writer_t* writer, uint64_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const int32_t&>::Write(skr_binary_writer_t* writer, int32_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const int64_t&>::Write(skr_binary_writer_t* writer, int64_t value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
 template<class T>
 int WriteBitpacked(skr_binary_writer_t* writer, T value, IntegerPackConfig<T> config)
 {
@@ -97,16 +67,6 @@ int WriteTrait<const int64_t&>::Write(skr_binary_writer_t* writer, int64_t value
     return WriteBitpacked(writer, value, config);
 }
 
-int WriteTrait<const float&>::Write(skr_binary_writer_t* writer, float value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
-int WriteTrait<const double&>::Write(skr_binary_writer_t* writer, double value)
-{
-    return WriteBytes(writer, &value, sizeof(value));
-}
-
 // template<class T>
 // int WriteBitpacked(skr_binary_writer_t* writer, T value, FloatingPackConfig<T> config)
 // {
@@ -9,6 +9,9 @@ add_requires("parallel-hashmap >=1.3.11-skr")
 add_requires("boost-context >=0.1.0-skr")
 add_requires("simdjson >=3.0.0-skr")
 add_requires("luau", { configs = { extern_c = true }})
+-- pak archives are compressed with these, pinned so every machine decodes with the same codec
+add_requires("zstd v1.5.5", {system = false})
+add_requires("lz4 v1.9.4", {system = false})
 
 target("SkrRTStatic")
     set_group("01.modules")
@@ -31,6 +34,7 @@ shared_module("SkrRT", "RUNTIME", engine_version)
 
     -- internal packages
     add_packages("boost-context", "luau", {public = true, inherit = true})
+    add_packages("zstd", "lz4", {public = false, inherit = false})
 
     -- add source files
     add_files("src/**/build.*.c", "src/**/build.*.cpp")
@@ -116,10 +116,13 @@ skr_camera_comp_t
 
 struct skr_transform_system_t {
     dual_query_t* relativeToWorld;
+    // depth-ordered flattened hierarchy, rebuilt when nodes or child lists change
+    struct skr_transform_hierarchy_t* hierarchy;
 };
 
 SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_transform_setup(dual_storage_t* world, skr_transform_system_t* system);
 SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_transform_update(skr_transform_system_t* query);
+SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_transform_release(skr_transform_system_t* system);
 SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_propagate_transform(dual_storage_t* world, dual_entity_t* entities, uint32_t count);
 SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_save_scene(dual_storage_t* world, struct skr_json_writer_t* writer);
 SKR_SCENE_EXTERN_C SKR_SCENE_API void skr_load_scene(dual_storage_t* world, struct skr_json_reader_t* reader);
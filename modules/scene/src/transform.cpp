@@ -3,100 +3,541 @@
 
 #include "SkrRT/ecs/dual_config.h"
 #include "SkrRT/misc/parallel_for.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/platform/memory.h"
 #include "SkrScene/scene.h"
 #include "SkrRT/math/matrix4x4f.h"
 #include "SkrRT/math/vector.h"
 #include "SkrRT/math/quat.h"
 #include "SkrRT/math/rtm/qvvf.h"
 
-rtm::qvvf make_qvv(skr_rotator_t* r, skr_float3_t* t, skr_float3_t* s)
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+
+#include "SkrProfile/profile.h"
+
+// nodes processed by a task inside one depth level
+static constexpr uint32_t kTransformBatchSize = 256;
+
+inline static uint64_t skr_transform_mix(uint32_t a, uint32_t b)
 {
-    const auto default_translation = rtm::vector_set(0.f, 0.f, 0.f);
-    const auto default_scale = rtm::vector_set(1.f, 1.f, 1.f);
-    const auto default_quat = rtm::quat_set(0.f, 0.f, 0.f, 1.f);
-    if (r && t && s)
-        return rtm::qvv_set(skr::math::load(*r), skr::math::load(*t), skr::math::load(*s));
-    else if (r && s)
-        return rtm::qvv_set(skr::math::load(*r), default_translation, skr::math::load(*s));
-    else if (r && t)
-        return rtm::qvv_set(skr::math::load(*r), skr::math::load(*t), default_scale);
-    else if (t && s)
-        return rtm::qvv_set(default_quat, skr::math::load(*t), skr::math::load(*s));
-    else if (t)
-        return rtm::qvv_set(default_quat, skr::math::load(*t), default_scale);
-    else if (r)
-        return rtm::qvv_set(skr::math::load(*r), default_translation, default_scale);
-    else if (s)
-        return rtm::qvv_set(default_quat, default_translation, skr::math::load(*s));
-    else
-        return rtm::qvv_set(default_quat, default_translation, default_scale);
+    uint64_t x = (((uint64_t)a << 32) | b) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 29);
 }
 
-static void skr_relative_to_world_children(skr_children_t* children, rtm::qvvf parent, dual_storage_t* storage)
-{
-    auto process = [&](dual_chunk_view_t* view) {
-        auto transforms = (skr_transform_t*)dualV_get_owned_ro(view, dual_id_of<skr_transform_comp_t>::get());
-        if (!transforms) 
-            return;
-        auto translations = (skr_float3_t*)dualV_get_owned_ro(view, dual_id_of<skr_translation_comp_t>::get());
-        auto rotations = (skr_rotator_t*)dualV_get_owned_ro(view, dual_id_of<skr_rotation_comp_t>::get());
-        auto scales = (skr_float3_t*)dualV_get_owned_ro(view, dual_id_of<skr_scale_comp_t>::get());
-        auto childrens = (skr_children_t*)dualV_get_owned_ro(view, dual_id_of<skr_child_comp_t>::get());
-        for(EIndex i = 0; i < view->count; ++i)
-        {
-            auto relative = make_qvv(rotations ? &rotations[i] : nullptr, translations ? &translations[i] : nullptr, scales ? &scales[i] : nullptr);
-            auto transform = rtm::qvv_mul(relative, parent);
-            skr::math::store(transform.translation, transforms[i].translation);
-            skr::math::store(transform.rotation, transforms[i].rotation);
-            skr::math::store(transform.scale, transforms[i].scale);
-            if (!childrens) 
-                continue;
-            skr_relative_to_world_children(children, transform, storage);
-        }
+// the scene hierarchy flattened into depth order, so every depth can be updated in parallel
+// once its parents are done. the node range of depth d is [depthOffsets[d], depthOffsets[d + 1])
+struct skr_transform_hierarchy_t {
+    static constexpr uint32_t kRoot = UINT32_MAX;
+
+    struct node_t {
+        dual_chunk_t* chunk;
+        EIndex index;
+        dual_entity_t entity;
+        uint32_t parent;
     };
-    if (children->size() > 256) // dispatch recursively
+
+    skr::vector<dual_entity_t> entities;
+    skr::vector<uint32_t> parents;
+    skr::vector<uint32_t> depthOffsets;
+    // world transforms of every node in SoA layout, indexed like entities
+    skr::vector<rtm::quatf> rotations;
+    skr::vector<rtm::vector4f> translations;
+    skr::vector<rtm::vector4f> scales;
+    // whether a node was recomputed by the current update, children of dirty nodes are dirty too
+    skr::vector<uint8_t> dirty;
+    // nodes placed by the last rebuild or patch, recomputed by the next update whatever their locals say
+    skr::vector<uint8_t> placed;
+    // roots without children are not part of the layout, their chunks are updated in place
+    skr::vector<dual_chunk_view_t> leafViews;
+    // layout chunks whose child or parent components were written since the last update, sorted
+    skr::vector<dual_chunk_t*> touchedChunks;
+    uint32_t layoutChunkCount = 0;
+    uint64_t layoutEntityCount = 0;
+    // local components written after this storage version need to be propagated again
+    uint64_t lastVersion = 0;
+    // storage version of the last update, chunk timestamps only tell changes apart once it moves
+    uint64_t updateVersion = 0;
+    // order independent hash of the nodes and their child lists, only kept for storages that are not versioned
+    uint64_t signature = 0;
+    bool signatureValid = false;
+    bool built = false;
+
+    dual_type_index_t transformType;
+    dual_type_index_t childType;
+    dual_type_index_t parentType;
+    dual_type_index_t translationType;
+    dual_type_index_t rotationType;
+    dual_type_index_t scaleType;
+
+    skr_transform_hierarchy_t()
+        : transformType(dual_id_of<skr_transform_comp_t>::get())
+        , childType(dual_id_of<skr_child_comp_t>::get())
+        , parentType(dual_id_of<skr_parent_comp_t>::get())
+        , translationType(dual_id_of<skr_translation_comp_t>::get())
+        , rotationType(dual_id_of<skr_rotation_comp_t>::get())
+        , scaleType(dual_id_of<skr_scale_comp_t>::get())
     {
-        using iter_t = typename skr_children_t::iterator;
-        skr::parallel_for(children->begin(), children->end(), 128,
-        [&](iter_t begin, iter_t end) {
-            dualS_batch(storage, (dual_entity_t*)&*begin, (EIndex)(end-begin), DUAL_LAMBDA(process));
+    }
+
+    bool has_type(const dual_chunk_t* chunk, dual_type_index_t type) const
+    {
+        dual_type_set_t set{ &type, 1 };
+        return dualG_has_components(dualC_get_group(chunk), &set);
+    }
+
+    bool is_root(const dual_chunk_view_t* view) const
+    {
+        return !has_type(view->chunk, parentType);
+    }
+
+    bool is_layout_root(const dual_chunk_t* chunk) const
+    {
+        return !has_type(chunk, parentType) && has_type(chunk, childType);
+    }
+
+    bool has_transform(dual_storage_t* storage, dual_entity_t entity, dual_chunk_view_t* view) const
+    {
+        dualS_access(storage, entity, view);
+        return view->chunk && dualV_get_owned_ro(view, transformType);
+    }
+
+    uint64_t compute_signature(dual_query_t* query) const
+    {
+        SkrZoneScopedN("TransformHierarchySignature");
+        uint64_t result = 0;
+        auto hashView = [&](dual_chunk_view_t* view) {
+            auto entities = dualV_get_entities(view);
+            auto children = (const skr_children_t*)dualV_get_owned_ro(view, childType);
+            const uint32_t root = is_root(view) ? 1 : 0;
+            for (EIndex i = 0; i < view->count; ++i)
+            {
+                result += skr_transform_mix(entities[i], root);
+                if (!children)
+                    continue;
+                for (const auto& child : children[i])
+                    result += skr_transform_mix(entities[i], child.entity);
+            }
+        };
+        dualQ_get_views(query, DUAL_LAMBDA(hashView));
+        return result;
+    }
+
+    // one pass over the chunks of the query, not the entities. picks out the chunks updated in place and
+    // returns whether a layout chunk was written to its child or parent components, or went away
+    bool scan(dual_query_t* query, bool versioned)
+    {
+        SkrZoneScopedN("TransformHierarchyScan");
+        leafViews.clear();
+        touchedChunks.clear();
+        const dual_type_index_t linkTypes[] = { childType, parentType };
+        const dual_type_set_t linkSet{ linkTypes, 2 };
+        uint32_t chunkCount = 0;
+        uint64_t entityCount = 0;
+        auto scanView = [&](dual_chunk_view_t* view) {
+            if (!has_type(view->chunk, parentType) && !has_type(view->chunk, childType))
+            {
+                leafViews.push_back(*view);
+                return;
+            }
+            ++chunkCount;
+            entityCount += view->count;
+            if (versioned && dualC_changed_since(view->chunk, &linkSet, lastVersion))
+                touchedChunks.push_back(view->chunk);
+        };
+        dualQ_get_views(query, DUAL_LAMBDA(scanView));
+        eastl::sort(touchedChunks.begin(), touchedChunks.end());
+        touchedChunks.erase(eastl::unique(touchedChunks.begin(), touchedChunks.end()), touchedChunks.end());
+        // removing the last entities of a chunk frees it, so no timestamp is left to tell
+        const bool shrunk = chunkCount != layoutChunkCount || entityCount != layoutEntityCount;
+        layoutChunkCount = chunkCount;
+        layoutEntityCount = entityCount;
+        return shrunk || !touchedChunks.empty();
+    }
+
+    // children driven by the hierarchy, subtrees below a node without transform are left alone
+    void collect_children(dual_storage_t* storage, const skr_children_t& children, uint32_t parent, skr::vector<node_t>& next) const
+    {
+        for (const auto& child : children)
+        {
+            dual_chunk_view_t childView;
+            if (has_transform(storage, child.entity, &childView))
+                next.push_back(node_t{ childView.chunk, childView.start, child.entity, parent });
+        }
+    }
+
+    // sort by chunk position so a batch of siblings resolves to few contiguous views
+    static void sort_nodes(skr::vector<node_t>& nodes)
+    {
+        eastl::sort(nodes.begin(), nodes.end(), [](const node_t& a, const node_t& b) {
+            return a.chunk != b.chunk ? a.chunk < b.chunk : a.index < b.index;
         });
     }
-    else
+
+    void resize_nodes()
     {
-        dualS_batch(storage, (dual_entity_t*)children->data(), (EIndex)children->size(), DUAL_LAMBDA(process));
+        rotations.resize(entities.size());
+        translations.resize(entities.size());
+        scales.resize(entities.size());
+        dirty.resize(entities.size());
+        placed.resize(entities.size());
     }
-}
 
-static void skr_relative_to_world_root(void* u, dual_query_t* query, dual_chunk_view_t* view, dual_type_index_t* localTypes, EIndex entityIndex)
-{
-    using namespace skr::math;
-    auto transforms = (skr_transform_t*)dualV_get_owned_ro_local(view, localTypes[0]);
-    auto children = (skr_children_t*)dualV_get_owned_ro_local(view, localTypes[1]);
-    auto translations = (skr_float3_t*)dualV_get_owned_ro_local(view, localTypes[2]);
-    auto rotations = (skr_rotator_t*)dualV_get_owned_ro_local(view, localTypes[3]);
-    auto scales = (skr_float3_t*)dualV_get_owned_ro_local(view, localTypes[4]);
-    for(EIndex i = 0; i < view->count; ++i)
+    void rebuild(dual_storage_t* storage, dual_query_t* query)
+    {
+        SkrZoneScopedN("TransformHierarchyRebuild");
+        entities.clear();
+        parents.clear();
+        depthOffsets.clear();
+
+        // roots are delivered in chunk order already
+        auto collectRoots = [&](dual_chunk_view_t* view) {
+            if (!is_layout_root(view->chunk))
+                return;
+            auto ents = dualV_get_entities(view);
+            entities.insert(entities.end(), ents, ents + view->count);
+            parents.insert(parents.end(), view->count, kRoot);
+        };
+        dualQ_get_views(query, DUAL_LAMBDA(collectRoots));
+        depthOffsets.push_back(0);
+
+        skr::vector<node_t> next;
+        uint32_t depthBegin = 0;
+        while (depthBegin != (uint32_t)entities.size())
+        {
+            const uint32_t depthEnd = (uint32_t)entities.size();
+            depthOffsets.push_back(depthEnd);
+            next.clear();
+            uint32_t parentIndex = depthBegin;
+            auto collectChildren = [&](dual_chunk_view_t* view) {
+                auto children = (const skr_children_t*)dualV_get_owned_ro(view, childType);
+                for (EIndex i = 0; i < view->count; ++i, ++parentIndex)
+                {
+                    if (children)
+                        collect_children(storage, children[i], parentIndex, next);
+                }
+            };
+            dualS_batch(storage, entities.data() + depthBegin, (EIndex)(depthEnd - depthBegin), DUAL_LAMBDA(collectChildren));
+            sort_nodes(next);
+            for (const auto& node : next)
+            {
+                entities.push_back(node.entity);
+                parents.push_back(node.parent);
+            }
+            depthBegin = depthEnd;
+        }
+
+        resize_nodes();
+        std::fill(placed.begin(), placed.end(), (uint8_t)1);
+        built = true;
+    }
+
+    // the layout keeps its untouched subtrees in place with their cached world transforms. nodes that are gone
+    // drop out with their subtrees, and the subtrees below nodes whose child list changed are collected again
+    void patch(dual_storage_t* storage)
+    {
+        SkrZoneScopedN("TransformHierarchyPatch");
+        enum : uint8_t
+        {
+            kKeep,
+            kExpand, // kept, its children are collected again
+            kDrop
+        };
+        const uint32_t count = (uint32_t)entities.size();
+        // hash of the child list of every node as the layout has it, to compare against the child components
+        skr::vector<uint64_t> childSignatures(count, 0);
+        for (uint32_t node = 0; node < count; ++node)
+        {
+            if (parents[node] != kRoot)
+                childSignatures[parents[node]] += skr_transform_mix(entities[parents[node]], entities[node]);
+        }
+        auto touched = [&](const dual_chunk_t* chunk) {
+            return eastl::binary_search(touchedChunks.begin(), touchedChunks.end(), chunk);
+        };
+        skr::vector<uint8_t> states(count);
+        for (uint32_t node = 0; node < count; ++node)
+        {
+            const uint32_t parent = parents[node];
+            if (parent != kRoot && states[parent] != kKeep)
+            {
+                states[node] = kDrop; // collected again below its parent or gone with it
+                continue;
+            }
+            dual_chunk_view_t view;
+            if (!has_transform(storage, entities[node], &view) || (parent == kRoot && !is_layout_root(view.chunk)))
+            {
+                states[node] = kDrop;
+                continue;
+            }
+            states[node] = kKeep;
+            if (!touched(view.chunk))
+                continue;
+            uint64_t childSignature = 0;
+            if (auto children = (const skr_children_t*)dualV_get_owned_ro(&view, childType))
+            {
+                for (const auto& child : *children)
+                {
+                    dual_chunk_view_t childView;
+                    if (has_transform(storage, child.entity, &childView))
+                        childSignature += skr_transform_mix(entities[node], child.entity);
+                }
+            }
+            if (childSignature != childSignatures[node])
+                states[node] = kExpand;
+        }
+
+        const uint32_t rootEnd = depthOffsets.size() > 1 ? depthOffsets[1] : 0;
+        // new roots can only show up in touched chunks
+        skr::vector<dual_entity_t> oldRoots;
+        for (uint32_t node = 0; node < rootEnd; ++node)
+        {
+            if (states[node] != kDrop)
+                oldRoots.push_back(entities[node]);
+        }
+        eastl::sort(oldRoots.begin(), oldRoots.end());
+        skr::vector<dual_entity_t> newRoots;
+        for (auto chunk : touchedChunks)
+        {
+            if (!is_layout_root(chunk))
+                continue;
+            const dual_chunk_view_t view{ chunk, 0, (EIndex)dualC_get_count(chunk) };
+            auto ents = dualV_get_entities(&view);
+            for (EIndex i = 0; i < view.count; ++i)
+            {
+                if (!eastl::binary_search(oldRoots.begin(), oldRoots.end(), ents[i]))
+                    newRoots.push_back(ents[i]);
+            }
+        }
+
+        skr::vector<dual_entity_t> newEntities;
+        skr::vector<uint32_t> newParents;
+        skr::vector<uint32_t> newOffsets;
+        skr::vector<rtm::quatf> newRotations;
+        skr::vector<rtm::vector4f> newTranslations;
+        skr::vector<rtm::vector4f> newScales;
+        skr::vector<uint8_t> newPlaced;
+        skr::vector<uint8_t> expand;
+        skr::vector<uint32_t> remap(count, kRoot);
+        const auto identityRotation = rtm::quat_identity();
+        const auto zero = rtm::vector_zero();
+        auto keep = [&](uint32_t node, uint32_t parent) {
+            remap[node] = (uint32_t)newEntities.size();
+            newEntities.push_back(entities[node]);
+            newParents.push_back(parent);
+            newRotations.push_back(rotations[node]);
+            newTranslations.push_back(translations[node]);
+            newScales.push_back(scales[node]);
+            newPlaced.push_back(0);
+            expand.push_back(states[node] == kExpand ? 1 : 0);
+        };
+        auto place = [&](dual_entity_t entity, uint32_t parent) {
+            newEntities.push_back(entity);
+            newParents.push_back(parent);
+            newRotations.push_back(identityRotation);
+            newTranslations.push_back(zero);
+            newScales.push_back(zero);
+            newPlaced.push_back(1);
+            expand.push_back(1);
+        };
+        for (uint32_t node = 0; node < rootEnd; ++node)
+        {
+            if (states[node] != kDrop)
+                keep(node, kRoot);
+        }
+        for (auto root : newRoots)
+            place(root, kRoot);
+        newOffsets.push_back(0);
+
+        const uint32_t oldDepthCount = depthOffsets.empty() ? 0 : (uint32_t)depthOffsets.size() - 1;
+        skr::vector<node_t> next;
+        uint32_t depth = 0;
+        uint32_t depthBegin = 0;
+        while (depthBegin != (uint32_t)newEntities.size())
+        {
+            const uint32_t depthEnd = (uint32_t)newEntities.size();
+            newOffsets.push_back(depthEnd);
+            ++depth;
+            // untouched nodes first, in their old order
+            if (depth < oldDepthCount)
+            {
+                for (uint32_t node = depthOffsets[depth]; node < depthOffsets[depth + 1]; ++node)
+                {
+                    if (states[node] != kDrop)
+                        keep(node, remap[parents[node]]);
+                }
+            }
+            next.clear();
+            for (uint32_t node = depthBegin; node < depthEnd; ++node)
+            {
+                if (!expand[node])
+                    continue;
+                dual_chunk_view_t view;
+                dualS_access(storage, newEntities[node], &view);
+                if (auto children = (const skr_children_t*)dualV_get_owned_ro(&view, childType))
+                    collect_children(storage, *children, node, next);
+            }
+            sort_nodes(next);
+            for (const auto& node : next)
+                place(node.entity, node.parent);
+            depthBegin = depthEnd;
+        }
+
+        entities.swap(newEntities);
+        parents.swap(newParents);
+        depthOffsets.swap(newOffsets);
+        rotations.swap(newRotations);
+        translations.swap(newTranslations);
+        scales.swap(newScales);
+        placed.swap(newPlaced);
+        dirty.resize(entities.size());
+    }
+
+    void update_leaf_view(dual_chunk_view_t* view, bool full)
     {
-        transforms[i].translation = translations ? translations[i] : skr_float3_t{0,0,0};
-        transforms[i].rotation = rotations ? rotations[i] : skr_rotator_t{0,0,0};
-        transforms[i].scale = scales ? scales[i] : skr_float3_t{1,1,1};
+        const dual_type_index_t localTypes[] = { translationType, rotationType, scaleType };
+        const dual_type_set_t localSet{ localTypes, 3 };
+        if (!full && !dualC_changed_since(view->chunk, &localSet, lastVersion))
+            return;
+        auto transforms = (skr_transform_comp_t*)dualV_get_owned_rw(view, transformType);
+        auto localTranslations = (const skr_translation_comp_t*)dualV_get_owned_ro(view, translationType);
+        auto localRotations = (const skr_rotation_comp_t*)dualV_get_owned_ro(view, rotationType);
+        auto localScales = (const skr_scale_comp_t*)dualV_get_owned_ro(view, scaleType);
+        for (EIndex i = 0; i < view->count; ++i)
+        {
+            transforms[i].value.rotation = localRotations ? localRotations[i].euler : skr_rotator_t{ 0, 0, 0 };
+            transforms[i].value.translation = localTranslations ? localTranslations[i].value : skr_float3_t{ 0, 0, 0 };
+            transforms[i].value.scale = localScales ? localScales[i].value : skr_float3_t{ 1, 1, 1 };
+        }
     }
-    auto storage = dualQ_get_storage(query);
-    forloop (i, 0, view->count)
+
+    void update_view(dual_chunk_view_t* view, uint32_t node)
     {
-        auto transform = rtm::qvv_set(skr::math::load(transforms[i].rotation), skr::math::load(transforms[i].translation), skr::math::load(transforms[i].scale));
-        skr_relative_to_world_children(&children[i], transform, storage);
+        // chunk timestamps tell whether any local transform in this chunk was touched since the last update
+        const dual_type_index_t localTypes[] = { translationType, rotationType, scaleType };
+        const dual_type_set_t localSet{ localTypes, 3 };
+        const bool localChanged = dualC_changed_since(view->chunk, &localSet, lastVersion);
+        bool anyDirty = false;
+        for (EIndex i = 0; i < view->count; ++i)
+        {
+            const uint32_t parent = parents[node + i];
+            const bool nodeDirty = localChanged || placed[node + i] || (parent != kRoot && dirty[parent]);
+            dirty[node + i] = nodeDirty;
+            anyDirty |= nodeDirty;
+        }
+        // leave clean views alone, so the transform components keep their timestamps too
+        if (!anyDirty)
+            return;
+        auto transforms = (skr_transform_comp_t*)dualV_get_owned_rw(view, transformType);
+        auto localTranslations = (const skr_translation_comp_t*)dualV_get_owned_ro(view, translationType);
+        auto localRotations = (const skr_rotation_comp_t*)dualV_get_owned_ro(view, rotationType);
+        auto localScales = (const skr_scale_comp_t*)dualV_get_owned_ro(view, scaleType);
+        const auto defaultRotation = rtm::quat_set(0.f, 0.f, 0.f, 1.f);
+        const auto defaultTranslation = rtm::vector_set(0.f, 0.f, 0.f);
+        const auto defaultScale = rtm::vector_set(1.f, 1.f, 1.f);
+        for (EIndex i = 0; i < view->count; ++i, ++node)
+        {
+            if (!dirty[node])
+                continue;
+            auto world = rtm::qvv_set(
+                localRotations ? skr::math::load(localRotations[i].euler) : defaultRotation,
+                localTranslations ? skr::math::load(localTranslations[i].value) : defaultTranslation,
+                localScales ? skr::math::load(localScales[i].value) : defaultScale);
+            const uint32_t parent = parents[node];
+            if (parent == kRoot)
+            {
+                // roots keep their local values as is, avoiding an euler round trip
+                transforms[i].value.rotation = localRotations ? localRotations[i].euler : skr_rotator_t{ 0, 0, 0 };
+                transforms[i].value.translation = localTranslations ? localTranslations[i].value : skr_float3_t{ 0, 0, 0 };
+                transforms[i].value.scale = localScales ? localScales[i].value : skr_float3_t{ 1, 1, 1 };
+            }
+            else
+            {
+                world = rtm::qvv_mul(world, rtm::qvv_set(rotations[parent], translations[parent], scales[parent]));
+                skr::math::store(world.rotation, transforms[i].value.rotation);
+                skr::math::store(world.translation, transforms[i].value.translation);
+                skr::math::store(world.scale, transforms[i].value.scale);
+            }
+            rotations[node] = world.rotation;
+            translations[node] = world.translation;
+            scales[node] = world.scale;
+        }
     }
-}
+
+    void update(dual_storage_t* storage, dual_query_t* query)
+    {
+        SkrZoneScopedN("TransformHierarchyUpdate");
+        const auto version = dualS_get_version(storage);
+        const bool versioned = built && version != updateVersion;
+        bool full = !built;
+        const bool changed = scan(query, versioned);
+        if (!versioned)
+        {
+            // without versions every chunk looks written, only a hash of the whole hierarchy tells
+            const auto newSignature = compute_signature(query);
+            full |= !signatureValid || newSignature != signature;
+            signature = newSignature;
+            signatureValid = true;
+        }
+        if (full)
+            rebuild(storage, query);
+        else if (versioned && changed)
+        {
+            patch(storage);
+            signatureValid = false;
+        }
+        {
+            SkrZoneScopedN("TransformLeafRoots");
+            using view_iter_t = typename decltype(leafViews)::iterator;
+            skr::parallel_for(leafViews.begin(), leafViews.end(), 1, [&](view_iter_t begin, view_iter_t end) {
+                for (auto iter = begin; iter != end; ++iter)
+                    update_leaf_view(&*iter, full);
+            }, 2u);
+        }
+        using iter_t = typename decltype(entities)::iterator;
+        for (size_t depth = 0; depth + 1 < depthOffsets.size(); ++depth)
+        {
+            SkrZoneScopedN("TransformDepth");
+            skr::parallel_for(entities.begin() + depthOffsets[depth], entities.begin() + depthOffsets[depth + 1], kTransformBatchSize,
+            [&](iter_t begin, iter_t end) {
+                uint32_t node = (uint32_t)(begin - entities.begin());
+                auto process = [&](dual_chunk_view_t* view) {
+                    update_view(view, node);
+                    node += view->count;
+                };
+                dualS_batch(storage, &*begin, (EIndex)(end - begin), DUAL_LAMBDA(process));
+            }, 2u);
+        }
+        std::fill(placed.begin(), placed.end(), (uint8_t)0);
+        // writes stamped with the current version may still land after this job, so they are checked again next time
+        lastVersion = version - 1;
+        updateVersion = version;
+    }
+};
 
 void skr_transform_setup(dual_storage_t* world, skr_transform_system_t* system)
 {
-    // then recursively calculate local to world for node entities
-    system->relativeToWorld = dualQ_from_literal(world, "[inout]<seq>skr_transform_comp_t,[in]<seq>skr_child_comp_t,!skr_parent_comp_t,[in]<seq>?skr_translation_comp_t,[in]<seq>?skr_rotation_comp_t,[in]<seq>?skr_scale_comp_t");
+    // every node with a transform, roots are told apart by the missing parent component.
+    // children are reached through dualS_access/dualS_batch, so every component is declared random access
+    // and the scheduler orders the job against writers in any archetype, not only the queried ones
+    system->relativeToWorld = dualQ_from_literal(world, "[inout]<par>skr_transform_comp_t,[in]<par>?skr_child_comp_t,[in]<par>?skr_parent_comp_t,[in]<par>?skr_translation_comp_t,[in]<par>?skr_rotation_comp_t,[in]<par>?skr_scale_comp_t");
+    system->hierarchy = SkrNew<skr_transform_hierarchy_t>();
 }
 
 void skr_transform_update(skr_transform_system_t* query)
 {
-    dualJ_schedule_ecs(query->relativeToWorld, 128, &skr_relative_to_world_root, nullptr, nullptr, nullptr, nullptr, nullptr);
+    // query caches are only built on the main thread, the job iterates the cached groups
+    dualQ_get(query->relativeToWorld, nullptr, nullptr);
+    auto update = +[](void* u, dual_query_t* query) {
+        auto hierarchy = (skr_transform_hierarchy_t*)u;
+        hierarchy->update(dualQ_get_storage(query), query);
+    };
+    dualJ_schedule_custom(query->relativeToWorld, update, query->hierarchy, nullptr, nullptr, nullptr, nullptr);
+}
+
+void skr_transform_release(skr_transform_system_t* system)
+{
+    SkrDelete(system->hierarchy);
+    system->hierarchy = nullptr;
+    dualQ_release(system->relativeToWorld);
+    system->relativeToWorld = nullptr;
 }
@@ -0,0 +1,262 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/misc/log.h"
+#include "SkrRT/misc/parallel_for.hpp"
+#include "SkrRT/misc/parallel_algo.hpp"
+
+#include "SkrTestFramework/framework.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+class ParallelAlgoTests
+{
+protected:
+    ParallelAlgoTests()
+    {
+        scheduler.initialize(skr::task::scheudler_config_t());
+        scheduler.bind();
+    }
+    ~ParallelAlgoTests()
+    {
+        scheduler.unbind();
+    }
+    skr::task::scheduler_t scheduler;
+};
+
+TEST_CASE_METHOD(ParallelAlgoTests, "ParallelForRange")
+{
+    // uneven counts leave a short last range
+    for (size_t count : { (size_t)1, (size_t)7, (size_t)1000, (size_t)100003 })
+    {
+        std::vector<std::atomic<uint32_t>> visits(count);
+        std::atomic<size_t> ranges = 0;
+        std::atomic<size_t> oversized = 0;
+        skr::parallel_for_range(count, [&](size_t begin, size_t end) {
+            if (begin >= end || end - begin > 64)
+                oversized++;
+            for (size_t i = begin; i < end; ++i)
+                visits[i]++;
+            ranges++;
+        }, 64);
+        bool once = true;
+        for (auto& visit : visits)
+            once &= (visit.load() == 1);
+        EXPECT_TRUE(once);
+        EXPECT_EQ(oversized.load(), 0);
+        EXPECT_EQ(ranges.load(), (count + 63) / 64);
+    }
+
+    std::vector<uint32_t> values(50000, 0);
+    skr::parallel_for_each_index(values.size(), [&](size_t i) { values[i] = (uint32_t)i * 2; });
+    bool doubled = true;
+    for (size_t i = 0; i < values.size(); ++i)
+        doubled &= (values[i] == i * 2);
+    EXPECT_TRUE(doubled);
+}
+
+TEST_CASE_METHOD(ParallelAlgoTests, "ParallelReduce")
+{
+    std::vector<uint64_t> values(1 << 20);
+    std::iota(values.begin(), values.end(), 0);
+    const uint64_t expected = (uint64_t)values.size() * (values.size() - 1) / 2;
+    EXPECT_EQ(skr::parallel_reduce(values.begin(), values.end(), (uint64_t)0, std::plus<uint64_t>()), expected);
+    EXPECT_EQ(skr::parallel_reduce(values.begin(), values.end(), (uint64_t)5, std::plus<uint64_t>(), 1000), expected + 5);
+    EXPECT_EQ(skr::parallel_reduce(values.begin(), values.begin(), (uint64_t)5, std::plus<uint64_t>()), 5);
+
+    // not commutative, the ranges must be combined in order
+    std::vector<std::string> words = { "a", "b", "c", "d", "e", "f", "g", "h", "i", "j" };
+    auto joined = skr::parallel_reduce(words.begin(), words.end(), std::string(), std::plus<std::string>(), 3);
+    EXPECT_EQ(joined, std::string("abcdefghij"));
+}
+
+TEST_CASE_METHOD(ParallelAlgoTests, "ParallelScan")
+{
+    for (size_t grain : { (size_t)0, (size_t)1, (size_t)100, (size_t)4096 })
+    {
+        std::vector<uint64_t> values(100003);
+        std::iota(values.begin(), values.end(), 1);
+        std::vector<uint64_t> expected(values.size());
+        std::partial_sum(values.begin(), values.end(), expected.begin());
+
+        std::vector<uint64_t> scanned(values.size());
+        skr::parallel_inclusive_scan(values.begin(), values.end(), scanned.begin(), std::plus<uint64_t>(), grain);
+        EXPECT_TRUE(scanned == expected);
+        // in place
+        skr::parallel_inclusive_scan(values.begin(), values.end(), values.begin(), std::plus<uint64_t>(), grain);
+        EXPECT_TRUE(values == expected);
+    }
+}
+
+TEST_CASE_METHOD(ParallelAlgoTests, "ParallelSort")
+{
+    std::mt19937 rng(42);
+    for (size_t count : { (size_t)0, (size_t)1, (size_t)5000, (size_t)100003 })
+    {
+        std::vector<uint32_t> values(count);
+        for (auto& value : values)
+            value = rng() % 1000;
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        auto sorted = values;
+        skr::parallel_sort(sorted.begin(), sorted.end());
+        EXPECT_TRUE(sorted == expected);
+        sorted = values;
+        skr::parallel_sort(sorted.begin(), sorted.end(), skr::Less<>(), 1000);
+        EXPECT_TRUE(sorted == expected);
+    }
+
+    // all keys distinct, no runs of equal keys shorten the merges
+    for (size_t grain : { (size_t)0, (size_t)1000 })
+    {
+        std::vector<uint32_t> values(100003);
+        std::iota(values.begin(), values.end(), 0);
+        std::shuffle(values.begin(), values.end(), rng);
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        skr::parallel_sort(values.begin(), values.end(), skr::Less<>(), grain);
+        EXPECT_TRUE(values == expected);
+    }
+
+    // equal keys keep their order
+    struct Item
+    {
+        uint32_t key;
+        uint32_t index;
+        bool operator==(const Item& other) const { return key == other.key && index == other.index; }
+    };
+    std::vector<Item> items(100003);
+    for (uint32_t i = 0; i < (uint32_t)items.size(); ++i)
+        items[i] = { (uint32_t)(rng() % 64), i };
+    auto by_key = [](const Item& a, const Item& b) { return a.key < b.key; };
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    skr::parallel_stable_sort(items.begin(), items.end(), by_key, 1000);
+    EXPECT_TRUE(items == expected);
+
+    // the merge scratch is constructed from the elements, they need no default constructor and no copies
+    struct MoveOnly
+    {
+        explicit MoveOnly(uint32_t key) : key(key), name(std::to_string(key)) {}
+        MoveOnly(MoveOnly&&) = default;
+        MoveOnly& operator=(MoveOnly&&) = default;
+        MoveOnly(const MoveOnly&) = delete;
+        MoveOnly& operator=(const MoveOnly&) = delete;
+        uint32_t key;
+        std::string name;
+    };
+    std::vector<MoveOnly> move_only;
+    for (uint32_t i = 0; i < 10007; ++i)
+        move_only.emplace_back((uint32_t)(rng() % 1000));
+    auto by_move_only_key = [](const MoveOnly& a, const MoveOnly& b) { return a.key < b.key; };
+    skr::parallel_stable_sort(move_only.begin(), move_only.end(), by_move_only_key, 1000);
+    for (size_t i = 0; i < move_only.size(); ++i)
+    {
+        EXPECT_TRUE(i == 0 || move_only[i - 1].key <= move_only[i].key);
+        EXPECT_EQ(move_only[i].name, std::to_string(move_only[i].key));
+    }
+}
+
+TEST_CASE_METHOD(ParallelAlgoTests, "ParallelAlgoBenchmark")
+{
+    static constexpr size_t kCount = 1 << 22;
+    std::vector<float> values(kCount);
+    std::mt19937 rng(7);
+    for (auto& value : values)
+        value = (float)(rng() % 10000) * 0.01f;
+    // integer work, so every algorithm produces the same bits
+    auto work = [](float value) {
+        uint32_t hash = (uint32_t)value;
+        for (uint32_t i = 0; i < 16; ++i)
+            hash = (hash ^ (hash >> 15)) * 0x2c1b3c6dU;
+        return hash;
+    };
+
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    {
+        std::vector<uint32_t> out(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            out[i] = work(values[i]);
+        const auto serial_seconds = skr_hires_timer_get_seconds(&timer, true);
+
+        std::vector<uint32_t> batched(kCount);
+        skr::parallel_for(values.begin(), values.end(), 4096, [&](auto begin, auto end) {
+            for (auto it = begin; it != end; ++it)
+                batched[it - values.begin()] = work(*it);
+        });
+        const auto batched_seconds = skr_hires_timer_get_seconds(&timer, true);
+
+        std::vector<uint32_t> split(kCount);
+        skr::parallel_for_range(kCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                split[i] = work(values[i]);
+        });
+        const auto split_seconds = skr_hires_timer_get_seconds(&timer, true);
+        SKR_TEST_INFO(u8"for {} elements: serial {} ms, parallel_for {} ms, parallel_for_range {} ms",
+            kCount, serial_seconds * 1000.0, batched_seconds * 1000.0, split_seconds * 1000.0);
+        EXPECT_TRUE(out == batched);
+        EXPECT_TRUE(out == split);
+    }
+    {
+        skr_hires_timer_reset(&timer);
+        double serial = 0.0;
+        for (auto value : values)
+            serial += value;
+        const auto serial_seconds = skr_hires_timer_get_seconds(&timer, true);
+        const double parallel = skr::parallel_reduce(values.begin(), values.end(), 0.0, [](double a, double b) { return a + b; });
+        const auto parallel_seconds = skr_hires_timer_get_seconds(&timer, true);
+        SKR_TEST_INFO(u8"reduce {} elements: serial {} ms, parallel_reduce {} ms",
+            kCount, serial_seconds * 1000.0, parallel_seconds * 1000.0);
+        EXPECT_TRUE(std::abs(serial - parallel) <= std::abs(serial) * 1e-9);
+    }
+    {
+        auto serial = values;
+        auto parallel = values;
+        skr_hires_timer_reset(&timer);
+        skr::algo::intro_sort(serial.begin(), serial.end(), skr::Less<>());
+        const auto serial_seconds = skr_hires_timer_get_seconds(&timer, true);
+        skr::parallel_sort(parallel.begin(), parallel.end());
+        const auto parallel_seconds = skr_hires_timer_get_seconds(&timer, true);
+        SKR_TEST_INFO(u8"sort {} elements: intro_sort {} ms, parallel_sort {} ms",
+            kCount, serial_seconds * 1000.0, parallel_seconds * 1000.0);
+        EXPECT_TRUE(serial == parallel);
+    }
+    {
+        // distinct keys make every merge step interleave the runs
+        std::vector<float> distinct(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            distinct[i] = (float)i;
+        std::shuffle(distinct.begin(), distinct.end(), rng);
+        auto serial = distinct;
+        auto parallel = distinct;
+        skr_hires_timer_reset(&timer);
+        skr::algo::intro_sort(serial.begin(), serial.end(), skr::Less<>());
+        const auto serial_seconds = skr_hires_timer_get_seconds(&timer, true);
+        skr::parallel_sort(parallel.begin(), parallel.end());
+        const auto parallel_seconds = skr_hires_timer_get_seconds(&timer, true);
+        SKR_TEST_INFO(u8"sort {} distinct elements: intro_sort {} ms, parallel_sort {} ms",
+            kCount, serial_seconds * 1000.0, parallel_seconds * 1000.0);
+        EXPECT_TRUE(serial == parallel);
+    }
+}
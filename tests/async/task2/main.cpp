@@ -21,6 +21,7 @@ static struct ProcInitializer
 #if __cpp_impl_coroutine
 #include "SkrRT/async/co_task.hpp"
 #include "SkrRT/platform/filesystem.hpp"
+#include <vector>
 
 class Task2
 {
@@ -246,6 +247,54 @@ TEST_CASE_METHOD(Task2, "MassiveCoroutine")
     EXPECT_EQ(a, 1010000);
 }
 
+TEST_CASE("PriorityLanes")
+{
+    using namespace skr::task2;
+    // a single worker thread besides the main one, which only helps out inside sync()
+    scheudler_config_t config;
+    config.numThreads = 2;
+    scheduler_t scheduler;
+    scheduler.initialize(config);
+    scheduler.bind();
+
+    // hold the worker so every lane is filled before any of them runs
+    std::atomic<bool> started = false;
+    std::atomic<bool> released = false;
+    schedule([&]()
+    {
+        started = true;
+        while (!released)
+            skr_thread_sleep(1);
+    });
+    while (!started)
+        skr_thread_sleep(1);
+
+    const int count = 64;
+    std::atomic<int> order = 0;
+    std::vector<int> lowOrder(count), normalOrder(count), highOrder(count);
+    for (int i = 0; i < count; ++i)
+    {
+        schedule([&, i]() { lowOrder[i] = order++; }, task_priority_t::low);
+        schedule([&, i]() { normalOrder[i] = order++; }, task_priority_t::normal);
+        schedule([&, i]() { highOrder[i] = order++; }, task_priority_t::high);
+    }
+    released = true;
+    while (order < count * 3)
+        skr_thread_sleep(1);
+
+    bool ordered = true;
+    for (int i = 0; i < count; ++i)
+    {
+        ordered &= highOrder[i] < count;
+        ordered &= normalOrder[i] >= count && normalOrder[i] < 2 * count;
+        ordered &= lowOrder[i] >= 2 * count;
+    }
+    EXPECT_TRUE(ordered);
+
+    scheduler.unbind();
+    scheduler.shutdown();
+}
+
 #else
 struct Task2
 {
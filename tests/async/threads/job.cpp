@@ -4,6 +4,12 @@
 #include "SkrRT/async/thread_job.hpp"
 
 #include "SkrTestFramework/framework.hpp"
+#include "SkrRT/platform/time.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 static struct ProcInitializer
 {
@@ -47,6 +53,184 @@ TEST_CASE("JobQueue")
     jq.wait_empty();
 }
 
+struct CountingJob : public skr::JobItem
+{
+    CountingJob(const skr::JobItemDesc& desc = {})
+        : JobItem(u8"CountingJob", desc)
+    {
+    }
+    skr::JobResult run() SKR_NOEXCEPT override
+    {
+        order = counter->fetch_add(1, std::memory_order_relaxed);
+        // a few hundred cycles of work, small enough for the queue overhead to dominate
+        uint32_t h = order;
+        for (uint32_t i = 0; i < 64; ++i)
+            h = h * 1664525u + 1013904223u;
+        hash = h;
+        for (uint32_t i = 0; i < children_count; ++i)
+            queue->enqueue(children + i);
+        return skr::ASYNC_RESULT_OK;
+    }
+    void finish(skr::JobResult result) SKR_NOEXCEPT override
+    {
+        finished++;
+    }
+    std::atomic<uint32_t>* counter = nullptr;
+    skr::JobQueue* queue = nullptr;
+    CountingJob* children = nullptr;
+    uint32_t children_count = 0;
+    uint32_t order = 0;
+    uint32_t hash = 0;
+    uint32_t finished = 0;
+};
+
+static void drain(skr::JobQueue& jq)
+{
+    while (!jq.is_empty())
+    {
+        jq.check();
+    }
+}
+
+TEST_CASE("JobQueueThroughput")
+{
+    const uint32_t threadCount = std::max(3u, std::thread::hardware_concurrency()) - 1;
+    auto jqDesc = make_zeroed<skr::JobQueueDesc>();
+    jqDesc.thread_count = threadCount;
+    jqDesc.priority = SKR_THREAD_NORMAL;
+    jqDesc.name = u8"ThroughputJobQueue";
+    skr::JobQueue jq(jqDesc);
+    std::atomic<uint32_t> counter = 0;
+
+    // many tiny jobs enqueued from the main thread go through the injection queue
+    const uint32_t jobCount = 200000;
+    std::vector<CountingJob> jobs(jobCount);
+    for (auto& job : jobs)
+    {
+        job.counter = &counter;
+        job.queue = &jq;
+    }
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    for (auto& job : jobs)
+        jq.enqueue(&job);
+    drain(jq);
+    const auto injectSeconds = skr_hires_timer_get_seconds(&timer, true);
+    EXPECT_EQ(counter.load(), jobCount);
+    bool allFinished = true;
+    for (auto& job : jobs)
+        allFinished &= job.finished == 1;
+    EXPECT_TRUE(allFinished);
+
+    // a few roots fan out from the workers, children land in the worker deques and get stolen
+    const uint32_t rootCount = 64;
+    const uint32_t fanout = jobCount / rootCount;
+    std::vector<CountingJob> roots(rootCount);
+    for (auto& job : jobs)
+        job.finished = 0;
+    for (uint32_t i = 0; i < rootCount; ++i)
+    {
+        roots[i].counter = &counter;
+        roots[i].queue = &jq;
+        roots[i].children = jobs.data() + i * fanout;
+        roots[i].children_count = fanout;
+    }
+    counter = 0;
+    skr_hires_timer_get_seconds(&timer, true);
+    for (auto& root : roots)
+        jq.enqueue(&root);
+    drain(jq);
+    const auto fanoutSeconds = skr_hires_timer_get_seconds(&timer, true);
+    EXPECT_EQ(counter.load(), rootCount + rootCount * fanout);
+
+    SKR_TEST_INFO(u8"{} threads: {} injected jobs in {} ms ({} jobs/ms), {} forked jobs in {} ms ({} jobs/ms)",
+        threadCount,
+        jobCount, injectSeconds * 1000.0, jobCount / (injectSeconds * 1000.0),
+        rootCount * fanout, fanoutSeconds * 1000.0, rootCount * fanout / (fanoutSeconds * 1000.0));
+}
+
+TEST_CASE("JobQueueWakeup")
+{
+    // workers park without a timeout, so a lost wakeup leaves the job queued for good
+    auto jqDesc = make_zeroed<skr::JobQueueDesc>();
+    jqDesc.thread_count = 2;
+    jqDesc.priority = SKR_THREAD_NORMAL;
+    jqDesc.name = u8"WakeupJobQueue";
+    skr::JobQueue jq(jqDesc);
+    std::atomic<uint32_t> counter = 0;
+    const uint32_t rounds = 200;
+    std::vector<CountingJob> jobs(rounds);
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    double maxSeconds = 0.0;
+    bool allRan = true;
+    for (uint32_t i = 0; i < rounds; ++i)
+    {
+        // long enough for the workers to run out of spins and park
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        jobs[i].counter = &counter;
+        jobs[i].queue = &jq;
+        skr_hires_timer_reset(&timer);
+        jq.enqueue(&jobs[i]);
+        while (counter.load() != i + 1 && skr_hires_timer_get_seconds(&timer, false) < 2.0)
+            std::this_thread::yield();
+        allRan &= counter.load() == i + 1;
+        maxSeconds = std::max(maxSeconds, skr_hires_timer_get_seconds(&timer, false));
+    }
+    drain(jq);
+    EXPECT_TRUE(allRan);
+    SKR_TEST_INFO(u8"{} wakeups of parked workers, slowest {} ms", rounds, maxSeconds * 1000.0);
+}
+
+TEST_CASE("JobQueuePriority")
+{
+    auto jqDesc = make_zeroed<skr::JobQueueDesc>();
+    jqDesc.thread_count = 1;
+    jqDesc.priority = SKR_THREAD_NORMAL;
+    skr::JobQueue jq(jqDesc);
+    std::atomic<uint32_t> counter = 0;
+
+    // hold the only worker so every other job is queued before any of them runs
+    struct BlockingJob : public skr::JobItem
+    {
+        BlockingJob() : JobItem(u8"BlockingJob") {}
+        skr::JobResult run() SKR_NOEXCEPT override
+        {
+            started = true;
+            while (!released)
+                skr_thread_sleep(1);
+            return skr::ASYNC_RESULT_OK;
+        }
+        void finish(skr::JobResult result) SKR_NOEXCEPT override {}
+        std::atomic<bool> started = false;
+        std::atomic<bool> released = false;
+    } blocker;
+    jq.enqueue(&blocker);
+    while (!blocker.started)
+        skr_thread_sleep(1);
+
+    const uint32_t count = 256;
+    std::vector<CountingJob> normal(count);
+    std::vector<CountingJob> high(count, CountingJob(skr::JobItemDesc{ kJobItemPriorityHigh }));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        normal[i].counter = high[i].counter = &counter;
+        normal[i].queue = high[i].queue = &jq;
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        jq.enqueue(&normal[i]);
+        jq.enqueue(&high[i]);
+    }
+    blocker.released = true;
+    drain(jq);
+
+    bool highFirst = true;
+    for (uint32_t i = 0; i < count; ++i)
+        highFirst &= high[i].order < count && normal[i].order >= count;
+    EXPECT_TRUE(highFirst);
+}
+
 #include "SkrRT/misc/log.h"
 #include "SkrRT/async/async_progress.hpp"
 #include <SkrRT/containers/string.hpp>
@@ -32,4 +32,10 @@ target("MarlTest")
     public_dependency("SkrRT", engine_version)
     add_deps("SkrTestFramework", {public = false})
     add_rules("c++.unity_build", {batchsize = default_unity_batch_size})
-    add_files("marl-test/**.cpp")
\ No newline at end of file
+    add_files("marl-test/**.cpp")
+target("ParallelAlgoTest")
+    set_kind("binary")
+    set_group("05.tests/task")
+    public_dependency("SkrRT", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    add_files("parallel/parallel_algo.cpp")
@@ -1,13 +1,25 @@
 #include "guid.hpp" //for guid
 #include "SkrRT/platform/crash.h"
 #include "SkrRT/ecs/dual.h"
+#include "SkrRT/ecs/entities.hpp"
+#include "SkrRT/ecs/entity.hpp"
+#include "SkrRT/ecs/chunk_pool.hpp"
 #include "SkrRT/misc/make_zeroed.hpp"
 #include "SkrRT/misc/log.h"
+#include "SkrRT/async/fib_task.hpp"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/serde/binary/writer.h"
+#include "SkrRT/serde/binary/reader.h"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/containers/span.hpp"
 
 #include "SkrTestFramework/framework.hpp"
 
 #include <memory>
+#include <atomic>
 #include <algorithm>
+#include <thread>
+#include <vector>
 
 using TestComp = int;
 dual_type_index_t type_test;
@@ -372,6 +384,567 @@ TEST_CASE_METHOD(ECSTest, "query")
     EXPECT_EQ(*dualV_get_entities(&view), e1);
 }
 
+TEST_CASE_METHOD(ECSTest, "parallel_for")
+{
+    skr::task::scheduler_t scheduler;
+    scheduler.initialize(skr::task::scheudler_config_t());
+    scheduler.bind();
+    {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        auto callback = [&](dual_chunk_view_t* inView) {
+            auto t = (TestComp*)dualV_get_owned_rw(inView, type_test);
+            std::fill(t, t + inView->count, 1);
+        };
+        dualS_allocate_type(storage, &entityType, 20000, DUAL_LAMBDA(callback));
+    }
+    auto query = dualQ_from_literal(storage, "[inout]test");
+
+    std::atomic<EIndex> visited = 0;
+    std::atomic<EIndex> indexSum = 0;
+    auto process = [&](dual_chunk_view_t* view, dual_type_index_t* localTypes, EIndex entityIndex) {
+        auto t = (TestComp*)dualV_get_owned_rw_local(view, localTypes[0]);
+        for (EIndex i = 0; i < view->count; ++i)
+        {
+            t[i] += 1;
+            indexSum += entityIndex + i;
+        }
+        visited += view->count;
+    };
+    auto trampoline = +[](void* u, dual_query_t* query, dual_chunk_view_t* view, dual_type_index_t* localTypes, EIndex entityIndex) {
+        (*(decltype(process)*)u)(view, localTypes, entityIndex);
+    };
+    dualQ_parallel_for(query, 256, trampoline, &process);
+    // every entity is visited exactly once with a unique entity index
+    const EIndex total = 20001;
+    EXPECT_EQ(visited.load(), total);
+    EXPECT_EQ(indexSum.load(), total * (total - 1) / 2);
+
+    bool allIncremented = true;
+    auto check = [&](dual_chunk_view_t* view) {
+        auto t = (const TestComp*)dualV_get_owned_ro(view, type_test);
+        for (EIndex i = 0; i < view->count; ++i)
+            allIncremented &= (t[i] == 2) || (t[i] == 124);
+    };
+    dualQ_get_views(query, DUAL_LAMBDA(check));
+    EXPECT_TRUE(allIncremented);
+
+    dualQ_release(query);
+    scheduler.unbind();
+}
+
+TEST_CASE_METHOD(ECSTest, "defragment_incremental")
+{
+    std::vector<dual_entity_t> entities;
+    auto spawn = [&](EIndex count) {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        auto callback = [&](dual_chunk_view_t* view) {
+            auto t = (TestComp*)dualV_get_owned_rw(view, type_test);
+            auto ents = dualV_get_entities(view);
+            for (EIndex i = 0; i < view->count; ++i)
+            {
+                t[i] = (TestComp)ents[i];
+                entities.push_back(ents[i]);
+            }
+        };
+        dualS_allocate_type(storage, &entityType, count, DUAL_LAMBDA(callback));
+    };
+    // destroying every other entity leaves all chunks half empty
+    auto fragment = [&]() {
+        std::vector<dual_entity_t> alive;
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            if (i % 2 == 0)
+            {
+                alive.push_back(entities[i]);
+                continue;
+            }
+            dual_chunk_view_t view;
+            dualS_access(storage, entities[i], &view);
+            dualS_destroy(storage, &view);
+        }
+        entities = std::move(alive);
+    };
+    auto chunkCount = [&]() {
+        uint32_t chunks = 0;
+        auto callback = [&](dual_chunk_view_t* view) { ++chunks; };
+        dualS_all(storage, false, false, DUAL_LAMBDA(callback));
+        return chunks;
+    };
+    auto intact = [&]() {
+        bool result = true;
+        for (auto e : entities)
+        {
+            dual_chunk_view_t view;
+            dualS_access(storage, e, &view);
+            result &= view.chunk && *(const TestComp*)dualV_get_owned_ro(&view, type_test) == (TestComp)e;
+        }
+        return result;
+    };
+
+    spawn(100000);
+    fragment();
+    const uint32_t fragmented = chunkCount();
+    // small steps need several calls, but every call makes progress
+    dual_defragment_budget_t budget = { 64 * 1024, 0 };
+    uint32_t steps = 1;
+    while (dualS_defragment_incremental(storage, &budget))
+        ++steps;
+    EXPECT_GT(steps, 1u);
+    EXPECT_LT(chunkCount(), fragmented);
+    EXPECT_TRUE(intact());
+
+    // the same as a job bound to the scheduler
+    skr::task::scheduler_t scheduler;
+    scheduler.initialize(skr::task::scheudler_config_t());
+    scheduler.bind();
+    dualJ_bind_storage(storage);
+    spawn(50000);
+    fragment();
+    const uint32_t refragmented = chunkCount();
+    budget = { 0, 0 };
+    skr::task::event_t event;
+    EXPECT_TRUE(dualJ_schedule_defragment(storage, &budget, &event));
+    dualJ_wait_storage(storage);
+    EXPECT_LT(chunkCount(), refragmented);
+    EXPECT_TRUE(intact());
+    EXPECT_FALSE(dualJ_schedule_defragment(storage, &budget, nullptr));
+    dualJ_unbind_storage(storage);
+    scheduler.unbind();
+}
+
+TEST_CASE_METHOD(ECSTest, "command_buffer")
+{
+    std::vector<dual_entity_t> entities;
+    {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        auto callback = [&](dual_chunk_view_t* view) {
+            auto ents = dualV_get_entities(view);
+            entities.insert(entities.end(), ents, ents + view->count);
+        };
+        dualS_allocate_type(storage, &entityType, 30000, DUAL_LAMBDA(callback));
+    }
+    auto buffer = dualCB_create(storage);
+    const dual_type_set_t test2Set = { &type_test2, 1 };
+    const dual_type_set_t testSet = { &type_test, 1 };
+    const uint32_t threadCount = 4;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (size_t i = t; i < entities.size(); i += threadCount)
+            {
+                // destroyed, moved to a wider group with data or moved to a narrower group
+                if (i % 3 == 0)
+                    dualCB_destroy(buffer, &entities[i], 1);
+                else if (i % 3 == 1)
+                {
+                    const TestComp value = (TestComp)i;
+                    dualCB_add_components(buffer, &entities[i], 1, &test2Set);
+                    dualCB_set_component(buffer, entities[i], type_test2, &value);
+                }
+                else
+                    dualCB_remove_components(buffer, &entities[i], 1, &testSet);
+            }
+            if (t == 0)
+                dualCB_spawn(buffer, e1, 10, nullptr, nullptr);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    // nothing is applied before playback
+    EXPECT_EQ(dualS_count(storage, false, false), (EIndex)entities.size() + 1);
+    dualCB_playback(buffer);
+
+    bool valid = true;
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        const bool exist = dualS_exist(storage, entities[i]);
+        if (i % 3 == 0)
+        {
+            valid &= !exist;
+            continue;
+        }
+        dual_chunk_view_t view;
+        dualS_access(storage, entities[i], &view);
+        auto test = dualV_get_owned_ro(&view, type_test);
+        auto test2 = (const TestComp*)dualV_get_owned_ro(&view, type_test2);
+        if (i % 3 == 1)
+            valid &= exist && test && test2 && *test2 == (TestComp)i;
+        else
+            valid &= exist && !test && !test2;
+    }
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(dualS_count(storage, false, false), (EIndex)(entities.size() - (entities.size() + 2) / 3 + 1 + 10));
+
+    // playback clears the buffer, so it can be reused by the next frame
+    dualCB_playback(buffer);
+    EXPECT_EQ(dualS_count(storage, false, false), (EIndex)(entities.size() - (entities.size() + 2) / 3 + 1 + 10));
+    dualCB_release(buffer);
+}
+
+TEST_CASE_METHOD(ECSTest, "command_buffer_sequential")
+{
+    // e1 owns test, e2 does not own test2. the folded commands must match applying them one by one
+    dual_entity_t e2;
+    {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        auto callback = [&](dual_chunk_view_t* view) { e2 = dualV_get_entities(view)[0]; };
+        dualS_allocate_type(storage, &entityType, 1, DUAL_LAMBDA(callback));
+    }
+    auto buffer = dualCB_create(storage);
+    const dual_type_set_t testSet = { &type_test, 1 };
+    const dual_type_set_t test2Set = { &type_test2, 1 };
+    dualCB_add_components(buffer, &e1, 1, &testSet);
+    dualCB_remove_components(buffer, &e1, 1, &testSet);
+    dualCB_remove_components(buffer, &e2, 1, &test2Set);
+    dualCB_add_components(buffer, &e2, 1, &test2Set);
+    dualCB_playback(buffer);
+    dualCB_release(buffer);
+
+    dual_chunk_view_t view;
+    dualS_access(storage, e1, &view);
+    EXPECT_EQ(dualV_get_owned_ro(&view, type_test), nullptr);
+    dualS_access(storage, e2, &view);
+    EXPECT_NE(dualV_get_owned_ro(&view, type_test), nullptr);
+    EXPECT_NE(dualV_get_owned_ro(&view, type_test2), nullptr);
+}
+
+TEST_CASE_METHOD(ECSTest, "serialize_buffered")
+{
+    {
+        dual_entity_type_t entityType;
+        dual_type_index_t types[2] = { type_test, type_test_arr };
+        std::sort(types, types + 2);
+        entityType.type = { types, 2 };
+        entityType.meta = { nullptr, 0 };
+        auto callback = [&](dual_chunk_view_t* view) {
+            auto t = (TestComp*)dualV_get_owned_rw(view, type_test);
+            std::fill(t, t + view->count, 42);
+        };
+        dualS_allocate_type(storage, &entityType, 1000000, DUAL_LAMBDA(callback));
+    }
+    // array components cost a few small writes per entity, that is where the staging memory pays off
+    eastl::vector<uint8_t> unbuffered;
+    eastl::vector<uint8_t> buffered;
+    {
+        skr::binary::VectorWriter writer{ &unbuffered };
+        skr_binary_writer_t archive(writer);
+        dualS_serialize(storage, &archive);
+    }
+    const size_t size = unbuffered.size();
+    unbuffered.clear();
+    unbuffered.reserve(size);
+    buffered.reserve(size);
+
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    {
+        skr::binary::VectorWriter writer{ &unbuffered };
+        skr_binary_writer_t archive(writer);
+        dualS_serialize(storage, &archive);
+    }
+    const auto unbufferedSeconds = skr_hires_timer_get_seconds(&timer, true);
+    {
+        eastl::vector<uint8_t> staging(64 * 1024);
+        skr::binary::VectorWriter writer{ &buffered };
+        skr_binary_writer_t archive(writer, staging.data(), staging.size());
+        dualS_serialize(storage, &archive);
+        archive.flush();
+    }
+    const auto bufferedSeconds = skr_hires_timer_get_seconds(&timer, true);
+    SKR_TEST_INFO(u8"serialize 1M entities ({} MiB): unbuffered {} ms, buffered {} ms",
+        size / (1024 * 1024), unbufferedSeconds * 1000.0, bufferedSeconds * 1000.0);
+    EXPECT_TRUE(unbuffered == buffered);
+
+    auto loaded = dualS_create();
+    {
+        eastl::vector<uint8_t> staging(64 * 1024);
+        skr::binary::SpanReader reader{ skr::span<uint8_t>(buffered.data(), buffered.size()) };
+        skr_binary_reader_t archive(reader, staging.data(), staging.size());
+        skr_init_hires_timer(&timer);
+        dualS_deserialize(loaded, &archive);
+        SKR_TEST_INFO(u8"deserialize buffered {} ms", skr_hires_timer_get_seconds(&timer, false) * 1000.0);
+    }
+    EXPECT_EQ(dualS_count(loaded, false, false), dualS_count(storage, false, false));
+    dualS_release(loaded);
+}
+
+TEST_CASE("chunk_pool_churn")
+{
+    // every thread spawns and destroys waves of entities in its own storage, so all chunks cycle through the pools
+    const uint32_t threadCount = 4;
+    const uint32_t waves = 50;
+    const EIndex waveSize = 50000;
+    std::vector<dual_storage_t*> storages;
+    for (uint32_t i = 0; i < threadCount; ++i)
+        storages.push_back(dualS_create());
+    auto churn = [&](dual_storage_t* storage) {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        const auto filter = make_zeroed<dual_meta_filter_t>();
+        for (uint32_t wave = 0; wave < waves; ++wave)
+        {
+            auto callback = [&](dual_chunk_view_t* view) {
+                auto t = (TestComp*)dualV_get_owned_rw(view, type_test);
+                std::fill(t, t + view->count, (TestComp)wave);
+            };
+            dualS_allocate_type(storage, &entityType, waveSize, DUAL_LAMBDA(callback));
+            dualS_destroy_all(storage, &filter);
+        }
+    };
+
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    churn(storages[0]);
+    const auto singleSeconds = skr_hires_timer_get_seconds(&timer, true);
+    {
+        std::vector<std::thread> threads;
+        for (auto storage : storages)
+            threads.emplace_back(churn, storage);
+        for (auto& thread : threads)
+            thread.join();
+    }
+    const auto parallelSeconds = skr_hires_timer_get_seconds(&timer, true);
+
+    dual_chunk_pool_stats_t stats;
+    dual_get_chunk_pool_stats(nullptr, &stats, nullptr);
+    SKR_TEST_INFO(u8"{} waves of {} entities in {} ms, on {} threads in {} ms",
+        waves, waveSize, singleSeconds * 1000.0, threadCount, parallelSeconds * 1000.0);
+    SKR_TEST_INFO(u8"committed {} KiB, cached {} blocks, heap {} blocks, {} allocations",
+        stats.committedBytes / 1024, stats.cachedBlocks, stats.heapBlocks, stats.allocations);
+    EXPECT_GE(stats.allocations, stats.deallocations);
+
+    dual_trim_chunk_pools();
+    dual_chunk_pool_stats_t trimmed;
+    dual_get_chunk_pool_stats(nullptr, &trimmed, nullptr);
+    SKR_TEST_INFO(u8"trim released {} KiB", trimmed.releasedBytes / 1024);
+    if (trimmed.reservedBytes)
+        EXPECT_GT(trimmed.releasedBytes, 0u);
+
+    // released blocks are handed out again transparently
+    {
+        dual_entity_type_t entityType;
+        entityType.type = { &type_test, 1 };
+        entityType.meta = { nullptr, 0 };
+        bool valid = true;
+        auto callback = [&](dual_chunk_view_t* view) {
+            auto t = (TestComp*)dualV_get_owned_rw(view, type_test);
+            std::fill(t, t + view->count, 7);
+            valid &= t[view->count - 1] == 7;
+        };
+        dualS_allocate_type(storages[0], &entityType, waveSize, DUAL_LAMBDA(callback));
+        EXPECT_TRUE(valid);
+    }
+    for (auto storage : storages)
+        dualS_release(storage);
+}
+
+TEST_CASE("chunk_pool_compare")
+{
+    // the queue based pool and the reserved pool churn the same waves of default sized chunks in one run
+    const uint32_t threadCount = 4;
+    const uint32_t waves = 200;
+    const uint32_t waveSize = 256;
+    auto churn = [&](auto& pool) {
+        std::vector<void*> blocks(waveSize);
+        for (uint32_t wave = 0; wave < waves; ++wave)
+        {
+            for (auto& block : blocks)
+            {
+                block = pool.allocate();
+                *(uint32_t*)block = wave;
+            }
+            for (auto block : blocks)
+                pool.free(block);
+        }
+    };
+    auto run = [&](auto& pool) {
+        SHiresTimer timer;
+        skr_init_hires_timer(&timer);
+        churn(pool);
+        const auto singleSeconds = skr_hires_timer_get_seconds(&timer, true);
+        {
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < threadCount; ++i)
+                threads.emplace_back([&] { churn(pool); });
+            for (auto& thread : threads)
+                thread.join();
+        }
+        const auto parallelSeconds = skr_hires_timer_get_seconds(&timer, true);
+        dual_chunk_pool_stats_t stats;
+        pool.get_stats(&stats);
+        EXPECT_EQ(stats.allocations, stats.deallocations);
+        EXPECT_EQ(stats.allocations, (uint64_t)(threadCount + 1) * waves * waveSize);
+        return std::make_pair(singleSeconds, parallelSeconds);
+    };
+    dual::queue_pool_t queuePool(dual::kFastBinSize, dual::kFastBinCapacity);
+    dual::reserved_pool_t reservedPool(dual::kFastBinSize, waveSize * (threadCount + 1) * 2);
+    const auto queueSeconds = run(queuePool);
+    const auto reservedSeconds = run(reservedPool);
+    SKR_TEST_INFO(u8"{} waves of {} chunks, queue pool {} ms, on {} threads {} ms",
+        waves, waveSize, queueSeconds.first * 1000.0, threadCount, queueSeconds.second * 1000.0);
+    SKR_TEST_INFO(u8"{} waves of {} chunks, reserved pool {} ms, on {} threads {} ms",
+        waves, waveSize, reservedSeconds.first * 1000.0, threadCount, reservedSeconds.second * 1000.0);
+}
+
+TEST_CASE("entity_id_contention")
+{
+    // every core spawns and destroys small batches from one registry, like jobs of one storage do
+    const uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    const uint32_t rounds = 200000;
+    const EIndex batchSize = 8;
+    auto run = [&](uint32_t threads) {
+        dual::entity_registry_t registry;
+        std::vector<std::vector<dual_entity_t>> kept(threads);
+        auto spawn = [&](uint32_t t) {
+            dual_entity_t ents[batchSize];
+            for (uint32_t r = 0; r < rounds / threads; ++r)
+            {
+                // single spawns and batches, every fourth batch member survives
+                registry.new_entities(ents, 1);
+                registry.new_entities(ents + 1, batchSize - 1);
+                kept[t].push_back(ents[0]);
+                registry.free_entities(ents + 1, batchSize - 1);
+                if (r % 4 != 0)
+                {
+                    registry.free_entities(&kept[t].back(), 1);
+                    kept[t].pop_back();
+                }
+            }
+        };
+        SHiresTimer timer;
+        skr_init_hires_timer(&timer);
+        std::vector<std::thread> workers;
+        for (uint32_t t = 0; t < threads; ++t)
+            workers.emplace_back(spawn, t);
+        for (auto& worker : workers)
+            worker.join();
+        const auto seconds = skr_hires_timer_get_seconds(&timer, false);
+
+        // live ids are unique and still carry the version they were handed out with
+        std::vector<dual_entity_t> all;
+        for (auto& ents : kept)
+            all.insert(all.end(), ents.begin(), ents.end());
+        bool valid = true;
+        for (auto e : all)
+            valid &= registry.entries[dual::e_id(e)].version == dual::e_version(e);
+        std::sort(all.begin(), all.end(), [](dual_entity_t a, dual_entity_t b) { return dual::e_id(a) < dual::e_id(b); });
+        valid &= std::adjacent_find(all.begin(), all.end(), [](dual_entity_t a, dual_entity_t b) { return dual::e_id(a) == dual::e_id(b); }) == all.end();
+        EXPECT_TRUE(valid);
+        // ids are recycled instead of growing the table
+        EXPECT_LT(registry.entries.size(), (EIndex)(all.size() + threads * (batchSize + dual::entity_registry_t::kReserveBlockSize)));
+        return seconds;
+    };
+    const auto singleSeconds = run(1);
+    const auto parallelSeconds = run(threadCount);
+    const double operations = (double)rounds * batchSize * 2;
+    SKR_TEST_INFO(u8"entity ids: 1 thread {} Mops/s, {} threads {} Mops/s",
+        operations / singleSeconds / 1e6, threadCount, operations / parallelSeconds / 1e6);
+}
+
+TEST_CASE_METHOD(ECSTest, "mask_filter_benchmark")
+{
+    // only the masked group takes part
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, e1, &view);
+        dualS_destroy(storage, &view);
+    }
+    // entities match when test is enabled and test2 is disabled in their mask
+    dual_type_index_t types[] = { type_test, type_test2, dual_id_of<dual::mask_comp_t>::get() };
+    std::sort(types, types + 3);
+    dual_entity_type_t entityType;
+    entityType.type = { types, 3 };
+    entityType.meta = { nullptr, 0 };
+    std::vector<dual_entity_t> entities;
+    auto collect = [&](dual_chunk_view_t* view) {
+        auto ents = dualV_get_entities(view);
+        entities.insert(entities.end(), ents, ents + view->count);
+    };
+    dualS_allocate_type(storage, &entityType, 1000000, DUAL_LAMBDA(collect));
+    const dual_type_set_t testSet = { &type_test, 1 };
+    const dual_type_set_t test2Set = { &type_test2, 1 };
+
+    auto filter = make_zeroed<dual_filter_t>();
+    filter.all = testSet;
+    filter.none = test2Set;
+    auto count = [&](const dual_meta_filter_t& meta) {
+        EIndex result = 0;
+        auto callback = [&](dual_chunk_view_t* view) { result += view->count; };
+        dualS_query(storage, &filter, &meta, DUAL_LAMBDA(callback));
+        return result;
+    };
+    uint64_t version = 1;
+    for (uint32_t selectivity : { 10u, 90u })
+    {
+        dualS_set_version(storage, version);
+        EIndex expected = 0;
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            dual_chunk_view_t view;
+            dualS_access(storage, entities[i], &view);
+            dualS_enable_components(&view, &testSet);
+            dualS_disable_components(&view, &test2Set);
+            // scattered so runs stay short
+            if ((i * 2654435761u) % 100 < selectivity)
+                ++expected;
+            else if (i % 2)
+                dualS_disable_components(&view, &testSet);
+            else
+                dualS_enable_components(&view, &test2Set);
+        }
+        // every tenth chunk is written after the setup
+        dualS_set_version(storage, version + 1);
+        uint32_t chunkIndex = 0;
+        auto touch = [&](dual_chunk_view_t* view) {
+            if (chunkIndex++ % 10 == 0)
+                dualV_get_owned_rw(view, type_test);
+        };
+        dualS_all(storage, false, false, DUAL_LAMBDA(touch));
+        auto changedMeta = make_zeroed<dual_meta_filter_t>();
+        changedMeta.changed = testSet;
+        changedMeta.timestamp = version;
+        const auto meta = make_zeroed<dual_meta_filter_t>();
+
+        EIndex changedExpected = 0;
+        for (auto isa : { DFI_SCALAR, DFI_SSE2, DFI_AVX2, DFI_AVX512 })
+        {
+            if (dual_set_filter_isa(isa) != isa)
+                continue;
+            const uint32_t iterations = 20;
+            SHiresTimer timer;
+            skr_init_hires_timer(&timer);
+            EIndex matched = 0, changed = 0;
+            for (uint32_t i = 0; i < iterations; ++i)
+                matched = count(meta);
+            const auto seconds = skr_hires_timer_get_seconds(&timer, true) / iterations;
+            for (uint32_t i = 0; i < iterations; ++i)
+                changed = count(changedMeta);
+            const auto changedSeconds = skr_hires_timer_get_seconds(&timer, false) / iterations;
+            SKR_TEST_INFO(u8"mask filter isa {}, {}% selectivity: {} ms, with changed filter {} ms",
+                (int)isa, selectivity, seconds * 1000.0, changedSeconds * 1000.0);
+            EXPECT_EQ(matched, expected);
+            // every kernel agrees with the scalar one
+            if (isa == DFI_SCALAR)
+                changedExpected = changed;
+            EXPECT_EQ(changed, changedExpected);
+            EXPECT_GT(changed, 0u);
+            EXPECT_LT(changed, matched);
+        }
+        dual_set_filter_isa(DFI_AUTO);
+        version += 2;
+    }
+}
+
 TEST_CASE_METHOD(ECSTest, "query_overload")
 {
     [[maybe_unused]] dual_entity_t e2, e3;
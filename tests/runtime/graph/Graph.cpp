@@ -89,4 +89,380 @@ TEST_CASE_METHOD(GraphTest, "RenderGraphFrontEnd")
     render_graph::RenderPassExecuteFunction());
     render_graph::RenderGraphViz::write_graphviz(*graph, "render_graph.gv");
     render_graph::RenderGraph::destroy(graph);
-}
\ No newline at end of file
+}
+
+#include "SkrRenderGraph/frontend/resource_node.hpp"
+#include "SkrRenderGraph/phases/memory_plan_phase.hpp"
+
+TEST_CASE_METHOD(GraphTest, "RenderGraphMemoryPlan")
+{
+    namespace render_graph = skr::render_graph;
+    auto graph = render_graph::RenderGraph::create(
+    [](render_graph::RenderGraphBuilder& builder) {
+        builder.frontend_only();
+    });
+    auto create_target = [&](const char8_t* name) {
+        return graph->create_texture(
+        [=](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+            builder.set_name(name)
+            .extent(1024, 1024)
+            .format(CGPU_FORMAT_R8G8B8A8_UNORM)
+            .allow_render_target();
+        });
+    };
+    // a chain of 4MB targets, each one lives from its writer to its reader
+    auto target0 = create_target(u8"target0");
+    auto target1 = create_target(u8"target1");
+    auto target2 = create_target(u8"target2");
+    auto target3 = create_target(u8"target3");
+    auto buffer = graph->create_buffer(
+    [](render_graph::RenderGraph&, render_graph::BufferBuilder& builder) {
+        builder.set_name(u8"buffer")
+        .size(1000)
+        .allow_shader_readwrite();
+    });
+    graph->add_render_pass(
+    [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+        builder.set_name(u8"pass0")
+        .write(0, target0)
+        .write(0, 0, buffer);
+    },
+    render_graph::RenderPassExecuteFunction());
+    graph->add_render_pass(
+    [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+        builder.set_name(u8"pass1")
+        .read(u8"Input", target0)
+        .write(0, target1);
+    },
+    render_graph::RenderPassExecuteFunction());
+    graph->add_render_pass(
+    [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+        builder.set_name(u8"pass2")
+        .read(u8"Input", target1)
+        .write(0, target2);
+    },
+    render_graph::RenderPassExecuteFunction());
+    graph->add_render_pass(
+    [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+        builder.set_name(u8"pass3")
+        .read(u8"Input", target2)
+        .read(u8"Buffer", buffer.range(0, 1000))
+        .write(0, target3);
+    },
+    render_graph::RenderPassExecuteFunction());
+
+    render_graph::MemoryPlanPhase phase;
+    phase.on_compile(graph);
+
+    const uint64_t target_size = 1024 * 1024 * 4;
+    const uint64_t buffer_size = phase.buffer_alignment;
+    EXPECT_EQ(phase.get_unaliased_size(), target_size * 4 + buffer_size);
+    EXPECT_EQ(phase.get_peak_live_size(), target_size * 2 + buffer_size);
+    EXPECT_EQ(phase.get_heap_size(render_graph::MemoryPlanPhase::kHeapTextures), target_size * 2);
+    EXPECT_EQ(phase.get_heap_size(render_graph::MemoryPlanPhase::kHeapBuffers), buffer_size);
+    EXPECT_EQ(phase.get_aliased_size(), phase.get_peak_live_size());
+
+    // resources alive at the same pass never share memory
+    const render_graph::TextureHandle targets[] = { target0, target1, target2, target3 };
+    for (auto a : targets)
+    {
+        for (auto b : targets)
+        {
+            if (a == b) continue;
+            auto A = phase.find_allocation(graph->resolve(a));
+            auto B = phase.find_allocation(graph->resolve(b));
+            REQUIRE(A);
+            REQUIRE(B);
+            const bool live_together = A->first_pass <= B->last_pass && B->first_pass <= A->last_pass;
+            const bool overlapped = A->offset < B->offset + B->size && B->offset < A->offset + A->size;
+            EXPECT_FALSE(live_together && overlapped);
+        }
+    }
+    SKR_TEST_INFO(u8"transient memory: {} bytes unaliased, {} bytes planned",
+        phase.get_unaliased_size(), phase.get_aliased_size());
+    render_graph::RenderGraph::destroy(graph);
+}
+
+#include "SkrRT/platform/time.h"
+
+TEST_CASE_METHOD(GraphTest, "RenderGraphCompileCache")
+{
+    namespace render_graph = skr::render_graph;
+    auto graph = render_graph::RenderGraph::create(
+    [](render_graph::RenderGraphBuilder& builder) {
+        builder.frontend_only();
+    });
+    static constexpr uint32_t kPassCount = 300;
+    // a chain of passes, each one reads the target of the previous pass and a shared buffer
+    auto build = [&](uint64_t width) {
+        auto buffer = graph->create_buffer(
+        [](render_graph::RenderGraph&, render_graph::BufferBuilder& builder) {
+            builder.set_name(u8"constants")
+            .size(256)
+            .as_uniform_buffer();
+        });
+        render_graph::TextureHandle last = graph->create_texture(
+        [=](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+            builder.set_name(u8"target")
+            .extent(width, 256)
+            .format(CGPU_FORMAT_R8G8B8A8_UNORM)
+            .allow_render_target();
+        });
+        for (uint32_t i = 0; i < kPassCount; i++)
+        {
+            auto target = graph->create_texture(
+            [=](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+                builder.extent(width, 256)
+                .format(CGPU_FORMAT_R8G8B8A8_UNORM)
+                .allow_render_target();
+            });
+            graph->add_render_pass(
+            [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+                builder.read(u8"Input", last)
+                .read(u8"Constants", buffer.range(0, 256))
+                .write(0, target);
+            },
+            render_graph::RenderPassExecuteFunction());
+            last = target;
+        }
+        return last;
+    };
+
+    render_graph::MemoryPlanPhase phase;
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    build(256);
+    graph->compile();
+    phase.on_compile(graph);
+    const auto cold_seconds = skr_hires_timer_get_seconds(&timer, true);
+    EXPECT_FALSE(graph->is_compile_cached());
+    const auto hash = graph->get_structure_hash();
+    const auto aliased_size = phase.get_aliased_size();
+    phase.on_execute(graph, nullptr);
+    graph->execute();
+
+    static constexpr uint32_t kFrameCount = 64;
+    double warm_seconds = 0.0;
+    for (uint32_t frame = 0; frame < kFrameCount; frame++)
+    {
+        skr_hires_timer_reset(&timer);
+        auto last = build(256);
+        graph->compile();
+        phase.on_compile(graph);
+        warm_seconds += skr_hires_timer_get_seconds(&timer, true);
+        EXPECT_TRUE(graph->is_compile_cached());
+        EXPECT_EQ(graph->get_structure_hash(), hash);
+        // the reused results are handed to the nodes of this frame
+        const auto lifespan = graph->resolve(last)->lifespan();
+        EXPECT_EQ(lifespan.from, kPassCount - 1);
+        EXPECT_EQ(lifespan.to, kPassCount - 1);
+        REQUIRE(phase.find_allocation(graph->resolve(last)));
+        EXPECT_EQ(phase.get_aliased_size(), aliased_size);
+        phase.on_execute(graph, nullptr);
+        graph->execute();
+    }
+    SKR_TEST_INFO(u8"setup & compile of {} passes: {} us cold, {} us cached",
+        kPassCount, cold_seconds * 1000000.0, warm_seconds * 1000000.0 / kFrameCount);
+
+    // a changed descriptor is a new structure
+    build(512);
+    graph->compile();
+    EXPECT_FALSE(graph->is_compile_cached());
+    EXPECT_NE(graph->get_structure_hash(), hash);
+    graph->execute();
+    render_graph::RenderGraph::destroy(graph);
+}
+
+#include "SkrRenderGraph/phases/schedule_phase.hpp"
+#include "SkrRenderGraph/frontend/pass_node.hpp"
+
+TEST_CASE_METHOD(GraphTest, "RenderGraphSchedule")
+{
+    namespace render_graph = skr::render_graph;
+    auto graph = render_graph::RenderGraph::create(
+    [](render_graph::RenderGraphBuilder& builder) {
+        builder.frontend_only();
+    });
+    auto create_target = [&](const char8_t* name) {
+        return graph->create_texture(
+        [=](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+            builder.set_name(name)
+            .extent(1024, 1024)
+            .format(CGPU_FORMAT_R16G16B16A16_SFLOAT)
+            .allow_render_target();
+        });
+    };
+    auto shadow = create_target(u8"shadow");
+    auto gbuffer = create_target(u8"gbuffer");
+    auto ao = create_target(u8"ao");
+    auto hdr = create_target(u8"hdr");
+    auto bloom = create_target(u8"bloom");
+    auto ldr = create_target(u8"ldr");
+    auto add_pass = [&](const char8_t* name, eastl::vector<render_graph::TextureHandle> inputs, render_graph::TextureHandle output) {
+        return graph->add_render_pass(
+        [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+            builder.set_name(name);
+            for (auto input : inputs)
+                builder.read(u8"Input", input);
+            builder.write(0, output);
+        },
+        render_graph::RenderPassExecuteFunction());
+    };
+    auto shadow_pass = add_pass(u8"shadow_pass", {}, shadow);
+    auto gbuffer_pass = add_pass(u8"gbuffer_pass", {}, gbuffer);
+    auto ao_pass = add_pass(u8"ao_pass", { gbuffer }, ao);
+    auto lighting_pass = add_pass(u8"lighting_pass", { gbuffer, ao, shadow }, hdr);
+    auto bloom_pass = add_pass(u8"bloom_pass", { hdr }, bloom);
+    auto tonemap_pass = add_pass(u8"tonemap_pass", { hdr, bloom }, ldr);
+
+    render_graph::SchedulePhase schedule;
+    // passes run as soon as their inputs are ready
+    schedule.shorten_lifetimes = false;
+    schedule.on_compile(graph);
+    REQUIRE(schedule.get_level_count() == 5);
+    EXPECT_EQ(schedule.get_level(0).size(), 2);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(shadow_pass)), 0);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(gbuffer_pass)), 0);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(ao_pass)), 1);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(lighting_pass)), 2);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(bloom_pass)), 3);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(tonemap_pass)), 4);
+
+    // the shadow pass sinks to the level right before lighting and runs after the gbuffer pass
+    schedule.shorten_lifetimes = true;
+    schedule.reorder = true;
+    schedule.on_compile(graph);
+    REQUIRE(schedule.get_level_count() == 5);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(gbuffer_pass)), 0);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(shadow_pass)), 1);
+    EXPECT_EQ(schedule.get_level_of(graph->resolve(ao_pass)), 1);
+    EXPECT_EQ(schedule.get_level(1).size(), 2);
+    EXPECT_EQ(graph->resolve(gbuffer_pass)->get_order(), 0);
+    EXPECT_EQ(graph->resolve(shadow_pass)->get_order(), 1);
+    EXPECT_EQ(graph->resolve(ao_pass)->get_order(), 2);
+    EXPECT_EQ(graph->resolve(tonemap_pass)->get_order(), 5);
+    const auto shadow_lifespan = graph->resolve(shadow)->lifespan();
+    EXPECT_EQ(shadow_lifespan.from, 1);
+    EXPECT_EQ(shadow_lifespan.to, 3);
+    // passes of a level never use a resource written by another pass of the same level
+    for (uint32_t level = 0; level < schedule.get_level_count(); level++)
+    {
+        for (auto pass : schedule.get_level(level))
+        {
+            pass->foreach_textures([&](render_graph::TextureNode* texture, render_graph::TextureEdge* edge) {
+                for (auto other : schedule.get_level(level))
+                {
+                    if (other == pass) continue;
+                    for (auto write : other->tex_write_edges())
+                        EXPECT_NE(write->get_texture_node(), texture);
+                }
+            });
+        }
+    }
+
+    render_graph::RenderGraphViz::write_graphviz(*graph, "render_graph_schedule.gv", &schedule);
+    std::ifstream viz("render_graph_schedule.gv");
+    REQUIRE(viz.is_open());
+    std::string dot((std::istreambuf_iterator<char>(viz)), std::istreambuf_iterator<char>());
+    EXPECT_NE(dot.find("cluster_level_4"), std::string::npos);
+    EXPECT_NE(dot.find("tonemap_pass"), std::string::npos);
+    render_graph::RenderGraph::destroy(graph);
+}
+
+TEST_CASE_METHOD(GraphTest, "RenderGraphPriorStates")
+{
+    namespace render_graph = skr::render_graph;
+    auto graph = render_graph::RenderGraph::create(
+    [](render_graph::RenderGraphBuilder& builder) {
+        builder.frontend_only();
+    });
+    // a texture and a buffer go through render target, unordered access and shader read states
+    auto build = [&]() {
+        auto color = graph->create_texture(
+        [](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+            builder.set_name(u8"color")
+            .extent(256, 256)
+            .format(CGPU_FORMAT_R8G8B8A8_UNORM)
+            .allow_render_target()
+            .allow_readwrite();
+        });
+        auto blur = graph->create_texture(
+        [](render_graph::RenderGraph&, render_graph::TextureBuilder& builder) {
+            builder.set_name(u8"blur")
+            .extent(256, 256)
+            .format(CGPU_FORMAT_R8G8B8A8_UNORM)
+            .allow_render_target();
+        });
+        auto buffer = graph->create_buffer(
+        [](render_graph::RenderGraph&, render_graph::BufferBuilder& builder) {
+            builder.set_name(u8"buffer")
+            .size(256)
+            .allow_shader_readwrite();
+        });
+        skr::vector<render_graph::PassHandle> passes;
+        passes.emplace_back(graph->add_render_pass(
+        [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+            builder.set_name(u8"draw")
+            .read(u8"Buffer", buffer.range(0, 256))
+            .write(0, color);
+        },
+        render_graph::RenderPassExecuteFunction()));
+        passes.emplace_back(graph->add_compute_pass(
+        [=](render_graph::RenderGraph&, render_graph::ComputePassBuilder& builder) {
+            builder.set_name(u8"resolve")
+            .readwrite(u8"Color", color)
+            .readwrite(u8"Buffer", buffer);
+        },
+        render_graph::ComputePassExecuteFunction()));
+        passes.emplace_back(graph->add_render_pass(
+        [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+            builder.set_name(u8"blur")
+            .read(u8"Color", color)
+            .read(u8"Buffer", buffer.range(0, 256))
+            .write(0, blur);
+        },
+        render_graph::RenderPassExecuteFunction()));
+        passes.emplace_back(graph->add_compute_pass(
+        [=](render_graph::RenderGraph&, render_graph::ComputePassBuilder& builder) {
+            builder.set_name(u8"histogram")
+            .read(u8"Blur", blur)
+            .read(u8"Color", color)
+            .readwrite(u8"Buffer", buffer);
+        },
+        render_graph::ComputePassExecuteFunction()));
+        passes.emplace_back(graph->add_render_pass(
+        [=](render_graph::RenderGraph&, render_graph::RenderPassBuilder& builder) {
+            builder.set_name(u8"composite")
+            .read(u8"Blur", blur)
+            .write(0, color);
+        },
+        render_graph::RenderPassExecuteFunction()));
+        return eastl::make_pair(color, passes);
+    };
+    // the states looked up from the compile results must match a walk over the edges
+    auto check = [&](const skr::vector<render_graph::PassHandle>& passes) {
+        for (auto handle : passes)
+        {
+            auto pass = graph->resolve(handle);
+            pass->foreach_textures([&](render_graph::TextureNode* texture, render_graph::TextureEdge*) {
+                EXPECT_EQ(graph->get_lastest_state(texture, pass), graph->calculate_lastest_state(texture, pass));
+            });
+            pass->foreach_buffers([&](render_graph::BufferNode* buffer, render_graph::BufferEdge*) {
+                EXPECT_EQ(graph->get_lastest_state(buffer, pass), graph->calculate_lastest_state(buffer, pass));
+            });
+        }
+    };
+
+    for (uint32_t frame = 0; frame < 3; frame++)
+    {
+        auto [color, passes] = build();
+        graph->compile();
+        EXPECT_EQ(graph->is_compile_cached(), frame != 0);
+        check(passes);
+        auto color_node = graph->resolve(color);
+        EXPECT_EQ(graph->get_lastest_state(color_node, graph->resolve(passes[1])), CGPU_RESOURCE_STATE_RENDER_TARGET);
+        EXPECT_EQ(graph->get_lastest_state(color_node, graph->resolve(passes[2])), CGPU_RESOURCE_STATE_UNORDERED_ACCESS);
+        graph->execute();
+    }
+    render_graph::RenderGraph::destroy(graph);
+}
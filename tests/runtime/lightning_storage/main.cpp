@@ -0,0 +1,351 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/misc/log.h"
+#include "lightning_storage/storage.h"
+#include "lightning_storage/transaction.h"
+
+#include "SkrTestFramework/framework.hpp"
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+class LightningStorageTests
+{
+protected:
+    LightningStorageTests()
+    {
+        std::error_code ec = {};
+        directory = skr::filesystem::current_path(ec) / "lightning-storage-test";
+        skr::filesystem::remove_all(directory, ec);
+        environment = skr_lightning_storage_create_environment(directory.string().c_str());
+        REQUIRE(environment);
+        SLightningStorageOpenDescriptor desc = {};
+        desc.name = "test";
+        desc.flags = LIGHTNING_STORAGE_OPEN_CREATE;
+        storage = skr_open_lightning_storage(environment, &desc);
+        REQUIRE(storage);
+    }
+    ~LightningStorageTests()
+    {
+        skr_close_lightning_storage(storage);
+        skr_lightning_storage_free_environment(environment);
+        std::error_code ec = {};
+        skr::filesystem::remove_all(directory, ec);
+    }
+
+    static SLightningValue value_of(const std::string& str) { return { str.data(), str.size() }; }
+    static std::string string_of(const SLightningValue& value) { return std::string((const char*)value.data, (size_t)value.size); }
+
+    skr::filesystem::path directory;
+    SLightningEnvironmentId environment = nullptr;
+    SLightningStorageId storage = nullptr;
+};
+
+TEST_CASE_METHOD(LightningStorageTests, "PutGetDelete")
+{
+    const std::string key = "key", value = "value";
+    {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        REQUIRE(txn);
+        const auto mkey = value_of(key), mvalue = value_of(value);
+        EXPECT_TRUE(skr_lightning_storage_put(txn, storage, &mkey, &mvalue));
+        EXPECT_TRUE(skr_lightning_storage_commit_transaction(txn));
+    }
+    {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+        const auto mkey = value_of(key);
+        SLightningValue read = {};
+        EXPECT_TRUE(skr_lightning_storage_get(txn, storage, &mkey, &read));
+        EXPECT_EQ(string_of(read), value);
+        // read only transactions refuse writes
+        EXPECT_FALSE(skr_lightning_storage_put(txn, storage, &mkey, &mkey));
+        const std::string missing = "missing";
+        const auto mmissing = value_of(missing);
+        EXPECT_FALSE(skr_lightning_storage_get(txn, storage, &mmissing, &read));
+        skr_lightning_storage_abort_transaction(txn);
+    }
+    {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        const auto mkey = value_of(key);
+        EXPECT_TRUE(skr_lightning_storage_delete(txn, storage, &mkey));
+        EXPECT_FALSE(skr_lightning_storage_delete(txn, storage, &mkey));
+        EXPECT_EQ(skr_lightning_storage_count(txn, storage), 0);
+        // aborted, the pair stays
+        skr_lightning_storage_abort_transaction(txn);
+    }
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+    EXPECT_EQ(skr_lightning_storage_count(txn, storage), 1);
+    skr_lightning_storage_abort_transaction(txn);
+}
+
+TEST_CASE_METHOD(LightningStorageTests, "BatchAndScan")
+{
+    std::vector<std::string> keys, values;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        char key[16];
+        snprintf(key, sizeof(key), "k%04u", i);
+        keys.emplace_back(key);
+        values.emplace_back(std::to_string(i * 3));
+    }
+    std::vector<SLightningKeyValue> pairs;
+    for (size_t i = 0; i < keys.size(); ++i)
+        pairs.push_back({ value_of(keys[i]), value_of(values[i]) });
+    {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        // sorted keys into an empty storage can be appended
+        EXPECT_EQ(skr_lightning_storage_put_batch(txn, storage, pairs.data(), pairs.size(), LIGHTNING_PUT_APPEND), 1000);
+        EXPECT_TRUE(skr_lightning_storage_commit_transaction(txn));
+    }
+    {
+        const std::string changed = "changed";
+        SLightningKeyValue pair = { value_of(keys[10]), value_of(changed) };
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        EXPECT_EQ(skr_lightning_storage_put_batch(txn, storage, &pair, 1, LIGHTNING_PUT_NO_OVERWRITE), 0);
+        SLightningValue read = {};
+        EXPECT_TRUE(skr_lightning_storage_get(txn, storage, &pair.key, &read));
+        EXPECT_EQ(string_of(read), values[10]);
+        skr_lightning_storage_abort_transaction(txn);
+    }
+
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+    EXPECT_EQ(skr_lightning_storage_count(txn, storage), 1000);
+    // [k0100, k0200)
+    struct Scan
+    {
+        std::vector<std::string> keys;
+        uint32_t limit = UINT32_MAX;
+    } scan;
+    const std::string begin = "k0100", end = "k0200";
+    const auto mbegin = value_of(begin), mend = value_of(end);
+    auto collect = +[](void* userdata, const SLightningKeyValue* pair) {
+        auto scan = (Scan*)userdata;
+        scan->keys.emplace_back((const char*)pair->key.data, (size_t)pair->key.size);
+        return scan->keys.size() < scan->limit;
+    };
+    EXPECT_EQ(skr_lightning_storage_scan(txn, storage, &mbegin, &mend, collect, &scan), 100);
+    REQUIRE(scan.keys.size() == 100);
+    EXPECT_EQ(scan.keys.front(), begin);
+    EXPECT_EQ(scan.keys.back(), std::string("k0199"));
+    // open bounds, stopped by the callback
+    scan.keys.clear();
+    scan.limit = 5;
+    EXPECT_EQ(skr_lightning_storage_scan(txn, storage, nullptr, nullptr, collect, &scan), 5);
+    EXPECT_EQ(scan.keys.front(), std::string("k0000"));
+
+    // seek between keys lands on the next one
+    auto cursor = skr_lightning_storage_open_cursor(txn, storage);
+    const std::string between = "k0500a";
+    const auto mbetween = value_of(between);
+    SLightningKeyValue pair = {};
+    EXPECT_TRUE(skr_lightning_cursor_seek(cursor, &mbetween, &pair));
+    EXPECT_EQ(string_of(pair.key), std::string("k0501"));
+    EXPECT_EQ(string_of(pair.value), values[501]);
+    EXPECT_TRUE(skr_lightning_cursor_next(cursor, &pair));
+    EXPECT_EQ(string_of(pair.key), std::string("k0502"));
+    skr_lightning_storage_close_cursor(cursor);
+    skr_lightning_storage_abort_transaction(txn);
+}
+
+TEST_CASE_METHOD(LightningStorageTests, "ConcurrentReaders")
+{
+    const std::string key = "counter";
+    auto write = [&](uint64_t value) {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        const auto mkey = value_of(key);
+        const SLightningValue mvalue = { &value, sizeof(value) };
+        skr_lightning_storage_put(txn, storage, &mkey, &mvalue);
+        return skr_lightning_storage_commit_transaction(txn);
+    };
+    REQUIRE(write(0));
+
+    // a reader keeps the snapshot it began with
+    auto snapshot = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+    REQUIRE(write(1));
+    {
+        const auto mkey = value_of(key);
+        SLightningValue read = {};
+        REQUIRE(skr_lightning_storage_get(snapshot, storage, &mkey, &read));
+        uint64_t value = 1;
+        memcpy(&value, read.data, sizeof(value));
+        EXPECT_EQ(value, 0);
+    }
+    skr_lightning_storage_abort_transaction(snapshot);
+
+    // readers on many threads while one thread writes, values only grow
+    std::atomic<bool> done = false;
+    std::atomic<uint32_t> failures = 0;
+    std::vector<std::thread> readers;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        readers.emplace_back([&]() {
+            uint64_t last = 0;
+            while (!done.load())
+            {
+                auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+                const auto mkey = value_of(key);
+                SLightningValue read = {};
+                uint64_t value = 0;
+                if (!txn || !skr_lightning_storage_get(txn, storage, &mkey, &read) || read.size != sizeof(value))
+                {
+                    failures++;
+                }
+                else
+                {
+                    memcpy(&value, read.data, sizeof(value));
+                    failures += (value < last) ? 1 : 0;
+                    last = value;
+                }
+                if (txn) skr_lightning_storage_abort_transaction(txn);
+            }
+        });
+    }
+    for (uint64_t i = 2; i < 200; ++i)
+        write(i);
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_CASE_METHOD(LightningStorageTests, "GrowMap")
+{
+    // a small environment of its own, the shared one is far from full
+    SLightningEnvironmentDescriptor env_desc = {};
+    const auto small_directory = (directory / "small").string();
+    env_desc.name = small_directory.c_str();
+    env_desc.map_size = 256 * 1024;
+    auto small = skr_lightning_storage_create_environment_with_desc(&env_desc);
+    REQUIRE(small);
+    SLightningStorageOpenDescriptor desc = {};
+    desc.name = "test";
+    desc.flags = LIGHTNING_STORAGE_OPEN_CREATE;
+    auto small_storage = skr_open_lightning_storage(small, &desc);
+    REQUIRE(small_storage);
+
+    SLightningEnvironmentInfo info = {};
+    REQUIRE(skr_lightning_storage_get_environment_info(small, &info));
+    EXPECT_EQ(info.map_size, env_desc.map_size);
+    const uint64_t used_before = info.used_size;
+
+    std::vector<uint8_t> payload(64 * 1024, 0x5a);
+    auto write = [&](uint32_t i) {
+        auto txn = skr_lightning_storage_begin_transaction(small, LIGHTNING_TRANSACTION_READ_WRITE);
+        if (!txn) return false;
+        const SLightningValue mkey = { &i, sizeof(i) };
+        const SLightningValue mvalue = { payload.data(), payload.size() };
+        if (!skr_lightning_storage_put(txn, small_storage, &mkey, &mvalue))
+        {
+            skr_lightning_storage_abort_transaction(txn);
+            return false;
+        }
+        return skr_lightning_storage_commit_transaction(txn);
+    };
+    uint32_t written = 0;
+    while (written < 16 && write(written))
+        written++;
+    // the map is full before 1 MiB is written
+    EXPECT_LT(written, 16);
+    REQUIRE(skr_lightning_storage_get_environment_info(small, &info));
+    EXPECT_GT(info.used_size, used_before);
+
+    REQUIRE(skr_lightning_storage_set_map_size(small, 4 * 1024 * 1024));
+    REQUIRE(skr_lightning_storage_get_environment_info(small, &info));
+    EXPECT_EQ(info.map_size, 4 * 1024 * 1024);
+    for (uint32_t i = written; i < 16; ++i)
+        EXPECT_TRUE(write(i));
+
+    auto txn = skr_lightning_storage_begin_transaction(small, LIGHTNING_TRANSACTION_READ_ONLY);
+    EXPECT_EQ(skr_lightning_storage_count(txn, small_storage), 16);
+    skr_lightning_storage_abort_transaction(txn);
+    skr_close_lightning_storage(small_storage);
+    skr_lightning_storage_free_environment(small);
+}
+
+TEST_CASE_METHOD(LightningStorageTests, "LooseFileBenchmark")
+{
+    static constexpr uint32_t kCount = 4096;
+    static constexpr uint32_t kValueSize = 512;
+    std::vector<std::string> keys;
+    std::vector<uint8_t> payload(kValueSize);
+    for (uint32_t i = 0; i < kValueSize; ++i)
+        payload[i] = (uint8_t)(i * 7);
+    for (uint32_t i = 0; i < kCount; ++i)
+    {
+        char key[16];
+        snprintf(key, sizeof(key), "%08x", i);
+        keys.emplace_back(key);
+    }
+
+    std::error_code ec = {};
+    const auto loose = directory / "loose";
+    skr::filesystem::create_directories(loose, ec);
+    SHiresTimer timer;
+    skr_init_hires_timer(&timer);
+    for (const auto& key : keys)
+    {
+        auto file = fopen((loose / key).string().c_str(), "wb");
+        REQUIRE(file);
+        fwrite(payload.data(), 1, payload.size(), file);
+        fclose(file);
+    }
+    const auto loose_write = skr_hires_timer_get_seconds(&timer, true);
+    uint64_t loose_bytes = 0;
+    std::vector<uint8_t> buffer(kValueSize);
+    for (const auto& key : keys)
+    {
+        auto file = fopen((loose / key).string().c_str(), "rb");
+        REQUIRE(file);
+        loose_bytes += fread(buffer.data(), 1, buffer.size(), file);
+        fclose(file);
+    }
+    const auto loose_read = skr_hires_timer_get_seconds(&timer, true);
+
+    std::vector<SLightningKeyValue> pairs;
+    for (const auto& key : keys)
+        pairs.push_back({ value_of(key), { payload.data(), payload.size() } });
+    {
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        EXPECT_EQ(skr_lightning_storage_put_batch(txn, storage, pairs.data(), pairs.size(), LIGHTNING_PUT_DEFAULT), kCount);
+        EXPECT_TRUE(skr_lightning_storage_commit_transaction(txn));
+    }
+    const auto storage_write = skr_hires_timer_get_seconds(&timer, true);
+    uint64_t storage_bytes = 0;
+    {
+        // values are read in place, the bytes are touched so the pages are really read
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+        for (const auto& pair : pairs)
+        {
+            SLightningValue read = {};
+            if (skr_lightning_storage_get(txn, storage, &pair.key, &read))
+            {
+                memcpy(buffer.data(), read.data, (size_t)read.size);
+                storage_bytes += read.size;
+            }
+        }
+        skr_lightning_storage_abort_transaction(txn);
+    }
+    const auto storage_read = skr_hires_timer_get_seconds(&timer, true);
+    SKR_TEST_INFO(u8"{} values of {} bytes: loose files write {} ms read {} ms, lightning storage write {} ms read {} ms",
+        kCount, kValueSize, loose_write * 1000.0, loose_read * 1000.0, storage_write * 1000.0, storage_read * 1000.0);
+    EXPECT_EQ(loose_bytes, (uint64_t)kCount * kValueSize);
+    EXPECT_EQ(storage_bytes, (uint64_t)kCount * kValueSize);
+}
@@ -0,0 +1,323 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/ecs/dual.h"
+#include "SkrRT/ecs/array.hpp"
+#include "SkrRT/ecs/type_builder.hpp"
+#include "SkrRT/async/fib_task.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/misc/make_zeroed.hpp"
+#include "SkrRT/misc/log.h"
+#include "SkrScene/scene.h"
+
+#include "SkrTestFramework/framework.hpp"
+
+#include <algorithm>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::dual_shutdown();
+
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+class SceneTest
+{
+public:
+    SceneTest() SKR_NOEXCEPT
+    {
+        scheduler.initialize(skr::task::scheudler_config_t());
+        scheduler.bind();
+        storage = dualS_create();
+        dualJ_bind_storage(storage);
+        skr_transform_setup(storage, &transformSystem);
+    }
+
+    ~SceneTest() SKR_NOEXCEPT
+    {
+        dualJ_wait_all();
+        skr_transform_release(&transformSystem);
+        dualJ_unbind_storage(storage);
+        dualS_release(storage);
+        scheduler.unbind();
+    }
+
+    // builds `depth` levels below `roots` root nodes, nodes of a level are spread evenly over the level above
+    // every node is translated by one unit along x, so its world x equals its depth + 1
+    skr::vector<skr::vector<dual_entity_t>> build_scene(uint32_t nodeCount, uint32_t depth, uint32_t roots)
+    {
+        auto rootT_builder = make_zeroed<dual::type_builder_t>();
+        rootT_builder
+            .with<skr_transform_comp_t, skr_child_comp_t>()
+            .with<skr_translation_comp_t, skr_rotation_comp_t, skr_scale_comp_t>();
+        auto rootT = make_zeroed<dual_entity_type_t>();
+        rootT.type = rootT_builder.build();
+        auto nodeT_builder = make_zeroed<dual::type_builder_t>();
+        nodeT_builder
+            .with<skr_transform_comp_t, skr_child_comp_t, skr_parent_comp_t>()
+            .with<skr_translation_comp_t, skr_rotation_comp_t, skr_scale_comp_t>();
+        auto nodeT = make_zeroed<dual_entity_type_t>();
+        nodeT.type = nodeT_builder.build();
+
+        skr::vector<skr::vector<dual_entity_t>> levels(depth);
+        const uint32_t perLevel = depth > 1 ? (nodeCount - roots) / (depth - 1) : 0;
+        for (uint32_t level = 0; level < depth; ++level)
+        {
+            auto& entities = levels[level];
+            auto setup = [&](dual_chunk_view_t* view) {
+                auto translations = dual::get_owned_rw<skr_translation_comp_t>(view);
+                auto rotations = dual::get_owned_rw<skr_rotation_comp_t>(view);
+                auto scales = dual::get_owned_rw<skr_scale_comp_t>(view);
+                auto ents = dualV_get_entities(view);
+                for (EIndex i = 0; i < view->count; ++i)
+                {
+                    translations[i].value = { 1.f, 0.f, 0.f };
+                    rotations[i].euler = { 0.f, 0.f, 0.f };
+                    scales[i].value = { 1.f, 1.f, 1.f };
+                    entities.push_back(ents[i]);
+                }
+            };
+            dualS_allocate_type(storage, level == 0 ? &rootT : &nodeT, level == 0 ? roots : perLevel, DUAL_LAMBDA(setup));
+            if (level == 0)
+                continue;
+            const auto& parents = levels[level - 1];
+            for (uint32_t i = 0; i < entities.size(); ++i)
+            {
+                const auto parent = parents[i % parents.size()];
+                dual_chunk_view_t view;
+                dualS_access(storage, entities[i], &view);
+                dual::get_owned_rw<skr_parent_comp_t>(&view)->entity = parent;
+                dualS_access(storage, parent, &view);
+                ((skr_children_t*)dualV_get_owned_rw(&view, dual_id_of<skr_child_comp_t>::get()))->push_back({ entities[i] });
+            }
+        }
+        return levels;
+    }
+
+    // allocates a single node translated by one unit along x, linked below `parent` unless that is DUAL_NULL_ENTITY
+    dual_entity_t create_node(dual_entity_t parent)
+    {
+        auto builder = make_zeroed<dual::type_builder_t>();
+        builder
+            .with<skr_transform_comp_t, skr_child_comp_t>()
+            .with<skr_translation_comp_t, skr_rotation_comp_t, skr_scale_comp_t>();
+        if (parent != DUAL_NULL_ENTITY)
+            builder.with<skr_parent_comp_t>();
+        auto type = make_zeroed<dual_entity_type_t>();
+        type.type = builder.build();
+        dual_entity_t entity = DUAL_NULL_ENTITY;
+        auto setup = [&](dual_chunk_view_t* view) {
+            dual::get_owned_rw<skr_translation_comp_t>(view)->value = { 1.f, 0.f, 0.f };
+            dual::get_owned_rw<skr_rotation_comp_t>(view)->euler = { 0.f, 0.f, 0.f };
+            dual::get_owned_rw<skr_scale_comp_t>(view)->value = { 1.f, 1.f, 1.f };
+            if (parent != DUAL_NULL_ENTITY)
+                dual::get_owned_rw<skr_parent_comp_t>(view)->entity = parent;
+            entity = dualV_get_entities(view)[0];
+        };
+        dualS_allocate_type(storage, &type, 1, DUAL_LAMBDA(setup));
+        if (parent != DUAL_NULL_ENTITY)
+            children_of(parent)->push_back({ entity });
+        return entity;
+    }
+
+    skr_children_t* children_of(dual_entity_t entity)
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, entity, &view);
+        return (skr_children_t*)dualV_get_owned_rw(&view, dual_id_of<skr_child_comp_t>::get());
+    }
+
+    void unlink(dual_entity_t parent, dual_entity_t child)
+    {
+        auto children = children_of(parent);
+        children->erase(std::find_if(children->begin(), children->end(), [&](const skr_child_comp_t& c) { return c.entity == child; }));
+    }
+
+    void destroy(dual_entity_t entity)
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, entity, &view);
+        dualS_destroy(storage, &view);
+    }
+
+    float world_x(dual_entity_t entity)
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, entity, &view);
+        return dual::get_owned_ro<skr_transform_comp_t>(&view)->value.translation.x;
+    }
+
+    skr::task::scheduler_t scheduler;
+    dual_storage_t* storage;
+    skr_transform_system_t transformSystem;
+};
+
+TEST_CASE_METHOD(SceneTest, "TransformHierarchy")
+{
+    auto levels = build_scene(1000, 5, 3);
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+    for (uint32_t level = 0; level < levels.size(); ++level)
+    {
+        EXPECT_EQ(world_x(levels[level].front()), (float)(level + 1));
+        EXPECT_EQ(world_x(levels[level].back()), (float)(level + 1));
+    }
+
+    // reparent a leaf directly under a root, the flattened hierarchy must pick the change up
+    const auto leaf = levels.back().back();
+    const auto oldParent = levels[levels.size() - 2][(levels.back().size() - 1) % levels[levels.size() - 2].size()];
+    dual_chunk_view_t view;
+    dualS_access(storage, oldParent, &view);
+    auto oldChildren = (skr_children_t*)dualV_get_owned_rw(&view, dual_id_of<skr_child_comp_t>::get());
+    oldChildren->erase(std::find_if(oldChildren->begin(), oldChildren->end(), [&](const skr_child_comp_t& c) { return c.entity == leaf; }));
+    dualS_access(storage, levels[0][0], &view);
+    ((skr_children_t*)dualV_get_owned_rw(&view, dual_id_of<skr_child_comp_t>::get()))->push_back({ leaf });
+    dualS_access(storage, leaf, &view);
+    dual::get_owned_rw<skr_parent_comp_t>(&view)->entity = levels[0][0];
+
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+    EXPECT_EQ(world_x(leaf), 2.f);
+}
+
+TEST_CASE_METHOD(SceneTest, "TransformDirtyTracking")
+{
+    uint64_t version = 1;
+    dualS_set_version(storage, version);
+    auto levels = build_scene(1000, 4, 2);
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+    // one more frame to settle writes stamped with the version of the first update
+    dualS_set_version(storage, ++version);
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+
+    // nothing changed, so no transform is written
+    dualS_set_version(storage, ++version);
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+    const auto transformType = dual_id_of<skr_transform_comp_t>::get();
+    const dual_type_set_t transformSet{ &transformType, 1 };
+    for (const auto& level : levels)
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, level.front(), &view);
+        EXPECT_FALSE(dualC_changed_since(view.chunk, &transformSet, version - 1));
+    }
+
+    // moving a root propagates to its subtree
+    dualS_set_version(storage, ++version);
+    {
+        dual_chunk_view_t view;
+        dualS_access(storage, levels[0][0], &view);
+        dual::get_owned_rw<skr_translation_comp_t>(&view)->value = { 2.f, 0.f, 0.f };
+    }
+    skr_transform_update(&transformSystem);
+    dualJ_wait_all();
+    EXPECT_EQ(world_x(levels[0][0]), 2.f);
+    EXPECT_EQ(world_x(levels[0][1]), 1.f);
+    // nodes are spread round robin, so even nodes hang below the first root
+    EXPECT_EQ(world_x(levels.back()[0]), 5.f);
+    EXPECT_EQ(world_x(levels.back()[1]), 4.f);
+}
+
+TEST_CASE_METHOD(SceneTest, "TransformHierarchyPatch")
+{
+    uint64_t version = 1;
+    auto update = [&]() {
+        dualS_set_version(storage, version++);
+        skr_transform_update(&transformSystem);
+        dualJ_wait_all();
+    };
+    auto levels = build_scene(64, 4, 2);
+    update();
+    update();
+
+    // reparent a leaf directly under a root
+    const auto leaf = levels.back().back();
+    dual_chunk_view_t view;
+    dualS_access(storage, leaf, &view);
+    unlink(dual::get_owned_ro<skr_parent_comp_t>(&view)->entity, leaf);
+    children_of(levels[0][0])->push_back({ leaf });
+    dual::get_owned_rw<skr_parent_comp_t>(&view)->entity = levels[0][0];
+    update();
+    EXPECT_EQ(world_x(leaf), 2.f);
+    EXPECT_EQ(world_x(levels.back().front()), 4.f);
+
+    // a new node below an existing one
+    const auto added = create_node(levels[1][0]);
+    update();
+    EXPECT_EQ(world_x(added), 3.f);
+
+    // destroyed leaves drop out, whether their parent was told or not
+    const auto& leaves = levels.back();
+    unlink(levels[2][0], leaves[0]);
+    destroy(leaves[0]);
+    destroy(leaves[1]);
+    update();
+    EXPECT_EQ(world_x(leaves[2]), 4.f);
+
+    // a new root with a child of its own
+    const auto root = create_node(DUAL_NULL_ENTITY);
+    const auto child = create_node(root);
+    update();
+    EXPECT_EQ(world_x(root), 1.f);
+    EXPECT_EQ(world_x(child), 2.f);
+
+    // the patched layout still propagates moves down every subtree
+    dualS_access(storage, levels[0][0], &view);
+    dual::get_owned_rw<skr_translation_comp_t>(&view)->value = { 2.f, 0.f, 0.f };
+    update();
+    EXPECT_EQ(world_x(leaf), 3.f);
+    EXPECT_EQ(world_x(added), 4.f);
+    EXPECT_EQ(world_x(leaves[2]), 5.f);
+    EXPECT_EQ(world_x(child), 2.f);
+}
+
+TEST_CASE("TransformBenchmark")
+{
+    struct config_t {
+        uint32_t depth;
+        uint32_t roots;
+    };
+    // wide and shallow to deep and narrow, 100k nodes each
+    const config_t configs[] = { { 2, 1 }, { 4, 64 }, { 16, 64 }, { 64, 16 }, { 1000, 100 } };
+    for (const auto& config : configs)
+    {
+        SceneTest scene;
+        auto levels = scene.build_scene(100000, config.depth, config.roots);
+
+        SHiresTimer timer;
+        skr_init_hires_timer(&timer);
+        skr_transform_update(&scene.transformSystem);
+        dualJ_wait_all();
+        const auto firstSeconds = skr_hires_timer_get_seconds(&timer, true);
+        const uint32_t frames = 20;
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            skr_transform_update(&scene.transformSystem);
+            dualJ_wait_all();
+        }
+        const auto seconds = skr_hires_timer_get_seconds(&timer, true) / frames;
+        // versioned frames without writes only pay for change detection
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            dualS_set_version(scene.storage, i + 1);
+            skr_transform_update(&scene.transformSystem);
+            dualJ_wait_all();
+        }
+        const auto staticSeconds = skr_hires_timer_get_seconds(&timer, false) / frames;
+        SKR_TEST_INFO(u8"depth {}, roots {}: first update (with rebuild) {} ms, update {} ms, static update {} ms",
+            config.depth, config.roots, firstSeconds * 1000.0, seconds * 1000.0, staticSeconds * 1000.0);
+        EXPECT_EQ(scene.world_x(levels.back().back()), (float)config.depth);
+    }
+}
@@ -86,4 +86,46 @@ TEST_CASE_METHOD(BinarySerdeTests, "str_arr")
 
     EXPECT_EQ(arr[0], readArr[0]);
     EXPECT_EQ(arr[1], readArr[1]);
-}
\ No newline at end of file
+}
+TEST_CASE("buffered")
+{
+    eastl::vector<uint8_t> buffer;
+    skr::binary::VectorWriter writer{ &buffer };
+    // the staging memory is smaller than the blob, so both the staged and the direct path are taken
+    uint8_t writeStaging[64];
+    skr::vector<uint32_t> blob(100, 0xABCDu);
+    {
+        skr_binary_writer_t archive(writer, writeStaging, sizeof(writeStaging));
+        for (uint32_t i = 0; i < 100; ++i)
+            skr::binary::Archive(&archive, i);
+        skr::binary::ArchiveBuffer(&archive, blob.data(), blob.size());
+        skr::binary::Archive(&archive, skr::string(u8"Hello World"));
+        // empty writes, e.g. of empty containers, carry no data pointer
+        EXPECT_EQ(archive.write(nullptr, 0), 0);
+        EXPECT_EQ(archive.flush(), 0);
+    }
+    EXPECT_EQ(buffer.size(), 100 * sizeof(uint32_t) + blob.size() * sizeof(uint32_t) + sizeof(uint32_t) + 11);
+
+    skr::binary::SpanReader reader{ skr::span<uint8_t>(buffer.data(), buffer.size()) };
+    uint8_t readStaging[48];
+    skr_binary_reader_t archive(reader, readStaging, sizeof(readStaging));
+    bool valid = true;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        uint32_t value = 0;
+        skr::binary::Archive(&archive, value);
+        valid &= value == i;
+    }
+    EXPECT_TRUE(valid);
+    skr::vector<uint32_t> readBlob(100, 0u);
+    EXPECT_EQ(skr::binary::ArchiveBuffer(&archive, readBlob.data(), readBlob.size()), 0);
+    EXPECT_EQ(readBlob, blob);
+    skr::string str;
+    skr::binary::Archive(&archive, str);
+    EXPECT_EQ(str, skr::string(u8"Hello World"));
+    // empty reads succeed at the end of the data too
+    EXPECT_EQ(archive.read(nullptr, 0), 0);
+    // reading past the end still fails
+    uint32_t extra;
+    EXPECT_NE(skr::binary::Archive(&archive, extra), 0);
+}
@@ -2,14 +2,26 @@
 #include "SkrRT/platform/crash.h"
 #include "SkrRT/platform/thread.h"
 #include "SkrRT/platform/dstorage.h"
+#include "SkrRT/platform/pak_vfs.h"
 #include <SkrRT/platform/filesystem.hpp>
 #include "SkrRT/misc/log.h"
 #include "SkrRT/misc/make_zeroed.hpp"
 #include "SkrRT/async/thread_job.hpp"
 #include "SkrRT/async/wait_timeout.hpp"
 #include "SkrRT/io/ram_io.hpp"
+#include "SkrRT/platform/time.h"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/containers/hashmap.hpp"
+#include "SkrRT/platform/guid.hpp"
+#include "SkrRT/resource/resource_system.h"
+#include "SkrRT/resource/resource_factory.h"
 
 #include <string>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <zstd.h>
+#include <lz4.h>
 
 #include "SkrProfile/profile.h"
 
@@ -374,5 +386,802 @@ for (uint32_t i = 0; i < 1; i++)
         }
         SKR_TEST_INFO(u8"sorts tested for {} times", TEST_CYCLES_COUNT);
     }
+
+    SUBCASE("deadline")
+    {
+        if (dstorage) 
+            return;
+
+        SkrZoneScopedN("deadline");
+        for (uint32_t i = 0; i < TEST_CYCLES_COUNT; i++)
+        {
+            skr_ram_io_service_desc_t ioServiceDesc = {};
+            ioServiceDesc.name = u8"Test";
+            ioServiceDesc.use_dstorage = dstorage;
+            ioServiceDesc.sleep_time = SKR_ASYNC_SERVICE_SLEEP_TIME_MAX;
+            auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+            ioService->set_sleep_time(0); // make test faster
+
+            // same priority, the later submitted request is due earlier and must finish first
+            const uint64_t now = (uint64_t)skr_sys_get_usec(false);
+            skr_io_future_t future = {};
+            skr::BlobId blob = nullptr;
+            skr_io_future_t future2 = {};
+            skr::BlobId blob2 = nullptr;
+            {
+                auto rq = ioService->open_request();
+                rq->set_vfs(abs_fs);
+                rq->set_path(u8"testfile");
+                rq->add_block({}); // read all
+                rq->add_callback(SKR_IO_STAGE_COMPLETED, 
+                +[](skr_io_future_t* f, skr_io_request_t* request, void* data) {
+                    auto future2 = (skr_io_future_t*)data;
+                    REQUIRE(future2->is_ready());
+                }, &future2);
+                blob = ioService->request(rq, &future, SKR_ASYNC_SERVICE_PRIORITY_NORMAL, now + 2000000);
+            }
+            {
+                auto rq2 = ioService->open_request();
+                rq2->set_vfs(abs_fs);
+                rq2->set_path(u8"testfile");
+                rq2->add_block({}); // read all
+                rq2->add_callback(SKR_IO_STAGE_COMPLETED, 
+                +[](skr_io_future_t* f, skr_io_request_t* request, void* data) {
+                    auto future = (skr_io_future_t*)data;
+                    REQUIRE(!future->is_ready());
+                }, &future);
+                blob2 = ioService->request(rq2, &future2, SKR_ASYNC_SERVICE_PRIORITY_NORMAL, now + 1000000);
+            }
+            ioService->run();
+            ioService->drain();
+
+            wait_timeout([&future]()->bool
+            {
+                return future.is_ready();
+            });
+            EXPECT_EQ(std::string((const char*)blob2->get_data()), std::string("Hello, World!"));
+            
+            blob.reset();
+            blob2.reset();
+            
+            skr_io_ram_service_t::destroy(ioService);
+        }
+        SKR_TEST_INFO(u8"deadlines tested for {} times", TEST_CYCLES_COUNT);
+    }
+}
+}
+TEST_CASE_METHOD(VFSTest, "ReaderThroughput")
+{
+    #define THROUGHPUT_FILE_COUNT 64
+    #define THROUGHPUT_FILE_SIZE (1024 * 1024)
+
+    skr::vector<uint8_t> content(THROUGHPUT_FILE_SIZE);
+    for (uint32_t i = 0; i < THROUGHPUT_FILE_SIZE; i++)
+        content[i] = (uint8_t)(i * 31u);
+    for (uint32_t i = 0; i < THROUGHPUT_FILE_COUNT; i++)
+    {
+        auto path = skr::format(u8"throughput_file{}", i);
+        auto f = skr_vfs_fopen(abs_fs, path.u8_str(), SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, content.data(), 0, content.size());
+        skr_vfs_fclose(f);
+    }
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        const auto io_uring = (i == 1);
+        skr_ram_io_service_desc_t ioServiceDesc = {};
+        ioServiceDesc.name = u8"Throughput";
+        ioServiceDesc.use_dstorage = false;
+        ioServiceDesc.use_io_uring = io_uring;
+        ioServiceDesc.sleep_time = SKR_ASYNC_SERVICE_SLEEP_TIME_MAX;
+        auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+        ioService->set_sleep_time(0);
+        ioService->run();
+
+        SHiresTimer timer;
+        skr_init_hires_timer(&timer);
+        skr_io_future_t futures[THROUGHPUT_FILE_COUNT] = {};
+        skr::io::RAMIOBufferId blobs[THROUGHPUT_FILE_COUNT];
+        auto batch = ioService->open_batch(THROUGHPUT_FILE_COUNT);
+        for (uint32_t j = 0; j < THROUGHPUT_FILE_COUNT; j++)
+        {
+            auto path = skr::format(u8"throughput_file{}", j);
+            auto rq = ioService->open_request();
+            rq->set_vfs(abs_fs);
+            rq->set_path(path.u8_str());
+            rq->add_block({}); // read all
+            blobs[j] = skr::static_pointer_cast<skr::io::IRAMIOBuffer>(batch->add_request(rq, &futures[j]));
+        }
+        ioService->request(batch);
+        wait_timeout([&futures]()->bool
+        {
+            for (const auto& future : futures)
+            {
+                if (!future.is_ready()) return false;
+            }
+            return true;
+        }, 20);
+        const auto seconds = skr_hires_timer_get_seconds(&timer, false);
+        const double mbytes = (double)THROUGHPUT_FILE_COUNT * THROUGHPUT_FILE_SIZE / (1024.0 * 1024.0);
+        SKR_TEST_INFO(u8"io_uring: {}, read {} MB in {} s, {} MB/s", io_uring, mbytes, seconds, mbytes / seconds);
+
+        for (uint32_t j = 0; j < THROUGHPUT_FILE_COUNT; j++)
+        {
+            REQUIRE(futures[j].is_ready());
+            EXPECT_EQ(blobs[j]->get_size(), THROUGHPUT_FILE_SIZE);
+            EXPECT_EQ(memcmp(blobs[j]->get_data(), content.data(), THROUGHPUT_FILE_SIZE), 0);
+            blobs[j].reset();
+        }
+        batch.reset();
+        skr_io_ram_service_t::destroy(ioService);
+    }
+}
+
+TEST_CASE_METHOD(VFSTest, "CompressedRead")
+{
+    #define COMPRESSED_BLOCK_COUNT 8
+    #define COMPRESSED_BLOCK_SIZE (256 * 1024)
+
+    // even blocks are zstd, odd blocks are lz4
+    skr::vector<uint8_t> content(COMPRESSED_BLOCK_COUNT * COMPRESSED_BLOCK_SIZE);
+    for (uint32_t i = 0; i < content.size(); i++)
+        content[i] = (uint8_t)((i / 64) * 7u);
+    skr::vector<uint8_t> packed;
+    skr::vector<skr_io_compressed_block_t> blocks;
+    for (uint32_t i = 0; i < COMPRESSED_BLOCK_COUNT; i++)
+    {
+        const uint8_t* src = content.data() + i * COMPRESSED_BLOCK_SIZE;
+        const bool zstd = (i % 2 == 0);
+        const uint64_t bound = zstd ? ZSTD_compressBound(COMPRESSED_BLOCK_SIZE) : LZ4_compressBound(COMPRESSED_BLOCK_SIZE);
+        const uint64_t offset = packed.size();
+        packed.resize(offset + bound);
+        uint64_t compressed_size = zstd ? 
+            ZSTD_compress(packed.data() + offset, bound, src, COMPRESSED_BLOCK_SIZE, 1) :
+            LZ4_compress_default((const char*)src, (char*)packed.data() + offset, COMPRESSED_BLOCK_SIZE, (int)bound);
+        REQUIRE(compressed_size > 0);
+        packed.resize(offset + compressed_size);
+
+        skr_io_compressed_block_t block = {};
+        block.offset = offset;
+        block.compressed_size = compressed_size;
+        block.uncompressed_size = COMPRESSED_BLOCK_SIZE;
+        block.decompress_method = zstd ? skr::io::IODecompressMethods::Zstd() : skr::io::IODecompressMethods::LZ4();
+        blocks.emplace_back(block);
+    }
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"compressed_file", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, packed.data(), 0, packed.size());
+        skr_vfs_fclose(f);
+    }
+
+    auto jqDesc = make_zeroed<skr::JobQueueDesc>();
+    jqDesc.thread_count = 4;
+    jqDesc.priority = SKR_THREAD_ABOVE_NORMAL;
+    jqDesc.name = u8"Test-DecompressJobQueue";
+    auto decompress_job_queue = SkrNew<skr::JobQueue>(jqDesc);
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        skr_ram_io_service_desc_t ioServiceDesc = {};
+        ioServiceDesc.name = u8"Compressed";
+        ioServiceDesc.use_dstorage = false;
+        ioServiceDesc.decompress_job_queue = (i == 0) ? nullptr : decompress_job_queue;
+        auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+        ioService->set_sleep_time(0);
+        ioService->run();
+
+        skr_io_future_t future = {};
+        skr::io::RAMIOBufferId blob = nullptr;
+        {
+            auto rq = ioService->open_request();
+            rq->set_vfs(abs_fs);
+            rq->set_path(u8"compressed_file");
+            for (const auto& block : blocks)
+                rq->add_compressed_block(block);
+            blob = ioService->request(rq, &future);
+        }
+        wait_timeout([&future]()->bool
+        {
+            return future.is_ready();
+        });
+
+        REQUIRE(future.is_ready());
+        EXPECT_EQ(blob->get_size(), content.size());
+        EXPECT_EQ(memcmp(blob->get_data(), content.data(), content.size()), 0);
+        SKR_TEST_INFO(u8"decompressed {} bytes from {} bytes, job queue: {}", content.size(), packed.size(), i == 1);
+        blob.reset();
+        skr_io_ram_service_t::destroy(ioService);
+    }
+
+    // a corrupt block fails the whole request instead of completing it with garbage
+    {
+        auto corrupt = packed;
+        memset(corrupt.data() + blocks[2].offset, 0xFF, blocks[2].compressed_size);
+        auto f = skr_vfs_fopen(abs_fs, u8"corrupt_compressed_file", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, corrupt.data(), 0, corrupt.size());
+        skr_vfs_fclose(f);
+    }
+    {
+        skr_ram_io_service_desc_t ioServiceDesc = {};
+        ioServiceDesc.name = u8"Corrupt";
+        ioServiceDesc.use_dstorage = false;
+        ioServiceDesc.decompress_job_queue = decompress_job_queue;
+        auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+        ioService->set_sleep_time(0);
+        ioService->run();
+
+        skr_io_future_t future = {};
+        skr::io::RAMIOBufferId blob = nullptr;
+        {
+            auto rq = ioService->open_request();
+            rq->set_vfs(abs_fs);
+            rq->set_path(u8"corrupt_compressed_file");
+            for (const auto& block : blocks)
+                rq->add_compressed_block(block);
+            blob = ioService->request(rq, &future);
+        }
+        wait_timeout([&future]()->bool
+        {
+            return future.is_ready() || future.is_cancelled();
+        });
+        EXPECT_TRUE(future.is_cancelled());
+        EXPECT_EQ(blob->get_data(), nullptr);
+        blob.reset();
+        skr_io_ram_service_t::destroy(ioService);
+    }
+    SkrDelete(decompress_job_queue);
+}
+
+#if __cpp_impl_coroutine
+#include "SkrRT/async/co_io.hpp"
+
+TEST_CASE_METHOD(VFSTest, "CoroutineRead")
+{
+    using namespace skr::task2;
+    // the raw file is read by co_request, its zstd blocks are unpacked by co_decompress
+    const uint32_t blockCount = 8;
+    const uint32_t blockSize = 64 * 1024;
+    skr::vector<uint8_t> content(blockCount * blockSize);
+    for (uint32_t i = 0; i < content.size(); i++)
+        content[i] = (uint8_t)((i / 32) * 13u);
+    skr::vector<uint8_t> packed;
+    skr::vector<skr_io_compressed_block_t> blocks;
+    for (uint32_t i = 0; i < blockCount; i++)
+    {
+        const uint64_t bound = ZSTD_compressBound(blockSize);
+        const uint64_t offset = packed.size();
+        packed.resize(offset + bound);
+        const uint64_t compressed_size = ZSTD_compress(packed.data() + offset, bound, content.data() + i * blockSize, blockSize, 1);
+        REQUIRE(compressed_size > 0);
+        packed.resize(offset + compressed_size);
+
+        skr_io_compressed_block_t block = {};
+        block.offset = offset;
+        block.compressed_size = compressed_size;
+        block.uncompressed_size = blockSize;
+        block.decompress_method = skr::io::IODecompressMethods::Zstd();
+        blocks.emplace_back(block);
+    }
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"co_compressed_file", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, packed.data(), 0, packed.size());
+        skr_vfs_fclose(f);
+    }
+
+    scheduler_t scheduler;
+    scheduler.initialize({});
+    scheduler.bind();
+
+    skr_ram_io_service_desc_t ioServiceDesc = {};
+    ioServiceDesc.name = u8"Coroutine";
+    ioServiceDesc.use_dstorage = false;
+    auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+    ioService->set_sleep_time(0);
+    ioService->run();
+
+    struct Result
+    {
+        skr::vector<uint8_t> raw;
+        skr::vector<uint8_t> unpacked;
+        bool cancelled = true;
+        bool decompressed = false;
+    } result;
+    event_t done;
+    schedule([](skr::io::IRAMService* service, skr_vfs_t* vfs, skr::span<const skr_io_compressed_block_t> blocks, Result& result, event_t done) -> skr_task_t
+    {
+        auto rq = service->open_request();
+        rq->set_vfs(vfs);
+        rq->set_path(u8"co_compressed_file");
+        rq->add_block({}); // read all
+        auto&& read = co_request(service, rq);
+        auto blob = co_await read;
+        result.cancelled = read.is_cancelled();
+        if (!result.cancelled)
+        {
+            result.raw.assign(blob->get_data(), blob->get_data() + blob->get_size());
+            uint64_t size = 0;
+            for (const auto& block : blocks)
+                size += block.uncompressed_size;
+            result.unpacked.resize(size);
+            result.decompressed = co_await co_decompress(blocks, blob->get_data(), result.unpacked.data());
+        }
+        done.notify();
+    }(ioService, abs_fs, { blocks.data(), blocks.size() }, result, done), task_priority_t::high);
+    sync(done);
+
+    EXPECT_FALSE(result.cancelled);
+    REQUIRE(result.raw.size() == packed.size());
+    EXPECT_EQ(memcmp(result.raw.data(), packed.data(), packed.size()), 0);
+    EXPECT_TRUE(result.decompressed);
+    REQUIRE(result.unpacked.size() == content.size());
+    EXPECT_EQ(memcmp(result.unpacked.data(), content.data(), content.size()), 0);
+
+    skr_io_ram_service_t::destroy(ioService);
+    scheduler.unbind();
+    scheduler.shutdown();
+}
+#endif
+
+TEST_CASE_METHOD(VFSTest, "MappedRead")
+{
+    #define MAPPED_FILE_SIZE (4 * 1024 * 1024)
+
+    skr::vector<uint8_t> content(MAPPED_FILE_SIZE);
+    for (uint32_t i = 0; i < MAPPED_FILE_SIZE; i++)
+        content[i] = (uint8_t)(i * 13u);
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"mapped_file", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, content.data(), 0, content.size());
+        skr_vfs_fclose(f);
+    }
+
+    skr_vfs_desc_t mmap_fs_desc = {};
+    mmap_fs_desc.app_name = u8"fs-test";
+    mmap_fs_desc.mount_type = SKR_MOUNT_TYPE_ABSOLUTE;
+    mmap_fs_desc.use_mmap = true;
+    auto mmap_fs = skr_create_vfs(&mmap_fs_desc);
+    REQUIRE(mmap_fs != nullptr);
+    {
+        auto f = skr_vfs_fopen(mmap_fs, u8"mapped_file", SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+        REQUIRE(f != nullptr);
+        EXPECT_EQ(skr_vfs_fsize(f), MAPPED_FILE_SIZE);
+        auto view = skr_vfs_fmap(f, 1024, 1024);
+        REQUIRE(view != nullptr);
+        EXPECT_EQ(memcmp(view, content.data() + 1024, 1024), 0);
+        EXPECT_EQ(skr_vfs_fmap(f, MAPPED_FILE_SIZE - 16, 32), nullptr);
+        skr_vfs_fclose(f);
+    }
+
+    skr_ram_io_service_desc_t ioServiceDesc = {};
+    ioServiceDesc.name = u8"Mapped";
+    ioServiceDesc.use_dstorage = false;
+    auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+    ioService->set_sleep_time(0);
+    ioService->run();
+
+    // contiguous blocks alias the mapping, scattered blocks are copied
+    skr_io_future_t futures[2] = {};
+    skr::io::RAMIOBufferId blobs[2];
+    {
+        auto rq = ioService->open_request();
+        rq->set_vfs(mmap_fs);
+        rq->set_path(u8"mapped_file");
+        rq->add_block({ 0, MAPPED_FILE_SIZE / 2 });
+        rq->add_block({ MAPPED_FILE_SIZE / 2, 0 });
+        blobs[0] = ioService->request(rq, &futures[0]);
+    }
+    {
+        auto rq = ioService->open_request();
+        rq->set_vfs(mmap_fs);
+        rq->set_path(u8"mapped_file");
+        rq->add_block({ MAPPED_FILE_SIZE / 2, 4096 });
+        rq->add_block({ 0, 4096 });
+        blobs[1] = ioService->request(rq, &futures[1]);
+    }
+    wait_timeout([&futures]()->bool
+    {
+        return futures[0].is_ready() && futures[1].is_ready();
+    });
+
+    REQUIRE(futures[0].is_ready());
+    REQUIRE(futures[1].is_ready());
+    EXPECT_EQ(blobs[0]->get_size(), MAPPED_FILE_SIZE);
+    EXPECT_EQ(memcmp(blobs[0]->get_data(), content.data(), MAPPED_FILE_SIZE), 0);
+    EXPECT_EQ(blobs[1]->get_size(), 8192);
+    EXPECT_EQ(memcmp(blobs[1]->get_data(), content.data() + MAPPED_FILE_SIZE / 2, 4096), 0);
+    EXPECT_EQ(memcmp(blobs[1]->get_data() + 4096, content.data(), 4096), 0);
+    // mapped buffers are copy-on-write, consumers can patch them and the file stays intact
+    memset(blobs[0]->get_data(), 0xCD, 4096);
+    blobs[0].reset();
+    blobs[1].reset();
+    skr_io_ram_service_t::destroy(ioService);
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"mapped_file", SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+        skr::vector<uint8_t> head(4096);
+        skr_vfs_fread(f, head.data(), 0, head.size());
+        skr_vfs_fclose(f);
+        EXPECT_EQ(memcmp(head.data(), content.data(), head.size()), 0);
+    }
+    skr_free_vfs(mmap_fs);
+}
+
+TEST_CASE_METHOD(VFSTest, "PakRead")
+{
+    #define PAK_ENTRY_COUNT 8
+    #define PAK_ENTRY_SIZE (96 * 1024)
+
+    skr::vector<uint8_t> contents[PAK_ENTRY_COUNT];
+    std::string names[PAK_ENTRY_COUNT];
+    auto pak_writer = skr_create_pak_writer(SKR_PAK_DEFAULT_ALIGNMENT);
+    for (uint32_t i = 0; i < PAK_ENTRY_COUNT; i++)
+    {
+        names[i] = "pak_entry_" + std::to_string(i);
+        contents[i].resize(PAK_ENTRY_SIZE + i * 1000);
+        for (uint32_t j = 0; j < contents[i].size(); j++)
+            contents[i][j] = (uint8_t)(j * 7u + i);
+        auto f = skr_vfs_fopen(abs_fs, (const char8_t*)names[i].c_str(), SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, contents[i].data(), 0, contents[i].size());
+        skr_vfs_fclose(f);
+        skr_pak_writer_add_file(pak_writer, (const char8_t*)names[i].c_str(), abs_fs, (const char8_t*)names[i].c_str());
+    }
+    REQUIRE(skr_pak_writer_write(pak_writer, abs_fs, u8"test.pak"));
+    skr_free_pak_writer(pak_writer);
+
+    skr_pak_vfs_desc_t pak_desc = {};
+    pak_desc.archive_fs = abs_fs;
+    pak_desc.archive_path = u8"test.pak";
+    auto pak_fs = skr_create_pak_vfs(&pak_desc);
+    REQUIRE(pak_fs != nullptr);
+    EXPECT_TRUE(skr_vfs_is_pak(pak_fs));
+    EXPECT_FALSE(skr_vfs_is_pak(abs_fs));
+    {
+        EXPECT_EQ(skr_vfs_fopen(pak_fs, u8"missing_entry", SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING), nullptr);
+        auto f = skr_vfs_fopen(pak_fs, u8"./pak_entry_3", SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+        REQUIRE(f != nullptr);
+        EXPECT_EQ(skr_vfs_fsize(f), contents[3].size());
+        uint64_t archive_offset = 0;
+        EXPECT_TRUE(skr_pak_vfs_locate(f, &archive_offset));
+        EXPECT_EQ(archive_offset % SKR_PAK_DEFAULT_ALIGNMENT, 0);
+        uint8_t bytes[256];
+        EXPECT_EQ(skr_vfs_fread(f, bytes, 1000, 256), 256);
+        EXPECT_EQ(memcmp(bytes, contents[3].data() + 1000, 256), 0);
+        skr_vfs_fclose(f);
+    }
+
+    skr_ram_io_service_desc_t ioServiceDesc = {};
+    ioServiceDesc.name = u8"Pak";
+    ioServiceDesc.use_dstorage = false;
+    auto ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+    ioService->set_sleep_time(0);
+    ioService->run();
+
+    // one batch over all entries is served by a few coalesced archive reads
+    skr_io_future_t futures[PAK_ENTRY_COUNT] = {};
+    skr::io::RAMIOBufferId blobs[PAK_ENTRY_COUNT];
+    auto batch = ioService->open_batch(PAK_ENTRY_COUNT);
+    for (uint32_t i = 0; i < PAK_ENTRY_COUNT; i++)
+    {
+        auto rq = ioService->open_request();
+        rq->set_vfs(pak_fs);
+        rq->set_path((const char8_t*)names[i].c_str());
+        rq->add_block({ 0, 0 });
+        blobs[i] = skr::static_pointer_cast<skr::io::IRAMIOBuffer>(batch->add_request(rq, &futures[i]));
+    }
+    ioService->request(batch);
+    wait_timeout([&futures]()->bool
+    {
+        for (auto& future : futures)
+        {
+            if (!future.is_ready())
+                return false;
+        }
+        return true;
+    });
+
+    for (uint32_t i = 0; i < PAK_ENTRY_COUNT; i++)
+    {
+        REQUIRE(futures[i].is_ready());
+        EXPECT_EQ(blobs[i]->get_size(), contents[i].size());
+        EXPECT_EQ(memcmp(blobs[i]->get_data(), contents[i].data(), contents[i].size()), 0);
+        blobs[i].reset();
+    }
+    skr_io_ram_service_t::destroy(ioService);
+    skr_free_pak_vfs(pak_fs);
+}
+
+TEST_CASE_METHOD(VFSTest, "PakCorrupt")
+{
+    const std::string content(3000, 'p');
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"pak_corrupt_src", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, content.data(), 0, content.size());
+        skr_vfs_fclose(f);
+    }
+    auto pak_writer = skr_create_pak_writer(SKR_PAK_DEFAULT_ALIGNMENT);
+    skr_pak_writer_add_file(pak_writer, u8"entry_a", abs_fs, u8"pak_corrupt_src");
+    skr_pak_writer_add_file(pak_writer, u8"entry_b", abs_fs, u8"pak_corrupt_src");
+    REQUIRE(skr_pak_writer_write(pak_writer, abs_fs, u8"corrupt.pak"));
+    skr_free_pak_writer(pak_writer);
+
+    skr::vector<uint8_t> archive;
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"corrupt.pak", SKR_FM_READ_BINARY, SKR_FILE_CREATION_OPEN_EXISTING);
+        archive.resize(skr_vfs_fsize(f));
+        skr_vfs_fread(f, archive.data(), 0, archive.size());
+        skr_vfs_fclose(f);
+    }
+    skr_pak_header_t header = {};
+    memcpy(&header, archive.data(), sizeof(header));
+    REQUIRE(header.entry_count == 2);
+    auto open_variant = [&](const skr::vector<uint8_t>& bytes) {
+        auto f = skr_vfs_fopen(abs_fs, u8"corrupt_variant.pak", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        skr_vfs_fwrite(f, bytes.data(), 0, bytes.size());
+        skr_vfs_fclose(f);
+        skr_pak_vfs_desc_t pak_desc = {};
+        pak_desc.archive_fs = abs_fs;
+        pak_desc.archive_path = u8"corrupt_variant.pak";
+        auto pak_fs = skr_create_pak_vfs(&pak_desc);
+        const bool opened = pak_fs != nullptr;
+        skr_free_pak_vfs(pak_fs);
+        return opened;
+    };
+    auto with_entry = [&](auto&& patch) {
+        auto bytes = archive;
+        skr_pak_entry_t entry = {};
+        memcpy(&entry, bytes.data() + header.toc_offset, sizeof(entry));
+        patch(entry);
+        memcpy(bytes.data() + header.toc_offset, &entry, sizeof(entry));
+        return bytes;
+    };
+
+    // the untouched archive opens
+    EXPECT_TRUE(open_variant(archive));
+    SUBCASE("ContentPastTheData")
+    {
+        EXPECT_FALSE(open_variant(with_entry([&](skr_pak_entry_t& e) { e.size = header.toc_offset; })));
+        EXPECT_FALSE(open_variant(with_entry([&](skr_pak_entry_t& e) { e.offset = ~0ull - 16; })));
+    }
+    SUBCASE("NamePastTheNames")
+    {
+        EXPECT_FALSE(open_variant(with_entry([&](skr_pak_entry_t& e) { e.name_offset = (uint32_t)header.names_size; })));
+        EXPECT_FALSE(open_variant(with_entry([&](skr_pak_entry_t& e) { e.name_size = ~0u; })));
+    }
+    SUBCASE("UnsortedToc")
+    {
+        EXPECT_FALSE(open_variant(with_entry([&](skr_pak_entry_t& e) { e.hash = ~0ull; })));
+    }
+    SUBCASE("Truncated")
+    {
+        auto bytes = archive;
+        bytes.resize(bytes.size() - 4);
+        EXPECT_FALSE(open_variant(bytes));
+        bytes.resize(sizeof(skr_pak_header_t) - 1);
+        EXPECT_FALSE(open_variant(bytes));
+    }
+}
+
+using namespace skr::guid::literals;
+static const skr_guid_t kTestResourceType = u8"{5C0E8B24-3F4A-4D6E-9B1A-7E2C8D9F0A13}"_guid;
+
+struct TestResourceFactory : public skr::resource::SResourceFactory
+{
+    skr_type_id_t GetResourceType() override { return kTestResourceType; }
+    bool AsyncIO() override { return asyncIO; }
+    float AsyncSerdeLoadFactor() override { return 0.f; } // deserialize inline, no task scheduler needed
+    int Deserialize(skr_resource_record_t* record, skr_binary_reader_t* reader) override { return 0; }
+    ESkrInstallStatus Install(skr_resource_record_t* record) override
+    {
+        installs.push_back(record->header.guid);
+        return SKR_INSTALL_STATUS_SUCCEED;
+    }
+    skr::vector<skr_guid_t> installs;
+    // read through the io service of the system instead of a blocking vfs read
+    bool asyncIO = false;
+};
+
+// serves the headers from memory, the data of every resource is the same small file
+struct TestResourceRegistry : public skr::resource::SResourceRegistry
+{
+    bool RequestResourceFile(skr::resource::SResourceRequest* request) override
+    {
+        auto iter = dependencies.find(request->GetGuid());
+        if (iter == dependencies.end())
+            return false;
+        skr_resource_header_t header;
+        header.version = 0;
+        header.guid = request->GetGuid();
+        header.type = kTestResourceType;
+        for (const auto& dependency : iter->second)
+            header.dependencies.emplace_back(dependency);
+        FillRequest(request, header, vfs, u8"resource_test.bin");
+        request->OnRequestFileFinished();
+        return true;
+    }
+    void CancelRequestFile(skr::resource::SResourceRequest* request) override {}
+
+    skr_vfs_t* vfs = nullptr;
+    skr::flat_hash_map<skr_guid_t, skr::vector<skr_guid_t>, skr::guid::hash> dependencies;
+};
+
+struct ResourceTest : public VFSTest
+{
+    ResourceTest()
+    {
+        auto f = skr_vfs_fopen(abs_fs, u8"resource_test.bin", SKR_FM_WRITE_BINARY, SKR_FILE_CREATION_ALWAYS_NEW);
+        const uint32_t payload = 0;
+        skr_vfs_fwrite(f, &payload, 0, sizeof(payload));
+        skr_vfs_fclose(f);
+
+        skr_ram_io_service_desc_t ioServiceDesc = {};
+        ioServiceDesc.name = u8"ResourceTest";
+        ioServiceDesc.sleep_time = 1;
+        ioService = skr_io_ram_service_t::create(&ioServiceDesc);
+        ioService->run();
+
+        registry.vfs = abs_fs;
+        system = skr::resource::GetResourceSystem();
+        system->Initialize(&registry, ioService);
+        system->RegisterFactory(&factory);
+    }
+
+    ~ResourceTest()
+    {
+        system->Shutdown();
+        system->UnregisterFactory(kTestResourceType);
+        system->SetInstallBudget(0);
+        system->SetStreamingSpeed(0.f);
+        system->SetPrefetchLifetime(60);
+        skr_io_ram_service_t::destroy(ioService);
+    }
+
+    void Load(skr_resource_handle_t& handle, const skr_guid_t& guid)
+    {
+        handle = guid;
+        system->LoadResource(handle, true, (uint64_t)this, SKR_REQUESTER_SYSTEM);
+    }
+
+    // updates the system until the resource reaches the status, async reads complete on the io thread
+    bool UpdateUntil(const skr_guid_t& guid, ESkrLoadingStatus status)
+    {
+        return wait_timeout([&]() -> bool {
+            system->Update();
+            return system->GetResourceStatus(guid) == status;
+        });
+    }
+
+    skr_io_ram_service_t* ioService = nullptr;
+    skr::resource::SResourceSystem* system = nullptr;
+    TestResourceRegistry registry;
+    TestResourceFactory factory;
+};
+
+TEST_CASE_METHOD(ResourceTest, "InstallWaves")
+{
+    // G depends on H and E depends on F, the dependencies are requested by the first update
+    const auto G = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E01}"_guid;
+    const auto H = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E02}"_guid;
+    const auto E = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E03}"_guid;
+    const auto F = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E04}"_guid;
+    registry.dependencies[G] = { H };
+    registry.dependencies[H] = {};
+    registry.dependencies[E] = { F };
+    registry.dependencies[F] = {};
+
+    SUBCASE("unlimited")
+    {
+        skr_resource_handle_t g, e;
+        Load(g, G);
+        Load(e, E);
+        system->Update();
+        EXPECT_TRUE(factory.installs.empty());
+        // dependencies install in the first wave and release their dependents into the second one
+        system->Update();
+        REQUIRE(factory.installs.size() == 4);
+        EXPECT_EQ(factory.installs[0], H);
+        EXPECT_EQ(factory.installs[1], F);
+        EXPECT_EQ(factory.installs[2], G);
+        EXPECT_EQ(factory.installs[3], E);
+        EXPECT_EQ(g.get_status(), SKR_LOADING_STATUS_INSTALLED);
+        EXPECT_EQ(e.get_status(), SKR_LOADING_STATUS_INSTALLED);
+    }
+
+    SUBCASE("budget")
+    {
+        system->SetInstallBudget(1);
+        skr_resource_handle_t g, e;
+        Load(g, G);
+        Load(e, E);
+        system->Update();
+        // one install per update. F, cut off from the wave of H, goes before G which H released,
+        // the requests left over by the budget keep their turn instead of restarting from the request order
+        const skr_guid_t expected[] = { H, F, G, E };
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            system->Update();
+            REQUIRE(factory.installs.size() == i + 1);
+            EXPECT_EQ(factory.installs[i], expected[i]);
+        }
+        EXPECT_EQ(g.get_status(), SKR_LOADING_STATUS_INSTALLED);
+        EXPECT_EQ(e.get_status(), SKR_LOADING_STATUS_INSTALLED);
+    }
+}
+
+TEST_CASE_METHOD(ResourceTest, "Prefetch")
+{
+    const auto G = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E11}"_guid;
+    registry.dependencies[G] = {};
+    factory.asyncIO = true;
+
+    SUBCASE("promote")
+    {
+        // a prefetch loads without installing, a real request promotes it and installs
+        system->PrefetchResources({ &G, 1 });
+        REQUIRE(UpdateUntil(G, SKR_LOADING_STATUS_LOADED));
+        EXPECT_TRUE(factory.installs.empty());
+        skr_resource_handle_t g;
+        Load(g, G);
+        EXPECT_EQ(g.get_record()->hint.urgency, SKR_LOADING_URGENCY_NORMAL);
+        REQUIRE(UpdateUntil(G, SKR_LOADING_STATUS_INSTALLED));
+        REQUIRE(factory.installs.size() == 1);
+        EXPECT_EQ(factory.installs[0], G);
+    }
+
+    SUBCASE("no demotion")
+    {
+        skr_resource_handle_t g;
+        Load(g, G);
+        skr_resource_hint_t hint;
+        hint.urgency = SKR_LOADING_URGENCY_URGENT;
+        g.set_hint(hint);
+        system->PrefetchResources({ &G, 1 });
+        EXPECT_EQ(g.get_record()->hint.urgency, SKR_LOADING_URGENCY_URGENT);
+        REQUIRE(UpdateUntil(G, SKR_LOADING_STATUS_INSTALLED));
+    }
+
+    SUBCASE("stale")
+    {
+        // the first update submits the read, the second one drops the prefetch and cancels the read if still pending
+        system->SetPrefetchLifetime(1);
+        system->PrefetchResources({ &G, 1 });
+        EXPECT_TRUE(UpdateUntil(G, SKR_LOADING_STATUS_UNLOADED));
+        EXPECT_TRUE(factory.installs.empty());
+    }
+
+    SUBCASE("refreshed")
+    {
+        // prefetching again every frame keeps the resource alive past the lifetime
+        system->SetPrefetchLifetime(1);
+        EXPECT_TRUE(wait_timeout([&]() -> bool {
+            system->PrefetchResources({ &G, 1 });
+            system->Update();
+            return system->GetResourceStatus(G) == SKR_LOADING_STATUS_LOADED;
+        }));
+        EXPECT_TRUE(factory.installs.empty());
+    }
+}
+
+TEST_CASE_METHOD(ResourceTest, "LoadingHints")
+{
+    // distances that make no finite deadline must still load, they are read without one
+    const float distances[] = { -1.f, 0.f, 10.f, 1e30f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+    const ESkrLoadingUrgency urgencies[] = { SKR_LOADING_URGENCY_PREFETCH, SKR_LOADING_URGENCY_NORMAL, SKR_LOADING_URGENCY_URGENT };
+    factory.asyncIO = true;
+    system->SetStreamingSpeed(1e-30f);
+    skr::vector<skr_guid_t> guids;
+    skr::vector<skr_resource_handle_t> handles(std::size(distances) * std::size(urgencies));
+    for (uint32_t i = 0; i < handles.size(); ++i)
+    {
+        auto guid = u8"{0B7D4C1E-2A3F-4E5D-8C6B-1A2B3C4D5E20}"_guid;
+        guid.Storage3 += i;
+        registry.dependencies[guid] = {};
+        guids.push_back(guid);
+        Load(handles[i], guid);
+        skr_resource_hint_t hint;
+        hint.urgency = urgencies[i % std::size(urgencies)];
+        hint.distance = distances[i / std::size(urgencies)];
+        handles[i].set_hint(hint);
+    }
+    for (const auto& guid : guids)
+        EXPECT_TRUE(UpdateUntil(guid, SKR_LOADING_STATUS_INSTALLED));
+    EXPECT_EQ(factory.installs.size(), guids.size());
 }
-}
\ No newline at end of file
@@ -18,8 +18,17 @@ target("VFSTest")
     set_kind("binary")
     public_dependency("SkrRT", engine_version)
     add_deps("SkrTestFramework", {public = false})
+    add_packages("zstd", "lz4", {public = false})
     add_files("vfs/main.cpp")
 
+target("LightningStorageTest")
+    set_group("05.tests/base")
+    set_kind("binary")
+    public_dependency("SkrRT", engine_version)
+    public_dependency("SkrLightningStorage", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    add_files("lightning_storage/main.cpp")
+
 target("SerdeTest")
     set_group("05.tests/base")
     set_kind("binary")
@@ -35,6 +44,14 @@ target("ECSTest")
     add_deps("SkrTestFramework", {public = false})
     add_files("ecs/main.cpp")
 
+target("SceneTest")
+    set_group("05.tests/base")
+    set_kind("binary")
+    public_dependency("SkrRT", engine_version)
+    public_dependency("SkrScene", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    add_files("scene/main.cpp")
+
 shared_module("RTTITestTypes", "RTTI_TEST_TYPES", engine_version)
     set_group("05.tests/framework")
     add_rules("c++.unity_build", {batchsize = default_unity_batch_size})
@@ -0,0 +1,205 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/misc/log.h"
+#include "SkrToolCore/asset/cook_database.hpp"
+
+#include "SkrTestFramework/framework.hpp"
+#include <chrono>
+#include <fstream>
+#include <string>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+using namespace skr::guid::literals;
+static const skr_guid_t kAsset = u8"{7A3C1E52-94B0-4D2F-8E61-0C5B9D4A2F17}"_guid;
+static const skr_guid_t kDependency = u8"{E14F6B08-2D93-4C7A-B5E0-98A1C3D6F245}"_guid;
+
+class CookDatabaseTests
+{
+protected:
+    CookDatabaseTests()
+    {
+        std::error_code ec = {};
+        directory = skr::filesystem::current_path(ec) / "cook-database-test";
+        skr::filesystem::remove_all(directory, ec);
+        skr::filesystem::create_directories(directory / "assets", ec);
+        database = skd::asset::SCookDatabase::Open(directory / "database");
+        REQUIRE(database);
+    }
+    ~CookDatabaseTests()
+    {
+        skd::asset::SCookDatabase::Close(database);
+        std::error_code ec = {};
+        skr::filesystem::remove_all(directory, ec);
+    }
+
+    skr::filesystem::path write(const char* name, const std::string& content)
+    {
+        const auto path = directory / "assets" / name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+        return path;
+    }
+
+    static void touch(const skr::filesystem::path& path)
+    {
+        std::error_code ec = {};
+        const auto time = skr::filesystem::last_write_time(path, ec);
+        skr::filesystem::last_write_time(path, time + std::chrono::seconds(10), ec);
+        REQUIRE(!ec);
+    }
+
+    static skd::asset::SCookRecord make_record()
+    {
+        skd::asset::SCookRecord record;
+        record.importerVersion = 3;
+        record.cookerVersion = 7;
+        record.metaHash = 0x1234;
+        record.outputHash = 0x5678;
+        auto& output = record.outputs.emplace_back();
+        output.path = u8"asset.bin";
+        output.size = 64;
+        output.timestamp = 100;
+        output.hash = 0xabcd;
+        auto& file = record.files.emplace_back();
+        file.path = u8"source.txt";
+        file.size = 5;
+        file.timestamp = 200;
+        file.hash = 0xef01;
+        auto& dependency = record.dependencies.emplace_back();
+        dependency.guid = kDependency;
+        dependency.content.hash = 0x2345;
+        return record;
+    }
+
+    skr::filesystem::path directory;
+    skd::asset::SCookDatabase* database = nullptr;
+};
+
+TEST_CASE_METHOD(CookDatabaseTests, "StoreFind")
+{
+    skd::asset::SCookRecord found;
+    EXPECT_FALSE(database->Find(kAsset, found));
+
+    const auto record = make_record();
+    REQUIRE(database->Store(kAsset, record));
+    REQUIRE(database->Find(kAsset, found));
+    EXPECT_EQ(found.importerVersion, record.importerVersion);
+    EXPECT_EQ(found.cookerVersion, record.cookerVersion);
+    EXPECT_EQ(found.metaHash, record.metaHash);
+    EXPECT_EQ(found.outputHash, record.outputHash);
+    REQUIRE(found.outputs.size() == 1);
+    EXPECT_EQ(found.outputs[0].path, record.outputs[0].path);
+    EXPECT_EQ(found.outputs[0].hash, record.outputs[0].hash);
+    REQUIRE(found.files.size() == 1);
+    EXPECT_EQ(found.files[0].path, record.files[0].path);
+    EXPECT_EQ(found.files[0].size, record.files[0].size);
+    EXPECT_EQ(found.files[0].timestamp, record.files[0].timestamp);
+    REQUIRE(found.dependencies.size() == 1);
+    EXPECT_EQ(found.dependencies[0].guid, kDependency);
+    EXPECT_EQ(found.dependencies[0].content.hash, record.dependencies[0].content.hash);
+
+    REQUIRE(database->Remove(kAsset));
+    EXPECT_FALSE(database->Find(kAsset, found));
+    // removing a missing record succeeds
+    EXPECT_TRUE(database->Remove(kAsset));
+}
+
+TEST_CASE_METHOD(CookDatabaseTests, "VersionMismatch")
+{
+    auto record = make_record();
+    record.version = skd::asset::SCookRecord::kVersion + 1;
+    REQUIRE(database->Store(kAsset, record));
+    skd::asset::SCookRecord found;
+    EXPECT_FALSE(database->Find(kAsset, found));
+}
+
+TEST_CASE_METHOD(CookDatabaseTests, "CheckFile")
+{
+    const auto path = write("source.txt", "hello");
+    skd::asset::SCookFileRecord file;
+    REQUIRE(database->HashFile(path, file));
+    EXPECT_EQ(file.size, 5);
+
+    bool stale = false;
+    EXPECT_TRUE(database->CheckFile(path, file, stale));
+    EXPECT_FALSE(stale);
+
+    SUBCASE("TouchedSameContent")
+    {
+        const auto recorded = file.timestamp;
+        touch(path);
+        EXPECT_TRUE(database->CheckFile(path, file, stale));
+        EXPECT_TRUE(stale);
+        EXPECT_NE(file.timestamp, recorded);
+        // the new stats are taken, the next check hashes nothing
+        stale = false;
+        const auto hashed = database->GetStatistics().files_hashed;
+        EXPECT_TRUE(database->CheckFile(path, file, stale));
+        EXPECT_FALSE(stale);
+        EXPECT_EQ(database->GetStatistics().files_hashed, hashed);
+    }
+    SUBCASE("ChangedContent")
+    {
+        // same size, only the hash tells them apart
+        write("source.txt", "world");
+        touch(path);
+        EXPECT_FALSE(database->CheckFile(path, file, stale));
+        write("source.txt", "hello, world");
+        EXPECT_FALSE(database->CheckFile(path, file, stale));
+    }
+    SUBCASE("Missing")
+    {
+        std::error_code ec = {};
+        skr::filesystem::remove(path, ec);
+        EXPECT_FALSE(database->CheckFile(path, file, stale));
+    }
+}
+
+TEST_CASE_METHOD(CookDatabaseTests, "RefreshFlush")
+{
+    const auto record = make_record();
+    REQUIRE(database->Store(kAsset, record));
+
+    auto refreshed = record;
+    refreshed.files[0].timestamp = 300;
+    database->Refresh(kAsset, refreshed);
+    skd::asset::SCookRecord found;
+    // refreshes are batched, nothing is written before the flush
+    REQUIRE(database->Find(kAsset, found));
+    EXPECT_EQ(found.files[0].timestamp, 200);
+
+    database->Flush();
+    EXPECT_EQ(database->GetStatistics().records_refreshed, 1);
+    REQUIRE(database->Find(kAsset, found));
+    EXPECT_EQ(found.files[0].timestamp, 300);
+
+    // persisted across a reopen
+    skd::asset::SCookDatabase::Close(database);
+    database = skd::asset::SCookDatabase::Open(directory / "database");
+    REQUIRE(database);
+    REQUIRE(database->Find(kAsset, found));
+    EXPECT_EQ(found.files[0].timestamp, 300);
+    EXPECT_EQ(found.outputHash, record.outputHash);
+
+    // a store supersedes a pending refresh
+    refreshed.files[0].timestamp = 400;
+    database->Refresh(kAsset, refreshed);
+    REQUIRE(database->Store(kAsset, record));
+    database->Flush();
+    REQUIRE(database->Find(kAsset, found));
+    EXPECT_EQ(found.files[0].timestamp, 200);
+}
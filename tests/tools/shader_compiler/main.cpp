@@ -0,0 +1,145 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/misc/log.h"
+#include "SkrShaderCompiler/dxc_compiler.hpp"
+#include "SkrShaderCompiler/assets/shader_asset.hpp"
+
+#include "SkrTestFramework/framework.hpp"
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+// keys come from a real dxc, includes are only expanded by its preprocessor
+class ShaderCacheKeyTests
+{
+protected:
+    ShaderCacheKeyTests()
+    {
+        std::error_code ec = {};
+        directory = skr::filesystem::current_path(ec) / "shader-cache-key-test";
+        skr::filesystem::remove_all(directory, ec);
+        skr::filesystem::create_directories(directory, ec);
+        skd::asset::SDXCLibrary::LoadDXCLibrary();
+        compiler = (skd::asset::SDXCCompiler*)skd::asset::SDXCCompiler::Create();
+        importer.entry = u8"main";
+        importer.target = u8"cs_6_0";
+
+        write(directory / "key_test.hlsli", "static const uint kValue = 1;\n");
+        // an absolute include keeps the lookup independent of the working directory
+        const auto include = (directory / "key_test.hlsli").generic_string();
+        write(directory / "key_test.hlsl", ("#include \"" + include + "\"\n"
+            "RWStructuredBuffer<uint> output : register(u0);\n"
+            "[numthreads(1, 1, 1)]\n"
+            "void main(uint3 id : SV_DispatchThreadID)\n"
+            "{\n"
+            "#ifdef KEY_TEST_DEFINE\n"
+            "    output[id.x] = kValue + 1;\n"
+            "#else\n"
+            "    output[id.x] = kValue;\n"
+            "#endif\n"
+            "}\n").c_str());
+    }
+    ~ShaderCacheKeyTests()
+    {
+        skd::asset::SDXCCompiler::Free(compiler);
+        skd::asset::SDXCLibrary::UnloadLibraries();
+        std::error_code ec = {};
+        skr::filesystem::remove_all(directory, ec);
+    }
+
+    static void write(const skr::filesystem::path& path, const char* text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    skr_md5_t key_of()
+    {
+        const auto path = directory / "key_test.hlsl";
+        std::ifstream file(path, std::ios::binary);
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const auto name = path.generic_string();
+        skd::asset::ShaderSourceCode source(skr::IBlob::Create((const uint8_t*)text.data(), text.size(), false),
+            (const char8_t*)name.c_str(), skd::asset::EShaderSourceType::HLSL);
+        skr_md5_t key = {};
+        REQUIRE(compiler->GetCacheKey(CGPU_SHADER_BYTECODE_TYPE_DXIL, source, importer, &key));
+        return key;
+    }
+
+    void set_define(const char8_t* value)
+    {
+        skr_shader_option_template_t def = {};
+        def.type = skr::renderer::EShaderOptionType::VALUE;
+        def.key = u8"KEY_TEST_DEFINE";
+        def.value_selections.emplace_back(u8"on");
+        def.value_selections.emplace_back(u8"off");
+        skr_shader_option_instance_t option = {};
+        option.key = u8"KEY_TEST_DEFINE";
+        option.value = value;
+        compiler->SetShaderOptions({ &def, 1 }, { &option, 1 }, kZeroStableShaderHash);
+    }
+
+    skr::filesystem::path directory;
+    skd::asset::SDXCCompiler* compiler = nullptr;
+    skd::asset::SShaderImporter importer;
+};
+
+TEST_CASE_METHOD(ShaderCacheKeyTests, "StableKey")
+{
+    REQUIRE_FALSE(skd::asset::SDXCLibrary::GetCompilerVersion().is_empty());
+    EXPECT_EQ(key_of(), key_of());
+}
+
+TEST_CASE_METHOD(ShaderCacheKeyTests, "IncludeChange")
+{
+    const auto key = key_of();
+    write(directory / "key_test.hlsli", "static const uint kValue = 2;\n");
+    EXPECT_FALSE(key_of() == key);
+    write(directory / "key_test.hlsli", "static const uint kValue = 1;\n");
+    EXPECT_EQ(key_of(), key);
+}
+
+TEST_CASE_METHOD(ShaderCacheKeyTests, "DefineChange")
+{
+    set_define(u8"off");
+    const auto key = key_of();
+    set_define(u8"on");
+    const auto defined = key_of();
+    EXPECT_FALSE(defined == key);
+    set_define(u8"2");
+    EXPECT_FALSE(key_of() == defined);
+    EXPECT_FALSE(key_of() == key);
+}
+
+TEST_CASE_METHOD(ShaderCacheKeyTests, "CompilerVersionChange")
+{
+    // the loaded dxc has one version, the composition GetCacheKey uses is checked with two
+    const eastl::vector<eastl::wstring> args = { L"key_test.hlsl", L"-E", L"main", L"-T", L"cs_6_0" };
+    const eastl::string_view preprocessed = "static const uint kValue = 1;";
+    const skr::string version = skd::asset::SDXCLibrary::GetCompilerVersion();
+    skr::string unsigned_version = version;
+    unsigned_version += u8"-unsigned";
+    skr_md5_t key = {}, same = {}, other = {}, unsigned_key = {};
+    skd::asset::SDXCCompiler::ComposeCacheKey(version, CGPU_SHADER_BYTECODE_TYPE_DXIL, args, preprocessed, &key);
+    skd::asset::SDXCCompiler::ComposeCacheKey(version, CGPU_SHADER_BYTECODE_TYPE_DXIL, args, preprocessed, &same);
+    skd::asset::SDXCCompiler::ComposeCacheKey(skr::string(u8"dxc-0.0"), CGPU_SHADER_BYTECODE_TYPE_DXIL, args, preprocessed, &other);
+    skd::asset::SDXCCompiler::ComposeCacheKey(unsigned_version, CGPU_SHADER_BYTECODE_TYPE_DXIL, args, preprocessed, &unsigned_key);
+    EXPECT_EQ(key, same);
+    EXPECT_FALSE(key == other);
+    EXPECT_FALSE(key == unsigned_key);
+}
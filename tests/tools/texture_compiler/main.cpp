@@ -0,0 +1,269 @@
+#include "SkrRT/platform/crash.h"
+#include "SkrRT/misc/log.h"
+#include "SkrRT/io/vram_io.hpp"
+#include "dxt_utils.hpp"
+
+#include "SkrTestFramework/framework.hpp"
+#include <math.h>
+
+static struct ProcInitializer
+{
+    ProcInitializer()
+    {
+        ::skr_log_set_level(SKR_LOG_LEVEL_WARN);
+        ::skr_initialize_crash_handler();
+        ::skr_log_initialize_async_worker();
+    }
+    ~ProcInitializer()
+    {
+        ::skr_log_finalize_async_worker();
+        ::skr_finalize_crash_handler();
+    }
+} init;
+
+using namespace skd::asset;
+
+// mips stay under kMipRowGrain rows, so the passes run on the calling thread without a task scheduler
+static STextureMip make_mip(uint32_t width, uint32_t height, uint32_t channels, float value)
+{
+    STextureMip mip;
+    mip.resize(width, height, channels);
+    for (auto& pixel : mip.pixels)
+        pixel = value;
+    return mip;
+}
+
+static float half_to_float(uint16_t half)
+{
+    const uint32_t exponent = (half >> 10) & 0x1F;
+    const uint32_t mantissa = half & 0x3FF;
+    if (exponent == 0)
+        return ldexpf((float)mantissa, -24);
+    return ldexpf((float)(mantissa | 0x400), (int)exponent - 25);
+}
+
+TEST_CASE("MipCount")
+{
+    EXPECT_EQ(Util_MipCount(1, 1), 1);
+    EXPECT_EQ(Util_MipCount(2, 1), 2);
+    EXPECT_EQ(Util_MipCount(1, 2), 2);
+    EXPECT_EQ(Util_MipCount(256, 256), 9);
+    EXPECT_EQ(Util_MipCount(1024, 1), 11);
+    EXPECT_EQ(Util_MipCount(7, 5), 3);
+    EXPECT_EQ(Util_MipCount(13, 7), 4);
+    EXPECT_EQ(Util_MipCount(1000, 600), 10);
+}
+
+TEST_CASE("FloatToUHalf")
+{
+    SUBCASE("Normal")
+    {
+        EXPECT_EQ(Util_FloatToUHalf(0.0f), 0x0000);
+        EXPECT_EQ(Util_FloatToUHalf(0.5f), 0x3800);
+        EXPECT_EQ(Util_FloatToUHalf(1.0f), 0x3C00);
+        EXPECT_EQ(Util_FloatToUHalf(65504.0f), 0x7BFF);
+        // smallest normal
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(1.0f, -14)), 0x0400);
+    }
+    SUBCASE("Denormal")
+    {
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(1.0f, -15)), 0x0200);
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(1.0f, -24)), 0x0001);
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(3.0f, -24)), 0x0003);
+        // too small for the smallest denormal
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(1.0f, -26)), 0x0000);
+    }
+    SUBCASE("RoundingCarry")
+    {
+        // the mantissa rounds up past its top bit and bumps the exponent
+        EXPECT_EQ(Util_FloatToUHalf(2.0f - ldexpf(1.0f, -12)), 0x4000);
+        EXPECT_EQ(Util_FloatToUHalf(1.0f + ldexpf(1.0f, -12)), 0x3C00);
+        EXPECT_EQ(Util_FloatToUHalf(1.0f + ldexpf(3.0f, -12)), 0x3C01);
+        // a denormal carries into the smallest normal
+        EXPECT_EQ(Util_FloatToUHalf(ldexpf(1.0f, -14) - ldexpf(1.0f, -26)), 0x0400);
+    }
+    SUBCASE("Clamp")
+    {
+        EXPECT_EQ(Util_FloatToUHalf(-1.0f), 0x0000);
+        EXPECT_EQ(Util_FloatToUHalf(-ldexpf(1.0f, -20)), 0x0000);
+        // would round to infinity without the clamp
+        EXPECT_EQ(Util_FloatToUHalf(65520.0f), 0x7BFF);
+        EXPECT_EQ(Util_FloatToUHalf(1e10f), 0x7BFF);
+    }
+    SUBCASE("RoundTrip")
+    {
+        for (float v = 0.001f; v < 60000.0f; v *= 1.37f)
+        {
+            const float back = half_to_float(Util_FloatToUHalf(v));
+            EXPECT_TRUE(fabsf(back - v) <= v * (1.0f / 2048.0f));
+        }
+    }
+}
+
+TEST_CASE("KaiserTaps")
+{
+    const uint32_t sizes[][2] = { { 2, 1 }, { 3, 1 }, { 5, 2 }, { 7, 3 }, { 13, 6 }, { 100, 50 }, { 256, 128 } };
+    for (const auto& size : sizes)
+    {
+        const auto taps = Util_KaiserTaps(size[0], size[1]);
+        REQUIRE(taps.count > 0);
+        REQUIRE(taps.weights.size() == (size_t)size[1] * taps.count);
+        REQUIRE(taps.indices.size() == (size_t)size[1] * taps.count);
+        for (uint32_t x = 0; x < size[1]; ++x)
+        {
+            double total = 0.0;
+            for (uint32_t j = 0; j < taps.count; ++j)
+            {
+                total += taps.weights[(size_t)x * taps.count + j];
+                EXPECT_TRUE(taps.indices[(size_t)x * taps.count + j] < size[0]);
+            }
+            EXPECT_TRUE(fabs(total - 1.0) < 1e-5);
+        }
+    }
+}
+
+TEST_CASE("DownsampleSize")
+{
+    const uint32_t sizes[][2] = { { 7, 5 }, { 13, 7 }, { 12, 10 }, { 1, 9 }, { 15, 1 }, { 3, 3 }, { 1, 1 } };
+    const ETextureMipFilter filters[] = { ETextureMipFilter::BOX, ETextureMipFilter::KAISER };
+    for (const auto filter : filters)
+    {
+        for (const auto& size : sizes)
+        {
+            STextureMip mip = make_mip(size[0], size[1], 4, 0.25f), next;
+            const uint32_t mips_count = Util_MipCount(size[0], size[1]);
+            for (uint32_t level = 1; level < mips_count; ++level)
+            {
+                Util_Downsample(mip, next, filter);
+                eastl::swap(mip, next);
+                EXPECT_EQ(mip.width, eastl::max(size[0] >> level, 1u));
+                EXPECT_EQ(mip.height, eastl::max(size[1] >> level, 1u));
+                EXPECT_EQ(mip.channels, 4);
+                REQUIRE(mip.pixels.size() == (size_t)mip.width * mip.height * 4);
+                // normalized filters keep a flat image flat
+                for (const auto pixel : mip.pixels)
+                    EXPECT_TRUE(fabsf(pixel - 0.25f) < 1e-4f);
+            }
+            EXPECT_EQ(mip.width, 1);
+            EXPECT_EQ(mip.height, 1);
+        }
+    }
+}
+
+TEST_CASE("BoxOddEdge")
+{
+    // the odd column pairs with itself
+    STextureMip mip = make_mip(3, 1, 1, 0.0f), next;
+    mip.pixels[0] = 0.0f;
+    mip.pixels[1] = 1.0f;
+    mip.pixels[2] = 2.0f;
+    Util_BoxDownsample(mip, next);
+    EXPECT_EQ(next.width, 1);
+    EXPECT_EQ(next.height, 1);
+    EXPECT_TRUE(fabsf(next.pixels[0] - 0.5f) < 1e-6f);
+}
+
+TEST_CASE("CompressedMipOffsets")
+{
+    const uint32_t sizes[][2] = { { 13, 7 }, { 5, 3 }, { 256, 30 }, { 1, 1 }, { 100, 29 } };
+    const ECGPUFormat formats[] = { CGPU_FORMAT_DXBC1_RGB_UNORM, CGPU_FORMAT_DXBC4_UNORM, CGPU_FORMAT_DXBC7_UNORM };
+    for (const auto format : formats)
+    {
+        for (const auto& size : sizes)
+        {
+            const uint32_t mips_count = Util_MipCount(size[0], size[1]);
+            const auto offsets = Util_DXBCMipOffsets(size[0], size[1], mips_count, format);
+            REQUIRE(offsets.size() == mips_count + 1);
+            EXPECT_EQ(offsets[0], 0);
+            // sizes of the mips the downsampler produces add up to the offsets the chain is written at
+            STextureMip mip = make_mip(size[0], size[1], 1, 0.0f), next;
+            uint64_t sum = 0;
+            for (uint32_t level = 0; level < mips_count; ++level)
+            {
+                if (level > 0)
+                {
+                    Util_BoxDownsample(mip, next);
+                    eastl::swap(mip, next);
+                }
+                EXPECT_EQ(offsets[level], sum);
+                sum += Util_DXBCCompressedSize(mip.width, mip.height, format);
+            }
+            EXPECT_EQ(offsets.back(), sum);
+        }
+    }
+    // 13x7 BC1: 4x2, 2x1, 1x1 and 1x1 blocks of 8 bytes
+    const auto offsets = Util_DXBCMipOffsets(13, 7, 4, CGPU_FORMAT_DXBC1_RGB_UNORM);
+    EXPECT_EQ(offsets[1], 64);
+    EXPECT_EQ(offsets[2], 80);
+    EXPECT_EQ(offsets[3], 88);
+    EXPECT_EQ(offsets[4], 96);
+}
+
+TEST_CASE("MipUploadLayout")
+{
+    // the upload side reads the chain the compiler writes
+    const uint32_t sizes[][2] = { { 13, 7 }, { 5, 3 }, { 6, 10 }, { 1, 1 } };
+    const ECGPUFormat formats[] = { CGPU_FORMAT_DXBC1_RGB_UNORM, CGPU_FORMAT_DXBC7_UNORM };
+    // d3d12 placement and pitch alignments, none, and a small pair that still pads the BC1 rows
+    const uint64_t alignments[][2] = { { 512, 256 }, { 1, 1 }, { 16, 4 } };
+    for (const auto format : formats)
+    {
+        for (const auto& size : sizes)
+        {
+            for (const auto& alignment : alignments)
+            {
+                const uint32_t mips_count = Util_MipCount(size[0], size[1]);
+                const auto offsets = Util_DXBCMipOffsets(size[0], size[1], mips_count, format);
+                skr::io::MipUploadLayout layouts[16] = {};
+                uint64_t upload_size = 0;
+                const auto count = skr::io::get_mip_upload_layouts(format, size[0], size[1], mips_count, offsets.back(),
+                    alignment[0], alignment[1], layouts, &upload_size);
+                REQUIRE(count == mips_count);
+                uint64_t end = 0;
+                for (uint32_t level = 0; level < count; ++level)
+                {
+                    const auto& layout = layouts[level];
+                    EXPECT_EQ(layout.src_offset, offsets[level]);
+                    EXPECT_EQ(layout.row_size * layout.rows, offsets[level + 1] - offsets[level]);
+                    EXPECT_TRUE(layout.row_pitch >= layout.row_size);
+                    EXPECT_EQ(layout.row_pitch % alignment[1], 0);
+                    EXPECT_EQ(layout.dst_offset % alignment[0], 0);
+                    // mips do not overlap in the upload buffer
+                    EXPECT_TRUE(layout.dst_offset >= end);
+                    end = layout.dst_offset + layout.row_pitch * layout.rows;
+                }
+                EXPECT_EQ(upload_size, end);
+                if (alignment[0] == 1 && alignment[1] == 1)
+                    EXPECT_EQ(upload_size, offsets.back());
+            }
+        }
+    }
+
+    SUBCASE("D3D12")
+    {
+        // 13x7 BC1: block rows of 32, 16, 8 and 8 bytes, each padded to 256 and placed on 512
+        skr::io::MipUploadLayout layouts[4] = {};
+        uint64_t upload_size = 0;
+        REQUIRE(skr::io::get_mip_upload_layouts(CGPU_FORMAT_DXBC1_RGB_UNORM, 13, 7, 4, 96, 512, 256, layouts, &upload_size) == 4);
+        EXPECT_EQ(layouts[0].row_size, 32);
+        EXPECT_EQ(layouts[0].rows, 2);
+        EXPECT_EQ(layouts[0].row_pitch, 256);
+        EXPECT_EQ(layouts[1].dst_offset, 512);
+        EXPECT_EQ(layouts[1].row_size, 16);
+        EXPECT_EQ(layouts[1].rows, 1);
+        EXPECT_EQ(layouts[2].dst_offset, 1024);
+        EXPECT_EQ(layouts[3].dst_offset, 1536);
+        EXPECT_EQ(layouts[3].src_offset, 88);
+        EXPECT_EQ(upload_size, 1792);
+    }
+    SUBCASE("FewerMips")
+    {
+        // a file holding the two largest mips uploads those
+        skr::io::MipUploadLayout layouts[4] = {};
+        uint64_t upload_size = 0;
+        EXPECT_EQ(skr::io::get_mip_upload_layouts(CGPU_FORMAT_DXBC1_RGB_UNORM, 13, 7, 4, 87, 1, 1, layouts, &upload_size), 2);
+        EXPECT_EQ(upload_size, 80);
+        EXPECT_EQ(skr::io::get_mip_upload_layouts(CGPU_FORMAT_DXBC1_RGB_UNORM, 13, 7, 4, 0, 1, 1, layouts, &upload_size), 0);
+        EXPECT_EQ(upload_size, 0);
+    }
+}
@@ -0,0 +1,25 @@
+target("ShaderCompilerTest")
+    set_group("05.tests/tools")
+    set_kind("binary")
+    public_dependency("SkrRT", engine_version)
+    public_dependency("SkrShaderCompiler", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    add_files("shader_compiler/main.cpp")
+
+target("CookDatabaseTest")
+    set_group("05.tests/tools")
+    set_kind("binary")
+    public_dependency("SkrRT", engine_version)
+    public_dependency("SkrToolCore", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    add_files("cook_database/main.cpp")
+
+target("TextureCompilerTest")
+    set_group("05.tests/tools")
+    set_kind("binary")
+    public_dependency("SkrRT", engine_version)
+    public_dependency("SkrTextureCompiler", engine_version)
+    add_deps("SkrTestFramework", {public = false})
+    -- the mip and block helpers are private headers of the compiler
+    add_includedirs("$(projectdir)/tools/texture_compiler/src", {public = false})
+    add_files("texture_compiler/main.cpp")
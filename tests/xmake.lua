@@ -10,4 +10,5 @@ target("SkrTestFramework")
 includes("cgpu/xmake.lua")
 includes("runtime/xmake.lua")
 includes("async/xmake.lua")
-includes("base/xmake.lua")
\ No newline at end of file
+includes("base/xmake.lua")
+includes("tools/xmake.lua")
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "SkrRT/platform/vfs.h"
+#include "SkrRT/platform/pak_vfs.h"
 #include "SkrRT/platform/filesystem.hpp"
 #include "SkrRT/misc/defer.hpp"
 #include "SkrRT/misc/opt.hpp"
@@ -81,17 +82,20 @@ void DestroyResourceSystem(skd::SProject& proj)
     SkrDelete(registry);
 }
 
-skr::vector<skd::SProject*> open_projects(int argc, char** argv)
+skr::vector<skd::SProject*> open_projects(int argc, char** argv, skr::string& pakName)
 {
     skr::cmd::parser parser(argc, argv);
     parser.add(u8"project", u8"project path", u8"-p", false);
     parser.add(u8"workspace", u8"workspace path", u8"-w", true);
+    parser.add(u8"pak", u8"pack cooked resources into an archive with this name", u8"-k", false);
     if(!parser.parse())
     {
         SKR_LOG_ERROR(u8"Failed to parse command line arguments.");
         return {};
     }
     auto projectPath = parser.get_optional<skr::string>(u8"project");
+    if (auto pak = parser.get_optional<skr::string>(u8"pak"))
+        pakName = *pak;
 
     std::error_code ec = {};
     skr::filesystem::path workspace{parser.get<skr::string>(u8"workspace").u8_str()};
@@ -175,6 +179,43 @@ int compile_project(skd::SProject* project)
     return 0;
 }
 
+int pack_project(skd::SProject* project, const skr::string& pakName)
+{
+    SkrZoneScopedN("Pack");
+    std::error_code ec = {};
+    // archives are told apart from cooked files by their extension, so a name without one gets it
+    auto archivePath = skr::filesystem::path(pakName.u8_str());
+    if (archivePath.extension() != ".pak")
+        archivePath += ".pak";
+    const skr::string archiveName = archivePath.generic_u8string().c_str();
+    const auto outputPath = project->GetOutputPath();
+    skr::filesystem::recursive_directory_iterator iter(outputPath, ec);
+    //----- collect cooked files, sorted so headers & blobs of one resource stay adjacent
+    eastl::vector<skr::filesystem::path> entries;
+    while (iter != end(iter))
+    {
+        if (iter->is_regular_file(ec) && iter->path().extension() != ".pak")
+            entries.push_back(skr::filesystem::relative(iter->path(), outputPath, ec));
+        iter.increment(ec);
+    }
+    eastl::sort(entries.begin(), entries.end());
+    //----- write archive into the output directory
+    auto writer = skr_create_pak_writer(SKR_PAK_DEFAULT_ALIGNMENT);
+    SKR_DEFER({ skr_free_pak_writer(writer); });
+    for (const auto& entry : entries)
+    {
+        const auto entryPath = entry.generic_u8string();
+        skr_pak_writer_add_file(writer, entryPath.c_str(), project->resource_vfs, entryPath.c_str());
+    }
+    if (!skr_pak_writer_write(writer, project->resource_vfs, archiveName.u8_str()))
+    {
+        SKR_LOG_FMT_ERROR(u8"Failed to write pak archive {}", archiveName);
+        return 1;
+    }
+    SKR_LOG_FMT_INFO(u8"Packed {} cooked files into {}", entries.size(), archiveName);
+    return 0;
+}
+
 int compile_all(int argc, char** argv)
 {
     skr_log_set_level(SKR_LOG_LEVEL_INFO);
@@ -185,13 +226,18 @@ int compile_all(int argc, char** argv)
     auto& system = *skd::asset::GetCookSystem();
     system.Initialize();
     //----- register project
-    auto projects = open_projects(argc, argv);
+    skr::string pakName;
+    auto projects = open_projects(argc, argv, pakName);
     SKR_DEFER({ 
         for(auto& project : projects)
             SkrDelete(project); 
     });
     for(auto& project : projects)
+    {
         compile_project(project);
+        if (!pakName.is_empty())
+            pack_project(project, pakName);
+    }
     
     scheduler.unbind();
     system.Shutdown();
@@ -4,6 +4,8 @@
 #include "SkrRT/platform/shared_library.hpp"
 
 #include <EASTL/string.h>
+#include <EASTL/string_view.h>
+#include <EASTL/vector.h>
 
 #include "SkrRenderer/resources/shader_resource.hpp"
 #ifndef __meta__
@@ -73,10 +75,15 @@ public:
     
     ICompiledShader* Compile(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer) SKR_NOEXCEPT override;
     void FreeCompileResult(ICompiledShader* compiled) SKR_NOEXCEPT override;
+    bool GetCacheKey(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer, skr_md5_t* out_key) SKR_NOEXCEPT override;
+    // md5 of the compiler version, the target format, the compile arguments and the preprocessed source
+    static void ComposeCacheKey(const skr::string& version, ECGPUShaderBytecodeType format, const eastl::vector<eastl::wstring>& args, eastl::string_view preprocessed, skr_md5_t* out_key) SKR_NOEXCEPT;
 
     void SetIncludeHandler(IDxcIncludeHandler* includeHandler) SKR_NOEXCEPT;
 
 protected:
+    IDxcBlobEncoding* createSourceBlob(const ShaderSourceCode& source) SKR_NOEXCEPT;
+    void createCompileArgs(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer, eastl::vector<eastl::wstring>& outArgs) SKR_NOEXCEPT;
     void createDefArgsFromOptions(skr::span<skr_shader_option_template_t> opt_defs, skr::span<skr_shader_option_instance_t> options, eastl::vector<eastl::wstring>& def_args) SKR_NOEXCEPT;
 
     IDxcUtils* utils = nullptr;
@@ -102,6 +109,8 @@ public:
     static void LoadDXCLibrary() SKR_NOEXCEPT;
     static void LoadDXILLibrary() SKR_NOEXCEPT;
     static void UnloadLibraries() SKR_NOEXCEPT;
+    // version and commit of the loaded dxc, empty if unknown
+    static const skr::string& GetCompilerVersion() SKR_NOEXCEPT;
 
     virtual void Initialize() override;
     virtual void Finalize() override;
@@ -110,6 +119,7 @@ protected:
     skr::SharedLibrary dxc_library;
     skr::SharedLibrary dxil_library;
     void* pDxcCreateInstance = nullptr; 
+    skr::string compiler_version;
 };
 } // namespace asset
 } // namespace skd
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include "SkrShaderCompiler/module.configure.h"
+#include "SkrRT/platform/configure.h"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/containers/span.hpp"
+#include "SkrRT/containers/function_ref.hpp"
+#include "SkrRT/misc/types.h"
+#include "cgpu/flags.h"
+#include <atomic>
+
+struct SLightningEnvironment;
+struct SLightningStorage;
+
+namespace skd
+{
+namespace asset
+{
+// compiled shaders keyed by a hash of everything that affects a compilation: preprocessed source, arguments,
+// target profile and compiler version (see IShaderCompiler::GetCacheKey). entries live in a lightning storage,
+// cook processes opening the same directory share them. the map grows when a store does not fit, past
+// kMaxMapSize the whole cache is dropped instead
+struct SKR_SHADER_COMPILER_API SShaderCache
+{
+    struct Entry
+    {
+        ECGPUShaderStage shader_stage = CGPU_SHADER_STAGE_NONE;
+        uint32_t hash_flags = 0;
+        uint32_t encoded_digits[4] = { 0, 0, 0, 0 };
+        skr::span<const uint8_t> bytecode;
+        skr::span<const uint8_t> pdb;
+    };
+
+    struct Statistics
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t bytes_read = 0;
+        uint64_t bytes_written = 0;
+    };
+
+    static constexpr uint64_t kMaxMapSize = (sizeof(void*) == 8) ? (uint64_t(64) << 30) : (uint64_t(1) << 30);
+
+    static SShaderCache* Get() SKR_NOEXCEPT;
+
+    // does nothing if the cache is open already
+    bool Open(const skr::filesystem::path& directory) SKR_NOEXCEPT;
+    void Close() SKR_NOEXCEPT;
+    bool IsOpen() const SKR_NOEXCEPT { return storage != nullptr; }
+
+    // calls f with the cached entry of key, the spans of the entry point into the storage and are only valid in f
+    bool Find(const skr_md5_t& key, skr::function_ref<void(const Entry&)> f) SKR_NOEXCEPT;
+    bool Store(const skr_md5_t& key, const Entry& entry) SKR_NOEXCEPT;
+
+    Statistics GetStatistics() const SKR_NOEXCEPT;
+
+    SShaderCache() SKR_NOEXCEPT;
+    ~SShaderCache() SKR_NOEXCEPT;
+
+protected:
+    // grows the map to fit size more bytes or drops every entry, called after a failed store
+    bool makeRoom(uint64_t size) SKR_NOEXCEPT;
+
+    SMutexObject open_mutex;
+    // transactions hold it shared, resizing the map and dropping the entries need it exclusive
+    SRWMutex txn_mutex;
+    SLightningEnvironment* environment = nullptr;
+    SLightningStorage* storage = nullptr;
+
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<uint64_t> misses = 0;
+    std::atomic<uint64_t> stores = 0;
+    std::atomic<uint64_t> bytes_read = 0;
+    std::atomic<uint64_t> bytes_written = 0;
+};
+} // namespace asset
+} // namespace skd
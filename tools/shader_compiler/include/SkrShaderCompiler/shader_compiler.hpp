@@ -5,6 +5,7 @@
 #include "SkrRT/containers/sptr.hpp"
 #include "SkrRT/containers/span.hpp"
 #include "SkrRT/containers/string.hpp"
+#include "SkrRT/misc/types.h"
 #include <EASTL/functional.h>
 #ifndef __meta__
 #include "SkrShaderCompiler/shader_compiler.generated.h" // IWYU pragma: export
@@ -30,7 +31,7 @@ EShaderSourceType : uint32_t
     COUNT
 };
 
-struct ShaderSourceCode
+struct SKR_SHADER_COMPILER_API ShaderSourceCode
 {
     inline ShaderSourceCode(skr::BlobId blob, const char8_t* name, EShaderSourceType type) SKR_NOEXCEPT
         : blob(blob), source_name(name), source_type(type) {}
@@ -61,6 +62,8 @@ struct SKR_SHADER_COMPILER_API IShaderCompiler
     virtual void SetShaderOptions(skr::span<skr_shader_option_template_t> opt_defs, skr::span<skr_shader_option_instance_t> options, const skr_stable_shader_hash_t& hash) SKR_NOEXCEPT = 0;
     virtual ICompiledShader* Compile(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer) SKR_NOEXCEPT = 0;
     virtual void FreeCompileResult(ICompiledShader* compiled) SKR_NOEXCEPT = 0;
+    // hash of everything the result of Compile() depends on, keys entries of SShaderCache. false if the compiler can not tell
+    virtual bool GetCacheKey(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer, skr_md5_t* out_key) SKR_NOEXCEPT { return false; }
 };
 
 IShaderCompiler* SkrShaderCompiler_CreateByType(EShaderSourceType type) SKR_NOEXCEPT;
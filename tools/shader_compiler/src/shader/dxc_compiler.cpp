@@ -374,25 +374,22 @@ void SDXCCompiler::createDefArgsFromOptions(skr::span<skr_shader_option_template
     }
 }
 
-ICompiledShader* SDXCCompiler::Compile(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer) SKR_NOEXCEPT
+IDxcBlobEncoding* SDXCCompiler::createSourceBlob(const ShaderSourceCode& source) SKR_NOEXCEPT
 {
     IDxcBlobEncoding* pSourceBlob = nullptr;
-    IDxcResult* pDxcResult = nullptr;
     if (auto hr = utils->CreateBlobFromPinned(source.blob->get_data(), (uint32_t)source.blob->get_size(), DXC_CP_ACP, &pSourceBlob);!SUCCEEDED(hr))
     {
         SKR_LOG_ERROR(u8"DXC Compiler: Failed to create blob from pinned memory, HRESULT: %u!", hr);
     }
-    DxcBuffer SourceBuffer;
-    SourceBuffer.Ptr = pSourceBlob->GetBufferPointer();
-    SourceBuffer.Size = pSourceBlob->GetBufferSize();
-    SourceBuffer.Encoding = DXC_CP_ACP; // Assume BOM says UTF8 or UTF16 or this is ANSI text.
-    
+    return pSourceBlob;
+}
+
+void SDXCCompiler::createCompileArgs(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer, eastl::vector<eastl::wstring>& allArgs) SKR_NOEXCEPT
+{
     // calculate compile arguments
     const auto wTargetString = utf8_to_utf16(importer.target);
     const auto wEntryString = utf8_to_utf16(importer.entry);
     const auto wNameString = utf8_to_utf16(source.source_name);
-    const auto shader_stage = getShaderStageFromTargetString(importer.target.c_str());
-    eastl::vector<eastl::wstring> allArgs;
     allArgs.emplace_back(wNameString.c_str());
     if (format == CGPU_SHADER_BYTECODE_TYPE_DXIL)
     {
@@ -421,6 +418,20 @@ ICompiledShader* SDXCCompiler::Compile(ECGPUShaderBytecodeType format, const Sha
 
     createDefArgsFromOptions(switch_defs, switches, allArgs);
     createDefArgsFromOptions(option_defs, options, allArgs);
+}
+
+ICompiledShader* SDXCCompiler::Compile(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer) SKR_NOEXCEPT
+{
+    IDxcBlobEncoding* pSourceBlob = createSourceBlob(source);
+    IDxcResult* pDxcResult = nullptr;
+    DxcBuffer SourceBuffer;
+    SourceBuffer.Ptr = pSourceBlob->GetBufferPointer();
+    SourceBuffer.Size = pSourceBlob->GetBufferSize();
+    SourceBuffer.Encoding = DXC_CP_ACP; // Assume BOM says UTF8 or UTF16 or this is ANSI text.
+    
+    const auto shader_stage = getShaderStageFromTargetString(importer.target.c_str());
+    eastl::vector<eastl::wstring> allArgs;
+    createCompileArgs(format, source, importer, allArgs);
 
 #ifdef SKR_PROFILE_ENABLE
     eastl::wstring wArgsString;
@@ -462,6 +473,62 @@ ICompiledShader* SDXCCompiler::Compile(ECGPUShaderBytecodeType format, const Sha
     return SDXCCompiledShader::Create(shader_stage, format, pSourceBlob, pDxcResult);
 }
 
+// md5 of the compiler version, the arguments and the preprocessed source. includes are expanded by the
+// preprocessor, so edits to included files change the key as well
+bool SDXCCompiler::GetCacheKey(ECGPUShaderBytecodeType format, const ShaderSourceCode& source, const SShaderImporter& importer, skr_md5_t* out_key) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("DXCCompiler::GetCacheKey");
+    const auto& version = SDXCLibrary::GetCompilerVersion();
+    if (version.is_empty()) return false;
+
+    IDxcBlobEncoding* pSourceBlob = createSourceBlob(source);
+    if (!pSourceBlob) return false;
+    SKR_DEFER({ pSourceBlob->Release(); });
+    DxcBuffer SourceBuffer;
+    SourceBuffer.Ptr = pSourceBlob->GetBufferPointer();
+    SourceBuffer.Size = pSourceBlob->GetBufferSize();
+    SourceBuffer.Encoding = DXC_CP_ACP;
+
+    eastl::vector<eastl::wstring> allArgs;
+    createCompileArgs(format, source, importer, allArgs);
+    eastl::vector<LPCWSTR> pszArgs;
+    pszArgs.reserve(allArgs.size() + 1);
+    for (auto& arg : allArgs)
+    {
+        pszArgs.emplace_back(arg.c_str());
+    }
+    pszArgs.emplace_back(L"-P");
+
+    IDxcResult* pDxcResult = nullptr;
+    IDxcBlobUtf8* pPreprocessed = nullptr;
+    SKR_DEFER({ SAFE_RELEASE(pPreprocessed); SAFE_RELEASE(pDxcResult); });
+    HRESULT status = E_FAIL;
+    if (!SUCCEEDED(compiler->Compile(&SourceBuffer, pszArgs.data(), (UINT32)pszArgs.size(), includeHandler, IID_PPV_ARGS(&pDxcResult))) ||
+        !SUCCEEDED(pDxcResult->GetStatus(&status)) || !SUCCEEDED(status) ||
+        !SUCCEEDED(pDxcResult->GetOutput(DXC_OUT_HLSL, IID_PPV_ARGS(&pPreprocessed), nullptr)) || !pPreprocessed)
+    {
+        // the compilation reports the errors
+        return false;
+    }
+
+    ComposeCacheKey(version, format, allArgs, { pPreprocessed->GetStringPointer(), pPreprocessed->GetStringLength() }, out_key);
+    return true;
+}
+
+void SDXCCompiler::ComposeCacheKey(const skr::string& version, ECGPUShaderBytecodeType format, const eastl::vector<eastl::wstring>& args, eastl::string_view preprocessed, skr_md5_t* out_key) SKR_NOEXCEPT
+{
+    eastl::string keyData;
+    keyData.reserve(preprocessed.size() + 1024);
+    keyData.append(version.c_str()).push_back('\0');
+    keyData.append((const char*)&format, sizeof(format));
+    for (auto&& arg : args)
+    {
+        keyData.append((const char*)arg.data(), arg.size() * sizeof(wchar_t)).push_back('\0');
+    }
+    keyData.append(preprocessed.data(), preprocessed.size());
+    skr_make_md5((const char8_t*)keyData.data(), (uint32_t)keyData.size(), out_key);
+}
+
 void SDXCCompiler::FreeCompileResult(ICompiledShader* compiled) SKR_NOEXCEPT { SkrDelete(compiled); } 
 
 void SDXCCompiler::SetIncludeHandler(IDxcIncludeHandler* handler) SKR_NOEXCEPT
@@ -505,6 +572,28 @@ void SDXCLibrary::LoadDXCLibrary() SKR_NOEXCEPT
     pTestUtils->CreateDefaultIncludeHandler(&pIncludeHandler);
     SKR_ASSERT(pTestUtils && "Fatal: Failed to create default include handler for dxc!");
 
+    // versions key the shader cache, results of other dxc builds are never reused
+    IDxcVersionInfo* pVersionInfo = nullptr;
+    if (SUCCEEDED(pTestCompiler->QueryInterface(IID_PPV_ARGS(&pVersionInfo))))
+    {
+        UINT32 major = 0, minor = 0;
+        pVersionInfo->GetVersion(&major, &minor);
+        dxcInstance->compiler_version = skr::format(u8"dxc-{}.{}", major, minor);
+        IDxcVersionInfo2* pVersionInfo2 = nullptr;
+        if (SUCCEEDED(pVersionInfo->QueryInterface(IID_PPV_ARGS(&pVersionInfo2))))
+        {
+            UINT32 commitCount = 0;
+            char* commitHash = nullptr;
+            if (SUCCEEDED(pVersionInfo2->GetCommitInfo(&commitCount, &commitHash)) && commitHash)
+            {
+                dxcInstance->compiler_version += skr::format(u8"-{}-{}", commitCount, (const char8_t*)commitHash);
+                CoTaskMemFree(commitHash);
+            }
+            pVersionInfo2->Release();
+        }
+        pVersionInfo->Release();
+    }
+
     pIncludeHandler->Release();
     pTestUtils->Release();
     pTestCompiler->Release();
@@ -522,9 +611,17 @@ void SDXCLibrary::LoadDXILLibrary() SKR_NOEXCEPT
     {
         SKR_LOG_ERROR(u8"failed to load dxil library!"
         "no correct signature will be assigned to the dxil files that shaders will be rejected by runtime driver!");
+        // unsigned dxil must not be shared with cooks that sign it
+        if (!dxcInstance->compiler_version.is_empty())
+            dxcInstance->compiler_version += u8"-unsigned";
     }
 }
 
+const skr::string& SDXCLibrary::GetCompilerVersion() SKR_NOEXCEPT
+{
+    return SDXCLibrary::Get()->compiler_version;
+}
+
 void SDXCLibrary::UnloadLibraries() SKR_NOEXCEPT
 {
     auto dxcInstance = SDXCLibrary::Get();
@@ -5,6 +5,7 @@
 #include "SkrRenderer/resources/shader_resource.hpp"
 #include "SkrShaderCompiler/assets/shader_asset.hpp"
 #include "SkrShaderCompiler/shader_compiler.hpp"
+#include "SkrShaderCompiler/shader_cache.hpp"
 
 #include <EASTL/array.h>
 
@@ -105,6 +106,8 @@ bool SShaderCooker::Cook(SCookContext* ctx)
 
     const auto outputPath = ctx->GetOutputPath();
     const auto assetRecord = ctx->GetAssetRecord();
+    // shared by the shader cooks of every process cooking the project
+    SShaderCache::Get()->Open(assetRecord->project->GetArtifactsPath() / "shader_cache");
     auto source_code = ctx->Import<ShaderSourceCode>();
     SKR_DEFER({ ctx->Destroy(source_code); });
     // Calculate all macro combines (shader variants)
@@ -182,17 +185,8 @@ bool SShaderCooker::Cook(SCookContext* ctx)
                 {
                     auto& identifier = outResource.option_variants[dyn_hash][fmtIndex];
                     auto& stage = identifier.shader_stage;
-                    // compile & write bytecode to disk
-                    const auto* shaderImporter = static_cast<SShaderImporter*>(ctx->GetImporter());
-                    compiler->SetShaderSwitches(flat_static_options, static_variants[static_varidx], static_stable_hashes[static_varidx]);
-                    compiler->SetShaderOptions(flat_dynamic_options, dynamic_variants[dynamic_varidx], dynamic_stable_hashes[dynamic_varidx]);
-                    auto compiled = compiler->Compile(format, *source_code, *shaderImporter);
-                    stage = compiled->GetShaderStage();
-                    auto bytes = compiled->GetBytecode();
-                    auto hashed = compiled->GetHashCode(&identifier.hash.flags, identifier.hash.encoded_digits);
-                    if (hashed && !bytes.empty())
-                    {
-                        // wirte bytecode to disk
+                    // write bytecode to disk
+                    auto writeCompiled = [&](skr::span<const uint8_t> bytes, skr::span<const uint8_t> pdb) {
                         const auto subdir = CGPUShaderBytecodeTypeNames[format];
                         auto basePath = outputPath.parent_path() / subdir;
                         const auto fname = skr::format(u8"{}#{}-{}-{}-{}",
@@ -217,7 +211,7 @@ bool SShaderCooker::Cook(SCookContext* ctx)
                             }
                         }
                         // write pdb to file
-                        if (auto pdb = compiled->GetPDB(); !pdb.empty())
+                        if (!pdb.empty())
                         {
                             auto pdbPath = basePath / skr::format(u8"{}.pdb", fname).c_str();
                             {
@@ -232,12 +226,49 @@ bool SShaderCooker::Cook(SCookContext* ctx)
                                 fwrite(pdb.data(), pdb.size(), 1, pdb_file);
                             }
                         }
-                    }
-                    else
+                    };
+                    const auto* shaderImporter = static_cast<SShaderImporter*>(ctx->GetImporter());
+                    compiler->SetShaderSwitches(flat_static_options, static_variants[static_varidx], static_stable_hashes[static_varidx]);
+                    compiler->SetShaderOptions(flat_dynamic_options, dynamic_variants[dynamic_varidx], dynamic_stable_hashes[dynamic_varidx]);
+                    // reuse the bytecode of an identical compilation, cooked before by any process sharing the cache
+                    auto cache = SShaderCache::Get();
+                    skr_md5_t cacheKey = {};
+                    const bool cacheable = cache->IsOpen() && compiler->GetCacheKey(format, *source_code, *shaderImporter, &cacheKey);
+                    const bool cached = cacheable && cache->Find(cacheKey, [&](const SShaderCache::Entry& entry) {
+                        stage = entry.shader_stage;
+                        identifier.hash.flags = entry.hash_flags;
+                        for (uint32_t i = 0; i < 4; i++)
+                            identifier.hash.encoded_digits[i] = entry.encoded_digits[i];
+                        writeCompiled(entry.bytecode, entry.pdb);
+                    });
+                    if (!cached)
                     {
-                        SKR_UNREACHABLE_CODE();
+                        // compile & write bytecode to disk
+                        auto compiled = compiler->Compile(format, *source_code, *shaderImporter);
+                        stage = compiled->GetShaderStage();
+                        auto bytes = compiled->GetBytecode();
+                        auto hashed = compiled->GetHashCode(&identifier.hash.flags, identifier.hash.encoded_digits);
+                        if (hashed && !bytes.empty())
+                        {
+                            writeCompiled(bytes, compiled->GetPDB());
+                            if (cacheable)
+                            {
+                                SShaderCache::Entry entry = {};
+                                entry.shader_stage = stage;
+                                entry.hash_flags = identifier.hash.flags;
+                                for (uint32_t i = 0; i < 4; i++)
+                                    entry.encoded_digits[i] = identifier.hash.encoded_digits[i];
+                                entry.bytecode = bytes;
+                                entry.pdb = compiled->GetPDB();
+                                cache->Store(cacheKey, entry);
+                            }
+                        }
+                        else
+                        {
+                            SKR_UNREACHABLE_CODE();
+                        }
+                        compiler->FreeCompileResult(compiled);
                     }
-                    compiler->FreeCompileResult(compiled);
                     // fill platform identifier
                     identifier.bytecode_type = format;
                 }
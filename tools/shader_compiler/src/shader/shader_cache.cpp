@@ -0,0 +1,214 @@
+#include "SkrShaderCompiler/shader_cache.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/misc/log.hpp"
+#include "SkrRT/misc/defer.hpp"
+#include "lightning_storage/storage.h"
+#include "lightning_storage/transaction.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/algorithm.h>
+#include <string.h>
+
+#include "SkrProfile/profile.h"
+
+namespace skd
+{
+namespace asset
+{
+// layout of a cached value, followed by the bytecode and the pdb. bump the version when it changes
+struct ShaderCacheEntryHeader
+{
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t version;
+    uint32_t shader_stage;
+    uint32_t hash_flags;
+    uint32_t encoded_digits[4];
+    uint32_t bytecode_size;
+    uint32_t pdb_size;
+};
+
+SShaderCache* SShaderCache::Get() SKR_NOEXCEPT
+{
+    static eastl::unique_ptr<SShaderCache> _this = eastl::make_unique<SShaderCache>();
+    return _this.get();
+}
+
+SShaderCache::SShaderCache() SKR_NOEXCEPT
+{
+    skr_init_rw_mutex(&txn_mutex);
+}
+
+SShaderCache::~SShaderCache() SKR_NOEXCEPT
+{
+    Close();
+    skr_destroy_rw_mutex(&txn_mutex);
+}
+
+bool SShaderCache::Open(const skr::filesystem::path& directory) SKR_NOEXCEPT
+{
+    SMutexLock lock(open_mutex.mMutex);
+    if (storage) return true;
+
+    SkrZoneScopedN("ShaderCache::Open");
+    environment = skr_lightning_storage_create_environment(directory.string().c_str());
+    if (!environment)
+    {
+        SKR_LOG_ERROR(u8"[ShaderCache] failed to open shader cache at %s, shaders are compiled without it", directory.string().c_str());
+        return false;
+    }
+    SLightningStorageOpenDescriptor desc = {};
+    desc.name = "shaders";
+    desc.flags = LIGHTNING_STORAGE_OPEN_CREATE;
+    storage = skr_open_lightning_storage(environment, &desc);
+    if (!storage)
+    {
+        skr_lightning_storage_free_environment(environment);
+        environment = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void SShaderCache::Close() SKR_NOEXCEPT
+{
+    SMutexLock lock(open_mutex.mMutex);
+    if (!storage) return;
+
+    const auto statistics = GetStatistics();
+    SKR_LOG_FMT_INFO(u8"[ShaderCache] {} hits, {} misses, {} stores, {} KiB read, {} KiB written",
+        statistics.hits, statistics.misses, statistics.stores, statistics.bytes_read / 1024, statistics.bytes_written / 1024);
+    skr_rw_mutex_acquire_w(&txn_mutex);
+    SKR_DEFER({ skr_rw_mutex_release_w(&txn_mutex); });
+    skr_close_lightning_storage(storage);
+    skr_lightning_storage_free_environment(environment);
+    storage = nullptr;
+    environment = nullptr;
+}
+
+bool SShaderCache::Find(const skr_md5_t& key, skr::function_ref<void(const Entry&)> f) SKR_NOEXCEPT
+{
+    if (!storage) return false;
+
+    SkrZoneScopedN("ShaderCache::Find");
+    skr_rw_mutex_acquire_r(&txn_mutex);
+    SKR_DEFER({ skr_rw_mutex_release_r(&txn_mutex); });
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+    if (!txn) return false;
+    SKR_DEFER({ skr_lightning_storage_abort_transaction(txn); });
+
+    const SLightningValue mkey = { key.digest, sizeof(key.digest) };
+    SLightningValue value = {};
+    ShaderCacheEntryHeader header = {};
+    bool found = skr_lightning_storage_get(txn, storage, &mkey, &value) && (value.size >= sizeof(header));
+    if (found)
+    {
+        memcpy(&header, value.data, sizeof(header));
+        found = (header.version == ShaderCacheEntryHeader::kVersion) &&
+                (value.size == sizeof(header) + (uint64_t)header.bytecode_size + header.pdb_size);
+    }
+    if (!found)
+    {
+        misses++;
+        return false;
+    }
+    const auto bytes = (const uint8_t*)value.data + sizeof(header);
+    Entry entry = {};
+    entry.shader_stage = (ECGPUShaderStage)header.shader_stage;
+    entry.hash_flags = header.hash_flags;
+    memcpy(entry.encoded_digits, header.encoded_digits, sizeof(entry.encoded_digits));
+    entry.bytecode = skr::span<const uint8_t>(bytes, header.bytecode_size);
+    entry.pdb = skr::span<const uint8_t>(bytes + header.bytecode_size, header.pdb_size);
+    f(entry);
+    hits++;
+    bytes_read += value.size;
+    return true;
+}
+
+bool SShaderCache::Store(const skr_md5_t& key, const Entry& entry) SKR_NOEXCEPT
+{
+    if (!storage) return false;
+
+    SkrZoneScopedN("ShaderCache::Store");
+    ShaderCacheEntryHeader header = {};
+    header.version = ShaderCacheEntryHeader::kVersion;
+    header.shader_stage = (uint32_t)entry.shader_stage;
+    header.hash_flags = entry.hash_flags;
+    memcpy(header.encoded_digits, entry.encoded_digits, sizeof(header.encoded_digits));
+    header.bytecode_size = (uint32_t)entry.bytecode.size();
+    header.pdb_size = (uint32_t)entry.pdb.size();
+    // staged outside of the write transaction, it blocks other writers of every cook process
+    skr::vector<uint8_t> buffer(sizeof(header) + entry.bytecode.size() + entry.pdb.size());
+    memcpy(buffer.data(), &header, sizeof(header));
+    if (!entry.bytecode.empty())
+        memcpy(buffer.data() + sizeof(header), entry.bytecode.data(), entry.bytecode.size());
+    if (!entry.pdb.empty())
+        memcpy(buffer.data() + sizeof(header) + entry.bytecode.size(), entry.pdb.data(), entry.pdb.size());
+
+    const SLightningValue mkey = { key.digest, sizeof(key.digest) };
+    const SLightningValue value = { buffer.data(), buffer.size() };
+    auto put = [&]() {
+        skr_rw_mutex_acquire_r(&txn_mutex);
+        SKR_DEFER({ skr_rw_mutex_release_r(&txn_mutex); });
+        auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+        if (!txn) return false;
+        if (!skr_lightning_storage_put(txn, storage, &mkey, &value))
+        {
+            skr_lightning_storage_abort_transaction(txn);
+            return false;
+        }
+        return skr_lightning_storage_commit_transaction(txn);
+    };
+    // a full map fails the put or the commit, another process growing the map fails the begin
+    if (!put() && !(makeRoom(buffer.size()) && put()))
+        return false;
+    stores++;
+    bytes_written += buffer.size();
+    return true;
+}
+
+bool SShaderCache::makeRoom(uint64_t size) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("ShaderCache::MakeRoom");
+    skr_rw_mutex_acquire_w(&txn_mutex);
+    SKR_DEFER({ skr_rw_mutex_release_w(&txn_mutex); });
+    SLightningEnvironmentInfo info = {};
+    if (!skr_lightning_storage_get_environment_info(environment, &info))
+        return false;
+    // copy-on-write touches a branch page per level besides the value pages, keep a margin for them
+    const uint64_t needed = info.used_size + 2 * size + (uint64_t(1) << 20);
+    if (needed <= info.map_size)
+    {
+        // the map is not full here, another process grew it and this one adopts its size
+        return skr_lightning_storage_set_map_size(environment, 0);
+    }
+    const uint64_t map_size = eastl::max(info.map_size * 2, needed);
+    if (map_size <= kMaxMapSize)
+    {
+        SKR_LOG_FMT_INFO(u8"[ShaderCache] growing the map from {} MiB to {} MiB", info.map_size >> 20, map_size >> 20);
+        return skr_lightning_storage_set_map_size(environment, map_size);
+    }
+    // at the cap, entries are cheaper to recompile than to track by age. the dropped pages are reused by later stores
+    SKR_LOG_FMT_WARN(u8"[ShaderCache] cache reached {} MiB, dropping every entry", info.map_size >> 20);
+    SLightningStorageOpenDescriptor desc = {};
+    desc.name = "shaders";
+    desc.flags = LIGHTNING_STORAGE_OPEN_CREATE | LIGHTNING_STORAGE_OPEN_TRUNCATE;
+    auto truncated = skr_open_lightning_storage(environment, &desc);
+    if (!truncated) return false;
+    skr_close_lightning_storage(storage);
+    storage = truncated;
+    return true;
+}
+
+SShaderCache::Statistics SShaderCache::GetStatistics() const SKR_NOEXCEPT
+{
+    Statistics statistics = {};
+    statistics.hits = hits.load();
+    statistics.misses = misses.load();
+    statistics.stores = stores.load();
+    statistics.bytes_read = bytes_read.load();
+    statistics.bytes_written = bytes_written.load();
+    return statistics;
+}
+} // namespace asset
+} // namespace skd
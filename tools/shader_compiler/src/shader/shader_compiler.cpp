@@ -3,6 +3,7 @@
 
 #include "SkrShaderCompiler/module.configure.h"
 #include "SkrShaderCompiler/shader_compiler.hpp"
+#include "SkrShaderCompiler/shader_cache.hpp"
 
 namespace skd
 {
@@ -26,6 +27,7 @@ struct SKR_SHADER_COMPILER_API SShaderCompilerModule : public skr::IDynamicModul
             // SKR_LOG_DEBUG(u8"ShaderCompilerModule unload event %s invoked", name.c_str());
             unload_event();
         }
+        SShaderCache::Get()->Close();
     }
     
     static skr::flat_hash_map<skd::asset::EShaderSourceType, eastl::function<IShaderCompiler*()>> ctors;
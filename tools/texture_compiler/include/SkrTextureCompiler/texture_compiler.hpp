@@ -10,6 +10,39 @@ namespace skd sreflect
 {
 namespace asset sreflect
 {
+sreflect_enum_class("guid" : "3cb2048a-3fb0-4057-a3f9-3e14a9b91d56")
+sattr("serialize" : "json")
+ETextureCompression : uint32_t {
+    // BC4 for gray images, BC3 otherwise
+    AUTO,
+    BC1,
+    BC3,
+    BC4,
+    BC5,
+    BC6H,
+    BC7
+};
+
+// speed/quality tradeoff of the BC6H & BC7 encoders
+sreflect_enum_class("guid" : "1cbdbc58-68d0-4fa9-906c-a0361328ad04")
+sattr("serialize" : "json")
+ETextureCompressionQuality : uint32_t {
+    ULTRA_FAST,
+    VERY_FAST,
+    FAST,
+    BASIC,
+    SLOW,
+    VERY_SLOW
+};
+
+sreflect_enum_class("guid" : "92fa0bd4-1e54-434e-86f8-8bef1cc3e2a0")
+sattr("serialize" : "json")
+ETextureMipFilter : uint32_t {
+    BOX,
+    // windowed sinc, sharper mips for a few more taps
+    KAISER
+};
+
 sreflect_struct("guid" : "a26c2436-9e5f-43c4-b4d7-e5373d353bae")
 sattr("serialize" : "json")
 SKR_TEXTURE_COMPILER_API STextureImporter final : public SImporter
@@ -17,6 +50,13 @@ SKR_TEXTURE_COMPILER_API STextureImporter final : public SImporter
     sattr("no-default" : true)
     skr::string assetPath;
 
+    ETextureCompression compression = ETextureCompression::AUTO;
+    ETextureCompressionQuality quality = ETextureCompressionQuality::BASIC;
+    ETextureMipFilter mip_filter = ETextureMipFilter::BOX;
+    bool generate_mips = true;
+    // color data is sRGB encoded, mips are filtered in linear space and BC1/BC3/BC7 use sRGB formats
+    bool srgb = false;
+
     void* Import(skr_io_ram_service_t*, SCookContext* context) override;
     void Destroy(void* resource) override;
 }
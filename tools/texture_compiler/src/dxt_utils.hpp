@@ -2,7 +2,11 @@
 #include "SkrTextureCompiler/texture_compiler.hpp"
 #include "SkrImageCoder/skr_image_coder.h"
 #include "SkrRenderer/resources/texture_resource.h"
+#include "SkrRT/misc/parallel_algo.hpp"
+#include "SkrProfile/profile.h"
 #include "ispc/ispc_texcomp.h"
+#include "mip_utils.hpp"
+#include <string.h>
 
 #define TEX_COMPRESS_ALIGN(x, a) (((x) + ((a)-1)) & ~((a)-1))
 
@@ -25,6 +29,9 @@ inline SKR_CONSTEXPR uint64_t Util_DXBCCompressedSize(uint32_t width, uint32_t h
     case CGPU_FORMAT_DXBC4_UNORM:
     case CGPU_FORMAT_DXBC4_SNORM:
         return (blocksW * blocksH) * 8;
+    case CGPU_FORMAT_DXBC5_UNORM:
+    case CGPU_FORMAT_DXBC5_SNORM:
+        return (blocksW * blocksH) * 16;
     case CGPU_FORMAT_DXBC6H_UFLOAT:
     case CGPU_FORMAT_DXBC6H_SFLOAT:
         return (blocksW * blocksH) * 16;
@@ -36,6 +43,15 @@ inline SKR_CONSTEXPR uint64_t Util_DXBCCompressedSize(uint32_t width, uint32_t h
     }
 }
 
+// offsets of every mip of a chain stored largest first, the extra last entry is the size of the whole chain
+inline static eastl::vector<uint64_t> Util_DXBCMipOffsets(uint32_t width, uint32_t height, uint32_t mips_count, ECGPUFormat format)
+{
+    eastl::vector<uint64_t> offsets(mips_count + 1);
+    for (uint32_t level = 0; level < mips_count; ++level)
+        offsets[level + 1] = offsets[level] + Util_DXBCCompressedSize(eastl::max(width >> level, 1u), eastl::max(height >> level, 1u), format);
+    return offsets;
+}
+
 inline static skr::string Util_CompressedTypeString(ECGPUFormat format)
 {
     switch (format)
@@ -51,9 +67,12 @@ inline static skr::string Util_CompressedTypeString(ECGPUFormat format)
     case CGPU_FORMAT_DXBC4_UNORM:
     case CGPU_FORMAT_DXBC4_SNORM:
         return u8"bc4";
+    case CGPU_FORMAT_DXBC5_UNORM:
+    case CGPU_FORMAT_DXBC5_SNORM:
+        return u8"bc5";
     case CGPU_FORMAT_DXBC6H_UFLOAT:
     case CGPU_FORMAT_DXBC6H_SFLOAT:
-        return u8"bc6";
+        return u8"bc6h";
     case CGPU_FORMAT_DXBC7_UNORM:
     case CGPU_FORMAT_DXBC7_SRGB:
         return u8"bc7";
@@ -62,83 +81,331 @@ inline static skr::string Util_CompressedTypeString(ECGPUFormat format)
     }
 }
 
-inline static eastl::vector<uint8_t> Util_DXTCompressWithImageCoder(skr::ImageDecoderId decoder, ECGPUFormat compressed_format)
+inline SKR_CONSTEXPR uint32_t Util_DXBCBlockSize(ECGPUFormat format)
 {
-    // fetch RGBA data
-    const auto bit_depth = decoder->get_bit_depth();
-    const auto encoded_format = decoder->get_color_format();
-    const auto raw_format = (encoded_format == IMAGE_CODER_COLOR_FORMAT_BGRA) ? IMAGE_CODER_COLOR_FORMAT_RGBA : encoded_format;
-    bool sucess = decoder->decode(raw_format, bit_depth);
-    uint8_t* rgba_data = rgba_data = decoder->get_data();
-    uint64_t rgba_size = decoder->get_size(); (void)rgba_size;
-    if (!sucess)
+    switch (format)
     {
-        SKR_UNREACHABLE_CODE()
-        return {};
+    case CGPU_FORMAT_DXBC1_RGB_UNORM:
+    case CGPU_FORMAT_DXBC1_RGB_SRGB:
+    case CGPU_FORMAT_DXBC1_RGBA_UNORM:
+    case CGPU_FORMAT_DXBC1_RGBA_SRGB:
+    case CGPU_FORMAT_DXBC4_UNORM:
+    case CGPU_FORMAT_DXBC4_SNORM:
+        return 8;
+    default:
+        return 16;
     }
-    // compress
-    rgba_surface rgba_surface = {};
-    const auto image_width = decoder->get_width();
-    const auto image_height = decoder->get_height();
-    switch (raw_format)
+}
+
+// blocks per compression task, BC6H & BC7 blocks cost a lot more than the others
+inline SKR_CONSTEXPR uint32_t Util_DXBCTileBlocks(ECGPUFormat format)
+{
+    switch (format)
+    {
+    case CGPU_FORMAT_DXBC6H_UFLOAT:
+    case CGPU_FORMAT_DXBC6H_SFLOAT:
+    case CGPU_FORMAT_DXBC7_UNORM:
+    case CGPU_FORMAT_DXBC7_SRGB:
+        return 256;
+    default:
+        return 4096;
+    }
+}
+
+inline static ECGPUFormat Util_CompressedFormat(skd::asset::ETextureCompression compression, EImageCoderColorFormat color_format, bool srgb)
+{
+    using namespace skd::asset;
+    switch (compression)
+    {
+    case ETextureCompression::BC1:
+        return srgb ? CGPU_FORMAT_DXBC1_RGB_SRGB : CGPU_FORMAT_DXBC1_RGB_UNORM;
+    case ETextureCompression::BC3:
+        return srgb ? CGPU_FORMAT_DXBC3_SRGB : CGPU_FORMAT_DXBC3_UNORM;
+    case ETextureCompression::BC4:
+        return CGPU_FORMAT_DXBC4_UNORM;
+    case ETextureCompression::BC5:
+        return CGPU_FORMAT_DXBC5_UNORM;
+    case ETextureCompression::BC6H:
+        return CGPU_FORMAT_DXBC6H_UFLOAT;
+    case ETextureCompression::BC7:
+        return srgb ? CGPU_FORMAT_DXBC7_SRGB : CGPU_FORMAT_DXBC7_UNORM;
+    case ETextureCompression::AUTO:
+    default:
+        switch (color_format)
+        {
+        case IMAGE_CODER_COLOR_FORMAT_Gray:
+        case IMAGE_CODER_COLOR_FORMAT_GrayF:
+            return CGPU_FORMAT_DXBC4_UNORM;
+        default:
+            return srgb ? CGPU_FORMAT_DXBC3_SRGB : CGPU_FORMAT_DXBC3_UNORM;
+        }
+    }
+}
+
+inline static void Util_GetBC7Profile(skd::asset::ETextureCompressionQuality quality, bool alpha, bc7_enc_settings* settings)
+{
+    using namespace skd::asset;
+    switch (quality)
+    {
+    case ETextureCompressionQuality::ULTRA_FAST:
+        alpha ? GetProfile_alpha_ultrafast(settings) : GetProfile_ultrafast(settings);
+        break;
+    case ETextureCompressionQuality::VERY_FAST:
+        alpha ? GetProfile_alpha_veryfast(settings) : GetProfile_veryfast(settings);
+        break;
+    case ETextureCompressionQuality::FAST:
+        alpha ? GetProfile_alpha_fast(settings) : GetProfile_fast(settings);
+        break;
+    case ETextureCompressionQuality::SLOW:
+    case ETextureCompressionQuality::VERY_SLOW:
+        alpha ? GetProfile_alpha_slow(settings) : GetProfile_slow(settings);
+        break;
+    case ETextureCompressionQuality::BASIC:
+    default:
+        alpha ? GetProfile_alpha_basic(settings) : GetProfile_basic(settings);
+        break;
+    }
+}
+
+inline static void Util_GetBC6HProfile(skd::asset::ETextureCompressionQuality quality, bc6h_enc_settings* settings)
+{
+    using namespace skd::asset;
+    switch (quality)
     {
-    case IMAGE_CODER_COLOR_FORMAT_RGBA:
-    case IMAGE_CODER_COLOR_FORMAT_BGRA:
-        rgba_surface.stride = image_width * 4;
+    case ETextureCompressionQuality::ULTRA_FAST:
+    case ETextureCompressionQuality::VERY_FAST:
+        GetProfile_bc6h_veryfast(settings);
         break;
-    case IMAGE_CODER_COLOR_FORMAT_Gray:
-    case IMAGE_CODER_COLOR_FORMAT_GrayF:
-        rgba_surface.stride = image_width;
+    case ETextureCompressionQuality::FAST:
+        GetProfile_bc6h_fast(settings);
         break;
+    case ETextureCompressionQuality::SLOW:
+        GetProfile_bc6h_slow(settings);
+        break;
+    case ETextureCompressionQuality::VERY_SLOW:
+        GetProfile_bc6h_veryslow(settings);
+        break;
+    case ETextureCompressionQuality::BASIC:
     default:
+        GetProfile_bc6h_basic(settings);
         break;
     }
-    rgba_surface.ptr = rgba_data;
-    rgba_surface.width = image_width;
-    rgba_surface.height = image_height;
-    const auto compressed_size = Util_DXBCCompressedSize(image_width, image_height, compressed_format);
-    eastl::vector<uint8_t> compressed_data(compressed_size);
-    switch (compressed_format)
+}
+
+struct STextureCompressSettings
+{
+    ECGPUFormat format = CGPU_FORMAT_UNDEFINED;
+    skd::asset::ETextureCompressionQuality quality = skd::asset::ETextureCompressionQuality::BASIC;
+    skd::asset::ETextureMipFilter mip_filter = skd::asset::ETextureMipFilter::BOX;
+    bool generate_mips = true;
+    // color of the source is sRGB encoded
+    bool srgb = false;
+};
+
+inline static uint8_t Util_FloatToUNorm8(float value)
+{
+    return (uint8_t)(eastl::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// BC6H_UFLOAT has no sign, negatives clamp to zero
+inline static uint16_t Util_FloatToUHalf(float value)
+{
+    value = eastl::clamp(value, 0.0f, 65504.0f);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent <= 0)
     {
-        case CGPU_FORMAT_DXBC1_RGB_UNORM:
-        case CGPU_FORMAT_DXBC1_RGB_SRGB:
-        case CGPU_FORMAT_DXBC1_RGBA_UNORM:
-        case CGPU_FORMAT_DXBC1_RGBA_SRGB:
-            CompressBlocksBC1(&rgba_surface, compressed_data.data());
-            break;
-        case CGPU_FORMAT_DXBC3_UNORM:
-        case CGPU_FORMAT_DXBC3_SRGB:
-            CompressBlocksBC3(&rgba_surface, compressed_data.data());
-            break;
-        case CGPU_FORMAT_DXBC4_UNORM:
-        case CGPU_FORMAT_DXBC4_SNORM:
-            CompressBlocksBC4(&rgba_surface, compressed_data.data());
-            break;
-        case CGPU_FORMAT_DXBC5_UNORM:
-        case CGPU_FORMAT_DXBC5_SNORM:
-            CompressBlocksBC5(&rgba_surface, compressed_data.data());
-            break;
-        case CGPU_FORMAT_DXBC6H_UFLOAT:
-        case CGPU_FORMAT_DXBC6H_SFLOAT:
+        if (exponent < -10) return 0;
+        mantissa |= 0x800000;
+        const uint32_t shift = (uint32_t)(14 - exponent);
+        return (uint16_t)((mantissa + (1u << (shift - 1))) >> shift);
+    }
+    // a rounding carry out of the mantissa correctly bumps the exponent
+    return (uint16_t)(((uint32_t)exponent << 10) + ((mantissa + 0x1000) >> 13));
+}
+
+// quantizes a mip to the encoder input of format: R8 for BC4, RG8 for BC5, RGBA16F for BC6H and RGBA8 otherwise.
+// the surface is padded to whole blocks by replicating the edges
+inline static eastl::vector<uint8_t> Util_EncodeSurface(const skd::asset::STextureMip& mip, ECGPUFormat format, bool srgb, rgba_surface* surface)
+{
+    uint32_t texel_size = 4;
+    switch (format)
+    {
+    case CGPU_FORMAT_DXBC4_UNORM:
+    case CGPU_FORMAT_DXBC4_SNORM:
+        texel_size = 1;
+        break;
+    case CGPU_FORMAT_DXBC5_UNORM:
+    case CGPU_FORMAT_DXBC5_SNORM:
+        texel_size = 2;
+        break;
+    case CGPU_FORMAT_DXBC6H_UFLOAT:
+    case CGPU_FORMAT_DXBC6H_SFLOAT:
+        texel_size = 8;
+        break;
+    default:
+        break;
+    }
+    surface->width = (int32_t)TEX_COMPRESS_ALIGN(mip.width, 4);
+    surface->height = (int32_t)TEX_COMPRESS_ALIGN(mip.height, 4);
+    surface->stride = surface->width * (int32_t)texel_size;
+    eastl::vector<uint8_t> data((size_t)surface->stride * surface->height);
+    surface->ptr = data.data();
+    skr::parallel_for_range((size_t)surface->height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y)
+        {
+            const float* src = mip.row(eastl::min((uint32_t)y, mip.height - 1));
+            uint8_t* dst = data.data() + y * surface->stride;
+            for (uint32_t x = 0; x < (uint32_t)surface->width; ++x)
             {
-                bc6h_enc_settings bc6_settings = {};
-                GetProfile_bc6h_basic(&bc6_settings);
-                CompressBlocksBC6H(&rgba_surface, compressed_data.data(), &bc6_settings);
+                const float* texel = src + (size_t)eastl::min(x, mip.width - 1) * mip.channels;
+                const float r = texel[0];
+                const float g = (mip.channels == 4) ? texel[1] : r;
+                const float b = (mip.channels == 4) ? texel[2] : r;
+                const float a = (mip.channels == 4) ? texel[3] : 1.0f;
+                switch (texel_size)
+                {
+                case 1:
+                    dst[x] = Util_FloatToUNorm8(r);
+                    break;
+                case 2:
+                    dst[x * 2 + 0] = Util_FloatToUNorm8(r);
+                    dst[x * 2 + 1] = Util_FloatToUNorm8(g);
+                    break;
+                case 8:
+                {
+                    const uint16_t half[4] = { Util_FloatToUHalf(r), Util_FloatToUHalf(g), Util_FloatToUHalf(b), Util_FloatToUHalf(1.0f) };
+                    memcpy(dst + x * 8, half, sizeof(half));
+                    break;
+                }
+                default:
+                    dst[x * 4 + 0] = Util_FloatToUNorm8(srgb ? skd::asset::Util_LinearToSRGB(r) : r);
+                    dst[x * 4 + 1] = Util_FloatToUNorm8(srgb ? skd::asset::Util_LinearToSRGB(g) : g);
+                    dst[x * 4 + 2] = Util_FloatToUNorm8(srgb ? skd::asset::Util_LinearToSRGB(b) : b);
+                    dst[x * 4 + 3] = Util_FloatToUNorm8(a);
+                    break;
+                }
             }
-            break;
-        case CGPU_FORMAT_DXBC7_UNORM:
-        case CGPU_FORMAT_DXBC7_SRGB:
+        }
+    }, skd::asset::kMipRowGrain);
+    return data;
+}
+
+// the ISPC kernels store blocks in raster order, so strips of whole block rows are compressed in parallel
+// straight into their final place in dst
+inline static void Util_DXTCompressSurface(const rgba_surface& surface, const STextureCompressSettings& settings, bool alpha, uint8_t* dst)
+{
+    const size_t blocks_w = (size_t)surface.width / 4;
+    const size_t blocks_h = (size_t)surface.height / 4;
+    const size_t block_size = Util_DXBCBlockSize(settings.format);
+    const size_t grain = eastl::max<size_t>(1, Util_DXBCTileBlocks(settings.format) / blocks_w);
+    bc7_enc_settings bc7_settings = {};
+    Util_GetBC7Profile(settings.quality, alpha, &bc7_settings);
+    bc6h_enc_settings bc6_settings = {};
+    Util_GetBC6HProfile(settings.quality, &bc6_settings);
+    skr::parallel_for_range(blocks_h, [&](size_t begin, size_t end) {
+        SkrZoneScopedN("CompressTile");
+        rgba_surface tile = surface;
+        tile.ptr = surface.ptr + begin * 4 * surface.stride;
+        tile.height = (int32_t)((end - begin) * 4);
+        uint8_t* out = dst + begin * blocks_w * block_size;
+        switch (settings.format)
+        {
+            case CGPU_FORMAT_DXBC1_RGB_UNORM:
+            case CGPU_FORMAT_DXBC1_RGB_SRGB:
+            case CGPU_FORMAT_DXBC1_RGBA_UNORM:
+            case CGPU_FORMAT_DXBC1_RGBA_SRGB:
+                CompressBlocksBC1(&tile, out);
+                break;
+            case CGPU_FORMAT_DXBC3_UNORM:
+            case CGPU_FORMAT_DXBC3_SRGB:
+                CompressBlocksBC3(&tile, out);
+                break;
+            case CGPU_FORMAT_DXBC4_UNORM:
+            case CGPU_FORMAT_DXBC4_SNORM:
+                CompressBlocksBC4(&tile, out);
+                break;
+            case CGPU_FORMAT_DXBC5_UNORM:
+            case CGPU_FORMAT_DXBC5_SNORM:
+                CompressBlocksBC5(&tile, out);
+                break;
+            case CGPU_FORMAT_DXBC6H_UFLOAT:
+            case CGPU_FORMAT_DXBC6H_SFLOAT:
             {
-                bc7_enc_settings bc7_settings = {};
-                GetProfile_basic(&bc7_settings);
-                CompressBlocksBC7(&rgba_surface, compressed_data.data(), &bc7_settings);
+                // the kernels take mutable settings
+                auto tile_settings = bc6_settings;
+                CompressBlocksBC6H(&tile, out, &tile_settings);
+                break;
             }
-            break;
-        case CGPU_FORMAT_DXBC2_UNORM:
-        case CGPU_FORMAT_DXBC2_SRGB:
-        default:
-            SKR_UNREACHABLE_CODE()
-            return {};
+            case CGPU_FORMAT_DXBC7_UNORM:
+            case CGPU_FORMAT_DXBC7_SRGB:
+            {
+                auto tile_settings = bc7_settings;
+                CompressBlocksBC7(&tile, out, &tile_settings);
+                break;
+            }
+            case CGPU_FORMAT_DXBC2_UNORM:
+            case CGPU_FORMAT_DXBC2_SRGB:
+            default:
+                SKR_UNREACHABLE_CODE()
+                break;
+        }
+    }, grain);
+}
+
+// mips are stored largest first, each one padded to whole blocks
+inline static eastl::vector<uint8_t> Util_DXTCompressWithImageCoder(skr::ImageDecoderId decoder, const STextureCompressSettings& settings, uint32_t* out_mips_count)
+{
+    using namespace skd::asset;
+    // fetch RGBA data, 16 bits only pay off for HDR targets
+    const auto encoded_format = decoder->get_color_format();
+    const bool gray = (encoded_format == IMAGE_CODER_COLOR_FORMAT_Gray) || (encoded_format == IMAGE_CODER_COLOR_FORMAT_GrayF);
+    const auto raw_format = gray ? IMAGE_CODER_COLOR_FORMAT_Gray : IMAGE_CODER_COLOR_FORMAT_RGBA;
+    const bool hdr = (settings.format == CGPU_FORMAT_DXBC6H_UFLOAT) || (settings.format == CGPU_FORMAT_DXBC6H_SFLOAT);
+    const uint32_t bit_depth = (hdr && decoder->get_bit_depth() == 16) ? 16 : 8;
+    if (!decoder->decode(raw_format, bit_depth))
+    {
+        SKR_UNREACHABLE_CODE()
+        return {};
+    }
+    const auto image_width = decoder->get_width();
+    const auto image_height = decoder->get_height();
+    STextureMip mip;
+    {
+        SkrZoneScopedN("LoadMip");
+        Util_LoadMip(mip, decoder->get_data(), image_width, image_height, gray ? 1 : 4, bit_depth, settings.srgb);
     }
+    // opaque images skip the alpha modes of BC7
+    bool alpha = false;
+    if (mip.channels == 4)
+    {
+        for (size_t i = 3; i < mip.pixels.size() && !alpha; i += 4)
+            alpha = mip.pixels[i] < 1.0f;
+    }
+
+    const uint32_t mips_count = settings.generate_mips ? Util_MipCount(image_width, image_height) : 1;
+    const auto offsets = Util_DXBCMipOffsets(image_width, image_height, mips_count, settings.format);
+    eastl::vector<uint8_t> compressed_data(offsets.back());
+    STextureMip next;
+    for (uint32_t level = 0; level < mips_count; ++level)
+    {
+        if (level > 0)
+        {
+            SkrZoneScopedN("GenerateMip");
+            Util_Downsample(mip, next, settings.mip_filter);
+            eastl::swap(mip, next);
+        }
+        // the downsampled mip has the size the offsets were laid out with
+        SKR_ASSERT(offsets[level + 1] - offsets[level] == Util_DXBCCompressedSize(mip.width, mip.height, settings.format));
+        rgba_surface surface = {};
+        const auto surface_data = Util_EncodeSurface(mip, settings.format, settings.srgb, &surface);
+        {
+            SkrZoneScopedN("CompressMip");
+            Util_DXTCompressSurface(surface, settings, alpha, compressed_data.data() + offsets[level]);
+        }
+    }
+    *out_mips_count = mips_count;
     return compressed_data;
-} 
\ No newline at end of file
+}
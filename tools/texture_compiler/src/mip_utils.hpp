@@ -0,0 +1,240 @@
+#pragma once
+#include "SkrTextureCompiler/texture_compiler.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/misc/parallel_algo.hpp"
+#include <math.h>
+
+namespace skd
+{
+namespace asset
+{
+// one mip level in linear float, channels interleaved
+struct STextureMip
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    skr::vector<float> pixels;
+
+    void resize(uint32_t w, uint32_t h, uint32_t c)
+    {
+        width = w;
+        height = h;
+        channels = c;
+        pixels.resize((size_t)w * h * c);
+    }
+    float* row(uint32_t y) { return pixels.data() + (size_t)y * width * channels; }
+    const float* row(uint32_t y) const { return pixels.data() + (size_t)y * width * channels; }
+};
+
+// rows per task of the mip passes, small mips stay on one task
+static constexpr size_t kMipRowGrain = 16;
+
+// half width of the kaiser window in destination texels
+static constexpr double kKaiserWidth = 3.0;
+static constexpr double kKaiserAlpha = 4.0;
+static constexpr double kPi = 3.14159265358979323846;
+
+inline static float Util_SRGBToLinear(float v)
+{
+    return (v <= 0.04045f) ? (v / 12.92f) : powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+inline static float Util_LinearToSRGB(float v)
+{
+    return (v <= 0.0031308f) ? (v * 12.92f) : (1.055f * powf(v, 1.0f / 2.4f) - 0.055f);
+}
+
+// 8-bit sRGB decodes through a table, every texel of the source goes through it
+inline static const float* Util_SRGBToLinearTable()
+{
+    static const auto table = []() {
+        skr::vector<float> values(256);
+        for (uint32_t i = 0; i < 256; ++i)
+            values[i] = Util_SRGBToLinear(i / 255.0f);
+        return values;
+    }();
+    return table.data();
+}
+
+// decoded 8 or 16 bit texels to linear float, alpha is never sRGB encoded
+inline static void Util_LoadMip(STextureMip& mip, const uint8_t* data, uint32_t width, uint32_t height, uint32_t channels, uint32_t bit_depth, bool srgb)
+{
+    mip.resize(width, height, channels);
+    const uint32_t color_channels = (channels == 4) ? 3 : channels;
+    const float* table = Util_SRGBToLinearTable();
+    skr::parallel_for_range(height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y)
+        {
+            float* dst = mip.row((uint32_t)y);
+            const size_t count = (size_t)width * channels;
+            if (bit_depth == 16)
+            {
+                const uint16_t* src = (const uint16_t*)data + y * count;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const float v = src[i] / 65535.0f;
+                    dst[i] = (srgb && (i % channels) < color_channels) ? Util_SRGBToLinear(v) : v;
+                }
+            }
+            else
+            {
+                const uint8_t* src = data + y * count;
+                for (size_t i = 0; i < count; ++i)
+                    dst[i] = (srgb && (i % channels) < color_channels) ? table[src[i]] : src[i] / 255.0f;
+            }
+        }
+    }, kMipRowGrain);
+}
+
+inline static void Util_BoxDownsample(const STextureMip& src, STextureMip& dst)
+{
+    const uint32_t c = src.channels;
+    dst.resize(eastl::max(src.width / 2, 1u), eastl::max(src.height / 2, 1u), c);
+    skr::parallel_for_range(dst.height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y)
+        {
+            // odd sizes clamp the last pair to the edge
+            const float* r0 = src.row(eastl::min((uint32_t)y * 2, src.height - 1));
+            const float* r1 = src.row(eastl::min((uint32_t)y * 2 + 1, src.height - 1));
+            float* out = dst.row((uint32_t)y);
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                const uint32_t x0 = eastl::min(x * 2, src.width - 1) * c;
+                const uint32_t x1 = eastl::min(x * 2 + 1, src.width - 1) * c;
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    out[x * c + ch] = 0.25f * (r0[x0 + ch] + r0[x1 + ch] + r1[x0 + ch] + r1[x1 + ch]);
+            }
+        }
+    }, kMipRowGrain);
+}
+
+// polyphase taps of one axis, every destination texel has the same count
+struct SKaiserTaps
+{
+    uint32_t count = 0;
+    skr::vector<uint32_t> indices;
+    skr::vector<float> weights;
+};
+
+inline static double Util_BesselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (uint32_t k = 1; k < 32; ++k)
+    {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+inline static SKaiserTaps Util_KaiserTaps(uint32_t src_size, uint32_t dst_size)
+{
+    SKaiserTaps taps;
+    const double ratio = (double)src_size / dst_size;
+    const double support = kKaiserWidth * ratio;
+    taps.count = (uint32_t)ceil(support * 2.0) + 1;
+    taps.indices.resize((size_t)dst_size * taps.count);
+    taps.weights.resize((size_t)dst_size * taps.count);
+    const double i0_alpha = Util_BesselI0(kKaiserAlpha);
+    for (uint32_t x = 0; x < dst_size; ++x)
+    {
+        const double center = (x + 0.5) * ratio;
+        const int64_t left = (int64_t)floor(center - support);
+        double total = 0.0;
+        for (uint32_t j = 0; j < taps.count; ++j)
+        {
+            // distance in destination texels
+            const double t = (left + j + 0.5 - center) / ratio;
+            double w = 0.0;
+            if (fabs(t) < kKaiserWidth)
+            {
+                const double sinc = (t == 0.0) ? 1.0 : sin(kPi * t) / (kPi * t);
+                const double r = t / kKaiserWidth;
+                w = sinc * Util_BesselI0(kKaiserAlpha * sqrt(1.0 - r * r)) / i0_alpha;
+            }
+            const int64_t index = eastl::clamp<int64_t>(left + j, 0, (int64_t)src_size - 1);
+            taps.indices[(size_t)x * taps.count + j] = (uint32_t)index;
+            taps.weights[(size_t)x * taps.count + j] = (float)w;
+            total += w;
+        }
+        for (uint32_t j = 0; j < taps.count; ++j)
+            taps.weights[(size_t)x * taps.count + j] = (float)(taps.weights[(size_t)x * taps.count + j] / total);
+    }
+    return taps;
+}
+
+// separable, rows then columns. negative lobes may overshoot, the encoders clamp
+inline static void Util_KaiserDownsample(const STextureMip& src, STextureMip& dst)
+{
+    const uint32_t c = src.channels;
+    dst.resize(eastl::max(src.width / 2, 1u), eastl::max(src.height / 2, 1u), c);
+    const auto htaps = Util_KaiserTaps(src.width, dst.width);
+    const auto vtaps = Util_KaiserTaps(src.height, dst.height);
+    STextureMip rows;
+    rows.resize(dst.width, src.height, c);
+    skr::parallel_for_range(src.height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y)
+        {
+            const float* in = src.row((uint32_t)y);
+            float* out = rows.row((uint32_t)y);
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                const uint32_t* indices = htaps.indices.data() + (size_t)x * htaps.count;
+                const float* weights = htaps.weights.data() + (size_t)x * htaps.count;
+                float* texel = out + (size_t)x * c;
+                for (uint32_t ch = 0; ch < c; ++ch)
+                    texel[ch] = 0.0f;
+                for (uint32_t j = 0; j < htaps.count; ++j)
+                {
+                    const float* s = in + (size_t)indices[j] * c;
+                    for (uint32_t ch = 0; ch < c; ++ch)
+                        texel[ch] += weights[j] * s[ch];
+                }
+            }
+        }
+    }, kMipRowGrain);
+    const size_t row_size = (size_t)dst.width * c;
+    skr::parallel_for_range(dst.height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y)
+        {
+            const uint32_t* indices = vtaps.indices.data() + y * vtaps.count;
+            const float* weights = vtaps.weights.data() + y * vtaps.count;
+            float* out = dst.row((uint32_t)y);
+            for (size_t i = 0; i < row_size; ++i)
+                out[i] = 0.0f;
+            // whole rows at once, the inner loop is contiguous
+            for (uint32_t j = 0; j < vtaps.count; ++j)
+            {
+                const float* in = rows.row(indices[j]);
+                const float w = weights[j];
+                for (size_t i = 0; i < row_size; ++i)
+                    out[i] += w * in[i];
+            }
+        }
+    }, kMipRowGrain);
+}
+
+inline static void Util_Downsample(const STextureMip& src, STextureMip& dst, ETextureMipFilter filter)
+{
+    if (filter == ETextureMipFilter::KAISER)
+        Util_KaiserDownsample(src, dst);
+    else
+        Util_BoxDownsample(src, dst);
+}
+
+inline static uint32_t Util_MipCount(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+    while (width > 1 || height > 1)
+    {
+        width = eastl::max(width / 2, 1u);
+        height = eastl::max(height / 2, 1u);
+        count++;
+    }
+    return count;
+}
+} // namespace asset
+} // namespace skd
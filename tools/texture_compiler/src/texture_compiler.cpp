@@ -70,32 +70,36 @@ bool STextureCooker::Cook(SCookContext *ctx)
     auto uncompressed = ctx->Import<skr_uncompressed_render_texture_t>();
     SKR_DEFER({ ctx->Destroy(uncompressed); });
     
+    auto importer = static_cast<STextureImporter*>(ctx->GetImporter());
+
     // try decode texture & calculate compressed format
     const auto decoder = uncompressed->decoder;
     const auto format = decoder->get_color_format();
-    ECGPUFormat compressed_format = CGPU_FORMAT_UNDEFINED;
-    switch (format) // TODO: format shuffle
-    {
-        case IMAGE_CODER_COLOR_FORMAT_Gray: 
-        case IMAGE_CODER_COLOR_FORMAT_GrayF:
-            compressed_format = CGPU_FORMAT_DXBC4_UNORM; 
-            break;
-        case IMAGE_CODER_COLOR_FORMAT_RGBA:
-        default:
-            compressed_format = CGPU_FORMAT_DXBC3_UNORM; 
-            break;
-    }
+    STextureCompressSettings settings = {};
+    settings.format = Util_CompressedFormat(importer->compression, format, importer->srgb);
+    settings.quality = importer->quality;
+    settings.mip_filter = importer->mip_filter;
+    settings.generate_mips = importer->generate_mips;
+    // BC4 & BC5 carry data channels, BC6H is linear HDR
+    settings.srgb = importer->srgb && (settings.format != CGPU_FORMAT_DXBC4_UNORM) && (settings.format != CGPU_FORMAT_DXBC5_UNORM);
     // DXT
     skr::vector<uint8_t> compressed_data;
+    uint32_t mips_count = 0;
     {
         SkrZoneScopedN("DXTCompress");
-        compressed_data = Util_DXTCompressWithImageCoder(decoder, compressed_format);
+        compressed_data = Util_DXTCompressWithImageCoder(decoder, settings, &mips_count);
+    }
+    if (compressed_data.empty())
+    {
+        SKR_LOG_ERROR(u8"[STextureCooker] failed to compress texture %s", importer->assetPath.c_str());
+        return false;
     }
     // TODO: ASTC
     // write texture resource
+    const auto compressed_format = settings.format;
     skr_texture_resource_t resource;
     resource.format = compressed_format;
-    resource.mips_count = 1;
+    resource.mips_count = mips_count;
     resource.data_size = compressed_data.size();
     resource.height = decoder->get_height();
     resource.width = decoder->get_width();
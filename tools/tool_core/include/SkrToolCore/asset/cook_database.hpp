@@ -0,0 +1,110 @@
+#pragma once
+#include "SkrToolCore/fwd_types.hpp"
+#include "SkrRT/platform/guid.hpp"
+#include "SkrRT/platform/thread.h"
+#include "SkrRT/platform/filesystem.hpp"
+#include "SkrRT/containers/string.hpp"
+#include "SkrRT/containers/vector.hpp"
+#include "SkrRT/containers/hashmap.hpp"
+#include <atomic>
+#ifndef __meta__
+    #include "SkrToolCore/asset/cook_database.generated.h" // IWYU pragma: export
+#endif
+
+struct SLightningEnvironment;
+struct SLightningStorage;
+
+namespace skd sreflect
+{
+namespace asset sreflect
+{
+// content hash of a file, size & write time only decide whether it has to be hashed again
+sreflect_struct("guid" : "D3E17D7E-DC46-47F7-A0D6-A0E5C686347D")
+sattr("serialize" : "bin")
+SCookFileRecord
+{
+    skr::string path;
+    uint64_t size = 0;
+    int64_t timestamp = 0;
+    uint64_t hash = 0;
+};
+
+sreflect_struct("guid" : "0746D104-5CE2-4206-BB6A-11FC107015C5")
+sattr("serialize" : "bin")
+SCookDependencyRecord
+{
+    skr_guid_t guid;
+    // output hash of a cooked dependency, the content of a plain file dependency
+    SCookFileRecord content;
+};
+
+// everything a cook of an asset read and wrote, a resource is up to date as long as all of it is unchanged
+sreflect_struct("guid" : "EE0B8360-A744-48B1-94D6-24834E027DBE")
+sattr("serialize" : "bin")
+SCookRecord
+{
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t version = kVersion;
+    uint32_t importerVersion = 0;
+    uint32_t cookerVersion = 0;
+    uint64_t metaHash = 0;
+    // hash of all outputs, dependents compare it to skip recooks when a recook produced identical outputs
+    uint64_t outputHash = 0;
+    // relative to the output directory
+    skr::vector<SCookFileRecord> outputs;
+    // relative to the directory of the asset
+    skr::vector<SCookFileRecord> files;
+    skr::vector<SCookDependencyRecord> dependencies;
+};
+
+// cook records of a project keyed by asset guid. records live in a lightning storage that is opened once with the
+// project, lookups read the memory map and parse nothing but the record
+struct TOOL_CORE_API SCookDatabase
+{
+    struct Statistics
+    {
+        uint64_t files_checked = 0;
+        uint64_t files_hashed = 0;
+        uint64_t bytes_hashed = 0;
+        uint64_t records_stored = 0;
+        uint64_t records_refreshed = 0;
+    };
+
+    static SCookDatabase* Open(const skr::filesystem::path& directory) SKR_NOEXCEPT;
+    static void Close(SCookDatabase* database) SKR_NOEXCEPT;
+
+    bool Find(skr_guid_t guid, SCookRecord& record) SKR_NOEXCEPT;
+    bool Store(skr_guid_t guid, const SCookRecord& record) SKR_NOEXCEPT;
+    // drops the record and a pending refresh of it, the asset and the dependents comparing its outputs recook
+    bool Remove(skr_guid_t guid) SKR_NOEXCEPT;
+    // for records whose content is unchanged but whose file stats are stale, they are written in one transaction by Flush
+    void Refresh(skr_guid_t guid, const SCookRecord& record) SKR_NOEXCEPT;
+    void Flush() SKR_NOEXCEPT;
+
+    // fills the size, write time and hash of file, path excluded
+    bool HashFile(const skr::filesystem::path& path, SCookFileRecord& file) SKR_NOEXCEPT;
+    // true if path has the content recorded in file. the file is only hashed if its size or write time changed,
+    // stale is set when the content matched with new stats, which are written to file
+    bool CheckFile(const skr::filesystem::path& path, SCookFileRecord& file, bool& stale) SKR_NOEXCEPT;
+
+    Statistics GetStatistics() const SKR_NOEXCEPT;
+
+    SCookDatabase() SKR_NOEXCEPT;
+    ~SCookDatabase() SKR_NOEXCEPT;
+
+protected:
+    SLightningEnvironment* environment = nullptr;
+    SLightningStorage* storage = nullptr;
+
+    SMutexObject refresh_mutex;
+    skr::flat_hash_map<skr_guid_t, SCookRecord, skr::guid::hash> refreshed;
+
+    std::atomic<uint64_t> files_checked = 0;
+    std::atomic<uint64_t> files_hashed = 0;
+    std::atomic<uint64_t> bytes_hashed = 0;
+    std::atomic<uint64_t> records_stored = 0;
+    std::atomic<uint64_t> records_refreshed = 0;
+};
+} // namespace asset
+} // namespace skd
@@ -74,8 +74,14 @@ public:
         //------write resource object
         skr::vector<uint8_t> buffer;
         skr::binary::VectorWriter writer{&buffer};
-        skr_binary_writer_t archive(writer);
-        if(int result = skr::binary::Archive(&archive, resource); result != 0)
+        // stage small fields so the vector only grows once per block
+        uint8_t staging[4096];
+        skr_binary_writer_t archive(writer, staging, sizeof(staging));
+        int result = skr::binary::Archive(&archive, resource);
+        const int flushed = archive.flush();
+        if (result == 0)
+            result = flushed;
+        if(result != 0)
         {
             SKR_LOG_FMT_ERROR(u8"[SConfigCooker::Cook] failed to serialize resource {}! path: {}", 
                 record->guid, (const char*)record->path.u8string().c_str());
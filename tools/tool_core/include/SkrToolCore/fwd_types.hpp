@@ -17,5 +17,6 @@ struct SAssetRecord;
 struct SCookSystem;
 struct SCooker;
 struct SCookContext;
+struct SCookDatabase;
 }
 }
\ No newline at end of file
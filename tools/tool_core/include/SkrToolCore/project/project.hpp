@@ -29,6 +29,7 @@ private:
 public:
     skr::filesystem::path GetAssetPath() const noexcept { return assetPath; }
     skr::filesystem::path GetOutputPath() const noexcept { return outputPath; }
+    skr::filesystem::path GetArtifactsPath() const noexcept { return artifactsPath; }
     skr::filesystem::path GetDependencyPath() const noexcept { return dependencyPath; }
 
     static SProject* OpenProject(const skr::filesystem::path& path) noexcept;
@@ -37,6 +38,7 @@ public:
     skr_vfs_t* asset_vfs = nullptr;
     skr_vfs_t* resource_vfs = nullptr;
     skr_io_ram_service_t* ram_service = nullptr;
+    asset::SCookDatabase* cook_database = nullptr;
     ~SProject() noexcept;
 };
 }
\ No newline at end of file
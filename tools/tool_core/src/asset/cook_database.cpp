@@ -0,0 +1,225 @@
+#include "SkrRT/misc/log.hpp"
+#include "SkrRT/misc/defer.hpp"
+#include "SkrRT/misc/hash.h"
+#include "SkrRT/serde/binary/reader.h"
+#include "SkrRT/serde/binary/writer.h"
+#include "SkrToolCore/asset/cook_database.hpp"
+#include "lightning_storage/storage.h"
+#include "lightning_storage/transaction.h"
+
+#include <stdio.h>
+
+#include "SkrProfile/profile.h"
+
+namespace skd::asset
+{
+static constexpr size_t kHashChunkSize = 1024 * 1024;
+
+SCookDatabase* SCookDatabase::Open(const skr::filesystem::path& directory) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::Open");
+    auto environment = skr_lightning_storage_create_environment(directory.string().c_str());
+    if (!environment)
+    {
+        SKR_LOG_ERROR(u8"[CookDatabase] failed to open cook database at %s, every asset will be recooked", directory.string().c_str());
+        return nullptr;
+    }
+    SLightningStorageOpenDescriptor desc = {};
+    desc.name = "cook_records";
+    desc.flags = LIGHTNING_STORAGE_OPEN_CREATE;
+    auto storage = skr_open_lightning_storage(environment, &desc);
+    if (!storage)
+    {
+        skr_lightning_storage_free_environment(environment);
+        return nullptr;
+    }
+    auto database = SkrNew<SCookDatabase>();
+    database->environment = environment;
+    database->storage = storage;
+    return database;
+}
+
+void SCookDatabase::Close(SCookDatabase* database) SKR_NOEXCEPT
+{
+    SkrDelete(database);
+}
+
+SCookDatabase::SCookDatabase() SKR_NOEXCEPT
+{
+
+}
+
+SCookDatabase::~SCookDatabase() SKR_NOEXCEPT
+{
+    Flush();
+    const auto statistics = GetStatistics();
+    SKR_LOG_FMT_INFO(u8"[CookDatabase] {} files checked, {} hashed ({} KiB), {} records stored, {} refreshed",
+        statistics.files_checked, statistics.files_hashed, statistics.bytes_hashed / 1024, statistics.records_stored, statistics.records_refreshed);
+    if (storage) skr_close_lightning_storage(storage);
+    if (environment) skr_lightning_storage_free_environment(environment);
+}
+
+bool SCookDatabase::Find(skr_guid_t guid, SCookRecord& record) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::Find");
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_ONLY);
+    if (!txn) return false;
+    SKR_DEFER({ skr_lightning_storage_abort_transaction(txn); });
+
+    const SLightningValue key = { &guid, sizeof(guid) };
+    SLightningValue value = {};
+    if (!skr_lightning_storage_get(txn, storage, &key, &value))
+        return false;
+    skr::binary::SpanReader reader = { { (const uint8_t*)value.data, (size_t)value.size }, 0 };
+    skr_binary_reader_t archive{reader};
+    if (skr::binary::Read(&archive, record) != 0)
+        return false;
+    // records of older layouts are dropped, their assets are recooked
+    return record.version == SCookRecord::kVersion;
+}
+
+bool SCookDatabase::Store(skr_guid_t guid, const SCookRecord& record) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::Store");
+    {
+        // the stored record supersedes a refreshed one
+        SMutexLock lock(refresh_mutex.mMutex);
+        refreshed.erase(guid);
+    }
+    skr::vector<uint8_t> buffer;
+    skr::binary::VectorWriter writer{&buffer};
+    skr_binary_writer_t archive(writer);
+    if (skr::binary::Archive(&archive, record) != 0)
+        return false;
+
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+    if (!txn) return false;
+    const SLightningValue key = { &guid, sizeof(guid) };
+    const SLightningValue value = { buffer.data(), buffer.size() };
+    if (!skr_lightning_storage_put(txn, storage, &key, &value))
+    {
+        skr_lightning_storage_abort_transaction(txn);
+        return false;
+    }
+    if (!skr_lightning_storage_commit_transaction(txn))
+        return false;
+    records_stored++;
+    return true;
+}
+
+bool SCookDatabase::Remove(skr_guid_t guid) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::Remove");
+    {
+        SMutexLock lock(refresh_mutex.mMutex);
+        refreshed.erase(guid);
+    }
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+    if (!txn) return false;
+    const SLightningValue key = { &guid, sizeof(guid) };
+    // a missing record is as good as a removed one
+    skr_lightning_storage_delete(txn, storage, &key);
+    return skr_lightning_storage_commit_transaction(txn);
+}
+
+void SCookDatabase::Refresh(skr_guid_t guid, const SCookRecord& record) SKR_NOEXCEPT
+{
+    SMutexLock lock(refresh_mutex.mMutex);
+    refreshed.insert_or_assign(guid, record);
+}
+
+void SCookDatabase::Flush() SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::Flush");
+    skr::flat_hash_map<skr_guid_t, SCookRecord, skr::guid::hash> records;
+    {
+        SMutexLock lock(refresh_mutex.mMutex);
+        records.swap(refreshed);
+    }
+    if (records.empty()) return;
+
+    skr::vector<skr::vector<uint8_t>> buffers;
+    skr::vector<SLightningKeyValue> pairs;
+    buffers.reserve(records.size());
+    pairs.reserve(records.size());
+    for (const auto& [guid, record] : records)
+    {
+        auto& buffer = buffers.emplace_back();
+        skr::binary::VectorWriter writer{&buffer};
+        skr_binary_writer_t archive(writer);
+        if (skr::binary::Archive(&archive, record) != 0)
+        {
+            buffers.pop_back();
+            continue;
+        }
+        pairs.push_back({ { &guid, sizeof(guid) }, { buffer.data(), buffer.size() } });
+    }
+    auto txn = skr_lightning_storage_begin_transaction(environment, LIGHTNING_TRANSACTION_READ_WRITE);
+    if (!txn) return;
+    if (skr_lightning_storage_put_batch(txn, storage, pairs.data(), pairs.size(), LIGHTNING_PUT_DEFAULT) != pairs.size())
+    {
+        skr_lightning_storage_abort_transaction(txn);
+        return;
+    }
+    if (skr_lightning_storage_commit_transaction(txn))
+        records_refreshed += pairs.size();
+}
+
+bool SCookDatabase::HashFile(const skr::filesystem::path& path, SCookFileRecord& file) SKR_NOEXCEPT
+{
+    SkrZoneScopedN("CookDatabase::HashFile");
+    std::error_code ec = {};
+    const auto timestamp = skr::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    auto stream = fopen(path.string().c_str(), "rb");
+    if (!stream) return false;
+    SKR_DEFER({ fclose(stream); });
+
+    // chunks chain through the seed, the hash of a file only depends on its content
+    skr::vector<uint8_t> chunk(kHashChunkSize);
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    while (auto read = fread(chunk.data(), 1, chunk.size(), stream))
+    {
+        hash = skr_hash64_xxh3(chunk.data(), read, hash);
+        size += read;
+    }
+    if (ferror(stream)) return false;
+    file.size = size;
+    file.timestamp = (int64_t)timestamp.time_since_epoch().count();
+    file.hash = hash;
+    files_hashed++;
+    bytes_hashed += size;
+    return true;
+}
+
+bool SCookDatabase::CheckFile(const skr::filesystem::path& path, SCookFileRecord& file, bool& stale) SKR_NOEXCEPT
+{
+    files_checked++;
+    std::error_code ec = {};
+    const auto size = skr::filesystem::file_size(path, ec);
+    if (ec) return false;
+    const auto timestamp = skr::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    if (size == file.size && (int64_t)timestamp.time_since_epoch().count() == file.timestamp)
+        return true;
+    // touched, e.g. by a checkout. only a different content counts as a change
+    SCookFileRecord current = {};
+    if (!HashFile(path, current) || current.size != file.size || current.hash != file.hash)
+        return false;
+    file.timestamp = current.timestamp;
+    stale = true;
+    return true;
+}
+
+SCookDatabase::Statistics SCookDatabase::GetStatistics() const SKR_NOEXCEPT
+{
+    Statistics statistics = {};
+    statistics.files_checked = files_checked.load();
+    statistics.files_hashed = files_hashed.load();
+    statistics.bytes_hashed = bytes_hashed.load();
+    statistics.records_stored = records_stored.load();
+    statistics.records_refreshed = records_refreshed.load();
+    return statistics;
+}
+} // namespace skd::asset
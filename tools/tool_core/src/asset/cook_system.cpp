@@ -3,15 +3,16 @@
 #include "SkrRT/misc/parallel_for.hpp"
 #include "SkrRT/misc/make_zeroed.hpp"
 #include "SkrRT/misc/defer.hpp"
+#include "SkrRT/misc/hash.h"
 #include "SkrRT/containers/string.hpp"
 #include "SkrRT/io/ram_io.hpp"
 #include "SkrRT/async/thread_job.hpp"
 
 #include "SkrRT/serde/json/reader.h"
-#include "SkrRT/serde/json/writer.h"
 #include "SkrRT/serde/binary/writer.h"
 
 #include "SkrToolCore/asset/cook_system.hpp"
+#include "SkrToolCore/asset/cook_database.hpp"
 #include "SkrToolCore/asset/importer.hpp"
 #include "SkrToolCore/project/project.hpp"
 
@@ -57,6 +58,12 @@ struct SCookSystemImpl : public skd::asset::SCookSystem
     SAssetRecord* ImportAsset(SProject* project, skr::filesystem::path path) override;
     skr_io_ram_service_t* getIOService() override;
 
+    // the cook waits for waitFor first, it is skipped if the dependencies it waited for produced their recorded outputs
+    skr::task::event_t ScheduleCook(skr_guid_t resource, skr::vector<skr::task::event_t> waitFor);
+    bool HashDependency(SAssetRecord* dependency, SCookFileRecord& content);
+    bool DependenciesUnchanged(SAssetRecord* record);
+    bool RecordCook(SCookContext* context);
+
     template <class F, class Iter>
     void ParallelFor(Iter begin, Iter end, size_t batch, F f)
     {
@@ -175,7 +182,17 @@ skr_io_ram_service_t* SCookSystemImpl::getIOService()
     return ioServices[cursor++];
 }
 
+static uint64_t HashMeta(const SAssetRecord* record)
+{
+    return skr_hash64_xxh3(record->meta.data(), record->meta.size(), 0);
+}
+
 skr::task::event_t SCookSystemImpl::AddCookTask(skr_guid_t guid)
+{
+    return ScheduleCook(guid, {});
+}
+
+skr::task::event_t SCookSystemImpl::ScheduleCook(skr_guid_t guid, skr::vector<skr::task::event_t> waitFor)
 {
     SCookContext* jobContext;
     {
@@ -193,7 +210,7 @@ skr::task::event_t SCookSystemImpl::AddCookTask(skr_guid_t guid)
     jobContext->SetCounter(counter);
     auto guidName = skr::format(u8"Fiber{}", jobContext->record->guid);
     mainCounter.add(1);
-    skr::task::schedule([jobContext]()
+    skr::task::schedule([jobContext, waitFor]()
     {
         auto system = static_cast<SCookSystemImpl*>(GetCookSystem());
         const auto metaAsset = jobContext->record;
@@ -220,6 +237,18 @@ skr::task::event_t SCookSystemImpl::AddCookTask(skr_guid_t guid)
             system->mainCounter.decrement();
         });
 
+        // early cutoff, recooked dependencies may produce what this resource was cooked with
+        if (!waitFor.empty())
+        {
+            for (auto& event : waitFor)
+                event.wait(false);
+            if (system->DependenciesUnchanged(metaAsset))
+            {
+                SKR_LOG_INFO(u8"[CookTask] dependencies of resource %s are cooked to identical outputs, cook skipped!", metaAsset->path.u8string().c_str());
+                return;
+            }
+        }
+
         // Create output dir
         auto outputPath = metaAsset->project->GetOutputPath();
         std::error_code ec = {};
@@ -257,39 +286,15 @@ skr::task::event_t SCookSystemImpl::AddCookTask(skr_guid_t guid)
                 fwrite(buffer.data(), 1, buffer.size(), file);
             }
 
-            // write resource dependencies
+            // record what the cook read & wrote
+            if (!system->RecordCook(jobContext))
             {
-                SKR_LOG_INFO(u8"[CookTask] resource %s cook finished! updating dependencies.", metaAsset->path.u8string().c_str());
-                // write dependencies
-                auto dependencyPath = metaAsset->project->GetDependencyPath() / skr::format(u8"{}.d", metaAsset->guid).c_str();
-                skr_json_writer_t writer(2);
-                writer.StartObject();
-                writer.Key(u8"importerVersion");
-                writer.UInt64(jobContext->GetImporterVersion());
-                writer.Key(u8"cookerVersion");
-                writer.UInt64(jobContext->GetCookerVersion());
-                writer.Key(u8"files");
-                writer.StartArray();
-                for (auto& dep : jobContext->GetFileDependencies())
-                {
-                    auto str = dep.string();
-                    skr::json::Write<const skr::string_view&>(&writer, {(const char8_t*)str.data(), str.size() });
-                }
-                writer.EndArray();
-                writer.Key(u8"dependencies");
-                writer.StartArray();
-                for (auto& dep : jobContext->GetStaticDependencies())
-                    skr::json::Write<const skr_resource_handle_t&>(&writer, dep);
-                writer.EndArray();
-                writer.EndObject();
-                auto file = fopen(dependencyPath.string().c_str(), "w");
-                if (!file)
+                // the previous record still carries the old output hash, dependents would skip their recook against it
+                SKR_LOG_ERROR(u8"[CookTask] failed to record cook of resource %s, it will be cooked again!", metaAsset->path.u8string().c_str());
+                if (auto database = metaAsset->project->cook_database; database && !database->Remove(metaAsset->guid))
                 {
-                    SKR_LOG_ERROR(u8"[CookTask] failed to write dependency file for resource %s!", metaAsset->path.u8string().c_str());
-                    return;
+                    SKR_LOG_ERROR(u8"[CookTask] failed to drop the stale cook record of resource %s!", metaAsset->path.u8string().c_str());
                 }
-                SKR_DEFER({ fclose(file); });
-                fwrite(writer.buffer.c_str(), 1, writer.buffer.size(), file);
             }
         }
     }, &counter, guidName.c_str());
@@ -314,6 +319,86 @@ void SCookSystemImpl::UnregisterCooker(skr_guid_t guid)
     cookers.erase(guid);
 }
 
+bool SCookSystemImpl::HashDependency(SAssetRecord* dependency, SCookFileRecord& content)
+{
+    auto database = dependency->project->cook_database;
+    if (!database)
+        return false;
+    // plain files are compared by content, cooked resources by the hash of their outputs
+    if (dependency->type == skr_guid_t{})
+        return database->HashFile(dependency->project->GetAssetPath() / dependency->path, content);
+    SCookRecord record;
+    if (!database->Find(dependency->guid, record))
+        return false;
+    content.hash = record.outputHash;
+    return true;
+}
+
+bool SCookSystemImpl::DependenciesUnchanged(SAssetRecord* metaAsset)
+{
+    SkrZoneScoped;
+    auto database = metaAsset->project->cook_database;
+    SCookRecord record;
+    if (!database || !database->Find(metaAsset->guid, record))
+        return false;
+    for (const auto& dependency : record.dependencies)
+    {
+        auto depRecord = GetAssetRecord(dependency.guid);
+        if (!depRecord)
+            return false;
+        // plain files are checked by EnsureCooked already
+        if (depRecord->type == skr_guid_t{})
+            continue;
+        SCookFileRecord content;
+        if (!HashDependency(depRecord, content) || content.hash != dependency.content.hash)
+            return false;
+    }
+    return true;
+}
+
+bool SCookSystemImpl::RecordCook(SCookContext* context)
+{
+    SkrZoneScoped;
+    const auto metaAsset = context->record;
+    auto database = metaAsset->project->cook_database;
+    if (!database)
+        return false;
+    SCookRecord record;
+    record.importerVersion = context->GetImporterVersion();
+    record.cookerVersion = context->GetCookerVersion();
+    record.metaHash = HashMeta(metaAsset);
+    const auto assetDirectory = metaAsset->project->GetAssetPath() / metaAsset->path.parent_path();
+    for (const auto& path : context->GetFileDependencies())
+    {
+        auto& file = record.files.emplace_back();
+        file.path = path.u8string().c_str();
+        if (!database->HashFile(assetDirectory / path, file))
+            return false;
+    }
+    for (const auto& handle : context->GetStaticDependencies())
+    {
+        auto& dependency = record.dependencies.emplace_back();
+        dependency.guid = handle.get_guid();
+        auto depRecord = GetAssetRecord(dependency.guid);
+        if (!depRecord || !HashDependency(depRecord, dependency.content))
+            return false;
+    }
+    auto resourcePath = context->GetOutputPath();
+    auto headerPath = resourcePath;
+    headerPath.replace_extension("rh");
+    uint64_t outputHashes[2] = {};
+    for (const auto& path : { resourcePath, headerPath })
+    {
+        auto& output = record.outputs.emplace_back();
+        output.path = path.filename().u8string().c_str();
+        if (!database->HashFile(path, output))
+            return false;
+        outputHashes[record.outputs.size() - 1] = output.hash;
+    }
+    record.outputHash = skr_hash64_xxh3(outputHashes, sizeof(outputHashes), 0);
+    return database->Store(metaAsset->guid, record);
+}
+
 #define SKR_CHECK_RESULT(result, name) \
     if (result.error() != simdjson::SUCCESS) \
     { \
@@ -335,11 +420,15 @@ skr::task::event_t SCookSystemImpl::EnsureCooked(skr_guid_t guid)
     auto metaAsset = GetAssetRecord(guid);
     if (!metaAsset)
     {
-        SKR_LOG_ERROR(u8"[SCookSystemImpl::EnsureCooked] resource not exist! asset path: %s", metaAsset->path.u8string().c_str());
+        SKR_LOG_FMT_ERROR(u8"[SCookSystemImpl::EnsureCooked] resource not exist! guid: {}", guid);
         return nullptr;
     }
-    auto resourcePath = metaAsset->project->GetOutputPath() / skr::format(u8"{}.bin", metaAsset->guid).u8_str();
-    auto dependencyPath = metaAsset->project->GetDependencyPath() / skr::format(u8"{}.d", metaAsset->guid).u8_str();
+    auto database = metaAsset->project->cook_database;
+    SCookRecord cookRecord;
+    // stats of unchanged files that moved, e.g. after a checkout
+    bool stale = false;
+    // cooks of dependencies, this resource may still be up to date if they produce their recorded outputs
+    skr::vector<skr::task::event_t> cookingDependencies;
     auto checkUpToDate = [&]() -> bool {
         auto cooker = GetCooker(metaAsset);
         if(!cooker)
@@ -347,29 +436,14 @@ skr::task::event_t SCookSystemImpl::EnsureCooked(skr_guid_t guid)
             SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] cooker not found! asset path: %s", metaAsset->path.u8string().c_str());
             return true;
         }
-        std::error_code ec = {};
-        if (!skr::filesystem::is_regular_file(resourcePath, ec))
+        if (!database || !database->Find(guid, cookRecord))
         {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] resource not exist! asset path: %s" , metaAsset->path.u8string().c_str());
+            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] cook record not exist! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
         }
-        if (!skr::filesystem::is_regular_file(dependencyPath, ec))
+        if (cookRecord.metaHash != HashMeta(metaAsset))
         {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file not exist! asset path: %s}", dependencyPath.string().c_str());
-            return false;
-        }
-        auto timestamp = skr::filesystem::last_write_time(resourcePath, ec);
-        if (skr::filesystem::last_write_time(metaAsset->path, ec) > timestamp)
-        {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] meta file modified! resource path: %s", metaAsset->path.u8string().c_str());
-            return false;
-        }
-        simdjson::ondemand::parser parser;
-        auto json = simdjson::padded_string::load(dependencyPath.string());
-        auto doc = parser.iterate(json);
-        if (doc.error() != simdjson::SUCCESS)
-        {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file parse failed! asset path: %s", metaAsset->path.u8string().c_str());
+            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] meta file modified! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
         }
         simdjson::ondemand::parser metaParser;
@@ -385,10 +459,8 @@ skr::task::event_t SCookSystemImpl::EnsureCooked(skr_guid_t guid)
             SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] meta file parse failed! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
         }
-        auto importerVersion = doc["importerVersion"].get_uint64();
-        SKR_CHECK_RESULT(importerVersion, "dependency")
         auto currentImporterVersion = GetImporterRegistry()->GetImporterVersion(importerTypeGuid);
-        if(importerVersion.value_unsafe() != currentImporterVersion)
+        if(cookRecord.importerVersion != currentImporterVersion)
         {
             SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] importer version changed! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
@@ -398,90 +470,72 @@ skr::task::event_t SCookSystemImpl::EnsureCooked(skr_guid_t guid)
             SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dev importer version (UINT32_MAX)! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
         }
+        if (cooker->Version() == UINT32_MAX)
         {
-            
-            if (cooker->Version() == UINT32_MAX)
-            {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dev cooker version (UINT32_MAX)! asset path: %s", metaAsset->path.u8string().c_str());
-                return false;
-            }
-            auto resourceFile = fopen(resourcePath.string().c_str(), "rb");
-            SKR_DEFER({ fclose(resourceFile); });
-            uint8_t buffer[sizeof(skr_resource_header_t)];
-            fread(buffer, 0, sizeof(skr_resource_header_t), resourceFile);
-            SKR_DEFER({ fclose(resourceFile); });
-            skr::binary::SpanReader reader = {buffer};
-            skr_binary_reader_t archive{reader};
-            skr_resource_header_t header;
-            if(header.ReadWithoutDeps(&archive) != 0)
-            {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] resource header read failed! asset path: %s", metaAsset->path.u8string().c_str());
-                return false;
-            }
-            if (header.version != cooker->Version())
-            {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] cooker version changed! asset path: %s", metaAsset->path.u8string().c_str());
-                return false;
-            }
+            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dev cooker version (UINT32_MAX)! asset path: %s", metaAsset->path.u8string().c_str());
+            return false;
         }
-        auto files = doc["files"].get_array();
-        if (files.error() != simdjson::SUCCESS)
+        if (cookRecord.cookerVersion != cooker->Version())
         {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file parse failed! asset path: %s", metaAsset->path.u8string().c_str());
+            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] cooker version changed! asset path: %s", metaAsset->path.u8string().c_str());
             return false;
         }
-        for (auto file : files.value_unsafe())
+        const auto outputPath = metaAsset->project->GetOutputPath();
+        for (auto& output : cookRecord.outputs)
         {
-            skr::string pathStr;
-            skr::json::Read(std::move(file).value_unsafe(), pathStr);
-            skr::filesystem::path path(pathStr.c_str());
-            path = metaAsset->path.parent_path() / (path);
-            std::error_code ec = {};
-            if(!skr::filesystem::exists(path, ec))
+            if (!database->CheckFile(outputPath / output.path.c_str(), output, stale))
             {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] file not exist! asset path: %s", metaAsset->path.u8string().c_str());
+                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] resource modified or not exist! asset path: %s", metaAsset->path.u8string().c_str());
                 return false;
             }
-            if (skr::filesystem::last_write_time(path, ec) > timestamp)
+        }
+        const auto assetDirectory = metaAsset->project->GetAssetPath() / metaAsset->path.parent_path();
+        for (auto& file : cookRecord.files)
+        {
+            if (!database->CheckFile(assetDirectory / file.path.c_str(), file, stale))
             {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] file modified! asset path: %s", metaAsset->path.u8string().c_str());
+                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] file %s modified or not exist! asset path: %s", file.path.c_str(), metaAsset->path.u8string().c_str());
                 return false;
             }
         }
-        auto deps = doc["dependencies"].get_array();
-        if (deps.error() != simdjson::SUCCESS)
-        {
-            SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file parse failed! asset path: %s", metaAsset->path.u8string().c_str());
-            return false;
-        }
-        for (auto depFile : deps.value_unsafe())
+        for (auto& dependency : cookRecord.dependencies)
         {
-            skr_guid_t depGuid;
-            skr::json::Read(std::move(depFile).value_unsafe(), depGuid);
-            auto record = GetAssetRecord(depGuid);
+            auto record = GetAssetRecord(dependency.guid);
             if (!record)
             {
-                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file not exist! asset path: %s", metaAsset->path.u8string().c_str());
+                SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency not exist! asset path: %s", metaAsset->path.u8string().c_str());
                 return false;
             }
             if (record->type == skr_guid_t{})
             {
-                if (skr::filesystem::last_write_time(record->path, ec) > timestamp)
+                if (!database->CheckFile(record->project->GetAssetPath() / record->path, dependency.content, stale))
                 {
                     SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency file %s modified! asset path: %s", record->path.u8string().c_str(), metaAsset->path.u8string().c_str());
                     return false;
                 }
             }
+            else if (auto event = EnsureCooked(dependency.guid))
+            {
+                cookingDependencies.emplace_back(std::move(event));
+            }
             else
             {
-                if (EnsureCooked(depGuid))
+                SCookFileRecord content;
+                if (!HashDependency(record, content) || content.hash != dependency.content.hash)
+                {
+                    SKR_LOG_INFO(u8"[SCookSystemImpl::EnsureCooked] dependency %s cooked to different outputs! asset path: %s", record->path.u8string().c_str(), metaAsset->path.u8string().c_str());
                     return false;
+                }
             }
         }
         return true;
     };
     if (!checkUpToDate())
         return AddCookTask(guid);
+    if (stale)
+        database->Refresh(guid, cookRecord);
+    if (!cookingDependencies.empty())
+        return ScheduleCook(guid, std::move(cookingDependencies));
     return nullptr;
 }
 
@@ -4,6 +4,7 @@
 #include "SkrRT/io/ram_io.hpp"
 #include "SkrRT/serde/json/reader.h"
 #include "SkrToolCore/project/project.hpp"
+#include "SkrToolCore/asset/cook_database.hpp"
 
 namespace skd
 {
@@ -111,11 +112,14 @@ SProject* SProject::OpenProject(const skr::filesystem::path& projectFile) noexce
     project->ram_service = skr_io_ram_service_t::create(&ioServiceDesc);
     project->ram_service->run();
 
+    project->cook_database = asset::SCookDatabase::Open(project->dependencyPath);
+
     return project;
 }
 
 SProject::~SProject() noexcept
 {
+    if (cook_database) asset::SCookDatabase::Close(cook_database);
     if(ram_service) skr_io_ram_service_t::destroy(ram_service);
     if (resource_vfs) skr_free_vfs(resource_vfs);
     if (asset_vfs) skr_free_vfs(asset_vfs);
@@ -4,6 +4,7 @@ shared_module("SkrToolCore", "TOOL_CORE", engine_version)
     set_pcxxheader("src/pch.hpp")
     add_files("src/**.cpp")
     public_dependency("SkrRT", engine_version)
+    public_dependency("SkrLightningStorage", engine_version)
     add_includedirs("include", {public = true})
     add_rules("c++.codegen", {
         files = {"include/**.h", "include/**.hpp"},